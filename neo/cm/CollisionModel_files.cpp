@@ -45,6 +45,12 @@ If you have questions concerning this license or the applicable additional terms
 #define CM_FILEID			"CM"
 #define CM_FILEVERSION		"1.00"
 
+#define CMB_FILE_EXT		"cmb"
+#define CMB_FILEID			( ( 'B' << 24 ) | ( 'M' << 16 ) | ( 'C' << 8 ) | 'I' )
+#define CMB_FILEVERSION		1
+
+idCVar cm_binaryCache( "cm_binaryCache", "1", CVAR_SYSTEM | CVAR_BOOL, "cache map collision models in binary .cmb files" );
+
 /*
 ===============================================================================
 
@@ -558,10 +564,24 @@ bool idCollisionModelManagerLocal::LoadCollisionModelFile( const char *name, uns
 	idToken token;
 	idLexer *src;
 	unsigned int crc;
+	ID_TIME_T timeStamp = 0;
+	int firstModel;
 
-	// load it
 	fileName = name;
 	fileName.SetFileExtension( CM_FILE_EXT );
+
+	// try the binary cache of map collision models first, it has to be
+	// from the same map and .cm file or it is rebuilt from the text
+	if ( mapFileCRC && cm_binaryCache.GetBool() ) {
+		if ( fileSystem->ReadFile( fileName, NULL, &timeStamp ) < 0 ) {
+			return false;
+		}
+		if ( LoadBinaryCollisionModelFile( name, mapFileCRC, timeStamp ) ) {
+			return true;
+		}
+	}
+
+	// load it
 	src = new idLexer( fileName );
 	src->SetFlags( LEXFL_NOSTRINGCONCAT | LEXFL_NODOLLARPRECOMPILE );
 	if ( !src->IsLoaded() ) {
@@ -595,6 +615,7 @@ bool idCollisionModelManagerLocal::LoadCollisionModelFile( const char *name, uns
 	}
 
 	// parse the file
+	firstModel = numModels;
 	while ( 1 ) {
 		if ( !src->ReadToken( &token ) ) {
 			break;
@@ -613,5 +634,478 @@ bool idCollisionModelManagerLocal::LoadCollisionModelFile( const char *name, uns
 
 	delete src;
 
+	// cache the parsed models so the next load doesn't have to parse the text again
+	if ( mapFileCRC && cm_binaryCache.GetBool() ) {
+		WriteBinaryCollisionModelFile( name, firstModel, numModels, mapFileCRC, timeStamp );
+	}
+
+	return true;
+}
+
+/*
+===============================================================================
+
+Binary collision model cache
+
+The .cmb file holds the models exactly as they are after loading the .cm
+file, in the in-memory layout with the pointers replaced by 1-based indexes
+or byte offsets. Every array is read straight into the block it lives in
+and the pointers are fixed up in place, so nothing is allocated per element.
+The layout depends on the byte order and pointer size, so a cache written
+by a different build is simply treated as out of date.
+
+===============================================================================
+*/
+
+typedef struct cmbHeader_s {
+	int						fileId;				// CMB_FILEID in native byte order
+	int						version;
+	int						pointerSize;
+	unsigned int			mapFileCRC;
+	unsigned int			timeStamp;			// of the .cm file the cache was made from
+	int						numModels;
+} cmbHeader_t;
+
+typedef struct cmbModel_s {
+	idBounds				bounds;
+	int						contents;
+	int						isConvex;
+	int						numVertices;
+	int						numEdges;
+	int						numNodes;
+	int						numPolygonRefs;
+	int						numBrushRefs;
+	int						numMaterials;
+	int						numPolygons;
+	int						polygonMemory;
+	int						numBrushes;
+	int						brushMemory;
+	int						numInternalEdges;
+	int						numSharpEdges;
+	int						numRemovedPolys;
+	int						numMergedPolys;
+	int						usedMemory;
+} cmbModel_t;
+
+/*
+================
+CMB_PointerMap
+
+maps the pointers of a model to their index in the file
+================
+*/
+class CMB_PointerMap {
+public:
+	int						Find( const void *ptr ) const {
+								for ( int i = hash.First( Key( ptr ) ); i != -1; i = hash.Next( i ) ) {
+									if ( list[i] == ptr ) {
+										return i;
+									}
+								}
+								return -1;
+							}
+	int						Add( const void *ptr ) {
+								hash.Add( Key( ptr ), list.Num() );
+								return list.Append( ptr );
+							}
+	int						Num( void ) const { return list.Num(); }
+	const void *			operator[]( int index ) const { return list[index]; }
+
+private:
+	idHashIndex				hash;
+	idList<const void *>	list;
+
+	static int				Key( const void *ptr ) { return (int)( ( (intptr_t) ptr ) >> 4 ); }
+};
+
+#define CMB_ENCODE( index )		( (void *)(intptr_t)( index ) )
+#define CMB_DECODE( ptr )		( (int)(intptr_t)( ptr ) )
+
+/*
+================
+CMB_CollectNodes_r
+================
+*/
+static void CMB_CollectNodes_r( CMB_PointerMap &nodes, const cm_node_t *node ) {
+	while ( 1 ) {
+		nodes.Add( node );
+		if ( node->planeType == -1 ) {
+			break;
+		}
+		CMB_CollectNodes_r( nodes, node->children[1] );
+		node = node->children[0];
+	}
+}
+
+/*
+================
+idCollisionModelManagerLocal::WriteBinaryCollisionModel
+================
+*/
+void idCollisionModelManagerLocal::WriteBinaryCollisionModel( idFile *fp, cm_model_t *model ) {
+	CMB_PointerMap nodes, polygonRefs, brushRefs, polygons, brushes, materials;
+	idList<int> polygonOffsets, brushOffsets;
+	cmbModel_t header;
+	int i, size;
+
+	// number everything in the order it is found in the tree
+	CMB_CollectNodes_r( nodes, model->node );
+	header.polygonMemory = header.brushMemory = 0;
+	for ( i = 0; i < nodes.Num(); i++ ) {
+		const cm_node_t *node = (const cm_node_t *) nodes[i];
+		for ( cm_polygonRef_t *pref = node->polygons; pref; pref = pref->next ) {
+			polygonRefs.Add( pref );
+			if ( polygons.Find( pref->p ) == -1 ) {
+				polygons.Add( pref->p );
+				polygonOffsets.Append( header.polygonMemory );
+				header.polygonMemory += sizeof( cm_polygon_t ) + ( pref->p->numEdges - 1 ) * sizeof( pref->p->edges[0] );
+				if ( materials.Find( pref->p->material ) == -1 ) {
+					materials.Add( pref->p->material );
+				}
+			}
+		}
+		for ( cm_brushRef_t *bref = node->brushes; bref; bref = bref->next ) {
+			brushRefs.Add( bref );
+			if ( brushes.Find( bref->b ) == -1 ) {
+				brushes.Add( bref->b );
+				brushOffsets.Append( header.brushMemory );
+				header.brushMemory += sizeof( cm_brush_t ) + ( bref->b->numPlanes - 1 ) * sizeof( bref->b->planes[0] );
+				if ( materials.Find( bref->b->material ) == -1 ) {
+					materials.Add( bref->b->material );
+				}
+			}
+		}
+	}
+
+	header.bounds = model->bounds;
+	header.contents = model->contents;
+	header.isConvex = model->isConvex;
+	header.numVertices = model->numVertices;
+	header.numEdges = model->numEdges;
+	header.numNodes = nodes.Num();
+	header.numPolygonRefs = polygonRefs.Num();
+	header.numBrushRefs = brushRefs.Num();
+	header.numMaterials = materials.Num();
+	header.numPolygons = polygons.Num();
+	header.numBrushes = brushes.Num();
+	header.numInternalEdges = model->numInternalEdges;
+	header.numSharpEdges = model->numSharpEdges;
+	header.numRemovedPolys = model->numRemovedPolys;
+	header.numMergedPolys = model->numMergedPolys;
+	header.usedMemory = model->usedMemory;
+
+	fp->WriteString( model->name );
+	fp->Write( &header, sizeof( header ) );
+
+	for ( i = 0; i < materials.Num(); i++ ) {
+		const idMaterial *material = (const idMaterial *) materials[i];
+		fp->WriteString( material ? material->GetName() : "" );
+	}
+
+	// the checkcounts and sides are scratch space for the collision detection and start out cleared
+	for ( i = 0; i < model->numVertices; i++ ) {
+		cm_vertex_t vertex = model->vertices[i];
+		vertex.checkcount = 0;
+		vertex.side = vertex.sideSet = 0;
+		fp->Write( &vertex, sizeof( vertex ) );
+	}
+	for ( i = 0; i < model->numEdges; i++ ) {
+		cm_edge_t edge = model->edges[i];
+		edge.checkcount = 0;
+		edge.side = edge.sideSet = 0;
+		fp->Write( &edge, sizeof( edge ) );
+	}
+
+	for ( i = 0; i < nodes.Num(); i++ ) {
+		cm_node_t node = *(const cm_node_t *) nodes[i];
+		node.polygons = (cm_polygonRef_t *) CMB_ENCODE( polygonRefs.Find( node.polygons ) + 1 );
+		node.brushes = (cm_brushRef_t *) CMB_ENCODE( brushRefs.Find( node.brushes ) + 1 );
+		node.parent = (cm_node_t *) CMB_ENCODE( nodes.Find( node.parent ) + 1 );
+		node.children[0] = (cm_node_t *) CMB_ENCODE( nodes.Find( node.children[0] ) + 1 );
+		node.children[1] = (cm_node_t *) CMB_ENCODE( nodes.Find( node.children[1] ) + 1 );
+		fp->Write( &node, sizeof( node ) );
+	}
+	for ( i = 0; i < polygonRefs.Num(); i++ ) {
+		cm_polygonRef_t pref = *(const cm_polygonRef_t *) polygonRefs[i];
+		pref.p = (cm_polygon_t *) CMB_ENCODE( polygonOffsets[polygons.Find( pref.p )] + 1 );
+		pref.next = (cm_polygonRef_t *) CMB_ENCODE( polygonRefs.Find( pref.next ) + 1 );
+		fp->Write( &pref, sizeof( pref ) );
+	}
+	for ( i = 0; i < brushRefs.Num(); i++ ) {
+		cm_brushRef_t bref = *(const cm_brushRef_t *) brushRefs[i];
+		bref.b = (cm_brush_t *) CMB_ENCODE( brushOffsets[brushes.Find( bref.b )] + 1 );
+		bref.next = (cm_brushRef_t *) CMB_ENCODE( brushRefs.Find( bref.next ) + 1 );
+		fp->Write( &bref, sizeof( bref ) );
+	}
+
+	// polygons and brushes are variable sized, copy them to a block like the one they're loaded into
+	byte *block = (byte *) Mem_Alloc( Max( header.polygonMemory, header.brushMemory ) + 1 );
+	for ( i = 0; i < polygons.Num(); i++ ) {
+		const cm_polygon_t *p = (const cm_polygon_t *) polygons[i];
+		size = sizeof( cm_polygon_t ) + ( p->numEdges - 1 ) * sizeof( p->edges[0] );
+		cm_polygon_t *copy = (cm_polygon_t *) ( block + polygonOffsets[i] );
+		memcpy( copy, p, size );
+		copy->checkcount = 0;
+		copy->material = (const idMaterial *) CMB_ENCODE( materials.Find( p->material ) );
+	}
+	fp->Write( block, header.polygonMemory );
+	for ( i = 0; i < brushes.Num(); i++ ) {
+		const cm_brush_t *b = (const cm_brush_t *) brushes[i];
+		size = sizeof( cm_brush_t ) + ( b->numPlanes - 1 ) * sizeof( b->planes[0] );
+		cm_brush_t *copy = (cm_brush_t *) ( block + brushOffsets[i] );
+		memcpy( copy, b, size );
+		copy->checkcount = 0;
+		copy->material = (const idMaterial *) CMB_ENCODE( materials.Find( b->material ) );
+	}
+	fp->Write( block, header.brushMemory );
+	Mem_Free( block );
+}
+
+/*
+================
+idCollisionModelManagerLocal::WriteBinaryCollisionModelFile
+================
+*/
+void idCollisionModelManagerLocal::WriteBinaryCollisionModelFile( const char *filename, int firstModel, int lastModel, unsigned int mapFileCRC, ID_TIME_T timeStamp ) {
+	int i;
+	idFile *fp;
+	idStr name;
+	cmbHeader_t header;
+
+	name = filename;
+	name.SetFileExtension( CMB_FILE_EXT );
+
+	fp = fileSystem->OpenFileWrite( name, "fs_devpath" );
+	if ( !fp ) {
+		common->Warning( "idCollisionModelManagerLocal::WriteBinaryCollisionModelFile: Error opening file %s\n", name.c_str() );
+		return;
+	}
+
+	header.fileId = CMB_FILEID;
+	header.version = CMB_FILEVERSION;
+	header.pointerSize = sizeof( void * );
+	header.mapFileCRC = mapFileCRC;
+	header.timeStamp = (unsigned int) timeStamp;
+	header.numModels = lastModel - firstModel;
+	fp->Write( &header, sizeof( header ) );
+
+	for ( i = firstModel; i < lastModel; i++ ) {
+		WriteBinaryCollisionModel( fp, models[ i ] );
+	}
+
+	fileSystem->CloseFile( fp );
+}
+
+/*
+================
+idCollisionModelManagerLocal::LoadBinaryCollisionModel
+================
+*/
+bool idCollisionModelManagerLocal::LoadBinaryCollisionModel( idFile *fp ) {
+	cm_model_t *model;
+	cmbModel_t header;
+	idList<const idMaterial *> materials;
+	idStr name;
+	int i, j, offset, size;
+
+	if ( numModels >= MAX_SUBMODELS ) {
+		common->Error( "LoadModel: no free slots" );
+		return false;
+	}
+
+	fp->ReadString( name );
+	if ( fp->Read( &header, sizeof( header ) ) != sizeof( header ) ) {
+		return false;
+	}
+	if ( header.numVertices < 0 || header.numEdges < 0 || header.numNodes < 1 || header.numPolygonRefs < 0 ||
+			header.numBrushRefs < 0 || header.numMaterials < 0 || header.polygonMemory < 0 || header.brushMemory < 0 ) {
+		return false;
+	}
+
+	materials.SetNum( header.numMaterials );
+	for ( i = 0; i < header.numMaterials; i++ ) {
+		idStr materialName;
+		fp->ReadString( materialName );
+		materials[i] = materialName.Length() ? declManager->FindMaterial( materialName ) : NULL;
+	}
+
+	// allocate the model the same way the text parser leaves it, one block per kind of element
+	model = AllocModel();
+	model->name = name;
+	model->maxVertices = model->numVertices = header.numVertices;
+	model->vertices = (cm_vertex_t *) Mem_Alloc( header.numVertices * sizeof( cm_vertex_t ) );
+	model->maxEdges = model->numEdges = header.numEdges;
+	model->edges = (cm_edge_t *) Mem_Alloc( header.numEdges * sizeof( cm_edge_t ) );
+	model->nodeBlocks = (cm_nodeBlock_t *) Mem_Alloc( sizeof( cm_nodeBlock_t ) + header.numNodes * sizeof( cm_node_t ) );
+	model->nodeBlocks->nextNode = NULL;
+	model->nodeBlocks->next = NULL;
+	model->polygonRefBlocks = (cm_polygonRefBlock_t *) Mem_Alloc( sizeof( cm_polygonRefBlock_t ) + header.numPolygonRefs * sizeof( cm_polygonRef_t ) );
+	model->polygonRefBlocks->nextRef = NULL;
+	model->polygonRefBlocks->next = NULL;
+	model->brushRefBlocks = (cm_brushRefBlock_t *) Mem_Alloc( sizeof( cm_brushRefBlock_t ) + header.numBrushRefs * sizeof( cm_brushRef_t ) );
+	model->brushRefBlocks->nextRef = NULL;
+	model->brushRefBlocks->next = NULL;
+	model->polygonBlock = (cm_polygonBlock_t *) Mem_Alloc( sizeof( cm_polygonBlock_t ) + header.polygonMemory );
+	model->polygonBlock->bytesRemaining = 0;
+	model->polygonBlock->next = ( (byte *) model->polygonBlock ) + sizeof( cm_polygonBlock_t ) + header.polygonMemory;
+	model->brushBlock = (cm_brushBlock_t *) Mem_Alloc( sizeof( cm_brushBlock_t ) + header.brushMemory );
+	model->brushBlock->bytesRemaining = 0;
+	model->brushBlock->next = ( (byte *) model->brushBlock ) + sizeof( cm_brushBlock_t ) + header.brushMemory;
+
+	cm_node_t *nodes = (cm_node_t *) ( model->nodeBlocks + 1 );
+	cm_polygonRef_t *polygonRefs = (cm_polygonRef_t *) ( model->polygonRefBlocks + 1 );
+	cm_brushRef_t *brushRefs = (cm_brushRef_t *) ( model->brushRefBlocks + 1 );
+	byte *polygonMemory = (byte *) ( model->polygonBlock + 1 );
+	byte *brushMemory = (byte *) ( model->brushBlock + 1 );
+
+	// read everything straight into place
+	bool ok = true;
+	size = header.numVertices * sizeof( cm_vertex_t );
+	ok = ok && fp->Read( model->vertices, size ) == size;
+	size = header.numEdges * sizeof( cm_edge_t );
+	ok = ok && fp->Read( model->edges, size ) == size;
+	size = header.numNodes * sizeof( cm_node_t );
+	ok = ok && fp->Read( nodes, size ) == size;
+	size = header.numPolygonRefs * sizeof( cm_polygonRef_t );
+	ok = ok && fp->Read( polygonRefs, size ) == size;
+	size = header.numBrushRefs * sizeof( cm_brushRef_t );
+	ok = ok && fp->Read( brushRefs, size ) == size;
+	ok = ok && fp->Read( polygonMemory, header.polygonMemory ) == header.polygonMemory;
+	ok = ok && fp->Read( brushMemory, header.brushMemory ) == header.brushMemory;
+
+	// fix up the pointers, checking every index so a damaged file can't take us down
+#define CMB_FIXUP( ptr, type, base, count )	{ int index = CMB_DECODE( ptr ); ok = ok && index >= 0 && index <= (count); ptr = ( ok && index ) ? (type)( (base) + index - 1 ) : NULL; }
+
+	for ( i = 0; ok && i < header.numEdges; i++ ) {
+		const cm_edge_t *edge = &model->edges[i];
+		ok = edge->vertexNum[0] >= 0 && edge->vertexNum[0] < header.numVertices &&
+				edge->vertexNum[1] >= 0 && edge->vertexNum[1] < header.numVertices;
+	}
+
+	for ( i = 0; ok && i < header.numNodes; i++ ) {
+		cm_node_t *node = &nodes[i];
+		CMB_FIXUP( node->polygons, cm_polygonRef_t *, polygonRefs, header.numPolygonRefs );
+		CMB_FIXUP( node->brushes, cm_brushRef_t *, brushRefs, header.numBrushRefs );
+		CMB_FIXUP( node->parent, cm_node_t *, nodes, header.numNodes );
+		CMB_FIXUP( node->children[0], cm_node_t *, nodes, header.numNodes );
+		CMB_FIXUP( node->children[1], cm_node_t *, nodes, header.numNodes );
+		ok = ok && ( node->planeType == -1 || ( node->planeType >= 0 && node->planeType < 3 && node->children[0] && node->children[1] ) );
+	}
+	for ( i = 0; ok && i < header.numPolygonRefs; i++ ) {
+		CMB_FIXUP( polygonRefs[i].p, cm_polygon_t *, polygonMemory, header.polygonMemory );
+		CMB_FIXUP( polygonRefs[i].next, cm_polygonRef_t *, polygonRefs, header.numPolygonRefs );
+		ok = ok && polygonRefs[i].p != NULL;
+	}
+	for ( i = 0; ok && i < header.numBrushRefs; i++ ) {
+		CMB_FIXUP( brushRefs[i].b, cm_brush_t *, brushMemory, header.brushMemory );
+		CMB_FIXUP( brushRefs[i].next, cm_brushRef_t *, brushRefs, header.numBrushRefs );
+		ok = ok && brushRefs[i].b != NULL;
+	}
+	for ( offset = 0; ok && offset < header.polygonMemory; offset += size ) {
+		cm_polygon_t *p = (cm_polygon_t *) ( polygonMemory + offset );
+		int materialNum = CMB_DECODE( p->material );
+		ok = offset + (int)sizeof( cm_polygon_t ) <= header.polygonMemory &&
+				p->numEdges > 0 && p->numEdges <= ( header.polygonMemory - offset ) / (int)sizeof( p->edges[0] ) &&
+				materialNum >= 0 && materialNum < header.numMaterials;
+		if ( ok ) {
+			size = sizeof( cm_polygon_t ) + ( p->numEdges - 1 ) * sizeof( p->edges[0] );
+			ok = offset + size <= header.polygonMemory;
+		}
+		for ( j = 0; ok && j < p->numEdges; j++ ) {
+			ok = p->edges[j] > -header.numEdges && p->edges[j] < header.numEdges;
+		}
+		if ( ok ) {
+			p->material = materials[materialNum];
+		}
+	}
+	for ( offset = 0; ok && offset < header.brushMemory; offset += size ) {
+		cm_brush_t *b = (cm_brush_t *) ( brushMemory + offset );
+		int materialNum = CMB_DECODE( b->material );
+		ok = offset + (int)sizeof( cm_brush_t ) <= header.brushMemory &&
+				b->numPlanes > 0 && b->numPlanes <= ( header.brushMemory - offset ) / (int)sizeof( b->planes[0] ) &&
+				materialNum >= 0 && materialNum < header.numMaterials;
+		if ( ok ) {
+			size = sizeof( cm_brush_t ) + ( b->numPlanes - 1 ) * sizeof( b->planes[0] );
+			ok = offset + size <= header.brushMemory;
+		}
+		if ( ok ) {
+			b->material = materials[materialNum];
+		}
+	}
+
+#undef CMB_FIXUP
+
+	if ( !ok ) {
+		// the tree can't be trusted, only free the blocks
+		FreeModel( model );
+		return false;
+	}
+
+	model->node = nodes;
+	model->bounds = header.bounds;
+	model->contents = header.contents;
+	model->isConvex = ( header.isConvex != 0 );
+	model->numNodes = header.numNodes;
+	model->numPolygonRefs = header.numPolygonRefs;
+	model->numBrushRefs = header.numBrushRefs;
+	model->numPolygons = header.numPolygons;
+	model->polygonMemory = header.polygonMemory;
+	model->numBrushes = header.numBrushes;
+	model->brushMemory = header.brushMemory;
+	model->numInternalEdges = header.numInternalEdges;
+	model->numSharpEdges = header.numSharpEdges;
+	model->numRemovedPolys = header.numRemovedPolys;
+	model->numMergedPolys = header.numMergedPolys;
+	model->usedMemory = header.usedMemory;
+
+	models[numModels] = model;
+	numModels++;
+
+	return true;
+}
+
+/*
+================
+idCollisionModelManagerLocal::LoadBinaryCollisionModelFile
+================
+*/
+bool idCollisionModelManagerLocal::LoadBinaryCollisionModelFile( const char *name, unsigned int mapFileCRC, ID_TIME_T timeStamp ) {
+	idStr fileName;
+	idFile *fp;
+	cmbHeader_t header;
+	int i, firstModel;
+
+	fileName = name;
+	fileName.SetFileExtension( CMB_FILE_EXT );
+	fp = fileSystem->OpenFileRead( fileName );
+	if ( !fp ) {
+		return false;
+	}
+
+	if ( fp->Read( &header, sizeof( header ) ) != sizeof( header ) ||
+			header.fileId != CMB_FILEID || header.version != CMB_FILEVERSION || header.pointerSize != sizeof( void * ) ||
+			header.mapFileCRC != mapFileCRC || header.timeStamp != (unsigned int) timeStamp ) {
+		common->Printf( "%s is out of date\n", fileName.c_str() );
+		fileSystem->CloseFile( fp );
+		return false;
+	}
+
+	firstModel = numModels;
+	for ( i = 0; i < header.numModels; i++ ) {
+		if ( !LoadBinaryCollisionModel( fp ) ) {
+			common->Warning( "%s is damaged", fileName.c_str() );
+			// drop what was loaded, the text file will be parsed instead
+			while ( numModels > firstModel ) {
+				numModels--;
+				FreeModel( models[numModels] );
+				models[numModels] = NULL;
+			}
+			fileSystem->CloseFile( fp );
+			return false;
+		}
+	}
+
+	fileSystem->CloseFile( fp );
+
 	return true;
 }
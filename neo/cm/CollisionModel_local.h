@@ -490,6 +490,11 @@ private:			// CollisionMap_files.cpp
 	void			ParseBrushes( idLexer *src, cm_model_t *model );
 	bool			ParseCollisionModel( idLexer *src );
 	bool			LoadCollisionModelFile( const char *name, unsigned int mapFileCRC );
+					// binary cache
+	void			WriteBinaryCollisionModel( idFile *fp, cm_model_t *model );
+	void			WriteBinaryCollisionModelFile( const char *filename, int firstModel, int lastModel, unsigned int mapFileCRC, ID_TIME_T timeStamp );
+	bool			LoadBinaryCollisionModel( idFile *fp );
+	bool			LoadBinaryCollisionModelFile( const char *name, unsigned int mapFileCRC, ID_TIME_T timeStamp );
 
 private:			// CollisionMap_debug
 	int				ContentsFromString( const char *string ) const;
@@ -1732,6 +1732,8 @@ void idGameLocal::MapShutdown( void ) {
 
 	mapFileName.Clear();
 
+	animFrameEntities.Clear();
+
 	gameRenderWorld = NULL;
 	gameSoundWorld = NULL;
 
@@ -2430,6 +2432,60 @@ void idGameLocal::SortActiveEntityList( void ) {
 	sortPushers = false;
 }
 
+/*
+================
+idGameLocal::PrepareAnimFramesJob
+================
+*/
+void idGameLocal::PrepareAnimFramesJob( void *data, int first, int last ) {
+	idGameLocal *game = static_cast<idGameLocal *>( data );
+
+	for ( int i = first; i < last; i++ ) {
+		idEntity *ent = game->animFrameEntities[i];
+		ent->GetAnimator()->PrepareFrame( game->GetTimeGroupTime( ent->timeGroup ), false );
+	}
+}
+
+/*
+================
+idGameLocal::PrepareAnimFrames
+
+  Builds the animation frames the renderer will ask for through the model
+  callbacks on the job threads, one entity per job. PrepareFrame only
+  touches the entity's own animator, the think phase itself stays serial.
+================
+*/
+void idGameLocal::PrepareAnimFrames( void ) {
+	idEntity *ent;
+
+	if ( inCinematic && skipCinematic ) {
+		return;
+	}
+
+	// animation debug output isn't thread safe
+	if ( g_debugAnim.GetInteger() != -1 ) {
+		return;
+	}
+
+	animFrameEntities.SetNum( 0, false );
+	for ( ent = activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next() ) {
+		if ( !ent->GetAnimator() || ent->GetModelDefHandle() == -1 ) {
+			continue;
+		}
+		if ( ent->GetRenderEntity()->callback != idEntity::ModelCallback ) {
+			continue;
+		}
+		if ( !InPlayerPVS( ent ) ) {
+			continue;
+		}
+		animFrameEntities.Append( ent );
+	}
+
+	if ( animFrameEntities.Num() ) {
+		sys->ParallelFor( PrepareAnimFramesJob, this, animFrameEntities.Num(), 1 );
+	}
+}
+
 #ifdef _D3XP
 /*
 ================
@@ -2496,6 +2552,9 @@ gameReturn_t idGameLocal::RunFrame(const usercmd_t* clientCmds) {
 	msecPrecise = slowmoMsec;
 #endif
 
+	ret.thinkMsec = 0.0f;
+	ret.eventMsec = 0.0f;
+
 	if ( !isMultiplayer && g_stopTime.GetBool() ) {
 		// clear any debug lines from a previous frame
 		gameRenderWorld->DebugClearLines( time + 1 );
@@ -2532,6 +2591,12 @@ gameReturn_t idGameLocal::RunFrame(const usercmd_t* clientCmds) {
 		}
 #endif
 
+		// switch between the clip sectors and the clip model tree on the fly
+		if ( g_clipModelTree.IsModified() ) {
+			clip.UseClipModelTree( g_clipModelTree.GetBool() );
+			g_clipModelTree.ClearModified();
+		}
+
 		// make sure the random number counter is used each frame so random events
 		// are influenced by the player's actions
 		random.RandomInt();
@@ -2570,6 +2635,7 @@ gameReturn_t idGameLocal::RunFrame(const usercmd_t* clientCmds) {
 
 		timer_think.Clear();
 		timer_think.Start();
+		double thinkStartTime = sys->GetMillisecondsPrecise();
 
 		// let entities think
 		if ( g_timeentities.GetFloat() ) {
@@ -2634,8 +2700,10 @@ gameReturn_t idGameLocal::RunFrame(const usercmd_t* clientCmds) {
 		}
 
 		timer_think.Stop();
+		ret.thinkMsec += sys->GetMillisecondsPrecise() - thinkStartTime;
 		timer_events.Clear();
 		timer_events.Start();
+		double eventStartTime = sys->GetMillisecondsPrecise();
 
 		// service any pending events
 		idEvent::ServiceEvents();
@@ -2648,6 +2716,12 @@ gameReturn_t idGameLocal::RunFrame(const usercmd_t* clientCmds) {
 #endif
 
 		timer_events.Stop();
+		ret.eventMsec += sys->GetMillisecondsPrecise() - eventStartTime;
+
+		// build the animation frames for the renderer on the job threads
+		if ( g_parallelAnimFrames.GetBool() ) {
+			PrepareAnimFrames();
+		}
 
 		// free the player pvs
 		FreePlayerPVS();
@@ -56,6 +56,8 @@ idAASLocal::idAASLocal
 */
 idAASLocal::idAASLocal( void ) {
 	file = NULL;
+	routingTables = NULL;
+	numRoutingTables = 0;
 }
 
 /*
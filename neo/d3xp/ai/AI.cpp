@@ -2380,9 +2380,10 @@ idAI::EntityCanSeePos
 =====================
 */
 bool idAI::EntityCanSeePos( idActor *actor, const idVec3 &actorOrigin, const idVec3 &pos ) {
-	idVec3 eye, point;
-	trace_t results;
+	idVec3 eye, points[2];
+	trace_t results[2];
 	pvsHandle_t handle;
+	int i;
 
 	handle = gameLocal.pvs.SetupCurrentPVS( actor->GetPVSAreas(), actor->GetNumPVSAreas() );
 
@@ -2395,24 +2396,23 @@ bool idAI::EntityCanSeePos( idActor *actor, const idVec3 &actorOrigin, const idV
 
 	eye = actorOrigin + actor->EyeOffset();
 
-	point = pos;
-	point[2] += 1.0f;
-
-	physicsObj.DisableClip();
+	const idBounds &bounds = physicsObj.GetBounds();
 
-	gameLocal.clip.TracePoint( results, eye, point, MASK_SOLID, actor );
-	if ( results.fraction >= 1.0f || ( gameLocal.GetTraceEntity( results ) == this ) ) {
-		physicsObj.EnableClip();
-		return true;
-	}
+	points[0] = pos;
+	points[0][2] += 1.0f;
+	points[1] = points[0];
+	points[1][2] += bounds[1][2] - bounds[0][2];
 
-	const idBounds &bounds = physicsObj.GetBounds();
-	point[2] += bounds[1][2] - bounds[0][2];
+	const idVec3 eyes[2] = { eye, eye };
 
-	gameLocal.clip.TracePoint( results, eye, point, MASK_SOLID, actor );
+	physicsObj.DisableClip();
+	gameLocal.clip.TracePointBatch( results, eyes, points, 2, MASK_SOLID, actor );
 	physicsObj.EnableClip();
-	if ( results.fraction >= 1.0f || ( gameLocal.GetTraceEntity( results ) == this ) ) {
-		return true;
+
+	for ( i = 0; i < 2; i++ ) {
+		if ( results[i].fraction >= 1.0f || ( gameLocal.GetTraceEntity( results[i] ) == this ) ) {
+			return true;
+		}
 	}
 	return false;
 }
@@ -528,6 +528,7 @@ public:
 	void						ForceUpdate( void );
 	void						ClearForceUpdate( void );
 	bool						CreateFrame( int animtime, bool force );
+	bool						PrepareFrame( int animtime, bool force );	// may be called from a job thread
 	bool						FrameHasChanged( int animtime ) const;
 	void						GetDelta( int fromtime, int totime, idVec3 &delta ) const;
 	bool						GetDeltaRotation( int fromtime, int totime, idMat3 &delta ) const;
@@ -587,6 +588,7 @@ private:
 
 	mutable int					lastTransformTime;		// mutable because the value is updated in CreateFrame
 	mutable bool				stoppedAnimatingUpdate;
+	bool						pendingFrameUpdate;		// frame was built ahead of CreateFrame by PrepareFrame
 	bool						removeOriginOffset;
 	bool						forceUpdate;
 
@@ -41,6 +41,7 @@ Event are used for scheduling tasks and for linking script commands.
 */
 
 #define MAX_EVENTSPERFRAME			4096
+#define EVENT_BLOCK_SIZE			1024		// events are allocated in blocks of this size
 //#define CREATE_EVENT_CODE
 
 /***********************************************************************
@@ -210,17 +211,220 @@ const idEventDef *idEventDef::FindEvent( const char *name ) {
 
 ***********************************************************************/
 
+/*
+===============================================================================
+
+	idEventHeap
+
+	Binary heap with the scheduled events ordered on time.  Events with the same
+	time come out in the order they were scheduled in, so events are serviced
+	and saved in the same order as with a sorted list, which keeps savegames
+	and demos deterministic.
+
+===============================================================================
+*/
+
+class idEventHeap {
+public:
+						idEventHeap( void ) { nextSequence = 0; heap.SetGranularity( 1024 ); }
+
+	void				Clear( void );
+	int					Num( void ) const { return heap.Num(); }
+	idEvent *			First( void ) const { return heap.Num() ? heap[ 0 ] : NULL; }
+	void				Add( idEvent *event );
+	void				Remove( idEvent *event );
+	void				GetSortedEvents( idList<idEvent *> &events ) const;
+
+private:
+	idList<idEvent *>	heap;
+	unsigned int		nextSequence;
+
+	static bool			Before( const idEvent *a, const idEvent *b );
+	static int			SortEvents( idEvent * const *a, idEvent * const *b );
+	void				Set( int index, idEvent *event );
+	void				MoveUp( int index );
+	void				MoveDown( int index );
+};
+
+/*
+================
+idEventHeap::Clear
+================
+*/
+void idEventHeap::Clear( void ) {
+	int i;
+
+	for( i = 0; i < heap.Num(); i++ ) {
+		heap[ i ]->queue = NULL;
+		heap[ i ]->queueIndex = -1;
+	}
+	heap.Clear();
+	nextSequence = 0;
+}
+
+/*
+================
+idEventHeap::Before
+================
+*/
+ID_INLINE bool idEventHeap::Before( const idEvent *a, const idEvent *b ) {
+	if ( a->time != b->time ) {
+		return ( a->time < b->time );
+	}
+	return ( a->sequence < b->sequence );
+}
+
+/*
+================
+idEventHeap::SortEvents
+================
+*/
+int idEventHeap::SortEvents( idEvent * const *a, idEvent * const *b ) {
+	if ( Before( *a, *b ) ) {
+		return -1;
+	}
+	if ( Before( *b, *a ) ) {
+		return 1;
+	}
+	return 0;
+}
+
+/*
+================
+idEventHeap::Set
+================
+*/
+ID_INLINE void idEventHeap::Set( int index, idEvent *event ) {
+	heap[ index ] = event;
+	event->queueIndex = index;
+}
+
+/*
+================
+idEventHeap::MoveUp
+================
+*/
+void idEventHeap::MoveUp( int index ) {
+	idEvent *event = heap[ index ];
+
+	while( index > 0 ) {
+		int parent = ( index - 1 ) >> 1;
+		if ( !Before( event, heap[ parent ] ) ) {
+			break;
+		}
+		Set( index, heap[ parent ] );
+		index = parent;
+	}
+	Set( index, event );
+}
+
+/*
+================
+idEventHeap::MoveDown
+================
+*/
+void idEventHeap::MoveDown( int index ) {
+	idEvent *event = heap[ index ];
+	int num = heap.Num();
+
+	while( 1 ) {
+		int child = ( index << 1 ) + 1;
+		if ( child >= num ) {
+			break;
+		}
+		if ( child + 1 < num && Before( heap[ child + 1 ], heap[ child ] ) ) {
+			child++;
+		}
+		if ( !Before( heap[ child ], event ) ) {
+			break;
+		}
+		Set( index, heap[ child ] );
+		index = child;
+	}
+	Set( index, event );
+}
+
+/*
+================
+idEventHeap::Add
+================
+*/
+void idEventHeap::Add( idEvent *event ) {
+	assert( event->queue == NULL );
+
+	event->queue = this;
+	event->sequence = nextSequence++;
+	Set( heap.Append( event ), event );
+	MoveUp( event->queueIndex );
+}
+
+/*
+================
+idEventHeap::Remove
+================
+*/
+void idEventHeap::Remove( idEvent *event ) {
+	int index;
+	idEvent *last;
+
+	assert( event->queue == this && heap[ event->queueIndex ] == event );
+
+	index = event->queueIndex;
+	last = heap[ heap.Num() - 1 ];
+	heap.SetNum( heap.Num() - 1, false );
+
+	event->queue = NULL;
+	event->queueIndex = -1;
+
+	if ( last != event ) {
+		Set( index, last );
+		if ( index > 0 && Before( last, heap[ ( index - 1 ) >> 1 ] ) ) {
+			MoveUp( index );
+		} else {
+			MoveDown( index );
+		}
+	}
+}
+
+/*
+================
+idEventHeap::GetSortedEvents
+================
+*/
+void idEventHeap::GetSortedEvents( idList<idEvent *> &events ) const {
+	events = heap;
+	events.Sort( SortEvents );
+}
+
 static idLinkList<idEvent> FreeEvents;
-static idLinkList<idEvent> EventQueue;
+static idEventHeap EventQueue;
 #ifdef _D3XP
-static idLinkList<idEvent> FastEventQueue;
+static idEventHeap FastEventQueue;
 #endif
-static idEvent EventPool[ MAX_EVENTS ];
+static idList<idEvent *> EventBlocks;
 
 bool idEvent::initialized = false;
 
 idDynamicBlockAlloc<byte, 16 * 1024, 256>	idEvent::eventDataAllocator;
 
+/*
+================
+idEvent::idEvent
+================
+*/
+idEvent::idEvent() {
+	eventdef	= NULL;
+	data		= NULL;
+	time		= 0;
+	object		= NULL;
+	typeinfo	= NULL;
+	queue		= NULL;
+	queueIndex	= -1;
+	sequence	= 0;
+	eventNode.SetOwner( this );
+	objectNode.SetOwner( this );
+}
+
 /*
 ================
 idEvent::~idEvent()
@@ -230,6 +434,42 @@ idEvent::~idEvent() {
 	Free();
 }
 
+/*
+================
+idEvent::AllocEventBlock
+
+Adds a block of events to the free list
+================
+*/
+void idEvent::AllocEventBlock( void ) {
+	idEvent *block;
+	int i;
+
+	block = new idEvent[ EVENT_BLOCK_SIZE ];
+	EventBlocks.Append( block );
+	for( i = 0; i < EVENT_BLOCK_SIZE; i++ ) {
+		block[ i ].Free();
+	}
+}
+
+/*
+================
+idEvent::GetFreeEvent
+================
+*/
+idEvent *idEvent::GetFreeEvent( void ) {
+	idEvent *ev;
+
+	if ( FreeEvents.IsListEmpty() ) {
+		AllocEventBlock();
+	}
+
+	ev = FreeEvents.Next();
+	ev->eventNode.Remove();
+
+	return ev;
+}
+
 /*
 ================
 idEvent::Alloc
@@ -244,13 +484,7 @@ idEvent *idEvent::Alloc( const idEventDef *evdef, int numargs, va_list args ) {
 	int			i;
 	const char	*materialName;
 
-	if ( FreeEvents.IsListEmpty() ) {
-		gameLocal.Error( "idEvent::Alloc : No more free events" );
-	}
-
-	ev = FreeEvents.Next();
-	ev->eventNode.Remove();
-
+	ev = GetFreeEvent();
 	ev->eventdef = evdef;
 
 	if ( numargs != evdef->GetNumArgs() ) {
@@ -365,12 +599,16 @@ void idEvent::Free( void ) {
 		data = NULL;
 	}
 
+	if ( queue ) {
+		queue->Remove( this );
+	}
+	objectNode.Remove();
+
 	eventdef	= NULL;
 	time		= 0;
 	object		= NULL;
 	typeinfo	= NULL;
 
-	eventNode.SetOwner( this );
 	eventNode.AddToEnd( FreeEvents );
 }
 
@@ -380,8 +618,6 @@ idEvent::Schedule
 ================
 */
 void idEvent::Schedule( idClass *obj, const idTypeInfo *type, int time ) {
-	idEvent *event;
-
 	assert( initialized );
 	if ( !initialized ) {
 		return;
@@ -393,37 +629,21 @@ void idEvent::Schedule( idClass *obj, const idTypeInfo *type, int time ) {
 	// wraps after 24 days...like I care. ;)
 	this->time = gameLocal.time + time;
 
-	eventNode.Remove();
+	if ( queue ) {
+		queue->Remove( this );
+	}
+	objectNode.AddToEnd( obj->eventList );
 
 #ifdef _D3XP
 	if ( obj->IsType( idEntity::Type ) && ( ( (idEntity*)(obj) )->timeGroup == TIME_GROUP2 ) ) {
-		event = FastEventQueue.Next();
-		while( ( event != NULL ) && ( this->time >= event->time ) ) {
-			event = event->eventNode.Next();
-		}
-
-		if ( event ) {
-			eventNode.InsertBefore( event->eventNode );
-		} else {
-			eventNode.AddToEnd( FastEventQueue );
-		}
-
+		FastEventQueue.Add( this );
 		return;
 	} else {
 		this->time = gameLocal.slow.time + time;
 	}
 #endif
 
-	event = EventQueue.Next();
-	while( ( event != NULL ) && ( this->time >= event->time ) ) {
-		event = event->eventNode.Next();
-	}
-
-	if ( event ) {
-		eventNode.InsertBefore( event->eventNode );
-	} else {
-		eventNode.AddToEnd( EventQueue );
-	}
+	EventQueue.Add( this );
 }
 
 /*
@@ -439,25 +659,12 @@ void idEvent::CancelEvents( const idClass *obj, const idEventDef *evdef ) {
 		return;
 	}
 
-	for( event = EventQueue.Next(); event != NULL; event = next ) {
-		next = event->eventNode.Next();
-		if ( event->object == obj ) {
-			if ( !evdef || ( evdef == event->eventdef ) ) {
-				event->Free();
-			}
-		}
-	}
-
-#ifdef _D3XP
-	for( event = FastEventQueue.Next(); event != NULL; event = next ) {
-		next = event->eventNode.Next();
-		if ( event->object == obj ) {
-			if ( !evdef || ( evdef == event->eventdef ) ) {
-				event->Free();
-			}
+	for( event = obj->eventList.Next(); event != NULL; event = next ) {
+		next = event->objectNode.Next();
+		if ( !evdef || ( evdef == event->eventdef ) ) {
+			event->Free();
 		}
 	}
-#endif
 }
 
 /*
@@ -473,12 +680,20 @@ void idEvent::ClearEventList( void ) {
 	//
 	FreeEvents.Clear();
 	EventQueue.Clear();
+#ifdef _D3XP
+	FastEventQueue.Clear();
+#endif
 
 	//
 	// add the events to the free list
 	//
-	for( i = 0; i < MAX_EVENTS; i++ ) {
-		EventPool[ i ].Free();
+	if ( !EventBlocks.Num() ) {
+		AllocEventBlock();
+	}
+	for( i = 0; i < EventBlocks.Num(); i++ ) {
+		for( int j = 0; j < EVENT_BLOCK_SIZE; j++ ) {
+			EventBlocks[ i ][ j ].Free();
+		}
 	}
 }
 
@@ -501,10 +716,7 @@ void idEvent::ServiceEvents( void ) {
 	const char  *materialName;
 
 	num = 0;
-	while( !EventQueue.IsListEmpty() ) {
-		event = EventQueue.Next();
-		assert( event );
-
+	while( ( event = EventQueue.First() ) != NULL ) {
 		if ( event->time > gameLocal.time ) {
 			break;
 		}
@@ -555,9 +767,10 @@ void idEvent::ServiceEvents( void ) {
 			}
 		}
 
-		// the event is removed from its list so that if then object
+		// the event is removed from its lists so that if then object
 		// is deleted, the event won't be freed twice
-		event->eventNode.Remove();
+		event->queue->Remove( event );
+		event->objectNode.Remove();
 		assert( event->object );
 		event->object->ProcessEventArgPtr( ev, args );
 
@@ -593,10 +806,7 @@ void idEvent::ServiceFastEvents() {
 	const char  *materialName;
 
 	num = 0;
-	while( !FastEventQueue.IsListEmpty() ) {
-		event = FastEventQueue.Next();
-		assert( event );
-
+	while( ( event = FastEventQueue.First() ) != NULL ) {
 		if ( event->time > gameLocal.fast.time ) {
 			break;
 		}
@@ -647,9 +857,10 @@ void idEvent::ServiceFastEvents() {
 			}
 		}
 
-		// the event is removed from its list so that if then object
+		// the event is removed from its lists so that if then object
 		// is deleted, the event won't be freed twice
-		event->eventNode.Remove();
+		event->queue->Remove( event );
+		event->objectNode.Remove();
 		assert( event->object );
 		event->object->ProcessEventArgPtr( ev, args );
 
@@ -715,6 +926,13 @@ void idEvent::Shutdown( void ) {
 
 	ClearEventList();
 
+	// free the event blocks, the events remove themselves from the free list
+	FreeEvents.Clear();
+	for( int i = 0; i < EventBlocks.Num(); i++ ) {
+		delete[] EventBlocks[ i ];
+	}
+	EventBlocks.Clear();
+
 	eventDataAllocator.Shutdown();
 
 	// say it is now shutdown
@@ -734,11 +952,13 @@ void idEvent::Save( idSaveGame *savefile ) {
 	bool validTrace;
 	const char	*format;
 	idStr s;
+	idList<idEvent *> events;
 
-	savefile->WriteInt( EventQueue.Num() );
+	EventQueue.GetSortedEvents( events );
+	savefile->WriteInt( events.Num() );
 
-	event = EventQueue.Next();
-	while( event != NULL ) {
+	for( int j = 0; j < events.Num(); j++ ) {
+		event = events[ j ];
 		savefile->WriteInt( event->time );
 		savefile->WriteString( event->eventdef->GetName() );
 		savefile->WriteString( event->typeinfo->classname );
@@ -791,23 +1011,21 @@ void idEvent::Save( idSaveGame *savefile ) {
 			}
 		}
 		assert( size == event->eventdef->GetArgSize() );
-		event = event->eventNode.Next();
 	}
 
 #ifdef _D3XP
 	// Save the Fast EventQueue
-	savefile->WriteInt( FastEventQueue.Num() );
+	FastEventQueue.GetSortedEvents( events );
+	savefile->WriteInt( events.Num() );
 
-	event = FastEventQueue.Next();
-	while( event != NULL ) {
+	for( int j = 0; j < events.Num(); j++ ) {
+		event = events[ j ];
 		savefile->WriteInt( event->time );
 		savefile->WriteString( event->eventdef->GetName() );
 		savefile->WriteString( event->typeinfo->classname );
 		savefile->WriteObject( event->object );
 		savefile->WriteInt( event->eventdef->GetArgSize() );
 		savefile->Write( event->data, event->eventdef->GetArgSize() );
-
-		event = event->eventNode.Next();
 	}
 #endif
 }
@@ -829,13 +1047,7 @@ void idEvent::Restore( idRestoreGame *savefile ) {
 	savefile->ReadInt( num );
 
 	for ( i = 0; i < num; i++ ) {
-		if ( FreeEvents.IsListEmpty() ) {
-			gameLocal.Error( "idEvent::Restore : No more free events" );
-		}
-
-		event = FreeEvents.Next();
-		event->eventNode.Remove();
-		event->eventNode.AddToEnd( EventQueue );
+		event = GetFreeEvent();
 
 		savefile->ReadInt( event->time );
 
@@ -854,6 +1066,9 @@ void idEvent::Restore( idRestoreGame *savefile ) {
 		}
 
 		savefile->ReadObject( event->object );
+		if ( !event->object ) {
+			savefile->Error( "idEvent::Restore: no object for event '%s'", event->eventdef->GetName() );
+		}
 
 		// read the args
 		savefile->ReadInt( argsize );
@@ -911,6 +1126,10 @@ void idEvent::Restore( idRestoreGame *savefile ) {
 		} else {
 			event->data = NULL;
 		}
+
+		// events are read back in the order they're serviced in
+		event->objectNode.AddToEnd( event->object->eventList );
+		EventQueue.Add( event );
 	}
 
 #ifdef _D3XP
@@ -918,13 +1137,7 @@ void idEvent::Restore( idRestoreGame *savefile ) {
 	savefile->ReadInt( num );
 
 	for ( i = 0; i < num; i++ ) {
-		if ( FreeEvents.IsListEmpty() ) {
-			gameLocal.Error( "idEvent::Restore : No more free events" );
-		}
-
-		event = FreeEvents.Next();
-		event->eventNode.Remove();
-		event->eventNode.AddToEnd( FastEventQueue );
+		event = GetFreeEvent();
 
 		savefile->ReadInt( event->time );
 
@@ -943,6 +1156,9 @@ void idEvent::Restore( idRestoreGame *savefile ) {
 		}
 
 		savefile->ReadObject( event->object );
+		if ( !event->object ) {
+			savefile->Error( "idEvent::Restore: no object for event '%s'", event->eventdef->GetName() );
+		}
 
 		// read the args
 		savefile->ReadInt( argsize );
@@ -955,6 +1171,9 @@ void idEvent::Restore( idRestoreGame *savefile ) {
 		} else {
 			event->data = NULL;
 		}
+
+		event->objectNode.AddToEnd( event->object->eventList );
+		FastEventQueue.Add( event );
 	}
 #endif
 }
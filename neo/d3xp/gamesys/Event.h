@@ -49,7 +49,7 @@ If you have questions concerning this license or the applicable additional terms
 #define	D_EVENT_ENTITY_NULL			'E'			// event can handle NULL entity pointers
 #define D_EVENT_TRACE				't'
 
-#define MAX_EVENTS					4096
+#define MAX_EVENTS					4096		// max number of event definitions
 
 class idClass;
 class idTypeInfo;
@@ -88,8 +88,11 @@ public:
 
 class idSaveGame;
 class idRestoreGame;
+class idEventHeap;
 
 class idEvent {
+	friend class idEventHeap;
+
 private:
 	const idEventDef			*eventdef;
 	byte						*data;
@@ -97,14 +100,22 @@ private:
 	idClass						*object;
 	const idTypeInfo			*typeinfo;
 
-	idLinkList<idEvent>			eventNode;
+	idEventHeap *				queue;			// queue the event is scheduled in, NULL if not scheduled
+	int							queueIndex;		// index in the queue
+	unsigned int				sequence;		// keeps events with the same time in the order they were scheduled
+
+	idLinkList<idEvent>			eventNode;		// node in the free list
+	idLinkList<idEvent>			objectNode;		// node in the list of events scheduled for the object
 
 	static idDynamicBlockAlloc<byte, 16 * 1024, 256> eventDataAllocator;
 
+	static idEvent *			GetFreeEvent( void );
+	static void					AllocEventBlock( void );
 
 public:
 	static bool					initialized;
 
+								idEvent();
 								~idEvent();
 
 	static idEvent				*Alloc( const idEventDef *evdef, int numargs, va_list args );
@@ -162,6 +162,9 @@ idCVar g_showTriggers(				"g_showTriggers",			"0",			CVAR_GAME | CVAR_BOOL, "dra
 idCVar g_showCollisionWorld(		"g_showCollisionWorld",		"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_showCollisionModels(		"g_showCollisionModels",	"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_showCollisionTraces(		"g_showCollisionTraces",	"0",			CVAR_GAME | CVAR_BOOL, "" );
+idCVar g_parallelAnimFrames(			"g_parallelAnimFrames",		"0",			CVAR_GAME | CVAR_BOOL, "build the animation frames of the active entities in the player pvs on the job threads" );
+idCVar g_clipModelTree(				"g_clipModelTree",			"0",			CVAR_GAME | CVAR_BOOL, "link clip models into a dynamic bounding volume tree instead of the fixed clip sectors" );
+idCVar g_checkTraceBatch(			"g_checkTraceBatch",		"0",			CVAR_GAME | CVAR_BOOL, "repeat every batched trace as a separate trace and warn if any field of the results differs" );
 idCVar g_maxShowDistance(			"g_maxShowDistance",		"128",			CVAR_GAME | CVAR_FLOAT, "" );
 idCVar g_showEntityInfo(			"g_showEntityInfo",			"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_showviewpos(				"g_showviewpos",			"0",			CVAR_GAME | CVAR_BOOL, "" );
@@ -371,6 +374,7 @@ idCVar aas_pullPlayer(				"aas_pullPlayer",			"0",			CVAR_GAME | CVAR_INTEGER, "
 idCVar aas_randomPullPlayer(		"aas_randomPullPlayer",		"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar aas_goalArea(				"aas_goalArea",				"0",			CVAR_GAME | CVAR_INTEGER, "" );
 idCVar aas_showPushIntoArea(		"aas_showPushIntoArea",		"0",			CVAR_GAME | CVAR_BOOL, "" );
+idCVar aas_routingTables(			"aas_routingTables",		"1",			CVAR_GAME | CVAR_BOOL | CVAR_ARCHIVE, "precompute the travel times from all areas to the cluster portals on map load and keep them in .routes files next to the .aas files" );
 
 idCVar g_password(					"g_password",				"",				CVAR_GAME | CVAR_ARCHIVE, "game password" );
 idCVar password(					"password",					"",				CVAR_GAME | CVAR_NOCHEAT, "client password used when connecting" );
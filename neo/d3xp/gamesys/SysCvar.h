@@ -76,6 +76,9 @@ extern idCVar	g_showTriggers;
 extern idCVar	g_showCollisionWorld;
 extern idCVar	g_showCollisionModels;
 extern idCVar	g_showCollisionTraces;
+extern idCVar	g_parallelAnimFrames;
+extern idCVar	g_clipModelTree;
+extern idCVar	g_checkTraceBatch;
 extern idCVar	g_maxShowDistance;
 extern idCVar	g_showEntityInfo;
 extern idCVar	g_showviewpos;
@@ -268,6 +271,7 @@ extern idCVar	aas_pullPlayer;
 extern idCVar	aas_randomPullPlayer;
 extern idCVar	aas_goalArea;
 extern idCVar	aas_showPushIntoArea;
+extern idCVar	aas_routingTables;
 
 extern idCVar	net_clientPredictGUI;
 
@@ -129,10 +129,14 @@ private:
 	int						renderModelHandle;		// render model def handle
 
 	struct clipLink_s *		clipLinks;				// links into sectors
+	class idClipTree *		clipTree;				// tree with a leaf for this clip model
+	int						clipTreeLeaf;			// leaf in the clip tree
+	bool					clipTreeLinked;			// the leaf is kept while unlinked to cheaply link again
 	int						touchCount;
 
 	void					Init( void );			// initialize
 	void					Link_r( struct clipSector_s *node );
+	void					FreeTreeLeaf( void );
 
 	static int				AllocTraceModel( const idTraceModel &trm );
 	static void				FreeTraceModel( int traceModelIndex );
@@ -225,7 +229,7 @@ ID_INLINE bool idClipModel::IsTraceModel( void ) const {
 }
 
 ID_INLINE bool idClipModel::IsLinked( void ) const {
-	return ( clipLinks != NULL );
+	return ( clipLinks != NULL || clipTreeLinked );
 }
 
 ID_INLINE bool idClipModel::IsEnabled( void ) const {
@@ -260,6 +264,10 @@ public:
 	void					Init( void );
 	void					Shutdown( void );
 
+							// link clip models into a dynamic tree instead of the clip sectors, relinks all clip models
+	void					UseClipModelTree( bool useTree );
+	bool					UsesClipModelTree( void ) const;
+
 	// clip versus the rest of the world
 	bool					Translation( trace_t &results, const idVec3 &start, const idVec3 &end,
 								const idClipModel *mdl, const idMat3 &trmAxis, int contentMask, const idEntity *passEntity );
@@ -278,6 +286,13 @@ public:
 	bool					TraceBounds( trace_t &results, const idVec3 &start, const idVec3 &end, const idBounds &bounds,
 								int contentMask, const idEntity *passEntity );
 
+	// translations of numTraces paths with the same clip model versus the rest of the world, these share
+	// the search for clip models and give the same results as separate calls, returns the number of hits
+	int						TranslationBatch( trace_t *results, const idVec3 *start, const idVec3 *end, const int numTraces,
+								const idClipModel *mdl, const idMat3 &trmAxis, int contentMask, const idEntity *passEntity );
+	int						TracePointBatch( trace_t *results, const idVec3 *start, const idVec3 *end, const int numTraces,
+								int contentMask, const idEntity *passEntity );
+
 	// clip versus a specific model
 	void					TranslationModel( trace_t &results, const idVec3 &start, const idVec3 &end,
 								const idClipModel *mdl, const idMat3 &trmAxis, int contentMask,
@@ -308,12 +323,14 @@ public:
 
 							// stats and debug drawing
 	void					PrintStatistics( void );
+	void					Benchmark( int numIterations );
 	void					DrawClipModels( const idVec3 &eye, const float radius, const idEntity *passEntity );
 	bool					DrawModelContactFeature( const contactInfo_t &contact, const idClipModel *clipModel, int lifetime ) const;
 
 private:
 	int						numClipSectors;
 	struct clipSector_s *	clipSectors;
+	class idClipTree *		clipTree;				// used instead of the clip sectors when set
 	idBounds				worldBounds;
 	idClipModel				temporaryClipModel;
 	idClipModel				defaultClipModel;
@@ -329,8 +346,15 @@ private:
 private:
 	struct clipSector_s *	CreateClipSectors_r( const int depth, const idBounds &bounds, idVec3 &maxSector );
 	void					ClipModelsTouchingBounds_r( const struct clipSector_s *node, struct listParms_s &parms ) const;
+	void					ClipModelsInSector( const struct clipSector_s *node, struct listParms_s &parms ) const;
+	void					ClipModelsInTree( struct listParms_s &parms ) const;
+	bool					ListClipModel( idClipModel *check, struct listParms_s &parms ) const;
+	void					GetLinkedClipModels( idList<idClipModel *> &list ) const;
+	void					FreeClipTree( void );
+	void					SectorsTouchingBounds_r( const struct clipSector_s *node, const idBounds &bounds, idVec3 lo, idVec3 hi, idList<struct clipSectorRef_s> &sectors ) const;
 	const idTraceModel *	TraceModelForClipModel( const idClipModel *mdl ) const;
 	int						GetTraceClipModels( const idBounds &bounds, int contentMask, const idEntity *passEntity, idClipModel **clipModelList ) const;
+	void					FilterTraceClipModels( const idEntity *passEntity, idClipModel **clipModelList, int num ) const;
 	void					TraceRenderModel( trace_t &trace, const idVec3 &start, const idVec3 &end, const float radius, const idMat3 &axis, idClipModel *touch ) const;
 };
 
@@ -346,6 +370,14 @@ ID_INLINE bool idClip::TraceBounds( trace_t &results, const idVec3 &start, const
 	return ( results.fraction < 1.0f );
 }
 
+ID_INLINE int idClip::TracePointBatch( trace_t *results, const idVec3 *start, const idVec3 *end, const int numTraces, int contentMask, const idEntity *passEntity ) {
+	return TranslationBatch( results, start, end, numTraces, NULL, mat3_identity, contentMask, passEntity );
+}
+
+ID_INLINE bool idClip::UsesClipModelTree( void ) const {
+	return ( clipTree != NULL );
+}
+
 ID_INLINE const idBounds & idClip::GetWorldBounds( void ) const {
 	return worldBounds;
 }
@@ -0,0 +1,391 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "sys/platform.h"
+
+#include "physics/ClipTree.h"
+
+/*
+================
+ClipTree_Area
+
+  half the surface area of the bounds, used as the cost of a node
+================
+*/
+static ID_INLINE float ClipTree_Area( const idBounds &bounds ) {
+	idVec3 size = bounds[1] - bounds[0];
+	return size[0] * size[1] + size[1] * size[2] + size[2] * size[0];
+}
+
+/*
+================
+idClipTree::idClipTree
+================
+*/
+idClipTree::idClipTree( void ) {
+	nodes.SetGranularity( 256 );
+	root = -1;
+	freeList = -1;
+	numLeafs = 0;
+}
+
+/*
+================
+idClipTree::Clear
+================
+*/
+void idClipTree::Clear( void ) {
+	nodes.Clear();
+	root = -1;
+	freeList = -1;
+	numLeafs = 0;
+}
+
+/*
+================
+idClipTree::AllocNode
+================
+*/
+int idClipTree::AllocNode( void ) {
+	int index;
+
+	if ( freeList != -1 ) {
+		index = freeList;
+		freeList = nodes[index].parent;
+	} else {
+		index = nodes.Num();
+		nodes.Alloc();
+	}
+
+	clipTreeNode_t &node = nodes[index];
+	node.parent = -1;
+	node.children[0] = node.children[1] = -1;
+	node.height = 0;
+	node.clipModel = NULL;
+	return index;
+}
+
+/*
+================
+idClipTree::FreeNode
+================
+*/
+void idClipTree::FreeNode( int index ) {
+	clipTreeNode_t &node = nodes[index];
+	node.parent = freeList;
+	node.height = -1;
+	node.clipModel = NULL;
+	freeList = index;
+}
+
+/*
+================
+idClipTree::Insert
+================
+*/
+int idClipTree::Insert( idClipModel *clipModel, const idBounds &bounds ) {
+	int leaf;
+
+	leaf = AllocNode();
+	nodes[leaf].bounds = bounds.Expand( CLIPTREE_FAT_MARGIN );
+	nodes[leaf].clipModel = clipModel;
+	InsertLeaf( leaf );
+	numLeafs++;
+	return leaf;
+}
+
+/*
+================
+idClipTree::Remove
+================
+*/
+void idClipTree::Remove( int leaf ) {
+	assert( leaf >= 0 && leaf < nodes.Num() && nodes[leaf].height == 0 );
+	RemoveLeaf( leaf );
+	FreeNode( leaf );
+	numLeafs--;
+}
+
+/*
+================
+idClipTree::Move
+================
+*/
+bool idClipTree::Move( int leaf, const idBounds &bounds ) {
+	clipTreeNode_t &node = nodes[leaf];
+
+	assert( node.height == 0 );
+
+	if (	bounds[0][0] >= node.bounds[0][0] && bounds[1][0] <= node.bounds[1][0] &&
+			bounds[0][1] >= node.bounds[0][1] && bounds[1][1] <= node.bounds[1][1] &&
+			bounds[0][2] >= node.bounds[0][2] && bounds[1][2] <= node.bounds[1][2] ) {
+		return false;
+	}
+
+	RemoveLeaf( leaf );
+	nodes[leaf].bounds = bounds.Expand( CLIPTREE_FAT_MARGIN );
+	InsertLeaf( leaf );
+	return true;
+}
+
+/*
+================
+idClipTree::InsertLeaf
+
+  Walks down to the sibling that adds the least surface area to the tree,
+  then refits and balances the nodes on the way back up.
+================
+*/
+void idClipTree::InsertLeaf( int leaf ) {
+	int index, sibling, oldParent, newParent, child0, child1;
+	float area, combinedArea, cost, inheritanceCost, cost0, cost1;
+	idBounds leafBounds;
+
+	if ( root == -1 ) {
+		root = leaf;
+		nodes[root].parent = -1;
+		return;
+	}
+
+	leafBounds = nodes[leaf].bounds;
+
+	index = root;
+	while( nodes[index].height > 0 ) {
+		const clipTreeNode_t &node = nodes[index];
+
+		child0 = node.children[0];
+		child1 = node.children[1];
+
+		area = ClipTree_Area( node.bounds );
+		combinedArea = ClipTree_Area( node.bounds + leafBounds );
+
+		// cost of creating a new parent for this node and the new leaf
+		cost = 2.0f * combinedArea;
+		// minimum cost of pushing the leaf further down the tree
+		inheritanceCost = 2.0f * ( combinedArea - area );
+
+		cost0 = ClipTree_Area( leafBounds + nodes[child0].bounds ) + inheritanceCost;
+		if ( nodes[child0].height > 0 ) {
+			cost0 -= ClipTree_Area( nodes[child0].bounds );
+		}
+		cost1 = ClipTree_Area( leafBounds + nodes[child1].bounds ) + inheritanceCost;
+		if ( nodes[child1].height > 0 ) {
+			cost1 -= ClipTree_Area( nodes[child1].bounds );
+		}
+
+		if ( cost < cost0 && cost < cost1 ) {
+			break;
+		}
+
+		index = ( cost0 < cost1 ) ? child0 : child1;
+	}
+	sibling = index;
+
+	// create a new parent for the sibling and the leaf
+	oldParent = nodes[sibling].parent;
+	newParent = AllocNode();
+	nodes[newParent].parent = oldParent;
+	nodes[newParent].bounds = leafBounds + nodes[sibling].bounds;
+	nodes[newParent].height = nodes[sibling].height + 1;
+	nodes[newParent].children[0] = sibling;
+	nodes[newParent].children[1] = leaf;
+	nodes[sibling].parent = newParent;
+	nodes[leaf].parent = newParent;
+
+	if ( oldParent != -1 ) {
+		if ( nodes[oldParent].children[0] == sibling ) {
+			nodes[oldParent].children[0] = newParent;
+		} else {
+			nodes[oldParent].children[1] = newParent;
+		}
+	} else {
+		root = newParent;
+	}
+
+	// refit the ancestors
+	for ( index = nodes[leaf].parent; index != -1; index = nodes[index].parent ) {
+		index = Balance( index );
+
+		clipTreeNode_t &node = nodes[index];
+		node.height = 1 + Max( nodes[node.children[0]].height, nodes[node.children[1]].height );
+		node.bounds = nodes[node.children[0]].bounds + nodes[node.children[1]].bounds;
+	}
+}
+
+/*
+================
+idClipTree::RemoveLeaf
+================
+*/
+void idClipTree::RemoveLeaf( int leaf ) {
+	int parent, grandParent, sibling, index;
+
+	if ( leaf == root ) {
+		root = -1;
+		return;
+	}
+
+	parent = nodes[leaf].parent;
+	grandParent = nodes[parent].parent;
+	sibling = ( nodes[parent].children[0] == leaf ) ? nodes[parent].children[1] : nodes[parent].children[0];
+
+	if ( grandParent == -1 ) {
+		root = sibling;
+		nodes[sibling].parent = -1;
+		FreeNode( parent );
+		return;
+	}
+
+	// replace the parent with the sibling
+	if ( nodes[grandParent].children[0] == parent ) {
+		nodes[grandParent].children[0] = sibling;
+	} else {
+		nodes[grandParent].children[1] = sibling;
+	}
+	nodes[sibling].parent = grandParent;
+	FreeNode( parent );
+
+	// refit the ancestors
+	for ( index = grandParent; index != -1; index = nodes[index].parent ) {
+		index = Balance( index );
+
+		clipTreeNode_t &node = nodes[index];
+		node.height = 1 + Max( nodes[node.children[0]].height, nodes[node.children[1]].height );
+		node.bounds = nodes[node.children[0]].bounds + nodes[node.children[1]].bounds;
+	}
+}
+
+/*
+================
+idClipTree::Balance
+
+  Rotates the higher child of node A up when the heights of its children
+  differ by more than one, returns the node that took the place of A.
+================
+*/
+int idClipTree::Balance( int iA ) {
+	int iB, iC, iD, iE, iF, iG, balance;
+
+	clipTreeNode_t *A = &nodes[iA];
+	if ( A->height < 2 ) {
+		return iA;
+	}
+
+	iB = A->children[0];
+	iC = A->children[1];
+	clipTreeNode_t *B = &nodes[iB];
+	clipTreeNode_t *C = &nodes[iC];
+
+	balance = C->height - B->height;
+
+	// rotate C up
+	if ( balance > 1 ) {
+		iF = C->children[0];
+		iG = C->children[1];
+		clipTreeNode_t *F = &nodes[iF];
+		clipTreeNode_t *G = &nodes[iG];
+
+		// swap A and C
+		C->children[0] = iA;
+		C->parent = A->parent;
+		A->parent = iC;
+
+		if ( C->parent != -1 ) {
+			if ( nodes[C->parent].children[0] == iA ) {
+				nodes[C->parent].children[0] = iC;
+			} else {
+				nodes[C->parent].children[1] = iC;
+			}
+		} else {
+			root = iC;
+		}
+
+		if ( F->height > G->height ) {
+			C->children[1] = iF;
+			A->children[1] = iG;
+			G->parent = iA;
+			A->bounds = B->bounds + G->bounds;
+			C->bounds = A->bounds + F->bounds;
+			A->height = 1 + Max( B->height, G->height );
+			C->height = 1 + Max( A->height, F->height );
+		} else {
+			C->children[1] = iG;
+			A->children[1] = iF;
+			F->parent = iA;
+			A->bounds = B->bounds + F->bounds;
+			C->bounds = A->bounds + G->bounds;
+			A->height = 1 + Max( B->height, F->height );
+			C->height = 1 + Max( A->height, G->height );
+		}
+		return iC;
+	}
+
+	// rotate B up
+	if ( balance < -1 ) {
+		iD = B->children[0];
+		iE = B->children[1];
+		clipTreeNode_t *D = &nodes[iD];
+		clipTreeNode_t *E = &nodes[iE];
+
+		// swap A and B
+		B->children[0] = iA;
+		B->parent = A->parent;
+		A->parent = iB;
+
+		if ( B->parent != -1 ) {
+			if ( nodes[B->parent].children[0] == iA ) {
+				nodes[B->parent].children[0] = iB;
+			} else {
+				nodes[B->parent].children[1] = iB;
+			}
+		} else {
+			root = iB;
+		}
+
+		if ( D->height > E->height ) {
+			B->children[1] = iD;
+			A->children[0] = iE;
+			E->parent = iA;
+			A->bounds = C->bounds + E->bounds;
+			B->bounds = A->bounds + D->bounds;
+			A->height = 1 + Max( C->height, E->height );
+			B->height = 1 + Max( A->height, D->height );
+		} else {
+			B->children[1] = iE;
+			A->children[0] = iD;
+			D->parent = iA;
+			A->bounds = C->bounds + D->bounds;
+			B->bounds = A->bounds + E->bounds;
+			A->height = 1 + Max( C->height, D->height );
+			B->height = 1 + Max( A->height, E->height );
+		}
+		return iB;
+	}
+
+	return iA;
+}
@@ -447,6 +447,23 @@ typedef struct statement_s {
 	idVarDef		*c;
 } statement_t;
 
+/*
+instruction_t is the decoded form of a statement_t that the interpreter executes.
+The operands are resolved when the program is compiled, so executing a statement
+doesn't have to go through the idVarDefs.  Operands that live on the local stack
+hold their stack offset and have their stack flag set, all others hold the final
+value of the def (a pointer to the variable, a jump offset, an argument size...).
+*/
+typedef struct instruction_s {
+	unsigned short	op;
+	bool			stackA;
+	bool			stackB;
+	bool			stackC;
+	varEval_t		a;
+	varEval_t		b;
+	varEval_t		c;
+} instruction_t;
+
 /***********************************************************************
 
 idProgram
@@ -469,6 +486,7 @@ private:
 	idStaticList<byte,MAX_GLOBALS>				variableDefaults;
 	idStaticList<function_t,MAX_FUNCS>			functions;
 	idStaticList<statement_t,MAX_STATEMENTS>	statements;
+	idStaticList<instruction_t,MAX_STATEMENTS>	instructions;
 	idList<idTypeDef *>							types;
 	idList<idVarDefName *>						varDefNames;
 	idHashIndex									varDefNameHash;
@@ -483,6 +501,7 @@ private:
 	int											top_files;
 
 	void										CompileStats( void );
+	void										DecodeStatements( void );
 	byte										*ReserveMem(int size);
 	idVarDef									*AllocVarDef(idTypeDef *type, const char *name, idVarDef *scope);
 
@@ -538,6 +557,7 @@ public:
 	statement_t									*AllocStatement( void );
 	statement_t									&GetStatement( int index );
 	int											NumStatements( void ) { return statements.Num(); }
+	const instruction_t							&GetInstruction( int index ) const;
 
 	int											GetReturnedInteger( void );
 
@@ -559,6 +579,15 @@ ID_INLINE statement_t &idProgram::GetStatement( int index ) {
 	return statements[ index ];
 }
 
+/*
+================
+idProgram::GetInstruction
+================
+*/
+ID_INLINE const instruction_t &idProgram::GetInstruction( int index ) const {
+	return instructions[ index ];
+}
+
 /*
 ================
 idProgram::GetFunction
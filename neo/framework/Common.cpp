@@ -96,6 +96,7 @@ idCVar com_preciseTic( "com_preciseTic", "1", CVAR_BOOL|CVAR_SYSTEM, "run one ga
 #define ASYNCSOUND_INFO "0: mix sound inline, 1 or 3: async update every 16ms 2: async update about every 100ms (original behavior)"
 idCVar com_asyncSound( "com_asyncSound", "1", CVAR_INTEGER|CVAR_SYSTEM, ASYNCSOUND_INFO, 0, 3 );
 idCVar com_forceGenericSIMD( "com_forceGenericSIMD", "0", CVAR_BOOL | CVAR_SYSTEM | CVAR_NOCHEAT, "force generic platform independent SIMD" );
+idCVar com_numJobThreads( "com_numJobThreads", "-1", CVAR_INTEGER | CVAR_SYSTEM | CVAR_ARCHIVE | CVAR_NOCHEAT, "number of job worker threads, -1 = one per core besides the main thread, 0 = run jobs on the submitting thread", -1, MAX_JOB_THREADS );
 idCVar com_developer( "developer", "0", CVAR_BOOL|CVAR_SYSTEM|CVAR_NOCHEAT, "developer mode" );
 idCVar com_allowConsole( "com_allowConsole", "0", CVAR_BOOL | CVAR_SYSTEM | CVAR_NOCHEAT, "allow toggling console with the tilde key" );
 idCVar com_speeds( "com_speeds", "0", CVAR_BOOL|CVAR_SYSTEM|CVAR_NOCHEAT, "show engine timings" );
@@ -218,6 +219,7 @@ private:
 	void						InitCommands( void );
 	void						InitRenderSystem( void );
 	void						InitSIMD( void );
+	void						InitJobs( void );
 	bool						AddStartupCommands( void );
 	void						ParseCommandLine( int argc, char **argv );
 	void						ClearCommandLine( void );
@@ -1435,6 +1437,83 @@ static void Com_Crash_f( const idCmdArgs &args ) {
 #endif
 }
 
+/*
+=================
+Com_ListJobs_f
+=================
+*/
+static void Com_ListJobs_f( const idCmdArgs &args ) {
+	Sys_PrintJobStats( idStr::Icmp( args.Argv( 1 ), "reset" ) == 0 );
+}
+
+/*
+=================
+Com_CompressorBench_f
+
+compresses and decompresses a file with every compressor and prints ratio and throughput
+=================
+*/
+static void Com_CompressorBench_f( const idCmdArgs &args ) {
+	static const struct {
+		const char *	name;
+		idCompressor *	(*alloc)( void );
+	} compressors[] = {
+		{ "None",		idCompressor::AllocNoCompression },
+		{ "RunLength",	idCompressor::AllocRunLength },
+		{ "Huffman",	idCompressor::AllocHuffman },
+		{ "Arithmetic",	idCompressor::AllocArithmetic },
+		{ "LZSS",		idCompressor::AllocLZSS },
+		{ "LZW",		idCompressor::AllocLZW },
+		{ "LZ4",		idCompressor::AllocLZ4 }
+	};
+	void *buffer;
+	int length;
+
+	if ( args.Argc() != 2 ) {
+		common->Printf( "usage: compressorBench <file>\n" );
+		return;
+	}
+
+	length = fileSystem->ReadFile( args.Argv( 1 ), &buffer );
+	if ( length <= 0 || buffer == NULL ) {
+		common->Printf( "couldn't load %s\n", args.Argv( 1 ) );
+		return;
+	}
+
+	byte *check = (byte *)Mem_Alloc( length );
+
+	common->Printf( "%s: %d bytes\n", args.Argv( 1 ), length );
+	common->Printf( "compressor  ratio  compress  decompress\n" );
+	for ( int i = 0; i < sizeof( compressors ) / sizeof( compressors[0] ); i++ ) {
+		idFile_Memory packed( "compressorBench" );
+		idCompressor *compressor = compressors[i].alloc();
+
+		double startTime = Sys_MillisecondsPrecise();
+		compressor->Init( &packed, true, 8 );
+		compressor->Write( buffer, length );
+		compressor->FinishCompress();
+		double compressTime = Sys_MillisecondsPrecise() - startTime;
+		float ratio = compressor->GetCompressionRatio();
+		delete compressor;
+
+		idFile_Memory unpacked( "compressorBench", packed.GetDataPtr(), packed.Length() );
+		compressor = compressors[i].alloc();
+
+		startTime = Sys_MillisecondsPrecise();
+		compressor->Init( &unpacked, false, 8 );
+		int read = compressor->Read( check, length );
+		double decompressTime = Sys_MillisecondsPrecise() - startTime;
+		delete compressor;
+
+		common->Printf( "%-10s %5.1f%% %6.1f MB/s %6.1f MB/s%s\n", compressors[i].name, ratio,
+						length / ( 1000.0 * Max( compressTime, 0.001 ) ), length / ( 1000.0 * Max( decompressTime, 0.001 ) ),
+						( read == length && memcmp( check, buffer, length ) == 0 ) ? "" : " MISMATCH" );
+	}
+
+	Mem_Free( check );
+	fileSystem->FreeFile( buffer );
+}
+
 /*
 =================
 Com_Quit_f
@@ -2425,6 +2504,8 @@ void idCommonLocal::InitCommands( void ) {
 	cmdSystem->AddCommand( "listDictKeys", idDict::ListKeys_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "lists all keys used by dictionaries" );
 	cmdSystem->AddCommand( "listDictValues", idDict::ListValues_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "lists all values used by dictionaries" );
 	cmdSystem->AddCommand( "testSIMD", idSIMD::Test_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "test SIMD code" );
+	cmdSystem->AddCommand( "listJobs", Com_ListJobs_f, CMD_FL_SYSTEM, "lists job system statistics, 'listJobs reset' also clears them" );
+	cmdSystem->AddCommand( "compressorBench", Com_CompressorBench_f, CMD_FL_SYSTEM, "measures ratio and speed of all compressors on a file", idCmdSystem::ArgCompletion_FileName );
 
 	// localization
 	cmdSystem->AddCommand( "localizeGuis", Com_LocalizeGuis_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "localize guis" );
@@ -2484,6 +2565,17 @@ void idCommonLocal::InitSIMD( void ) {
 	com_forceGenericSIMD.ClearModified();
 }
 
+/*
+=================
+idCommonLocal::InitJobs
+=================
+*/
+void idCommonLocal::InitJobs( void ) {
+	Sys_ShutdownJobs();
+	Sys_InitJobs( com_numJobThreads.GetInteger() );
+	com_numJobThreads.ClearModified();
+}
+
 /*
 =================
 idCommonLocal::Frame
@@ -2507,6 +2599,11 @@ void idCommonLocal::Frame( void ) {
 			InitSIMD();
 		}
 
+		// restart the job workers if required, no jobs are in flight between frames
+		if ( com_numJobThreads.IsModified() ) {
+			InitJobs();
+		}
+
 		if ( com_enableDebuggerServer.IsModified() ) {
 			if ( com_enableDebuggerServer.GetBool() ) {
 				DebuggerServerInit();
@@ -3133,6 +3230,9 @@ void idCommonLocal::Init( int argc, char **argv ) {
 		// initialize processor specific SIMD implementation
 		InitSIMD();
 
+		// start the job worker threads
+		InitJobs();
+
 		// init commands
 		InitCommands();
 
@@ -3235,6 +3335,8 @@ void idCommonLocal::Shutdown( void ) {
 	// shutdown idLib
 	idLib::ShutDown();
 
+	Sys_ShutdownJobs();
+
 	Sys_ShutdownThreads();
 
 	SDL_Quit();
@@ -2487,6 +2487,464 @@ void idCompressor_LZW::DecompressBlock() {
 	blockSize = Min( writeByte, LZW_BLOCK_SIZE );
 }
 
+/*
+=================================================================================
+
+	idCompressor_LZ4
+
+	Byte oriented LZ77 compressor using the LZ4 block format. Unlike the other
+	compressors nothing is done one bit at a time, which makes it an order of
+	magnitude faster at the cost of a somewhat lower compression ratio.
+
+	The stream is cut into independent blocks of up to LZ4_BLOCK_SIZE bytes.
+	Each block starts with the uncompressed size and the packed size written
+	as ints. A packed size of zero means the block is stored uncompressed
+	because it did not compress. An uncompressed size of zero marks the end of
+	the stream.
+
+	A packed block is a list of sequences. Each sequence starts with a token
+	byte, the high nibble is the number of literals and the low nibble is the
+	match length minus LZ4_MIN_MATCH. A nibble of 15 is followed by extra
+	length bytes which are added until a byte other than 255 is found. The
+	literals follow the literal length and the match offset is stored as a
+	little endian 16 bit value after the literals. The last sequence only has
+	literals, the last LZ4_LAST_LITERALS bytes of a block are always literals
+	and no match starts in the last LZ4_MF_LIMIT bytes of a block.
+
+	Matches are found with a hash table of the last position where each
+	four byte sequence was seen. The search skips ahead faster the longer no
+	match has been found so incompressible data passes through quickly.
+
+=================================================================================
+*/
+
+class idCompressor_LZ4 : public idCompressor_None {
+public:
+					idCompressor_LZ4( void );
+
+	void			Init( idFile *f, bool compress, int wordLength );
+	void			FinishCompress( void );
+	float			GetCompressionRatio( void ) const;
+
+	int				Write( const void *inData, int inLength );
+	int				Read( void *outData, int outLength );
+
+protected:
+	void			CompressBlock( void );
+	bool			DecompressBlock( void );
+
+	static int		PackBlock( const byte *src, int srcLength, byte *dst, unsigned short *hashTable );
+	static int		UnpackBlock( const byte *src, int srcLength, byte *dst, int dstLength );
+
+	static const int LZ4_BLOCK_SIZE = 65536;
+	static const int LZ4_PACKED_SIZE = LZ4_BLOCK_SIZE + LZ4_BLOCK_SIZE / 255 + 16;
+	static const int LZ4_HASH_BITS = 14;
+	static const int LZ4_HASH_SIZE = 1 << LZ4_HASH_BITS;
+	static const int LZ4_MIN_MATCH = 4;
+	static const int LZ4_MF_LIMIT = 12;
+	static const int LZ4_LAST_LITERALS = 5;
+	static const int LZ4_SKIP_TRIGGER = 6;
+
+	byte			block[LZ4_BLOCK_SIZE];
+	int				blockSize;
+	int				blockIndex;
+	bool			endOfStream;
+
+	byte			packed[LZ4_PACKED_SIZE];
+	unsigned short	hashTable[LZ4_HASH_SIZE];
+
+	int				compressedSize;
+	int				unCompressedSize;
+};
+
+/*
+================
+LZ4_Read32
+================
+*/
+static ID_INLINE unsigned int LZ4_Read32( const byte *p ) {
+	unsigned int v;
+	memcpy( &v, p, sizeof( v ) );
+	return v;
+}
+
+/*
+================
+LZ4_Hash
+================
+*/
+static ID_INLINE int LZ4_Hash( unsigned int v, int bits ) {
+	return (int)( ( v * 2654435761U ) >> ( 32 - bits ) );
+}
+
+/*
+================
+LZ4_WriteLength
+================
+*/
+static ID_INLINE byte *LZ4_WriteLength( byte *op, int length ) {
+	while ( length >= 255 ) {
+		*op++ = 255;
+		length -= 255;
+	}
+	*op++ = (byte)length;
+	return op;
+}
+
+/*
+================
+idCompressor_LZ4::idCompressor_LZ4
+================
+*/
+idCompressor_LZ4::idCompressor_LZ4( void ) {
+	blockSize = 0;
+	blockIndex = 0;
+	endOfStream = false;
+	compressedSize = 0;
+	unCompressedSize = 0;
+}
+
+/*
+================
+idCompressor_LZ4::Init
+================
+*/
+void idCompressor_LZ4::Init( idFile *f, bool compress, int wordLength ) {
+	idCompressor_None::Init( f, compress, wordLength );
+
+	blockSize = 0;
+	blockIndex = 0;
+	endOfStream = false;
+	compressedSize = 0;
+	unCompressedSize = 0;
+}
+
+/*
+================
+idCompressor_LZ4::PackBlock
+
+Returns the packed size, the output buffer must hold at least LZ4_PACKED_SIZE bytes.
+================
+*/
+int idCompressor_LZ4::PackBlock( const byte *src, int srcLength, byte *dst, unsigned short *hashTable ) {
+	const int matchLimit = srcLength - LZ4_LAST_LITERALS;
+	const int mfLimit = srcLength - LZ4_MF_LIMIT;
+	byte *op = dst;
+	int anchor = 0;
+	int ip = 0;
+
+	assert( srcLength <= LZ4_BLOCK_SIZE );
+
+	memset( hashTable, 0, LZ4_HASH_SIZE * sizeof( hashTable[0] ) );
+
+	if ( srcLength > LZ4_MF_LIMIT ) {
+		ip = 1;
+		while ( ip <= mfLimit ) {
+			int ref, searched = 1 << LZ4_SKIP_TRIGGER;
+
+			// find a four byte match
+			for ( ;; ) {
+				unsigned int seq = LZ4_Read32( src + ip );
+				int h = LZ4_Hash( seq, LZ4_HASH_BITS );
+				ref = hashTable[h];
+				hashTable[h] = (unsigned short)ip;
+				if ( ref < ip && LZ4_Read32( src + ref ) == seq ) {
+					break;
+				}
+				ip += searched++ >> LZ4_SKIP_TRIGGER;
+				if ( ip > mfLimit ) {
+					goto lastLiterals;
+				}
+			}
+
+			// extend the match backwards into the pending literals
+			while ( ip > anchor && ref > 0 && src[ip - 1] == src[ref - 1] ) {
+				ip--;
+				ref--;
+			}
+
+			// extend the match forwards
+			int matchLength = LZ4_MIN_MATCH;
+			while ( ip + matchLength < matchLimit && src[ip + matchLength] == src[ref + matchLength] ) {
+				matchLength++;
+			}
+
+			// emit the sequence
+			int literals = ip - anchor;
+			byte *token = op++;
+			if ( literals >= 15 ) {
+				*token = 15 << 4;
+				op = LZ4_WriteLength( op, literals - 15 );
+			} else {
+				*token = (byte)( literals << 4 );
+			}
+			memcpy( op, src + anchor, literals );
+			op += literals;
+
+			int offset = ip - ref;
+			*op++ = (byte)( offset & 255 );
+			*op++ = (byte)( offset >> 8 );
+
+			int extra = matchLength - LZ4_MIN_MATCH;
+			if ( extra >= 15 ) {
+				*token |= 15;
+				op = LZ4_WriteLength( op, extra - 15 );
+			} else {
+				*token |= (byte)extra;
+			}
+
+			ip += matchLength;
+			anchor = ip;
+
+			// seed the table with a position inside the match
+			if ( ip <= mfLimit ) {
+				hashTable[LZ4_Hash( LZ4_Read32( src + ip - 2 ), LZ4_HASH_BITS )] = (unsigned short)( ip - 2 );
+			}
+		}
+	}
+
+lastLiterals:
+	int literals = srcLength - anchor;
+	if ( literals >= 15 ) {
+		*op++ = 15 << 4;
+		op = LZ4_WriteLength( op, literals - 15 );
+	} else {
+		*op++ = (byte)( literals << 4 );
+	}
+	memcpy( op, src + anchor, literals );
+	op += literals;
+
+	assert( op - dst <= LZ4_PACKED_SIZE );
+
+	return op - dst;
+}
+
+/*
+================
+idCompressor_LZ4::UnpackBlock
+
+Returns the unpacked size or -1 if the packed data is corrupt.
+================
+*/
+int idCompressor_LZ4::UnpackBlock( const byte *src, int srcLength, byte *dst, int dstLength ) {
+	int ip = 0;
+	int op = 0;
+
+	while ( ip < srcLength ) {
+		int token = src[ip++];
+
+		// literals
+		int length = token >> 4;
+		if ( length == 15 ) {
+			int b;
+			do {
+				if ( ip >= srcLength ) {
+					return -1;
+				}
+				b = src[ip++];
+				length += b;
+			} while ( b == 255 );
+		}
+		if ( length > srcLength - ip || length > dstLength - op ) {
+			return -1;
+		}
+		memcpy( dst + op, src + ip, length );
+		ip += length;
+		op += length;
+
+		// the last sequence has no match
+		if ( ip == srcLength ) {
+			break;
+		}
+
+		// match
+		if ( ip + 2 > srcLength ) {
+			return -1;
+		}
+		int offset = src[ip] | ( src[ip + 1] << 8 );
+		ip += 2;
+		if ( offset == 0 || offset > op ) {
+			return -1;
+		}
+		length = token & 15;
+		if ( length == 15 ) {
+			int b;
+			do {
+				if ( ip >= srcLength ) {
+					return -1;
+				}
+				b = src[ip++];
+				length += b;
+			} while ( b == 255 );
+		}
+		length += LZ4_MIN_MATCH;
+		if ( length > dstLength - op ) {
+			return -1;
+		}
+		const byte *ref = dst + op - offset;
+		if ( offset >= length ) {
+			memcpy( dst + op, ref, length );
+			op += length;
+		} else {
+			// overlapping copy repeats the last offset bytes
+			for ( int i = 0; i < length; i++ ) {
+				dst[op++] = ref[i];
+			}
+		}
+	}
+
+	return op;
+}
+
+/*
+================
+idCompressor_LZ4::CompressBlock
+================
+*/
+void idCompressor_LZ4::CompressBlock( void ) {
+	if ( blockSize <= 0 ) {
+		return;
+	}
+
+	int packedSize = PackBlock( block, blockSize, packed, hashTable );
+
+	file->WriteInt( blockSize );
+	if ( packedSize < blockSize ) {
+		file->WriteInt( packedSize );
+		file->Write( packed, packedSize );
+	} else {
+		// store blocks that did not compress
+		packedSize = blockSize;
+		file->WriteInt( 0 );
+		file->Write( block, blockSize );
+	}
+
+	compressedSize += 2 * sizeof( int ) + packedSize;
+	unCompressedSize += blockSize;
+	blockSize = 0;
+}
+
+/*
+================
+idCompressor_LZ4::DecompressBlock
+================
+*/
+bool idCompressor_LZ4::DecompressBlock( void ) {
+	int unpackedSize = 0;
+	int packedSize = 0;
+
+	blockSize = 0;
+	blockIndex = 0;
+
+	if ( endOfStream ) {
+		return false;
+	}
+
+	if ( file->ReadInt( unpackedSize ) != sizeof( int ) || unpackedSize == 0 ) {
+		endOfStream = true;
+		return false;
+	}
+	file->ReadInt( packedSize );
+
+	if ( unpackedSize < 0 || unpackedSize > LZ4_BLOCK_SIZE || packedSize < 0 || packedSize >= unpackedSize ) {
+		common->Error( "idCompressor_LZ4: corrupt block header in '%s'", GetName() );
+	}
+
+	if ( packedSize == 0 ) {
+		if ( file->Read( block, unpackedSize ) != unpackedSize ) {
+			common->Error( "idCompressor_LZ4: unexpected end of file in '%s'", GetName() );
+		}
+		compressedSize += 2 * sizeof( int ) + unpackedSize;
+	} else {
+		if ( file->Read( packed, packedSize ) != packedSize ) {
+			common->Error( "idCompressor_LZ4: unexpected end of file in '%s'", GetName() );
+		}
+		if ( UnpackBlock( packed, packedSize, block, unpackedSize ) != unpackedSize ) {
+			common->Error( "idCompressor_LZ4: corrupt block in '%s'", GetName() );
+		}
+		compressedSize += 2 * sizeof( int ) + packedSize;
+	}
+
+	unCompressedSize += unpackedSize;
+	blockSize = unpackedSize;
+	return true;
+}
+
+/*
+================
+idCompressor_LZ4::FinishCompress
+================
+*/
+void idCompressor_LZ4::FinishCompress( void ) {
+	if ( compress == false ) {
+		return;
+	}
+	CompressBlock();
+	file->WriteInt( 0 );
+	compressedSize += sizeof( int );
+}
+
+/*
+================
+idCompressor_LZ4::GetCompressionRatio
+================
+*/
+float idCompressor_LZ4::GetCompressionRatio( void ) const {
+	if ( unCompressedSize ) {
+		return ( unCompressedSize - compressedSize ) * 100.0f / unCompressedSize;
+	} else {
+		return 0.0f;
+	}
+}
+
+/*
+================
+idCompressor_LZ4::Write
+================
+*/
+int idCompressor_LZ4::Write( const void *inData, int inLength ) {
+	int i, n;
+
+	if ( compress == false || inLength <= 0 ) {
+		return 0;
+	}
+
+	for ( i = 0; i < inLength; i += n ) {
+		n = Min( LZ4_BLOCK_SIZE - blockSize, inLength - i );
+		memcpy( block + blockSize, ((const byte *)inData) + i, n );
+		blockSize += n;
+		if ( blockSize == LZ4_BLOCK_SIZE ) {
+			CompressBlock();
+		}
+	}
+	return inLength;
+}
+
+/*
+================
+idCompressor_LZ4::Read
+================
+*/
+int idCompressor_LZ4::Read( void *outData, int outLength ) {
+	int i, n;
+
+	if ( compress == true || outLength <= 0 ) {
+		return 0;
+	}
+
+	for ( i = 0; i < outLength; i += n ) {
+		if ( blockIndex == blockSize ) {
+			if ( !DecompressBlock() ) {
+				break;
+			}
+		}
+		n = Min( blockSize - blockIndex, outLength - i );
+		memcpy( ((byte *)outData) + i, block + blockIndex, n );
+		blockIndex += n;
+	}
+	return i;
+}
+
 /*
 =================================================================================
 
@@ -2575,3 +3033,12 @@ idCompressor::AllocLZW
 idCompressor * idCompressor::AllocLZW( void ) {
 	return new idCompressor_LZW();
 }
+
+/*
+================
+idCompressor::AllocLZ4
+================
+*/
+idCompressor * idCompressor::AllocLZ4( void ) {
+	return new idCompressor_LZ4();
+}
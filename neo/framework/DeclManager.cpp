@@ -80,6 +80,10 @@ missing reload over a previously explicit definition
 #define USE_COMPRESSED_DECLS
 //#define GET_HUFFMAN_FREQUENCIES
 
+#define DECL_INDEX_FILENAME			"declindex.bin"
+#define DECL_INDEX_FILEID			"DIDX"
+#define DECL_INDEX_VERSION			1
+
 class idDeclType {
 public:
 	idStr						typeName;
@@ -94,6 +98,26 @@ public:
 	declType_t					defaultType;
 };
 
+// the decl index stores where the decls are in a decl file so the file doesn't
+// have to be scanned again as long as its checksum doesn't change
+typedef struct declIndexEntry_s {
+	declType_t					type;
+	idStr						name;
+	int							offset;
+	int							length;
+	int							line;
+} declIndexEntry_t;
+
+class idDeclIndexFile {
+public:
+	idStr						fileName;
+	int							checksum;			// MD5 checksum of the decl file text
+	int							fileSize;
+	int							numLines;
+	int							typesChecksum;		// checksum of the decl types registered when the file was scanned
+	idList<declIndexEntry_t>	decls;
+};
+
 class idDeclFile;
 
 class idDeclLocal : public idDeclBase {
@@ -177,6 +201,9 @@ public:
 	void						Reload( bool force );
 	int							LoadAndParse();
 
+private:
+	void						AddDecl( declType_t type, const char *name, const char *buffer, int offset, int size, int line );
+
 public:
 	idStr						fileName;
 	declType_t					defaultType;
@@ -237,10 +264,24 @@ public:
 	idDeclType *				GetDeclType( int type ) const { return declTypes[type]; }
 	const idDeclFile *			GetImplicitDeclFile( void ) const { return &implicitDecls; }
 
+	idDeclIndexFile *			FindIndexFile( const char *fileName, bool create );
+	int							GetTypesChecksum( void ) const { return typesChecksum; }
+	void						IndexFileChanged( void ) { indexModified = true; }
+	void						IndexFileUsed( void ) { numIndexHits++; }
+
+	static idCVar				decl_useIndex;
+
 private:
 	idList<idDeclType *>		declTypes;
+	idHashIndex					declTypeHash;	// hash of the decl type names
+	int							typesChecksum;	// checksum of the registered decl type names
 	idList<idDeclFolder *>		declFolders;
 
+	idList<idDeclIndexFile *>	indexFiles;
+	idHashIndex					indexFileHash;
+	bool						indexModified;
+	int							numIndexHits;
+
 	idList<idDeclFile *>		loadedFiles;
 	idHashIndex					hashTables[DECL_MAX_TYPES];
 	idList<idDeclLocal *>		linearLists[DECL_MAX_TYPES];
@@ -254,12 +295,17 @@ private:
 	static idCVar				decl_show;
 
 private:
+	void						ReadIndex( void );
+	void						WriteIndex( void );
+	void						FreeIndex( void );
+
 	static void					ListDecls_f( const idCmdArgs &args );
 	static void					ReloadDecls_f( const idCmdArgs &args );
 	static void					TouchDecl_f( const idCmdArgs &args );
 };
 
 idCVar idDeclManagerLocal::decl_show( "decl_show", "0", CVAR_SYSTEM, "set to 1 to print parses, 2 to also print references", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
+idCVar idDeclManagerLocal::decl_useIndex( "decl_useIndex", "1", CVAR_SYSTEM | CVAR_BOOL, "use the decl index to skip scanning decl files that did not change since the last run" );
 
 idDeclManagerLocal	declManagerLocal;
 idDeclManager *		declManager = &declManagerLocal;
@@ -616,7 +662,7 @@ This is used during both the initial load, and any reloads
 int c_savedMemory = 0;
 
 int idDeclFile::LoadAndParse() {
-	int			i, numTypes;
+	int			i;
 	idLexer		src;
 	idToken		token;
 	int			startMarker;
@@ -624,8 +670,7 @@ int idDeclFile::LoadAndParse() {
 	int			length, size;
 	int			sourceLine;
 	idStr		name;
-	idDeclLocal *newDecl;
-	bool		reparse;
+	idDeclIndexFile *index;
 
 	// load the text
 	common->DPrintf( "...loading '%s'\n", fileName.c_str() );
@@ -635,145 +680,131 @@ int idDeclFile::LoadAndParse() {
 		return 0;
 	}
 
-	if ( !src.LoadMemory( buffer, length, fileName ) ) {
-		common->Error( "Couldn't parse %s", fileName.c_str() );
-		Mem_Free( buffer );
-		return 0;
-	}
-
 	// mark all the defs that were from the last reload of this file
 	for ( idDeclLocal *decl = decls; decl; decl = decl->nextInFile ) {
 		decl->redefinedInReload = false;
 	}
 
-	src.SetFlags( DECL_LEXER_FLAGS );
-
 	checksum = MD5_BlockChecksum( buffer, length );
 
 	fileSize = length;
 
-	// scan through, identifying each individual declaration
-	while( 1 ) {
+	// if the file didn't change since it was indexed the decls can be added without scanning the text
+	index = declManagerLocal.FindIndexFile( fileName, false );
+	if ( index != NULL && idDeclManagerLocal::decl_useIndex.GetBool() && index->checksum == checksum && index->fileSize == fileSize &&
+			index->typesChecksum == declManagerLocal.GetTypesChecksum() ) {
 
-		startMarker = src.GetFileOffset();
-		sourceLine = src.GetLineNum();
+		for ( i = 0; i < index->decls.Num(); i++ ) {
+			const declIndexEntry_t &entry = index->decls[i];
+			AddDecl( entry.type, entry.name, buffer, entry.offset, entry.length, entry.line );
+		}
+		numLines = index->numLines;
 
-		// parse the decl type name
-		if ( !src.ReadToken( &token ) ) {
-			break;
+		declManagerLocal.IndexFileUsed();
+
+	} else {
+
+		if ( !src.LoadMemory( buffer, length, fileName ) ) {
+			common->Error( "Couldn't parse %s", fileName.c_str() );
+			Mem_Free( buffer );
+			return 0;
 		}
 
-		declType_t identifiedType = DECL_MAX_TYPES;
+		src.SetFlags( DECL_LEXER_FLAGS );
+
+		index = declManagerLocal.FindIndexFile( fileName, true );
+		index->decls.Clear();
+
+		// scan through, identifying each individual declaration
+		while( 1 ) {
 
-		// get the decl type from the type name
-		numTypes = declManagerLocal.GetNumDeclTypes();
-		for ( i = 0; i < numTypes; i++ ) {
-			idDeclType *typeInfo = declManagerLocal.GetDeclType( i );
-			if ( typeInfo && typeInfo->typeName.Icmp( token ) == 0 ) {
-				identifiedType = (declType_t) typeInfo->type;
+			startMarker = src.GetFileOffset();
+			sourceLine = src.GetLineNum();
+
+			// parse the decl type name
+			if ( !src.ReadToken( &token ) ) {
 				break;
 			}
-		}
 
-		if ( i >= numTypes ) {
+			// get the decl type from the type name
+			declType_t identifiedType = declManagerLocal.GetDeclTypeFromName( token );
 
-			if ( token.Icmp( "{" ) == 0 ) {
+			if ( identifiedType == DECL_MAX_TYPES ) {
 
-				// if we ever see an open brace, we somehow missed the [type] <name> prefix
-				src.Warning( "Missing decl name" );
-				src.SkipBracedSection( false );
-				continue;
-
-			} else {
+				if ( token.Icmp( "{" ) == 0 ) {
 
-				if ( defaultType == DECL_MAX_TYPES ) {
-					src.Warning( "No type" );
+					// if we ever see an open brace, we somehow missed the [type] <name> prefix
+					src.Warning( "Missing decl name" );
+					src.SkipBracedSection( false );
 					continue;
+
+				} else {
+
+					if ( defaultType == DECL_MAX_TYPES ) {
+						src.Warning( "No type" );
+						continue;
+					}
+					src.UnreadToken( &token );
+					// use the default type
+					identifiedType = defaultType;
 				}
-				src.UnreadToken( &token );
-				// use the default type
-				identifiedType = defaultType;
 			}
-		}
 
-		// now parse the name
-		if ( !src.ReadToken( &token ) ) {
-			src.Warning( "Type without definition at end of file" );
-			break;
-		}
+			// now parse the name
+			if ( !src.ReadToken( &token ) ) {
+				src.Warning( "Type without definition at end of file" );
+				break;
+			}
 
-		if ( !token.Icmp( "{" ) ) {
-			// if we ever see an open brace, we somehow missed the [type] <name> prefix
-			src.Warning( "Missing decl name" );
-			src.SkipBracedSection( false );
-			continue;
-		}
+			if ( !token.Icmp( "{" ) ) {
+				// if we ever see an open brace, we somehow missed the [type] <name> prefix
+				src.Warning( "Missing decl name" );
+				src.SkipBracedSection( false );
+				continue;
+			}
 
-		// FIXME: export decls are only used by the model exporter, they are skipped here for now
-		if ( identifiedType == DECL_MODELEXPORT ) {
-			src.SkipBracedSection();
-			continue;
-		}
+			// FIXME: export decls are only used by the model exporter, they are skipped here for now
+			if ( identifiedType == DECL_MODELEXPORT ) {
+				src.SkipBracedSection();
+				continue;
+			}
 
-		name = token;
+			name = token;
 
-		// make sure there's a '{'
-		if ( !src.ReadToken( &token ) ) {
-			src.Warning( "Type without definition at end of file" );
-			break;
-		}
-		if ( token != "{" ) {
-			src.Warning( "Expecting '{' but found '%s'", token.c_str() );
-			continue;
-		}
-		src.UnreadToken( &token );
-
-		// now take everything until a matched closing brace
-		src.SkipBracedSection();
-		size = src.GetFileOffset() - startMarker;
-
-		// look it up, possibly getting a newly created default decl
-		reparse = false;
-		newDecl = declManagerLocal.FindTypeWithoutParsing( identifiedType, name, false );
-		if ( newDecl ) {
-			// update the existing copy
-			if ( newDecl->sourceFile != this || newDecl->redefinedInReload ) {
-				src.Warning( "%s '%s' previously defined at %s:%i", declManagerLocal.GetDeclNameFromType( identifiedType ),
-								name.c_str(), newDecl->sourceFile->fileName.c_str(), newDecl->sourceLine );
-				continue;
+			// make sure there's a '{'
+			if ( !src.ReadToken( &token ) ) {
+				src.Warning( "Type without definition at end of file" );
+				break;
 			}
-			if ( newDecl->declState != DS_UNPARSED ) {
-				reparse = true;
+			if ( token != "{" ) {
+				src.Warning( "Expecting '{' but found '%s'", token.c_str() );
+				continue;
 			}
-		} else {
-			// allow it to be created as a default, then add it to the per-file list
-			newDecl = declManagerLocal.FindTypeWithoutParsing( identifiedType, name, true );
-			newDecl->nextInFile = this->decls;
-			this->decls = newDecl;
-		}
+			src.UnreadToken( &token );
+
+			// now take everything until a matched closing brace
+			src.SkipBracedSection();
+			size = src.GetFileOffset() - startMarker;
 
-		newDecl->redefinedInReload = true;
+			declIndexEntry_t &entry = index->decls.Alloc();
+			entry.type = identifiedType;
+			entry.name = name;
+			entry.offset = startMarker;
+			entry.length = size;
+			entry.line = sourceLine;
 
-		if ( newDecl->textSource ) {
-			Mem_Free( newDecl->textSource );
-			newDecl->textSource = NULL;
+			AddDecl( identifiedType, name, buffer, startMarker, size, sourceLine );
 		}
 
-		newDecl->SetTextLocal( buffer + startMarker, size );
-		newDecl->sourceFile = this;
-		newDecl->sourceTextOffset = startMarker;
-		newDecl->sourceTextLength = size;
-		newDecl->sourceLine = sourceLine;
-		newDecl->declState = DS_UNPARSED;
+		numLines = src.GetLineNum();
 
-		// if it is currently in use, reparse it immedaitely
-		if ( reparse ) {
-			newDecl->ParseLocal();
-		}
+		index->checksum = checksum;
+		index->fileSize = fileSize;
+		index->numLines = numLines;
+		index->typesChecksum = declManagerLocal.GetTypesChecksum();
+		declManagerLocal.IndexFileChanged();
 	}
 
-	numLines = src.GetLineNum();
-
 	Mem_Free( buffer );
 
 	// any defs that weren't redefinedInReload should now be defaulted
@@ -789,6 +820,57 @@ int idDeclFile::LoadAndParse() {
 	return checksum;
 }
 
+/*
+================
+idDeclFile::AddDecl
+
+Adds or updates a decl that was found in the file text
+================
+*/
+void idDeclFile::AddDecl( declType_t type, const char *name, const char *buffer, int offset, int size, int line ) {
+	idDeclLocal *newDecl;
+	bool		reparse;
+
+	// look it up, possibly getting a newly created default decl
+	reparse = false;
+	newDecl = declManagerLocal.FindTypeWithoutParsing( type, name, false );
+	if ( newDecl ) {
+		// update the existing copy
+		if ( newDecl->sourceFile != this || newDecl->redefinedInReload ) {
+			common->Warning( "file %s, line %d: %s '%s' previously defined at %s:%i", fileName.c_str(), line,
+							declManagerLocal.GetDeclNameFromType( type ), name, newDecl->sourceFile->fileName.c_str(), newDecl->sourceLine );
+			return;
+		}
+		if ( newDecl->declState != DS_UNPARSED ) {
+			reparse = true;
+		}
+	} else {
+		// allow it to be created as a default, then add it to the per-file list
+		newDecl = declManagerLocal.FindTypeWithoutParsing( type, name, true );
+		newDecl->nextInFile = this->decls;
+		this->decls = newDecl;
+	}
+
+	newDecl->redefinedInReload = true;
+
+	if ( newDecl->textSource ) {
+		Mem_Free( newDecl->textSource );
+		newDecl->textSource = NULL;
+	}
+
+	newDecl->SetTextLocal( buffer + offset, size );
+	newDecl->sourceFile = this;
+	newDecl->sourceTextOffset = offset;
+	newDecl->sourceTextLength = size;
+	newDecl->sourceLine = line;
+	newDecl->declState = DS_UNPARSED;
+
+	// if it is currently in use, reparse it immedaitely
+	if ( reparse ) {
+		newDecl->ParseLocal();
+	}
+}
+
 /*
 ====================================================================================
 
@@ -809,6 +891,9 @@ void idDeclManagerLocal::Init( void ) {
 	common->Printf( "----- Initializing Decls -----\n" );
 
 	checksum = 0;
+	typesChecksum = 0;
+
+	ReadIndex();
 
 #ifdef USE_COMPRESSED_DECLS
 	SetupHuffman();
@@ -907,8 +992,15 @@ void idDeclManagerLocal::Shutdown( void ) {
 	// free decl files
 	loadedFiles.DeleteContents( true );
 
+	// save the decl index for the next run
+	if ( indexModified ) {
+		WriteIndex();
+	}
+	FreeIndex();
+
 	// free the decl types and folders
 	declTypes.DeleteContents( true );
+	declTypeHash.Free();
 	declFolders.DeleteContents( true );
 
 #ifdef USE_COMPRESSED_DECLS
@@ -933,6 +1025,8 @@ idDeclManagerLocal::BeginLevelLoad
 ===================
 */
 void idDeclManagerLocal::BeginLevelLoad() {
+	int startTime = Sys_Milliseconds();
+
 	insideLevelLoad = true;
 
 	// clear all the referencedThisLevel flags and purge all the data
@@ -944,6 +1038,8 @@ void idDeclManagerLocal::BeginLevelLoad() {
 			decl->Purge();
 		}
 	}
+
+	common->Printf( "%5d msec to purge decls for level load\n", Sys_Milliseconds() - startTime );
 }
 
 /*
@@ -954,6 +1050,11 @@ idDeclManagerLocal::EndLevelLoad
 void idDeclManagerLocal::EndLevelLoad() {
 	insideLevelLoad = false;
 
+	// the game may have registered new decl folders or reloaded decl files
+	if ( indexModified ) {
+		WriteIndex();
+	}
+
 	// we don't need to do anything here, but the image manager, model manager,
 	// and sound sample manager will need to free media that was not referenced
 }
@@ -980,6 +1081,10 @@ void idDeclManagerLocal::RegisterDeclType( const char *typeName, declType_t type
 		declTypes.AssureSize( (int)type + 1, NULL );
 	}
 	declTypes[type] = declType;
+	declTypeHash.Add( declTypeHash.GenerateKey( typeName, false ), type );
+
+	// decl files scanned with a different set of types can have different decl boundaries
+	typesChecksum = typesChecksum * 31 + idStr::IHash( typeName ) + type;
 }
 
 /*
@@ -993,6 +1098,10 @@ void idDeclManagerLocal::RegisterDeclFolder( const char *folder, const char *ext
 	idDeclFolder *declFolder;
 	idFileList *fileList;
 	idDeclFile *df;
+	int startTime, startHits;
+
+	startTime = Sys_Milliseconds();
+	startHits = numIndexHits;
 
 	// check whether this folder / extension combination already exists
 	for ( i = 0; i < declFolders.Num(); i++ ) {
@@ -1032,6 +1141,9 @@ void idDeclManagerLocal::RegisterDeclFolder( const char *folder, const char *ext
 		df->LoadAndParse();
 	}
 
+	common->Printf( "%5d msec to load %d %s/*%s files, %d from the decl index\n", Sys_Milliseconds() - startTime,
+					fileList->GetNumFiles(), declFolder->folder.c_str(), declFolder->extension.c_str(), numIndexHits - startHits );
+
 	fileSystem->FreeFileList( fileList );
 }
 
@@ -1110,7 +1222,7 @@ idDeclManagerLocal::GetDeclTypeFromName
 declType_t idDeclManagerLocal::GetDeclTypeFromName( const char *typeName ) const {
 	int i;
 
-	for ( i = 0; i < declTypes.Num(); i++ ) {
+	for ( i = declTypeHash.First( declTypeHash.GenerateKey( typeName, false ) ); i >= 0; i = declTypeHash.Next( i ) ) {
 		if ( declTypes[i] && declTypes[i]->typeName.Icmp( typeName ) == 0 ) {
 			return (declType_t)declTypes[i]->type;
 		}
@@ -1750,6 +1862,160 @@ idDeclLocal *idDeclManagerLocal::FindTypeWithoutParsing( declType_t type, const
 	return decl;
 }
 
+/*
+===================
+idDeclManagerLocal::FindIndexFile
+===================
+*/
+idDeclIndexFile *idDeclManagerLocal::FindIndexFile( const char *fileName, bool create ) {
+	int i, hash;
+	idDeclIndexFile *indexFile;
+
+	hash = indexFileHash.GenerateKey( fileName, false );
+	for ( i = indexFileHash.First( hash ); i >= 0; i = indexFileHash.Next( i ) ) {
+		if ( indexFiles[i]->fileName.Icmp( fileName ) == 0 ) {
+			return indexFiles[i];
+		}
+	}
+
+	if ( !create ) {
+		return NULL;
+	}
+
+	indexFile = new idDeclIndexFile;
+	indexFile->fileName = fileName;
+	indexFile->checksum = 0;
+	indexFile->fileSize = 0;
+	indexFile->numLines = 0;
+	indexFile->typesChecksum = 0;
+	indexFileHash.Add( hash, indexFiles.Append( indexFile ) );
+
+	return indexFile;
+}
+
+/*
+===================
+idDeclManagerLocal::ReadIndex
+===================
+*/
+void idDeclManagerLocal::ReadIndex( void ) {
+	idFile *file;
+	char fileId[4];
+	int i, j, version, numFiles, numDecls, type;
+	idDeclIndexFile *indexFile;
+
+	FreeIndex();
+
+	file = fileSystem->OpenFileRead( DECL_INDEX_FILENAME );
+	if ( !file ) {
+		return;
+	}
+
+	file->Read( fileId, sizeof( fileId ) );
+	file->ReadInt( version );
+	file->ReadInt( numFiles );
+	if ( memcmp( fileId, DECL_INDEX_FILEID, sizeof( fileId ) ) != 0 || version != DECL_INDEX_VERSION ) {
+		common->Printf( "%s is out of date\n", DECL_INDEX_FILENAME );
+		fileSystem->CloseFile( file );
+		return;
+	}
+
+	for ( i = 0; i < numFiles; i++ ) {
+		idStr fileName;
+
+		file->ReadString( fileName );
+		indexFile = FindIndexFile( fileName, true );
+		file->ReadInt( indexFile->checksum );
+		file->ReadInt( indexFile->fileSize );
+		file->ReadInt( indexFile->numLines );
+		file->ReadInt( indexFile->typesChecksum );
+		file->ReadInt( numDecls );
+
+		// every entry takes at least 20 bytes
+		if ( numDecls < 0 || numDecls > ( file->Length() - file->Tell() ) / 20 ) {
+			break;
+		}
+		indexFile->decls.SetNum( numDecls );
+		for ( j = 0; j < numDecls; j++ ) {
+			declIndexEntry_t &entry = indexFile->decls[j];
+			file->ReadInt( type );
+			file->ReadString( entry.name );
+			file->ReadInt( entry.offset );
+			file->ReadInt( entry.length );
+			file->ReadInt( entry.line );
+			entry.type = (declType_t)type;
+			if ( type < 0 || type >= DECL_MAX_TYPES || entry.offset < 0 || entry.length < 0 || entry.offset + entry.length > indexFile->fileSize ) {
+				break;
+			}
+		}
+		if ( j < numDecls ) {
+			break;
+		}
+	}
+
+	if ( i < numFiles || file->Tell() != file->Length() ) {
+		common->Warning( "%s is damaged", DECL_INDEX_FILENAME );
+		FreeIndex();
+	}
+
+	fileSystem->CloseFile( file );
+}
+
+/*
+===================
+idDeclManagerLocal::WriteIndex
+===================
+*/
+void idDeclManagerLocal::WriteIndex( void ) {
+	idFile *file;
+	int i, j;
+
+	indexModified = false;
+
+	file = fileSystem->OpenFileWrite( DECL_INDEX_FILENAME );
+	if ( !file ) {
+		common->Warning( "couldn't write %s", DECL_INDEX_FILENAME );
+		return;
+	}
+
+	file->Write( DECL_INDEX_FILEID, 4 );
+	file->WriteInt( DECL_INDEX_VERSION );
+	file->WriteInt( indexFiles.Num() );
+
+	for ( i = 0; i < indexFiles.Num(); i++ ) {
+		const idDeclIndexFile *indexFile = indexFiles[i];
+
+		file->WriteString( indexFile->fileName );
+		file->WriteInt( indexFile->checksum );
+		file->WriteInt( indexFile->fileSize );
+		file->WriteInt( indexFile->numLines );
+		file->WriteInt( indexFile->typesChecksum );
+		file->WriteInt( indexFile->decls.Num() );
+		for ( j = 0; j < indexFile->decls.Num(); j++ ) {
+			const declIndexEntry_t &entry = indexFile->decls[j];
+			file->WriteInt( entry.type );
+			file->WriteString( entry.name );
+			file->WriteInt( entry.offset );
+			file->WriteInt( entry.length );
+			file->WriteInt( entry.line );
+		}
+	}
+
+	fileSystem->CloseFile( file );
+}
+
+/*
+===================
+idDeclManagerLocal::FreeIndex
+===================
+*/
+void idDeclManagerLocal::FreeIndex( void ) {
+	indexFiles.DeleteContents( true );
+	indexFileHash.Free();
+	indexModified = false;
+	numIndexHits = 0;
+}
+
 
 /*
 ====================================================================================
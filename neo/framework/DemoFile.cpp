@@ -34,7 +34,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "framework/DemoFile.h"
 
 idCVar idDemoFile::com_logDemos( "com_logDemos", "0", CVAR_SYSTEM | CVAR_BOOL, "Write demo.log with debug information in it" );
-idCVar idDemoFile::com_compressDemos( "com_compressDemos", "1", CVAR_SYSTEM | CVAR_INTEGER | CVAR_ARCHIVE, "Compression scheme for demo files\n0: None    (Fast, large files)\n1: LZW     (Fast to compress, Fast to decompress, medium/small files)\n2: LZSS    (Slow to compress, Fast to decompress, small files)\n3: Huffman (Fast to compress, Slow to decompress, medium files)\nSee also: The 'CompressDemo' command" );
+idCVar idDemoFile::com_compressDemos( "com_compressDemos", "1", CVAR_SYSTEM | CVAR_INTEGER | CVAR_ARCHIVE, "Compression scheme for demo files\n0: None    (Fast, large files)\n1: LZW     (Fast to compress, Fast to decompress, medium/small files)\n2: LZSS    (Slow to compress, Fast to decompress, small files)\n3: Huffman (Fast to compress, Slow to decompress, medium files)\n4: LZ4     (Very fast to compress, Very fast to decompress, medium files)\nSee also: The 'CompressDemo' command" );
 idCVar idDemoFile::com_preloadDemos( "com_preloadDemos", "0", CVAR_SYSTEM | CVAR_BOOL | CVAR_ARCHIVE, "Load the whole demo in to RAM before running it" );
 
 #define DEMO_MAGIC GAME_NAME " RDEMO"
@@ -74,6 +74,7 @@ idCompressor *idDemoFile::AllocCompressor( int type ) {
 	case 1: return idCompressor::AllocLZW();
 	case 2: return idCompressor::AllocLZSS();
 	case 3: return idCompressor::AllocHuffman();
+	case 4: return idCompressor::AllocLZ4();
 	}
 }
 
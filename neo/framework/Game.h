@@ -61,6 +61,8 @@ typedef struct {
 	int			combat;
 	bool		syncNextGameFrame;					// used when cinematics are skipped to prevent session from simulating several game frames to
 													// keep the game time in sync with real time
+	float		thinkMsec;							// time spent in entity think this frame, reported by serverBench
+	float		eventMsec;							// time spent servicing events this frame
 } gameReturn_t;
 
 typedef enum {
@@ -197,6 +199,10 @@ public:
 	virtual bool				DownloadRequest( const char *IP, const char *guid, const char *paks, char urls[ MAX_STRING_CHARS ] ) = 0;
 
 	virtual void				GetMapLoadingGUI( char gui[ MAX_STRING_CHARS ] ) = 0;
+
+	// Called before the snapshots of a server frame are written, the entity states are recorded
+	// once for the snapshots of all clients until the next call.
+	virtual void				ServerBeginSnapshots( void ) = 0;
 };
 
 extern idGame *					game;
@@ -363,7 +369,7 @@ public:
 ===============================================================================
 */
 
-const int GAME_API_VERSION		= 9;
+const int GAME_API_VERSION		= 10;
 
 typedef struct {
 
@@ -94,7 +94,8 @@ If you have questions concerning this license or the applicable additional terms
 // 16: Doom v1.1
 // 17: Doom v1.2 / D3XP. Can still read old v16 with defaults for new data
 // 18: dhewm3 with CstDoom3 anchored window support - can still read v16 and v17, unless gamedata changed
-#define SAVEGAME_VERSION				18
+// 19: dhewm3 with compressed game state - can still read v16 - v18
+#define SAVEGAME_VERSION				19
 
 // <= Doom v1.1: 1. no DS_VERSION token ( default )
 // Doom v1.2: 2
@@ -62,6 +62,14 @@ idCVar	idSessionLocal::com_numQuicksaves( "com_numQuicksaves", "4", CVAR_SYSTEM|
                                            "number of quicksaves to keep before overwriting the oldest", 1, 99 );
 idCVar	idSessionLocal::com_disableAutoSaves( "com_disableAutoSaves", "0", CVAR_SYSTEM|CVAR_ARCHIVE|CVAR_BOOL,
                                               "Don't create Autosaves when entering a new map" );
+idCVar	idSessionLocal::com_compressSaveGames( "com_compressSaveGames", "1", CVAR_SYSTEM|CVAR_ARCHIVE|CVAR_BOOL,
+                                               "LZ4 compress the game state in savegames" );
+
+// compression of the game state following the savegame header, since savegame version 19
+enum {
+	SAVEGAME_COMPRESS_NONE,
+	SAVEGAME_COMPRESS_LZ4
+};
 
 idSessionLocal		sessLocal;
 idSession			*session = &sessLocal;
@@ -329,6 +337,7 @@ void idSessionLocal::Clear() {
 
 	loadingSaveGame = false;
 	savegameFile = NULL;
+	savegameRawFile = NULL;
 	savegameVersion = 0;
 
 	currentMapName.Clear();
@@ -856,6 +865,10 @@ void idSessionLocal::StopRecordingRenderDemo() {
 	writeDemo = NULL;
 }
 
+// implemented in renderer/tr_nullgl.cpp, only print something when r_nullGL is set
+extern void R_ResetNullBackEndStats( void );
+extern void R_PrintNullBackEndStats( void );
+
 /*
 ================
 idSessionLocal::StopPlayingRenderDemo
@@ -890,6 +903,7 @@ void idSessionLocal::StopPlayingRenderDemo() {
 		idStr	message = va( "%i frames rendered in %3.1f seconds = %3.1f fps\n", numDemoFrames, demoSeconds, demoFPS );
 
 		common->Printf( "%s", message.c_str() );
+		R_PrintNullBackEndStats();
 		if ( timeDemo == TD_YES_THEN_QUIT ) {
 			cmdSystem->BufferCommandText( CMD_EXEC_APPEND, "quit\n" );
 		} else {
@@ -922,6 +936,7 @@ void idSessionLocal::DemoShot( const char *demoName ) {
 idSessionLocal::StartPlayingRenderDemo
 ================
 */
+
 void idSessionLocal::StartPlayingRenderDemo( idStr demoName ) {
 	if ( !demoName[0] ) {
 		common->Printf( "idSessionLocal::StartPlayingRenderDemo: no name specified\n" );
@@ -971,6 +986,7 @@ void idSessionLocal::StartPlayingRenderDemo( idStr demoName ) {
 	numDemoFrames = 1;
 
 	lastDemoTic = -1;
+	R_ResetNullBackEndStats();
 	timeDemoStartTime = Sys_Milliseconds();
 }
 
@@ -1649,6 +1665,8 @@ void idSessionLocal::ExecuteMapChange( bool noFadeWipe ) {
 		common->Error( "couldn't load %s", fullMapName.c_str() );
 	}
 
+	int geometryLoaded = Sys_Milliseconds();
+
 	// for the synchronous networking we needed to roll the angles over from
 	// level to level, but now we can just clear everything
 	usercmdGen->InitForNewMap();
@@ -1665,8 +1683,7 @@ void idSessionLocal::ExecuteMapChange( bool noFadeWipe ) {
 		if ( game->InitFromSaveGame( fullMapName + ".map", rw, sw, savegameFile ) == false ) {
 			// If the loadgame failed, restart the map with the player persistent data
 			loadingSaveGame = false;
-			fileSystem->CloseFile( savegameFile );
-			savegameFile = NULL;
+			CloseSaveGameFile();
 
 			common->Warning( "WARNING: Loading savegame failed, will restart the map with the player persistent data!" );
 
@@ -1685,15 +1702,23 @@ void idSessionLocal::ExecuteMapChange( bool noFadeWipe ) {
 		}
 	}
 
+	int gameLoaded = Sys_Milliseconds();
+	int renderLoaded = gameLoaded;
+	int soundLoaded = gameLoaded;
+
 	// actually purge/load the media
 	if ( !reloadingSameMap ) {
 		renderSystem->EndLevelLoad();
+		renderLoaded = Sys_Milliseconds();
 		soundSystem->EndLevelLoad( mapString.c_str() );
+		soundLoaded = Sys_Milliseconds();
 		declManager->EndLevelLoad();
 		SetBytesNeededForMapLoad( mapString.c_str(), fileSystem->GetReadCount() );
 	}
 	uiManager->EndLevelLoad();
 
+	int mediaLoaded = Sys_Milliseconds();
+
 	if ( !idAsyncNetwork::IsActive() && !loadingSaveGame ) {
 		// run a few frames to allow everything to settle
 		for ( i = 0; i < 10; i++ ) {
@@ -1703,6 +1728,9 @@ void idSessionLocal::ExecuteMapChange( bool noFadeWipe ) {
 
 	int	msec = Sys_Milliseconds() - start;
 	common->Printf( "%6d msec to load %s\n", msec, mapString.c_str() );
+	common->Printf( "%6d msec map geometry, %d msec game, %d msec models and images, %d msec sounds, %d msec decls and guis, %d msec settling\n",
+		geometryLoaded - start, gameLoaded - geometryLoaded, renderLoaded - gameLoaded, soundLoaded - renderLoaded,
+		mediaLoaded - soundLoaded, start + msec - mediaLoaded );
 
 	// let the renderSystem generate interactions now that everything is spawned
 	rw->GenerateAllInteractions();
@@ -2000,8 +2028,24 @@ bool idSessionLocal::SaveGame( const char *saveName, bool autosave, const char*
 		mapSpawnData.persistentPlayerInfo[i].WriteToFileHandle( fileOut );
 	}
 
-	// let the game save its state
-	game->SaveGame( fileOut );
+	// the game state is compressed, it makes up almost all of the file
+	if ( com_compressSaveGames.GetBool() ) {
+		fileOut->WriteInt( SAVEGAME_COMPRESS_LZ4 );
+
+		idCompressor *compressor = idCompressor::AllocLZ4();
+		compressor->Init( fileOut, true, 8 );
+
+		// let the game save its state
+		game->SaveGame( compressor );
+
+		compressor->FinishCompress();
+		delete compressor;
+	} else {
+		fileOut->WriteInt( SAVEGAME_COMPRESS_NONE );
+
+		// let the game save its state
+		game->SaveGame( fileOut );
+	}
 
 	// close the sava game file
 	fileSystem->CloseFile( fileOut );
@@ -2112,8 +2156,7 @@ bool idSessionLocal::LoadGame( const char *saveName ) {
 		common->Warning( "Attempted to load an invalid savegame: %s", in.c_str() );
 
 		loadingSaveGame = false;
-		fileSystem->CloseFile( savegameFile );
-		savegameFile = NULL;
+		CloseSaveGameFile();
 		return false;
 	}
 
@@ -2131,11 +2174,27 @@ bool idSessionLocal::LoadGame( const char *saveName ) {
 	// check the version, if it doesn't match, cancel the loadgame,
 	// but still load the map with the persistant playerInfo from the header
 	// so that the player doesn't lose too much progress.
-	if ( savegameVersion < 16 || savegameVersion > SAVEGAME_VERSION ) { // dhewm3 supports savegames with v16 - v18
+	if ( savegameVersion < 16 || savegameVersion > SAVEGAME_VERSION ) { // dhewm3 supports savegames with v16 - v19
 		common->Warning( "Savegame Version mismatch: aborting loadgame and starting level with persistent data" );
 		loadingSaveGame = false;
-		fileSystem->CloseFile( savegameFile );
-		savegameFile = NULL;
+		CloseSaveGameFile();
+	}
+
+	// since v19 the game state may be compressed
+	if ( loadingSaveGame && savegameVersion >= 19 ) {
+		int compression = -1;
+		savegameFile->ReadInt( compression );
+
+		if ( compression == SAVEGAME_COMPRESS_LZ4 ) {
+			idCompressor *compressor = idCompressor::AllocLZ4();
+			compressor->Init( savegameFile, false, 8 );
+			savegameRawFile = savegameFile;
+			savegameFile = compressor;
+		} else if ( compression != SAVEGAME_COMPRESS_NONE ) {
+			common->Warning( "Unknown savegame compression %d: aborting loadgame and starting level with persistent data", compression );
+			loadingSaveGame = false;
+			CloseSaveGameFile();
+		}
 	}
 
 	common->DPrintf( "loading a v%d savegame\n", savegameVersion );
@@ -2163,15 +2222,31 @@ bool idSessionLocal::LoadGame( const char *saveName ) {
 	}
 
 	if ( loadingSaveGame ) {
-		fileSystem->CloseFile( savegameFile );
+		CloseSaveGameFile();
 		loadingSaveGame = false;
-		savegameFile = NULL;
 	}
 
 	return true;
 #endif
 }
 
+/*
+===============
+idSessionLocal::CloseSaveGameFile
+===============
+*/
+void idSessionLocal::CloseSaveGameFile( void ) {
+	if ( savegameRawFile ) {
+		// savegameFile is the decompressor reading from savegameRawFile
+		delete savegameFile;
+		fileSystem->CloseFile( savegameRawFile );
+	} else if ( savegameFile ) {
+		fileSystem->CloseFile( savegameFile );
+	}
+	savegameFile = NULL;
+	savegameRawFile = NULL;
+}
+
 bool idSessionLocal::QuickSave()
 {
 	idStr saveName = common->GetLanguageDict()->GetString( "#str_07178" );
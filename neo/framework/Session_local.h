@@ -174,6 +174,8 @@ public:
 	bool				QuickSave();
 	bool				QuickLoad();
 
+	void				CloseSaveGameFile( void );
+
 	const char			*GetAuthMsg( void );
 
 	//=====================================
@@ -192,6 +194,7 @@ public:
 	static idCVar		com_guid;
 	static idCVar		com_numQuicksaves;
 	static idCVar		com_disableAutoSaves;
+	static idCVar		com_compressSaveGames;
 
 	static idCVar		gui_configServerRate;
 
@@ -227,6 +230,7 @@ public:
 
 	bool				loadingSaveGame;	// currently loading map from a SaveGame
 	idFile *			savegameFile;		// this is the savegame file to load from
+	idFile *			savegameRawFile;	// file on disk when savegameFile is a decompressor
 	int					savegameVersion;
 
 	idFile *			cmdDemoFile;		// if non-zero, we are reading commands from a file
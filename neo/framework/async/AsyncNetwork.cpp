@@ -48,6 +48,7 @@ idCVar				idAsyncNetwork::serverDedicated( "net_serverDedicated", "0", CVAR_SERV
 #endif
 idCVar				idAsyncNetwork::serverSnapshotDelay( "net_serverSnapshotDelay", "50", CVAR_SYSTEM | CVAR_INTEGER | CVAR_NOCHEAT, "delay between snapshots in milliseconds" );
 idCVar				idAsyncNetwork::serverMaxClientRate( "net_serverMaxClientRate", "16000", CVAR_SYSTEM | CVAR_INTEGER | CVAR_ARCHIVE | CVAR_NOCHEAT, "maximum rate to a client in bytes/sec" );
+idCVar				idAsyncNetwork::serverBatchPackets( "net_serverBatchPackets", "1", CVAR_SYSTEM | CVAR_BOOL | CVAR_NOCHEAT, "queue the server packets of a frame and send them with one system call, also read incoming packets in batches (Linux only)" );
 idCVar				idAsyncNetwork::clientMaxRate( "net_clientMaxRate", "16000", CVAR_SYSTEM | CVAR_INTEGER | CVAR_ARCHIVE | CVAR_NOCHEAT, "maximum rate requested by client from server in bytes/sec" );
 idCVar				idAsyncNetwork::serverMaxUsercmdRelay( "net_serverMaxUsercmdRelay", "5", CVAR_SYSTEM | CVAR_INTEGER | CVAR_NOCHEAT, "maximum number of usercmds from other clients the server relays to a client", 1, MAX_USERCMD_RELAY, idCmdSystem::ArgCompletion_Integer<1,MAX_USERCMD_RELAY> );
 idCVar				idAsyncNetwork::serverZombieTimeout( "net_serverZombieTimeout", "5", CVAR_SYSTEM | CVAR_INTEGER | CVAR_NOCHEAT, "disconnected client timeout in seconds" );
@@ -109,6 +110,7 @@ void idAsyncNetwork::Init( void ) {
 	cmdSystem->AddCommand( "kick", Kick_f, CMD_FL_SYSTEM, "kick a client by connection number" );
 	cmdSystem->AddCommand( "checkNewVersion", CheckNewVersion_f, CMD_FL_SYSTEM, "check if a new version of the game is available" );
 	cmdSystem->AddCommand( "updateUI", UpdateUI_f, CMD_FL_SYSTEM, "internal - cause a sync down of game-modified userinfo" );
+	cmdSystem->AddCommand( "serverBench", ServerBench_f, CMD_FL_SYSTEM, "runs a map with synthetic clients and prints the server frame times", idCmdSystem::ArgCompletion_MapName );
 }
 
 /*
@@ -327,6 +329,25 @@ void idAsyncNetwork::SpawnServer_f( const idCmdArgs &args ) {
 	}
 }
 
+/*
+==================
+idAsyncNetwork::ServerBench_f
+==================
+*/
+void idAsyncNetwork::ServerBench_f( const idCmdArgs &args ) {
+	if ( args.Argc() != 4 ) {
+		common->Printf( "usage: serverBench <map> <numClients> <seconds>\n" );
+		return;
+	}
+
+	// don't let a server spawn with singleplayer game type - it will crash
+	if ( idStr::Icmp( cvarSystem->GetCVarString( "si_gameType" ), "singleplayer" ) == 0 ) {
+		cvarSystem->SetCVarString( "si_gameType", "deathmatch" );
+	}
+
+	server.RunBenchmark( args.Argv( 1 ), atoi( args.Argv( 2 ) ), atoi( args.Argv( 3 ) ) );
+}
+
 /*
 ==================
 idAsyncNetwork::NextMap_f
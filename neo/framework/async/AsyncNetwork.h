@@ -144,6 +144,7 @@ public:
 	static idCVar			serverDedicated;				// if set run a dedicated server
 	static idCVar			serverSnapshotDelay;			// number of milliseconds between snapshots
 	static idCVar			serverMaxClientRate;			// maximum outgoing rate to clients
+	static idCVar			serverBatchPackets;				// send and read server packets in batches
 	static idCVar			clientMaxRate;					// maximum rate from server requested by client
 	static idCVar			serverMaxUsercmdRelay;			// maximum number of usercmds relayed to other clients
 	static idCVar			serverZombieTimeout;			// time out in seconds for zombie clients
@@ -186,6 +187,7 @@ private:
 	static void				Kick_f( const idCmdArgs &args );
 	static void				CheckNewVersion_f( const idCmdArgs &args );
 	static void				UpdateUI_f( const idCmdArgs &args );
+	static void				ServerBench_f( const idCmdArgs &args );
 };
 
 #endif /* !__ASYNCNETWORK_H__ */
@@ -87,8 +87,13 @@ idAsyncServer::idAsyncServer( void ) {
 	serverReloadingEngine = false;
 	nextHeartbeatTime = 0;
 	nextAsyncStatsTime = 0;
+	statsNetworkMsec = 0.0;
+	statsNetworkFrames = 0;
+	statsRecvCalls = statsSendCalls = 0;
+	statsPacketsRead = statsPacketsWritten = 0;
 	noRconOutput = true;
 	lastAuthTime = 0;
+	benchmarking = false;
 
 	memset( stats_outrate, 0, sizeof( stats_outrate ) );
 	stats_current = 0;
@@ -124,6 +129,8 @@ bool idAsyncServer::InitPort( void ) {
 				return false;
 			}
 		}
+		serverPort.SetBatching( idAsyncNetwork::serverBatchPackets.GetBool() );
+		idAsyncNetwork::serverBatchPackets.ClearModified();
 	}
 
 	return true;
@@ -223,6 +230,7 @@ void idAsyncServer::Kill( void ) {
 				}
 			}
 		}
+		serverPort.FlushPackets();
 		Sys_Sleep( 10 );
 	}
 
@@ -317,7 +325,7 @@ void idAsyncServer::ExecuteMapChange( void ) {
 	gameTimeResidual = 0;
 	memset( userCmds, 0, sizeof( userCmds ) );
 
-	if ( idAsyncNetwork::serverDedicated.GetInteger() == 0 ) {
+	if ( idAsyncNetwork::serverDedicated.GetInteger() == 0 && !benchmarking ) {
 		InitLocalClient( 0 );
 	} else {
 		localClientNum = -1;
@@ -2357,6 +2365,7 @@ void idAsyncServer::RunFrame( void ) {
 	netadr_t	from;
 	int			outgoingRate, incomingRate;
 	float		outgoingCompression, incomingCompression;
+	double		networkStart;
 
 	msec = UpdateTime( 100 );
 
@@ -2364,8 +2373,15 @@ void idAsyncServer::RunFrame( void ) {
 		return;
 	}
 
+	if ( idAsyncNetwork::serverBatchPackets.IsModified() ) {
+		serverPort.FlushPackets();
+		serverPort.SetBatching( idAsyncNetwork::serverBatchPackets.GetBool() );
+		idAsyncNetwork::serverBatchPackets.ClearModified();
+	}
+
 	if ( !active ) {
 		ProcessConnectionLessMessages();
+		serverPort.FlushPackets();
 		return;
 	}
 
@@ -2379,12 +2395,15 @@ void idAsyncServer::RunFrame( void ) {
 			// blocking read with game time residual timeout
 			newPacket = serverPort.GetPacketBlocking( from, msgBuf, size, sizeof( msgBuf ), USERCMD_MSEC - gameTimeResidual - 1 );
 			if ( newPacket ) {
+				networkStart = Sys_MillisecondsPrecise();
 				msg.Init( msgBuf, sizeof( msgBuf ) );
 				msg.SetSize( size );
 				msg.BeginReading();
 				if ( ProcessMessage( from, msg ) ) {
+					serverPort.FlushPackets();
 					return;	// return because rcon was used
 				}
+				statsNetworkMsec += Sys_MillisecondsPrecise() - networkStart;
 			}
 
 			msec = UpdateTime( 100 );
@@ -2410,6 +2429,7 @@ void idAsyncServer::RunFrame( void ) {
 	// make sure the time doesn't wrap
 	if ( serverTime > 0x70000000 ) {
 		ExecuteMapChange();
+		serverPort.FlushPackets();
 		return;
 	}
 
@@ -2456,37 +2476,11 @@ void idAsyncServer::RunFrame( void ) {
 	DuplicateUsercmds( gameFrame, gameTime );
 
 	// send snapshots to connected clients
-	for ( i = 0; i < MAX_ASYNC_CLIENTS; i++ ) {
-		serverClient_t &client = clients[i];
-
-		if ( client.clientState == SCS_FREE || i == localClientNum ) {
-			continue;
-		}
-
-		// modify maximum rate if necesary
-		if ( idAsyncNetwork::serverMaxClientRate.IsModified() ) {
-			client.channel.SetMaxOutgoingRate( Min( client.clientRate, idAsyncNetwork::serverMaxClientRate.GetInteger() ) );
-		}
-
-		// if the channel is not yet ready to send new data
-		if ( !client.channel.ReadyToSend( serverTime ) ) {
-			continue;
-		}
-
-		// send additional message fragments if the last message was too large to send at once
-		if ( client.channel.UnsentFragmentsLeft() ) {
-			client.channel.SendNextFragment( serverPort, serverTime );
-			continue;
-		}
-
-		if ( client.clientState == SCS_INGAME ) {
-			if ( !SendSnapshotToClient( i ) ) {
-				SendPingToClient( i );
-			}
-		} else {
-			SendEmptyToClient( i );
-		}
-	}
+	networkStart = Sys_MillisecondsPrecise();
+	SendSnapshots();
+	serverPort.FlushPackets();
+	statsNetworkMsec += Sys_MillisecondsPrecise() - networkStart;
+	statsNetworkFrames++;
 
 	if ( com_showAsyncStats.GetBool() ) {
 
@@ -2514,6 +2508,12 @@ void idAsyncServer::RunFrame( void ) {
 			GetAsyncStatsAvgMsg( msg );
 			common->Printf( "%s\n", msg.c_str() );
 
+			common->Printf( "network = %.3f msec/frame, %d packets in %d recv calls, %d packets in %d send calls\n",
+							statsNetworkFrames ? statsNetworkMsec / statsNetworkFrames : 0.0,
+							serverPort.packetsRead - statsPacketsRead, serverPort.recvCalls - statsRecvCalls,
+							serverPort.packetsWritten - statsPacketsWritten, serverPort.sendCalls - statsSendCalls );
+			ResetNetworkStats();
+
 			nextAsyncStatsTime = serverTime + 1000;
 		}
 	}
@@ -2521,6 +2521,62 @@ void idAsyncServer::RunFrame( void ) {
 	idAsyncNetwork::serverMaxClientRate.ClearModified();
 }
 
+/*
+==================
+idAsyncServer::SendSnapshots
+==================
+*/
+void idAsyncServer::SendSnapshots( void ) {
+	int i;
+
+	game->ServerBeginSnapshots();
+	for ( i = 0; i < MAX_ASYNC_CLIENTS; i++ ) {
+		serverClient_t &client = clients[i];
+
+		if ( client.clientState == SCS_FREE || i == localClientNum ) {
+			continue;
+		}
+
+		// modify maximum rate if necesary
+		if ( idAsyncNetwork::serverMaxClientRate.IsModified() ) {
+			client.channel.SetMaxOutgoingRate( Min( client.clientRate, idAsyncNetwork::serverMaxClientRate.GetInteger() ) );
+		}
+
+		// if the channel is not yet ready to send new data
+		if ( !client.channel.ReadyToSend( serverTime ) ) {
+			continue;
+		}
+
+		// send additional message fragments if the last message was too large to send at once
+		if ( client.channel.UnsentFragmentsLeft() ) {
+			client.channel.SendNextFragment( serverPort, serverTime );
+			continue;
+		}
+
+		if ( client.clientState == SCS_INGAME ) {
+			if ( !SendSnapshotToClient( i ) ) {
+				SendPingToClient( i );
+			}
+		} else {
+			SendEmptyToClient( i );
+		}
+	}
+}
+
+/*
+==================
+idAsyncServer::ResetNetworkStats
+==================
+*/
+void idAsyncServer::ResetNetworkStats( void ) {
+	statsNetworkMsec = 0.0;
+	statsNetworkFrames = 0;
+	statsRecvCalls = serverPort.recvCalls;
+	statsSendCalls = serverPort.sendCalls;
+	statsPacketsRead = serverPort.packetsRead;
+	statsPacketsWritten = serverPort.packetsWritten;
+}
+
 /*
 ==================
 idAsyncServer::PacifierUpdate
@@ -2543,6 +2599,7 @@ void idAsyncServer::PacifierUpdate( void ) {
 			}
 		}
 	}
+	serverPort.FlushPackets();
 }
 
 /*
@@ -2568,6 +2625,10 @@ idAsyncServer::MasterHeartbeat
 ==================
 */
 void idAsyncServer::MasterHeartbeat( bool force ) {
+	// the benchmark runs without any network
+	if ( benchmarking ) {
+		return;
+	}
 	if ( idAsyncNetwork::LANServer.GetBool() ) {
 		if ( force ) {
 			common->Printf( "net_LANServer is enabled. Not sending heartbeats\n" );
@@ -2789,3 +2850,310 @@ void idAsyncServer::ProcessDownloadRequestMessage( const netadr_t from, const id
 		serverPort.SendPacket( from, outMsg.GetData(), outMsg.GetSize() );
 	}
 }
+
+/*
+==================
+idAsyncServer::BenchClientConnect
+
+does what ProcessConnectMessage does for a client that passed the challenge
+==================
+*/
+void idAsyncServer::BenchClientConnect( int clientNum, benchClient_t &bench ) {
+	idBitMsg	msg;
+	byte		msgBuf[MAX_MESSAGE_SIZE];
+
+	bench.clientId = clientNum + 1;
+	bench.serverMessageSequence = 0;
+	bench.snapshotSequence = 0;
+	bench.bytesReceived = 0;
+	memset( &bench.cmd, 0, sizeof( bench.cmd ) );
+	bench.channel.Init( serverPort.GetAdr(), bench.clientId );
+
+	serverClient_t &client = clients[clientNum];
+	client.channel.Init( bench.port.GetAdr(), serverId );
+	client.guid[0] = '\0';
+	InitClient( clientNum, bench.clientId, 0 );
+	client.gameInitSequence = 1;
+	client.snapshotSequence = 1;
+
+	// send the user info like a connecting client
+	idDict info = *cvarSystem->MoveCVarsToDict( CVAR_USERINFO );
+	info.Set( "ui_name", va( "bench%d", clientNum ) );
+	msg.Init( msgBuf, sizeof( msgBuf ) );
+	msg.WriteByte( CLIENT_RELIABLE_MESSAGE_CLIENTINFO );
+	msg.WriteDeltaDict( info, NULL );
+	bench.channel.SendReliableMessage( msg );
+}
+
+/*
+==================
+idAsyncServer::BenchClientReceive
+
+reads the packets the server sent to a benchmark client, only the snapshot sequence is needed for the acknowledge
+==================
+*/
+void idAsyncServer::BenchClientReceive( benchClient_t &bench ) {
+	idBitMsg	msg, reliableMsg;
+	byte		msgBuf[MAX_MESSAGE_SIZE], reliableBuf[MAX_MESSAGE_SIZE];
+	netadr_t	from;
+	int			size;
+
+	while ( bench.port.GetPacket( from, msgBuf, size, sizeof( msgBuf ) ) ) {
+		bench.bytesReceived += size;
+
+		msg.Init( msgBuf, sizeof( msgBuf ) );
+		msg.SetSize( size );
+		msg.BeginReading();
+		if ( msg.ReadShort() != serverId ) {
+			continue;
+		}
+		if ( !bench.channel.Process( from, serverTime, msg, bench.serverMessageSequence ) ) {
+			continue;
+		}
+
+		// the reliable messages set up the client game, which a benchmark client doesn't have
+		reliableMsg.Init( reliableBuf, sizeof( reliableBuf ) );
+		while ( bench.channel.GetReliableMessage( reliableMsg ) ) {
+		}
+
+		if ( msg.ReadInt() != gameInitId ) {
+			continue;
+		}
+		if ( msg.ReadByte() == SERVER_UNRELIABLE_MESSAGE_SNAPSHOT ) {
+			bench.snapshotSequence = msg.ReadInt();
+		}
+	}
+}
+
+/*
+==================
+idAsyncServer::BenchClientSend
+
+sends the next scripted user command of a benchmark client
+==================
+*/
+void idAsyncServer::BenchClientSend( int clientNum, benchClient_t &bench ) {
+	idBitMsg	msg;
+	byte		msgBuf[MAX_MESSAGE_SIZE];
+	usercmd_t &	cmd = bench.cmd;
+
+	// every second each client picks a new direction to run and turn in and whether it fires,
+	// the script only depends on the client number so every run plays out the same way
+	idRandom random( clientNum * 7919 + gameFrame / USERCMD_HZ );
+	int attack = random.RandomInt( 2 );
+	int forward = random.RandomInt( 4 );
+	int right = random.RandomInt( 3 );
+	int jump = random.RandomInt( 4 );
+	float pitch = random.CRandomFloat();
+	float yaw = random.CRandomFloat();
+
+	cmd.gameFrame = gameFrame;
+	cmd.gameTime = gameTime;
+	cmd.duplicateCount = 0;
+	cmd.buttons = BUTTON_RUN | BUTTON_MLOOK | ( attack ? BUTTON_ATTACK : 0 );
+	cmd.forwardmove = forward ? 127 : -127;
+	cmd.rightmove = ( right - 1 ) * 127;
+	cmd.upmove = ( jump == 0 && gameFrame % USERCMD_HZ < 10 ) ? 127 : 0;
+	cmd.angles[PITCH] = ANGLE2SHORT( pitch * 20.0f );
+	cmd.angles[YAW] = (short)( cmd.angles[YAW] + ANGLE2SHORT( yaw * 3.0f ) );
+	cmd.angles[ROLL] = 0;
+	cmd.mx = 0;
+	cmd.my = 0;
+	cmd.impulse = 0;
+	cmd.flags = 0;
+	cmd.sequence = gameFrame;
+
+	msg.Init( msgBuf, sizeof( msgBuf ) );
+	msg.WriteInt( bench.serverMessageSequence );
+	msg.WriteInt( gameInitId );
+	msg.WriteInt( bench.snapshotSequence );
+	msg.WriteByte( CLIENT_UNRELIABLE_MESSAGE_USERCMD );
+	msg.WriteShort( 0 );
+	msg.WriteInt( gameFrame );
+	msg.WriteByte( 1 );
+	idAsyncNetwork::WriteUserCmdDelta( msg, cmd, NULL );
+
+	bench.channel.SendMessage( bench.port, serverTime, msg );
+	while ( bench.channel.UnsentFragmentsLeft() ) {
+		bench.channel.SendNextFragment( bench.port, serverTime );
+	}
+}
+
+/*
+==================
+BenchCompareTimes
+==================
+*/
+static int BenchCompareTimes( const float *a, const float *b ) {
+	if ( *a < *b ) {
+		return -1;
+	}
+	return ( *a > *b ) ? 1 : 0;
+}
+
+/*
+==================
+idAsyncServer::RunBenchmark
+
+Spawns the server on a loopback port and connects numClients synthetic clients on loopback
+ports that send scripted user commands. The game runs for the given number of game seconds
+as fast as possible, so no network, renderer or sound is needed. After a second to let
+the clients join, the time of every server frame is recorded and the percentiles printed.
+==================
+*/
+void idAsyncServer::RunBenchmark( const char *mapName, int numClients, int seconds ) {
+	enum {
+		BENCH_TOTAL,
+		BENCH_THINK,
+		BENCH_EVENTS,
+		BENCH_GAME,
+		BENCH_SNAPSHOT,
+		BENCH_NETWORK,
+		BENCH_NUM_TIMES
+	};
+	static const char *benchTimeNames[BENCH_NUM_TIMES] = {
+		"total",		// the whole server frame
+		"think",		// entity think
+		"events",		// event servicing
+		"game",			// the rest of the game frame
+		"snapshot",		// writing and sending the snapshots
+		"network"		// reading the user commands from the clients
+	};
+	idList<float>	times[BENCH_NUM_TIMES];
+	idBitMsg		msg;
+	byte			msgBuf[MAX_MESSAGE_SIZE];
+	netadr_t		from;
+	int				i, j, size;
+
+	if ( numClients < 1 || numClients > MAX_ASYNC_CLIENTS ) {
+		common->Printf( "serverBench: number of clients must be between 1 and %d\n", MAX_ASYNC_CLIENTS );
+		return;
+	}
+	if ( seconds < 1 ) {
+		common->Printf( "serverBench: number of seconds must be positive\n" );
+		return;
+	}
+
+	// the benchmark needs the server port for itself
+	Kill();
+	ClosePort();
+
+	if ( !serverPort.InitForLoopback( PORT_SERVER ) ) {
+		common->Printf( "serverBench: couldn't open the loopback server port\n" );
+		return;
+	}
+
+	benchClient_t *benchClients = new benchClient_t[numClients];
+	for ( i = 0; i < numClients; i++ ) {
+		if ( !benchClients[i].port.InitForLoopback( PORT_SERVER + 1 + i ) ) {
+			common->Printf( "serverBench: couldn't open loopback port for client %d\n", i );
+			delete[] benchClients;
+			ClosePort();
+			return;
+		}
+	}
+
+	idStr oldMap = cvarSystem->GetCVarString( "si_map" );
+	bool oldPure = cvarSystem->GetCVarBool( "si_pure" );
+	cvarSystem->SetCVarString( "si_map", mapName );
+	cvarSystem->SetCVarBool( "si_pure", false );
+
+	benchmarking = true;
+	Spawn();
+
+	if ( active && sessLocal.mapSpawned ) {
+		for ( i = 0; i < numClients; i++ ) {
+			BenchClientConnect( i, benchClients[i] );
+		}
+
+		const int warmupFrames = USERCMD_HZ;
+		const int numFrames = seconds * USERCMD_HZ;
+		for ( i = 0; i < BENCH_NUM_TIMES; i++ ) {
+			times[i].SetNum( numFrames );
+		}
+
+		common->Printf( "serverBench: running %s for %d seconds with %d clients\n", mapName, seconds, numClients );
+
+		double startTime = Sys_MillisecondsPrecise();
+		for ( i = -warmupFrames; i < numFrames; i++ ) {
+
+			if ( i == 0 ) {
+				startTime = Sys_MillisecondsPrecise();
+				for ( j = 0; j < numClients; j++ ) {
+					benchClients[j].bytesReceived = 0;
+				}
+			}
+
+			// the clients read their snapshots and send the next user command, this isn't server time
+			for ( j = 0; j < numClients; j++ ) {
+				BenchClientReceive( benchClients[j] );
+				BenchClientSend( j, benchClients[j] );
+			}
+
+			double networkTime = Sys_MillisecondsPrecise();
+
+			while ( serverPort.GetPacket( from, msgBuf, size, sizeof( msgBuf ) ) ) {
+				msg.Init( msgBuf, sizeof( msgBuf ) );
+				msg.SetSize( size );
+				msg.BeginReading();
+				ProcessMessage( from, msg );
+			}
+
+			double gameFrameTime = Sys_MillisecondsPrecise();
+
+			// advance the game, session commands like a map change at the frag limit are
+			// ignored to keep the benchmark on one map
+			DuplicateUsercmds( gameFrame, gameTime );
+			gameReturn_t ret = game->RunFrame( userCmds[gameFrame & ( MAX_USERCMD_BACKUP - 1 ) ] );
+			gameFrame++;
+			gameTime += USERCMD_MSEC;
+			serverTime += USERCMD_MSEC;
+			DuplicateUsercmds( gameFrame, gameTime );
+
+			double snapshotTime = Sys_MillisecondsPrecise();
+
+			SendSnapshots();
+
+			double endTime = Sys_MillisecondsPrecise();
+
+			if ( i >= 0 ) {
+				times[BENCH_TOTAL][i] = endTime - networkTime;
+				times[BENCH_THINK][i] = ret.thinkMsec;
+				times[BENCH_EVENTS][i] = ret.eventMsec;
+				times[BENCH_GAME][i] = Max( 0.0, snapshotTime - gameFrameTime - ret.thinkMsec - ret.eventMsec );
+				times[BENCH_SNAPSHOT][i] = endTime - snapshotTime;
+				times[BENCH_NETWORK][i] = gameFrameTime - networkTime;
+			}
+		}
+		double totalTime = Sys_MillisecondsPrecise() - startTime;
+
+		int bytesReceived = 0;
+		for ( j = 0; j < numClients; j++ ) {
+			bytesReceived += benchClients[j].bytesReceived;
+		}
+
+		common->Printf( "serverBench: %d frames in %.1f seconds, %.1f times real time, %d B/s per client\n",
+						numFrames, totalTime * 0.001, seconds * 1000.0 / Max( totalTime, 0.001 ), bytesReceived / ( numClients * seconds ) );
+		common->Printf( "msec          mean     p50     p90     p99     max\n" );
+		for ( j = 0; j < BENCH_NUM_TIMES; j++ ) {
+			float mean = 0.0f;
+			for ( i = 0; i < numFrames; i++ ) {
+				mean += times[j][i];
+			}
+			mean /= numFrames;
+			times[j].Sort( BenchCompareTimes );
+			common->Printf( "%-10s %7.3f %7.3f %7.3f %7.3f %7.3f\n", benchTimeNames[j], mean,
+							times[j][numFrames / 2], times[j][numFrames * 90 / 100], times[j][numFrames * 99 / 100], times[j][numFrames - 1] );
+		}
+	} else {
+		common->Printf( "serverBench: couldn't start the server on %s\n", mapName );
+	}
+
+	Kill();
+	benchmarking = false;
+	ClosePort();
+	delete[] benchClients;
+
+	cvarSystem->SetCVarString( "si_map", oldMap );
+	cvarSystem->SetCVarBool( "si_pure", oldPure );
+}
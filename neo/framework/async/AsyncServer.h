@@ -127,6 +127,17 @@ typedef struct serverClient_s {
 
 } serverClient_t;
 
+// synthetic client of the server benchmark, connected through loopback ports
+typedef struct benchClient_s {
+	idPort				port;
+	idMsgChannel		channel;
+	int					clientId;
+	int					serverMessageSequence;
+	int					snapshotSequence;
+	int					bytesReceived;
+	usercmd_t			cmd;
+} benchClient_t;
+
 
 class idAsyncServer {
 public:
@@ -177,6 +188,9 @@ public:
 
 	void				PrintLocalServerInfo( void );
 
+						// runs a map with synthetic clients as fast as possible and prints the frame times
+	void				RunBenchmark( const char *mapName, int numClients, int seconds );
+
 private:
 	bool				active;						// true if server is active
 	int					realTime;					// absolute time
@@ -201,10 +215,20 @@ private:
 	int					nextHeartbeatTime;
 	int					nextAsyncStatsTime;
 
+	// network time and system calls since the last async stats print
+	double				statsNetworkMsec;
+	int					statsNetworkFrames;
+	int					statsRecvCalls;
+	int					statsSendCalls;
+	int					statsPacketsRead;
+	int					statsPacketsWritten;
+
 	bool				serverReloadingEngine;		// flip-flop to not loop over when net_serverReloadEngine is on
 
 	bool				noRconOutput;				// for default rcon response when command is silent
 
+	bool				benchmarking;				// running the server benchmark on loopback ports
+
 	int					lastAuthTime;				// global for auth server timeout
 
 	// track the max outgoing rate over the last few secs to watch for spikes
@@ -254,6 +278,11 @@ private:
 	int					UpdateTime( int clamp );
 	void				SendEnterGameToClient( int clientNum );
 	void				ProcessDownloadRequestMessage( const netadr_t from, const idBitMsg &msg );
+	void				SendSnapshots( void );
+	void				ResetNetworkStats( void );
+	void				BenchClientConnect( int clientNum, benchClient_t &bench );
+	void				BenchClientReceive( benchClient_t &bench );
+	void				BenchClientSend( int clientNum, benchClient_t &bench );
 };
 
 #endif /* !__ASYNCSERVER_H__ */
@@ -103,6 +103,14 @@ typedef struct entityState_s {
 	struct entityState_s *	next;
 } entityState_t;
 
+// the recorded writes of an entity state can take many times the size of the state itself
+const int MAX_SNAPSHOT_RECORD_SIZE	= MAX_ENTITY_STATE_SIZE * 80;
+
+typedef struct snapshotRecord_s {
+	int						offset;			// in snapshotRecordBuf, -1 if not recorded yet, -2 if it can't be recorded
+	int						size;
+} snapshotRecord_t;
+
 typedef struct snapshot_s {
 	int						sequence;
 	entityState_t *			firstEntityState;
@@ -445,6 +453,8 @@ public:
 	void					SetPortalState( qhandle_t portal, int blockingBits );
 	void					SaveEntityNetworkEvent( const idEntity *ent, int event, const idBitMsg *msg );
 	void					ServerSendChatMessage( int to, const char *name, const char *text );
+	void					ServerWriteEntityState( idEntity *ent, idBitMsgDelta &msg );
+	void					ServerReplayEntityState( idEntity *ent, idBitMsgDelta &msg );
 	int						ServerRemapDecl( int clientNum, declType_t type, int index );
 	int						ClientRemapDecl( declType_t type, int index );
 
@@ -491,6 +501,9 @@ private:
 	idList<int>				clientDeclRemap[MAX_CLIENTS][DECL_MAX_TYPES];
 
 	entityState_t *			clientEntityStates[MAX_CLIENTS][MAX_GENTITIES];
+	snapshotRecord_t		snapshotRecords[MAX_GENTITIES];	// entity states recorded for the snapshots of all clients
+	idList<byte>			snapshotRecordBuf;
+	int						snapshotRecordBytes;
 	int						clientPVS[MAX_CLIENTS][ENTITY_PVS_SIZE];
 	snapshot_t *			clientSnapshots[MAX_CLIENTS];
 	idBlockAlloc<entityState_t,256>entityStateAllocator;
@@ -509,6 +522,8 @@ private:
 
 	byte					lagometer[ LAGO_IMG_HEIGHT ][ LAGO_IMG_WIDTH ][ 4 ];
 
+	idList<idEntity *>		animFrameEntities;		// entities in the player pvs with animation frames to prepare
+
 	void					Clear( void );
 							// returns true if the entity shouldn't be spawned at all in this game type or difficulty level
 	bool					InhibitEntitySpawn( idDict &spawnArgs );
@@ -523,6 +538,8 @@ private:
 	void					FreePlayerPVS( void );
 	void					UpdateGravity( void );
 	void					SortActiveEntityList( void );
+	void					PrepareAnimFrames( void );
+	static void				PrepareAnimFramesJob( void *data, int first, int last );
 	void					ShowTargets( void );
 	void					RunDebugInfo( void );
 
@@ -561,6 +578,7 @@ private:
 	void					UpdateLagometer( int aheadOfServer, int dupeUsercmds );
 
 	virtual void			GetMapLoadingGUI( char gui[ MAX_STRING_CHARS ] );
+	virtual void			ServerBeginSnapshots( void );
 };
 
 //============================================================================
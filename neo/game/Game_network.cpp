@@ -78,6 +78,8 @@ void idGameLocal::InitAsyncNetwork( void ) {
 	memset( clientPVS, 0, sizeof( clientPVS ) );
 	memset( clientSnapshots, 0, sizeof( clientSnapshots ) );
 
+	ServerBeginSnapshots();
+
 	eventQueue.Init();
 	savedEventQueue.Init();
 
@@ -101,6 +103,8 @@ void idGameLocal::ShutdownAsyncNetwork( void ) {
 	memset( clientEntityStates, 0, sizeof( clientEntityStates ) );
 	memset( clientPVS, 0, sizeof( clientPVS ) );
 	memset( clientSnapshots, 0, sizeof( clientSnapshots ) );
+	snapshotRecordBuf.Clear();
+	snapshotRecordBytes = 0;
 }
 
 /*
@@ -546,6 +550,78 @@ void idGameLocal::ReadGameStateFromSnapshot( const idBitMsgDelta &msg ) {
 	mpGame.ReadFromSnapshot( msg );
 }
 
+/*
+================
+idGameLocal::ServerBeginSnapshots
+================
+*/
+void idGameLocal::ServerBeginSnapshots( void ) {
+	for ( int i = 0; i < MAX_GENTITIES; i++ ) {
+		snapshotRecords[i].offset = -1;
+	}
+	snapshotRecordBytes = 0;
+}
+
+/*
+================
+idGameLocal::ServerWriteEntityState
+================
+*/
+void idGameLocal::ServerWriteEntityState( idEntity *ent, idBitMsgDelta &msg ) {
+	msg.WriteBits( spawnIds[ ent->entityNumber ], 32 - GENTITYNUM_BITS );
+	msg.WriteBits( ent->GetType()->typeNum, idClass::GetTypeNumBits() );
+	msg.WriteBits( ServerRemapDecl( -1, DECL_ENTITYDEF, ent->entityDefNumber ), entityDefBits );
+
+	// write the class specific data to the snapshot
+	ent->WriteToSnapshot( msg );
+}
+
+/*
+================
+idGameLocal::ServerReplayEntityState
+
+  The entity state doesn't depend on the client so it is only written once
+  per server frame into a record of the writes. The record is replayed
+  against the base of every client, which gives the same delta as writing
+  the entity state for each client.
+================
+*/
+void idGameLocal::ServerReplayEntityState( idEntity *ent, idBitMsgDelta &msg ) {
+	snapshotRecord_t &record = snapshotRecords[ ent->entityNumber ];
+	idBitMsg recordMsg;
+
+	if ( record.offset == -1 ) {
+		idBitMsgDelta recordDelta;
+
+		if ( snapshotRecordBuf.Num() < snapshotRecordBytes + MAX_SNAPSHOT_RECORD_SIZE ) {
+			snapshotRecordBuf.SetNum( snapshotRecordBytes + MAX_SNAPSHOT_RECORD_SIZE );
+		}
+		recordMsg.Init( snapshotRecordBuf.Ptr() + snapshotRecordBytes, MAX_SNAPSHOT_RECORD_SIZE );
+		recordMsg.SetAllowOverflow( true );
+		recordMsg.BeginWriting();
+		recordDelta.InitRecord( &recordMsg );
+
+		ServerWriteEntityState( ent, recordDelta );
+
+		if ( recordMsg.IsOverflowed() ) {
+			record.offset = -2;
+		} else {
+			record.offset = snapshotRecordBytes;
+			record.size = recordMsg.GetSize();
+			snapshotRecordBytes += record.size;
+		}
+	}
+
+	if ( record.offset < 0 ) {
+		ServerWriteEntityState( ent, msg );
+		return;
+	}
+
+	recordMsg.Init( (const byte *)snapshotRecordBuf.Ptr() + record.offset, record.size );
+	recordMsg.SetSize( record.size );
+	msg.Replay( recordMsg );
+}
+
 /*
 ================
 idGameLocal::ServerWriteSnapshot
@@ -628,12 +704,7 @@ void idGameLocal::ServerWriteSnapshot( int clientNum, int sequence, idBitMsg &ms
 
 		deltaMsg.Init( base ? &base->state : NULL, &newBase->state, &msg );
 
-		deltaMsg.WriteBits( spawnIds[ ent->entityNumber ], 32 - GENTITYNUM_BITS );
-		deltaMsg.WriteBits( ent->GetType()->typeNum, idClass::GetTypeNumBits() );
-		deltaMsg.WriteBits( ServerRemapDecl( -1, DECL_ENTITYDEF, ent->entityDefNumber ), entityDefBits );
-
-		// write the class specific data to the snapshot
-		ent->WriteToSnapshot( deltaMsg );
+		ServerReplayEntityState( ent, deltaMsg );
 
 		if ( !deltaMsg.HasChanged() ) {
 			msg.RestoreWriteState( msgSize, msgWriteBit );
@@ -52,6 +52,7 @@ private:
 	idRoutingCache *			time_next;				// next in time based list
 	idRoutingCache *			time_prev;				// previous in time based list
 	unsigned short				startTravelTime;		// travel time to start with
+	bool						dirty;					// routing table that has to be updated before it is used
 	unsigned char *				reachabilities;			// reachabilities used for routing
 	unsigned short *			travelTimes;			// travel time for every area
 };
@@ -136,6 +137,8 @@ private:	// routing data
 	mutable idRoutingCache *	cacheListEnd;			// end of list with cache sorted from oldest to newest
 	mutable int					totalCacheMemory;		// total cache memory used
 	idList<idRoutingObstacle *>	obstacleList;			// list with obstacles
+	idRoutingCache **			routingTables;			// for each portal side and routing table travel flags the travel times from the cluster areas
+	int							numRoutingTables;		// number of routing table entries
 
 private:	// routing
 	bool						SetupRouting( void );
@@ -158,6 +161,12 @@ private:	// routing
 	void						UpdatePortalRoutingCache( idRoutingCache *portalCache ) const;
 	idRoutingCache *			GetPortalRoutingCache( int clusterNum, int areaNum, int travelFlags ) const;
 	void						RemoveRoutingCacheUsingArea( int areaNum );
+	void						SetupRoutingTables( void );
+	void						DeleteRoutingTables( void );
+	void						InvalidateRoutingTables( int clusterNum );
+	idRoutingCache *			GetRoutingTable( int clusterNum, int areaNum, int travelFlags ) const;
+	bool						ReadRoutingTables( const char *fileName, ID_TIME_T timeStamp );
+	void						WriteRoutingTables( const char *fileName, ID_TIME_T timeStamp ) const;
 	void						DisableArea( int areaNum );
 	void						EnableArea( int areaNum );
 	bool						SetAreaState_r( int nodeNum, const idBounds &bounds, const int areaContents, bool disabled );
@@ -27,6 +27,8 @@ If you have questions concerning this license or the applicable additional terms
 */
 
 #include "sys/platform.h"
+#include "framework/FileSystem.h"
+#include "gamesys/SysCvar.h"
 #include "Game_local.h"
 
 #include "ai/AAS_local.h"
@@ -38,6 +40,28 @@ If you have questions concerning this license or the applicable additional terms
 
 #define LEDGE_TRAVELTIME_PANALTY	250
 
+#define ROUTES_FILE_EXT				".routes"
+#define ROUTES_FILEID				( ( 'S' << 24 ) | ( 'T' << 16 ) | ( 'R' << 8 ) | 'A' )
+#define ROUTES_FILEVERSION			1
+
+// travel flags the AI routes with, routing tables are precomputed for these
+static const int routingTableTravelFlags[] = {
+	TFL_WALK|TFL_AIR,
+	TFL_WALK|TFL_AIR|TFL_FLY
+};
+static const int numRoutingTableTravelFlags = sizeof( routingTableTravelFlags ) / sizeof( routingTableTravelFlags[0] );
+
+typedef struct aasRoutesHeader_s {
+	int							fileId;				// ROUTES_FILEID in native byte order
+	int							version;
+	unsigned int				mapFileCRC;
+	unsigned int				timeStamp;			// of the .aas file the routing tables were made from
+	int							numAreas;
+	int							numPortals;
+	int							numAreaTravelTimes;
+	int							numRoutingTables;
+} aasRoutesHeader_t;
+
 /*
 ============
 idRoutingCache::idRoutingCache
@@ -50,6 +74,7 @@ idRoutingCache::idRoutingCache( int size ) {
 	time_next = time_prev = NULL;
 	travelFlags = 0;
 	startTravelTime = 0;
+	dirty = false;
 	type = 0;
 	this->size = size;
 	reachabilities = new byte[size];
@@ -288,6 +313,7 @@ idAASLocal::SetupRouting
 bool idAASLocal::SetupRouting( void ) {
 	CalculateAreaTravelTimes();
 	SetupRoutingCache();
+	SetupRoutingTables();
 	return true;
 }
 
@@ -298,6 +324,7 @@ idAASLocal::ShutdownRouting
 */
 void idAASLocal::ShutdownRouting( void ) {
 	DeleteAreaTravelTimes();
+	DeleteRoutingTables();
 	ShutdownRoutingCache();
 }
 
@@ -308,8 +335,8 @@ idAASLocal::RoutingStats
 */
 void idAASLocal::RoutingStats( void ) const {
 	idRoutingCache *cache;
-	int numAreaCache, numPortalCache;
-	int totalAreaCacheMemory, totalPortalCacheMemory;
+	int i, numAreaCache, numPortalCache, numTables, numDirtyTables;
+	int totalAreaCacheMemory, totalPortalCacheMemory, totalTableMemory;
 
 	numAreaCache = numPortalCache = 0;
 	totalAreaCacheMemory = totalPortalCacheMemory = 0;
@@ -326,6 +353,16 @@ void idAASLocal::RoutingStats( void ) const {
 	gameLocal.Printf( "%6d area cache (%d KB)\n", numAreaCache, totalAreaCacheMemory >> 10 );
 	gameLocal.Printf( "%6d portal cache (%d KB)\n", numPortalCache, totalPortalCacheMemory >> 10 );
 	gameLocal.Printf( "%6d total cache (%d KB)\n", numAreaCache + numPortalCache, totalCacheMemory >> 10 );
+
+	numTables = numDirtyTables = totalTableMemory = 0;
+	for ( i = 0; i < numRoutingTables; i++ ) {
+		if ( routingTables[i] ) {
+			numTables++;
+			numDirtyTables += routingTables[i]->dirty;
+			totalTableMemory += routingTables[i]->Size();
+		}
+	}
+	gameLocal.Printf( "%6d routing tables, %d out of date (%d KB)\n", numTables, numDirtyTables, totalTableMemory >> 10 );
 	gameLocal.Printf( "%6d area travel times (%zu KB)\n", numAreaTravelTimes, ( numAreaTravelTimes * sizeof( unsigned short ) ) >> 10 );
 	gameLocal.Printf( "%6d area cache entries (%zu KB)\n", areaCacheIndexSize, ( areaCacheIndexSize * sizeof( idRoutingCache * ) ) >> 10 );
 	gameLocal.Printf( "%6d portal cache entries (%zu KB)\n", portalCacheIndexSize, ( portalCacheIndexSize * sizeof( idRoutingCache * ) ) >> 10 );
@@ -343,15 +380,253 @@ void idAASLocal::RemoveRoutingCacheUsingArea( int areaNum ) {
 	if ( clusterNum > 0 ) {
 		// remove all the cache in the cluster the area is in
 		DeleteClusterCache( clusterNum );
+		InvalidateRoutingTables( clusterNum );
 	}
 	else {
 		// if this is a portal remove all cache in both the front and back cluster
 		DeleteClusterCache( file->GetPortal( -clusterNum ).clusters[0] );
 		DeleteClusterCache( file->GetPortal( -clusterNum ).clusters[1] );
+		InvalidateRoutingTables( file->GetPortal( -clusterNum ).clusters[0] );
+		InvalidateRoutingTables( file->GetPortal( -clusterNum ).clusters[1] );
 	}
 	DeletePortalCache();
 }
 
+/*
+============
+idAASLocal::SetupRoutingTables
+
+  The routing tables are area caches towards every portal area, one for each cluster the portal
+  is in and for each of the travel flags the AI uses. The portal routing cache floods through
+  all of these for every goal area, so they are calculated once on load and never deleted.
+  They are only updated when an area in their cluster is enabled or disabled.
+============
+*/
+void idAASLocal::SetupRoutingTables( void ) {
+	int i, j, side, clusterNum;
+	ID_TIME_T timeStamp;
+	const aasPortal_t *portal;
+	idRoutingCache *cache;
+
+	if ( !aas_routingTables.GetBool() ) {
+		return;
+	}
+
+	numRoutingTables = numRoutingTableTravelFlags * file->GetNumPortals() * 2;
+	routingTables = (idRoutingCache **) Mem_ClearedAlloc( numRoutingTables * sizeof( idRoutingCache * ) );
+
+	for ( i = 0; i < numRoutingTableTravelFlags; i++ ) {
+		for ( j = 1; j < file->GetNumPortals(); j++ ) {
+			portal = &file->GetPortal( j );
+			for ( side = 0; side < 2; side++ ) {
+				clusterNum = portal->clusters[side];
+				if ( clusterNum <= 0 ) {
+					continue;
+				}
+				cache = new idRoutingCache( file->GetCluster( clusterNum ).numReachableAreas );
+				cache->type = CACHETYPE_AREA;
+				cache->cluster = clusterNum;
+				cache->areaNum = portal->areaNum;
+				cache->startTravelTime = 1;
+				cache->travelFlags = routingTableTravelFlags[i];
+				routingTables[( i * file->GetNumPortals() + j ) * 2 + side] = cache;
+			}
+		}
+	}
+
+	timeStamp = FILE_NOT_FOUND_TIMESTAMP;
+	fileSystem->ReadFile( file->GetName(), NULL, &timeStamp );
+
+	if ( ReadRoutingTables( file->GetName(), timeStamp ) ) {
+		return;
+	}
+
+	for ( i = 0; i < numRoutingTables; i++ ) {
+		if ( routingTables[i] ) {
+			UpdateAreaRoutingCache( routingTables[i] );
+		}
+	}
+
+	if ( timeStamp != FILE_NOT_FOUND_TIMESTAMP ) {
+		WriteRoutingTables( file->GetName(), timeStamp );
+	}
+}
+
+/*
+============
+idAASLocal::DeleteRoutingTables
+============
+*/
+void idAASLocal::DeleteRoutingTables( void ) {
+	int i;
+
+	for ( i = 0; i < numRoutingTables; i++ ) {
+		delete routingTables[i];
+	}
+	Mem_Free( routingTables );
+	routingTables = NULL;
+	numRoutingTables = 0;
+}
+
+/*
+============
+idAASLocal::InvalidateRoutingTables
+============
+*/
+void idAASLocal::InvalidateRoutingTables( int clusterNum ) {
+	int i, j, portalNum, side;
+	const aasCluster_t *cluster;
+
+	if ( !routingTables || clusterNum <= 0 ) {
+		return;
+	}
+
+	cluster = &file->GetCluster( clusterNum );
+	for ( i = 0; i < cluster->numPortals; i++ ) {
+		portalNum = file->GetPortalIndex( cluster->firstPortal + i );
+		side = file->GetPortal( portalNum ).clusters[0] != clusterNum;
+		for ( j = 0; j < numRoutingTableTravelFlags; j++ ) {
+			routingTables[( j * file->GetNumPortals() + portalNum ) * 2 + side]->dirty = true;
+		}
+	}
+}
+
+/*
+============
+idAASLocal::GetRoutingTable
+
+  returns NULL if there is no routing table for the portal area and travel flags
+============
+*/
+idRoutingCache *idAASLocal::GetRoutingTable( int clusterNum, int areaNum, int travelFlags ) const {
+	int i, portalNum, side;
+	idRoutingCache *cache;
+
+	for ( i = 0; i < numRoutingTableTravelFlags; i++ ) {
+		if ( routingTableTravelFlags[i] == travelFlags ) {
+			break;
+		}
+	}
+	if ( i >= numRoutingTableTravelFlags ) {
+		return NULL;
+	}
+
+	portalNum = -file->GetArea( areaNum ).cluster;
+	side = file->GetPortal( portalNum ).clusters[0] != clusterNum;
+	cache = routingTables[( i * file->GetNumPortals() + portalNum ) * 2 + side];
+
+	if ( cache && cache->dirty ) {
+		memset( cache->reachabilities, 0, cache->size * sizeof( cache->reachabilities[0] ) );
+		memset( cache->travelTimes, 0, cache->size * sizeof( cache->travelTimes[0] ) );
+		UpdateAreaRoutingCache( cache );
+		cache->dirty = false;
+	}
+	return cache;
+}
+
+/*
+============
+idAASLocal::ReadRoutingTables
+============
+*/
+bool idAASLocal::ReadRoutingTables( const char *fileName, ID_TIME_T timeStamp ) {
+	int i, size;
+	idStr name;
+	idFile *fp;
+	aasRoutesHeader_t header;
+	idRoutingCache *cache;
+
+	name = fileName;
+	name += ROUTES_FILE_EXT;
+
+	fp = fileSystem->OpenFileRead( name );
+	if ( !fp ) {
+		return false;
+	}
+
+	if ( fp->Read( &header, sizeof( header ) ) != sizeof( header ) ||
+			header.fileId != ROUTES_FILEID || header.version != ROUTES_FILEVERSION ||
+			header.mapFileCRC != file->GetCRC() || header.timeStamp != (unsigned int) timeStamp ||
+			header.numAreas != file->GetNumAreas() || header.numPortals != file->GetNumPortals() ||
+			header.numAreaTravelTimes != numAreaTravelTimes || header.numRoutingTables != numRoutingTables ) {
+		gameLocal.Printf( "%s is out of date\n", name.c_str() );
+		fileSystem->CloseFile( fp );
+		return false;
+	}
+
+	for ( i = 0; i < numRoutingTables; i++ ) {
+		cache = routingTables[i];
+		if ( !cache ) {
+			continue;
+		}
+		size = cache->size * sizeof( cache->travelTimes[0] );
+		if ( fp->Read( cache->travelTimes, size ) != size ) {
+			break;
+		}
+		size = cache->size * sizeof( cache->reachabilities[0] );
+		if ( fp->Read( cache->reachabilities, size ) != size ) {
+			break;
+		}
+	}
+
+	fileSystem->CloseFile( fp );
+
+	if ( i < numRoutingTables ) {
+		gameLocal.Warning( "%s is damaged", name.c_str() );
+		for ( i = 0; i < numRoutingTables; i++ ) {
+			if ( routingTables[i] ) {
+				memset( routingTables[i]->reachabilities, 0, routingTables[i]->size * sizeof( routingTables[i]->reachabilities[0] ) );
+				memset( routingTables[i]->travelTimes, 0, routingTables[i]->size * sizeof( routingTables[i]->travelTimes[0] ) );
+			}
+		}
+		return false;
+	}
+
+	return true;
+}
+
+/*
+============
+idAASLocal::WriteRoutingTables
+============
+*/
+void idAASLocal::WriteRoutingTables( const char *fileName, ID_TIME_T timeStamp ) const {
+	int i;
+	idStr name;
+	idFile *fp;
+	aasRoutesHeader_t header;
+	const idRoutingCache *cache;
+
+	name = fileName;
+	name += ROUTES_FILE_EXT;
+
+	fp = fileSystem->OpenFileWrite( name, "fs_devpath" );
+	if ( !fp ) {
+		gameLocal.Warning( "idAASLocal::WriteRoutingTables: Error opening file %s", name.c_str() );
+		return;
+	}
+
+	header.fileId = ROUTES_FILEID;
+	header.version = ROUTES_FILEVERSION;
+	header.mapFileCRC = file->GetCRC();
+	header.timeStamp = (unsigned int) timeStamp;
+	header.numAreas = file->GetNumAreas();
+	header.numPortals = file->GetNumPortals();
+	header.numAreaTravelTimes = numAreaTravelTimes;
+	header.numRoutingTables = numRoutingTables;
+	fp->Write( &header, sizeof( header ) );
+
+	for ( i = 0; i < numRoutingTables; i++ ) {
+		cache = routingTables[i];
+		if ( cache ) {
+			fp->Write( cache->travelTimes, cache->size * sizeof( cache->travelTimes[0] ) );
+			fp->Write( cache->reachabilities, cache->size * sizeof( cache->reachabilities[0] ) );
+		}
+	}
+
+	fileSystem->CloseFile( fp );
+}
+
 /*
 ============
 idAASLocal::DisableArea
@@ -829,6 +1104,14 @@ idRoutingCache *idAASLocal::GetAreaRoutingCache( int clusterNum, int areaNum, in
 	int clusterAreaNum;
 	idRoutingCache *cache, *clusterCache;
 
+	// portal areas have precomputed routing tables for the travel flags the AI uses
+	if ( routingTables && file->GetArea( areaNum ).cluster < 0 ) {
+		cache = GetRoutingTable( clusterNum, areaNum, travelFlags );
+		if ( cache ) {
+			return cache;
+		}
+	}
+
 	// number of the area in the cluster
 	clusterAreaNum = ClusterAreaNum( clusterNum, areaNum );
 	// pointer to the cache for the area in the cluster
@@ -1370,7 +1370,7 @@ bool idAI::TestTrajectory( const idVec3 &start, const idVec3 &end, float zVel, f
 	int i, numSegments;
 	float maxHeight, t, t2;
 	idVec3 points[5];
-	trace_t trace;
+	trace_t traces[4];
 	bool result;
 
 	t = zVel / gravity;
@@ -1421,11 +1421,13 @@ bool idAI::TestTrajectory( const idVec3 &start, const idVec3 &end, float zVel, f
 		}
 	}
 
+	// trace all segments at once, the first one that hits decides
+	gameLocal.clip.TranslationBatch( traces, points, points + 1, numSegments, clip, mat3_identity, clipmask, ignore );
+
 	result = true;
 	for ( i = 0; i < numSegments; i++ ) {
-		gameLocal.clip.Translation( trace, points[i], points[i+1], clip, mat3_identity, clipmask, ignore );
-		if ( trace.fraction < 1.0f ) {
-			if ( gameLocal.GetTraceEntity( trace ) == targetEntity ) {
+		if ( traces[i].fraction < 1.0f ) {
+			if ( gameLocal.GetTraceEntity( traces[i] ) == targetEntity ) {
 				result = true;
 			} else {
 				result = false;
@@ -1433,6 +1435,7 @@ bool idAI::TestTrajectory( const idVec3 &start, const idVec3 &end, float zVel, f
 			break;
 		}
 	}
+	const trace_t &trace = traces[Min( i, numSegments - 1 )];
 
 	if ( drawtime ) {
 		if ( clip ) {
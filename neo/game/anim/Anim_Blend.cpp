@@ -3015,6 +3015,7 @@ idAnimator::idAnimator() {
 	joints					= NULL;
 	lastTransformTime		= -1;
 	stoppedAnimatingUpdate	= false;
+	pendingFrameUpdate		= false;
 	removeOriginOffset		= false;
 	forceUpdate				= false;
 
@@ -4199,7 +4200,10 @@ bool idAnimator::CreateFrame( int currentTime, bool force ) {
 
 	if ( !force && !r_showSkel.GetInteger() ) {
 		if ( lastTransformTime == currentTime ) {
-			return false;
+			// report a frame built by PrepareFrame as changed once
+			bool changed = pendingFrameUpdate;
+			pendingFrameUpdate = false;
+			return changed;
 		}
 		if ( lastTransformTime != -1 && !stoppedAnimatingUpdate && !IsAnimating( currentTime ) ) {
 			return false;
@@ -4208,6 +4212,7 @@ bool idAnimator::CreateFrame( int currentTime, bool force ) {
 
 	lastTransformTime = currentTime;
 	stoppedAnimatingUpdate = false;
+	pendingFrameUpdate = false;
 
 	if ( entity && ( ( g_debugAnim.GetInteger() == entity->entityNumber ) || ( g_debugAnim.GetInteger() == -2 ) ) ) {
 		debugInfo = true;
@@ -4414,6 +4419,22 @@ bool idAnimator::CreateFrame( int currentTime, bool force ) {
 	return true;
 }
 
+/*
+=====================
+idAnimator::PrepareFrame
+
+Builds the frame before the renderer asks for it through the entity's model
+callback, which then reports the frame as changed. Only touches the animator
+itself, so different animators can be prepared on the job threads.
+=====================
+*/
+bool idAnimator::PrepareFrame( int currentTime, bool force ) {
+	if ( CreateFrame( currentTime, force ) ) {
+		pendingFrameUpdate = true;
+	}
+	return pendingFrameUpdate;
+}
+
 /*
 =====================
 idAnimator::ForceUpdate
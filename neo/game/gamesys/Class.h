@@ -177,6 +177,8 @@ class idSaveGame;
 class idRestoreGame;
 
 class idClass {
+	friend class idEvent;
+
 public:
 	ABSTRACT_PROTOTYPE( idClass );
 
@@ -259,6 +261,8 @@ private:
 
 	void						Event_SafeRemove( void );
 
+	idLinkList<idEvent>			eventList;		// events scheduled for this object
+
 	static bool					initialized;
 	static idList<idTypeInfo *>	types;
 	static idList<idTypeInfo *>	typenums;
@@ -28,6 +28,7 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "sys/platform.h"
 #include "idlib/LangDict.h"
+#include "idlib/Timer.h"
 #include "framework/async/NetworkSystem.h"
 #include "framework/FileSystem.h"
 
@@ -196,6 +197,79 @@ void Cmd_Script_f( const idCmdArgs &args ) {
 	}
 }
 
+/*
+===================
+Cmd_ScriptBench_f
+
+Times a fixed script workload of arithmetic, vector, string and function call opcodes.
+===================
+*/
+static const char *scriptBenchText =
+	"float scriptBench_add( float a, float b ) {\n"
+	"	return a + b;\n"
+	"}\n"
+	"void scriptBench_run() {\n"
+	"	float i;\n"
+	"	float sum;\n"
+	"	vector v;\n"
+	"	string s;\n"
+	"	sum = 0;\n"
+	"	v = '0 0 0';\n"
+	"	for( i = 0; i < 50000; i++ ) {\n"
+	"		sum = scriptBench_add( sum, i * 0.5 );\n"
+	"		if ( sum > 1000 && i != 0 ) {\n"
+	"			sum = sum - 1000;\n"
+	"		}\n"
+	"		v = v + '1 2 3' * i;\n"
+	"		v_x = v * '0 0 1';\n"
+	"		if ( !( i % 1000 ) ) {\n"
+	"			s = \"bench\" + sum;\n"
+	"		}\n"
+	"	}\n"
+	"}\n";
+
+static void Cmd_ScriptBench_f( const idCmdArgs &args ) {
+	const function_t	*func;
+	idThread			*thread;
+	idTimer				timer;
+	int					i, numIterations;
+
+	if ( !gameLocal.CheatsOk() ) {
+		return;
+	}
+
+	numIterations = ( args.Argc() > 1 ) ? atoi( args.Argv( 1 ) ) : 10;
+	if ( numIterations < 1 ) {
+		gameLocal.Printf( "usage: scriptBench [iterations]\n" );
+		return;
+	}
+
+	func = gameLocal.program.FindFunction( "scriptBench_run" );
+	if ( !func ) {
+		if ( !gameLocal.program.CompileText( "scriptBench", scriptBenchText, true ) ) {
+			return;
+		}
+		func = gameLocal.program.FindFunction( "scriptBench_run" );
+		if ( !func ) {
+			return;
+		}
+	}
+
+	timer.Start();
+	for( i = 0; i < numIterations; i++ ) {
+		thread = new idThread( func );
+		thread->Start();
+	}
+	timer.Stop();
+
+#ifdef ID_SCRIPT_COMPUTED_GOTO
+	const char *dispatch = "computed goto";
+#else
+	const char *dispatch = "switch";
+#endif
+	gameLocal.Printf( "scriptBench: %d runs in %u msec, %.2f msec per run (%s dispatch)\n", numIterations, timer.Milliseconds(), ( float )timer.Milliseconds() / numIterations, dispatch );
+}
+
 /*
 ==================
 KillEntities
@@ -1310,6 +1384,27 @@ static void Cmd_ListCollisionModels_f( const idCmdArgs &args ) {
 	collisionModelManager->ListModels();
 }
 
+/*
+==================
+Cmd_ClipBench_f
+==================
+*/
+static void Cmd_ClipBench_f( const idCmdArgs &args ) {
+	int numIterations;
+
+	if ( !gameLocal.CheatsOk() ) {
+		return;
+	}
+
+	numIterations = ( args.Argc() > 1 ) ? atoi( args.Argv( 1 ) ) : 100;
+	if ( numIterations < 1 ) {
+		gameLocal.Printf( "usage: clipBench [iterations]\n" );
+		return;
+	}
+
+	gameLocal.clip.Benchmark( numIterations );
+}
+
 /*
 ==================
 Cmd_CollisionModelInfo_f
@@ -2361,8 +2456,10 @@ void idGameLocal::InitConsoleCommands( void ) {
 	cmdSystem->AddCommand( "testBlend",				idTestModel::TestBlend_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"tests animation blending" );
 	cmdSystem->AddCommand( "reloadScript",			Cmd_ReloadScript_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"reloads scripts" );
 	cmdSystem->AddCommand( "script",				Cmd_Script_f,				CMD_FL_GAME|CMD_FL_CHEAT,	"executes a line of script" );
+	cmdSystem->AddCommand( "scriptBench",			Cmd_ScriptBench_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"times the script interpreter on a fixed workload" );
 	cmdSystem->AddCommand( "listCollisionModels",	Cmd_ListCollisionModels_f,	CMD_FL_GAME,				"lists collision models" );
 	cmdSystem->AddCommand( "collisionModelInfo",	Cmd_CollisionModelInfo_f,	CMD_FL_GAME,				"shows collision model info" );
+	cmdSystem->AddCommand( "clipBench",				Cmd_ClipBench_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"times clip model queries and moves with the clip sectors and the clip model tree" );
 	cmdSystem->AddCommand( "reexportmodels",		Cmd_ReexportModels_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"reexports models", ArgCompletion_DefFile );
 	cmdSystem->AddCommand( "reloadanims",			Cmd_ReloadAnims_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"reloads animations" );
 	cmdSystem->AddCommand( "listAnims",				Cmd_ListAnims_f,			CMD_FL_GAME,				"lists all animations" );
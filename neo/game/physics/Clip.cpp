@@ -27,14 +27,18 @@ If you have questions concerning this license or the applicable additional terms
 */
 
 #include "sys/platform.h"
+#include "idlib/Timer.h"
 #include "gamesys/SaveGame.h"
+#include "gamesys/SysCvar.h"
 #include "Entity.h"
 #include "Game_local.h"
 
 #include "physics/Clip.h"
+#include "physics/ClipTree.h"
 
 #define	MAX_SECTOR_DEPTH				12
 #define MAX_SECTORS						((1<<(MAX_SECTOR_DEPTH+1))-1)
+#define MAX_CLIPTREE_STACK				256
 
 typedef struct clipSector_s {
 	int						axis;		// -1 = leaf node
@@ -286,6 +290,9 @@ void idClipModel::Init( void ) {
 	renderModelHandle = -1;
 	traceModelIndex = -1;
 	clipLinks = NULL;
+	clipTree = NULL;
+	clipTreeLeaf = -1;
+	clipTreeLinked = false;
 	touchCount = -1;
 }
 
@@ -352,6 +359,9 @@ idClipModel::idClipModel( const idClipModel *model ) {
 	}
 	renderModelHandle = model->renderModelHandle;
 	clipLinks = NULL;
+	clipTree = NULL;
+	clipTreeLeaf = -1;
+	clipTreeLinked = false;
 	touchCount = -1;
 }
 
@@ -363,6 +373,7 @@ idClipModel::~idClipModel
 idClipModel::~idClipModel( void ) {
 	// make sure the clip model is no longer linked
 	Unlink();
+	FreeTreeLeaf();
 	if ( traceModelIndex != -1 ) {
 		FreeTraceModel( traceModelIndex );
 	}
@@ -391,7 +402,7 @@ void idClipModel::Save( idSaveGame *savefile ) const {
 	}
 	savefile->WriteInt( traceModelIndex );
 	savefile->WriteInt( renderModelHandle );
-	savefile->WriteBool( clipLinks != NULL );
+	savefile->WriteBool( IsLinked() );
 	savefile->WriteInt( touchCount );
 }
 
@@ -444,7 +455,7 @@ idClipModel::SetPosition
 ================
 */
 void idClipModel::SetPosition( const idVec3 &newOrigin, const idMat3 &newAxis ) {
-	if ( clipLinks ) {
+	if ( IsLinked() ) {
 		Unlink();	// unlink from old position
 	}
 	origin = newOrigin;
@@ -505,6 +516,21 @@ void idClipModel::Unlink( void ) {
 		}
 		clipLinkAllocator.Free( link );
 	}
+	clipTreeLinked = false;
+}
+
+/*
+===============
+idClipModel::FreeTreeLeaf
+===============
+*/
+void idClipModel::FreeTreeLeaf( void ) {
+	if ( clipTree ) {
+		clipTree->Remove( clipTreeLeaf );
+		clipTree = NULL;
+		clipTreeLeaf = -1;
+		clipTreeLinked = false;
+	}
 }
 
 /*
@@ -551,7 +577,7 @@ void idClipModel::Link( idClip &clp ) {
 		return;
 	}
 
-	if ( clipLinks ) {
+	if ( IsLinked() ) {
 		Unlink();	// unlink from old position
 	}
 
@@ -574,6 +600,19 @@ void idClipModel::Link( idClip &clp ) {
 	absBounds[0] -= vec3_boxEpsilon;
 	absBounds[1] += vec3_boxEpsilon;
 
+	if ( clp.clipTree ) {
+		// the leaf only moves in the tree once the clip model leaves the fat leaf bounds
+		if ( clipTree ) {
+			assert( clipTree == clp.clipTree );
+			clipTree->Move( clipTreeLeaf, absBounds );
+		} else {
+			clipTree = clp.clipTree;
+			clipTreeLeaf = clipTree->Insert( this, absBounds );
+		}
+		clipTreeLinked = true;
+		return;
+	}
+
 	Link_r( clp.clipSectors );
 }
 
@@ -624,6 +663,7 @@ idClip::idClip
 idClip::idClip( void ) {
 	numClipSectors = 0;
 	clipSectors = NULL;
+	clipTree = NULL;
 	worldBounds.Zero();
 	numRotations = numTranslations = numMotions = numRenderModelTraces = numContents = numContacts = 0;
 }
@@ -702,6 +742,12 @@ void idClip::Init( void ) {
 	gameLocal.Printf( "map bounds are (%1.1f, %1.1f, %1.1f)\n", size[0], size[1], size[2] );
 	gameLocal.Printf( "max clip sector is (%1.1f, %1.1f, %1.1f)\n", maxSector[0], maxSector[1], maxSector[2] );
 
+	// clip models are linked into a dynamic tree instead of the sectors if requested
+	if ( g_clipModelTree.GetBool() ) {
+		clipTree = new idClipTree;
+	}
+	g_clipModelTree.ClearModified();
+
 	// initialize a default clip model
 	defaultClipModel.LoadModel( idTraceModel( idBounds( idVec3( 0, 0, 0 ) ).Expand( 8 ) ) );
 
@@ -718,6 +764,8 @@ void idClip::Shutdown( void ) {
 	delete[] clipSectors;
 	clipSectors = NULL;
 
+	FreeClipTree();
+
 	// free the trace model used for the temporaryClipModel
 	if ( temporaryClipModel.traceModelIndex != -1 ) {
 		idClipModel::FreeTraceModel( temporaryClipModel.traceModelIndex );
@@ -733,6 +781,97 @@ void idClip::Shutdown( void ) {
 	clipLinkAllocator.Shutdown();
 }
 
+/*
+===============
+idClip::FreeClipTree
+
+  Detaches the clip models from the tree and frees it.
+===============
+*/
+void idClip::FreeClipTree( void ) {
+	int i;
+
+	if ( !clipTree ) {
+		return;
+	}
+
+	for ( i = 0; i < clipTree->GetNumNodes(); i++ ) {
+		const clipTreeNode_t &node = clipTree->GetNode( i );
+		if ( node.height == 0 ) {
+			node.clipModel->clipTree = NULL;
+			node.clipModel->clipTreeLeaf = -1;
+			node.clipModel->clipTreeLinked = false;
+		}
+	}
+
+	delete clipTree;
+	clipTree = NULL;
+}
+
+/*
+===============
+idClip::GetLinkedClipModels
+===============
+*/
+void idClip::GetLinkedClipModels( idList<idClipModel *> &list ) const {
+	int i;
+	clipLink_t *link;
+
+	list.SetNum( 0, false );
+
+	if ( clipTree ) {
+		for ( i = 0; i < clipTree->GetNumNodes(); i++ ) {
+			const clipTreeNode_t &node = clipTree->GetNode( i );
+			if ( node.height == 0 && node.clipModel->clipTreeLinked ) {
+				list.Append( node.clipModel );
+			}
+		}
+		return;
+	}
+
+	touchCount++;
+	for ( i = 0; i < numClipSectors; i++ ) {
+		if ( clipSectors[i].axis != -1 ) {
+			continue;
+		}
+		for ( link = clipSectors[i].clipLinks; link; link = link->nextInSector ) {
+			if ( link->clipModel->touchCount != touchCount ) {
+				link->clipModel->touchCount = touchCount;
+				list.Append( link->clipModel );
+			}
+		}
+	}
+}
+
+/*
+===============
+idClip::UseClipModelTree
+===============
+*/
+void idClip::UseClipModelTree( bool useTree ) {
+	int i;
+	idList<idClipModel *> linked;
+
+	if ( useTree == ( clipTree != NULL ) || !clipSectors ) {
+		return;
+	}
+
+	GetLinkedClipModels( linked );
+	for ( i = 0; i < linked.Num(); i++ ) {
+		linked[i]->Unlink();
+	}
+
+	if ( useTree ) {
+		clipTree = new idClipTree;
+	} else {
+		FreeClipTree();
+	}
+
+	for ( i = 0; i < linked.Num(); i++ ) {
+		linked[i]->Link( *this );
+	}
+}
+
 /*
 ====================
 idClip::ClipModelsTouchingBounds_r
@@ -759,43 +898,107 @@ void idClip::ClipModelsTouchingBounds_r( const struct clipSector_s *node, listPa
 		}
 	}
 
-	for ( clipLink_t *link = node->clipLinks; link; link = link->nextInSector ) {
-		idClipModel	*check = link->clipModel;
+	ClipModelsInSector( node, parms );
+}
 
-		// if the clip model is enabled
-		if ( !check->enabled ) {
-			continue;
+/*
+====================
+idClip::ClipModelsInSector
+====================
+*/
+void idClip::ClipModelsInSector( const struct clipSector_s *node, listParms_t &parms ) const {
+	for ( clipLink_t *link = node->clipLinks; link; link = link->nextInSector ) {
+		if ( !ListClipModel( link->clipModel, parms ) ) {
+			return;
 		}
+	}
+}
 
-		// avoid duplicates in the list
-		if ( check->touchCount == touchCount ) {
-			continue;
-		}
+/*
+====================
+idClip::ClipModelsInTree
+====================
+*/
+void idClip::ClipModelsInTree( listParms_t &parms ) const {
+	int stack[MAX_CLIPTREE_STACK], stackDepth;
+
+	if ( clipTree->GetRoot() == -1 ) {
+		return;
+	}
+
+	stack[0] = clipTree->GetRoot();
+	stackDepth = 1;
+	while( stackDepth > 0 ) {
+		const clipTreeNode_t &node = clipTree->GetNode( stack[--stackDepth] );
 
-		// if the clip model does not have any contents we are looking for
-		if ( !( check->contents & parms.contentMask ) ) {
+		if (	node.bounds[0][0] > parms.bounds[1][0] ||
+				node.bounds[1][0] < parms.bounds[0][0] ||
+				node.bounds[0][1] > parms.bounds[1][1] ||
+				node.bounds[1][1] < parms.bounds[0][1] ||
+				node.bounds[0][2] > parms.bounds[1][2] ||
+				node.bounds[1][2] < parms.bounds[0][2] ) {
 			continue;
 		}
 
-		// if the bounds really do overlap
-		if (	check->absBounds[0][0] > parms.bounds[1][0] ||
-				check->absBounds[1][0] < parms.bounds[0][0] ||
-				check->absBounds[0][1] > parms.bounds[1][1] ||
-				check->absBounds[1][1] < parms.bounds[0][1] ||
-				check->absBounds[0][2] > parms.bounds[1][2] ||
-				check->absBounds[1][2] < parms.bounds[0][2] ) {
+		if ( node.height == 0 ) {
+			if ( node.clipModel->clipTreeLinked && !ListClipModel( node.clipModel, parms ) ) {
+				return;
+			}
 			continue;
 		}
 
-		if ( parms.count >= parms.maxCount ) {
-			gameLocal.Warning( "idClip::ClipModelsTouchingBounds_r: max count" );
+		if ( stackDepth + 2 > MAX_CLIPTREE_STACK ) {
+			gameLocal.Warning( "idClip::ClipModelsInTree: stack overflow" );
 			return;
 		}
+		stack[stackDepth++] = node.children[1];
+		stack[stackDepth++] = node.children[0];
+	}
+}
+
+/*
+====================
+idClip::ListClipModel
 
-		check->touchCount = touchCount;
-		parms.list[parms.count] = check;
-		parms.count++;
+  adds the clip model to the list if it is touching the bounds, returns false if the list is full
+====================
+*/
+bool idClip::ListClipModel( idClipModel *check, listParms_t &parms ) const {
+
+	// if the clip model is enabled
+	if ( !check->enabled ) {
+		return true;
+	}
+
+	// avoid duplicates in the list
+	if ( check->touchCount == touchCount ) {
+		return true;
+	}
+
+	// if the clip model does not have any contents we are looking for
+	if ( !( check->contents & parms.contentMask ) ) {
+		return true;
+	}
+
+	// if the bounds really do overlap
+	if (	check->absBounds[0][0] > parms.bounds[1][0] ||
+			check->absBounds[1][0] < parms.bounds[0][0] ||
+			check->absBounds[0][1] > parms.bounds[1][1] ||
+			check->absBounds[1][1] < parms.bounds[0][1] ||
+			check->absBounds[0][2] > parms.bounds[1][2] ||
+			check->absBounds[1][2] < parms.bounds[0][2] ) {
+		return true;
+	}
+
+	if ( parms.count >= parms.maxCount ) {
+		gameLocal.Warning( "idClip::ClipModelsTouchingBounds_r: max count" );
+		return false;
 	}
+
+	check->touchCount = touchCount;
+	parms.list[parms.count] = check;
+	parms.count++;
+	return true;
 }
 
 /*
@@ -822,7 +1025,11 @@ int idClip::ClipModelsTouchingBounds( const idBounds &bounds, int contentMask, i
 	parms.maxCount = maxCount;
 
 	touchCount++;
-	ClipModelsTouchingBounds_r( clipSectors, parms );
+	if ( clipTree ) {
+		ClipModelsInTree( parms );
+	} else {
+		ClipModelsTouchingBounds_r( clipSectors, parms );
+	}
 
 	return parms.count;
 }
@@ -870,14 +1077,28 @@ idClip::GetTraceClipModels
 ====================
 */
 int idClip::GetTraceClipModels( const idBounds &bounds, int contentMask, const idEntity *passEntity, idClipModel **clipModelList ) const {
-	int i, num;
-	idClipModel	*cm;
-	idEntity *passOwner;
+	int num;
 
 	num = ClipModelsTouchingBounds( bounds, contentMask, clipModelList, MAX_GENTITIES );
+	FilterTraceClipModels( passEntity, clipModelList, num );
+
+	return num;
+}
+
+/*
+====================
+idClip::FilterTraceClipModels
+
+  clears the clip models in the list that GetTraceClipModels excludes
+====================
+*/
+void idClip::FilterTraceClipModels( const idEntity *passEntity, idClipModel **clipModelList, int num ) const {
+	int i;
+	idClipModel	*cm;
+	idEntity *passOwner;
 
 	if ( !passEntity ) {
-		return num;
+		return;
 	}
 
 	if ( passEntity->GetPhysics()->GetNumClipModels() > 0 ) {
@@ -903,8 +1124,6 @@ int idClip::GetTraceClipModels( const idBounds &bounds, int contentMask, const i
 			}
 		}
 	}
-
-	return num;
 }
 
 /*
@@ -1122,6 +1341,231 @@ bool idClip::Translation( trace_t &results, const idVec3 &start, const idVec3 &e
 	return ( results.fraction < 1.0f );
 }
 
+/*
+============
+idClip::SectorsTouchingBounds_r
+
+  Collects the leaf sectors the bounds reach in the order ClipModelsTouchingBounds_r visits them.
+  A query with other bounds b reaches the same leaf if b[1] >= lo and b[0] <= hi on every axis,
+  lo and hi being the split distances on the way down to the front and back children.
+============
+*/
+typedef struct clipSectorRef_s {
+	const clipSector_t *	sector;
+	idVec3					lo;
+	idVec3					hi;
+} clipSectorRef_t;
+
+void idClip::SectorsTouchingBounds_r( const struct clipSector_s *node, const idBounds &bounds, idVec3 lo, idVec3 hi, idList<clipSectorRef_t> &sectors ) const {
+
+	while( node->axis != -1 ) {
+		if ( bounds[0][node->axis] > node->dist ) {
+			lo[node->axis] = Max( lo[node->axis], node->dist );
+			node = node->children[0];
+		} else if ( bounds[1][node->axis] < node->dist ) {
+			hi[node->axis] = Min( hi[node->axis], node->dist );
+			node = node->children[1];
+		} else {
+			idVec3 frontLo = lo;
+			frontLo[node->axis] = Max( lo[node->axis], node->dist );
+			SectorsTouchingBounds_r( node->children[0], bounds, frontLo, hi, sectors );
+			hi[node->axis] = Min( hi[node->axis], node->dist );
+			node = node->children[1];
+		}
+	}
+
+	clipSectorRef_t &ref = sectors.Alloc();
+	ref.sector = node;
+	ref.lo = lo;
+	ref.hi = hi;
+}
+
+/*
+============
+TracesMatch
+============
+*/
+static bool TracesMatch( const trace_t &a, const trace_t &b ) {
+	return	a.fraction == b.fraction && a.endpos == b.endpos && a.endAxis == b.endAxis &&
+			a.c.type == b.c.type && a.c.point == b.c.point && a.c.normal == b.c.normal && a.c.dist == b.c.dist &&
+			a.c.contents == b.c.contents && a.c.material == b.c.material && a.c.modelFeature == b.c.modelFeature &&
+			a.c.trmFeature == b.c.trmFeature && a.c.entityNum == b.c.entityNum && a.c.id == b.c.id;
+}
+
+/*
+============
+idClip::TranslationBatch
+
+  Does the same as calling Translation for every path, but the clip sectors are only walked once
+  for the bounds of all the paths. Each path then takes the clip models from the sectors it reaches
+  in the same order as ClipModelsTouchingBounds, so the closest hit wins ties the same way.
+  With the clip model tree every clip model has a single leaf, so the clip models for all the
+  paths are listed at once and each path takes the ones touching its own bounds.
+============
+*/
+int idClip::TranslationBatch( trace_t *results, const idVec3 *start, const idVec3 *end, const int numTraces,
+						const idClipModel *mdl, const idMat3 &trmAxis, int contentMask, const idEntity *passEntity ) {
+	int i, j, num, numHits, numBatchClipModels;
+	idClipModel *touch, *clipModelList[MAX_GENTITIES], *batchClipModels[MAX_GENTITIES];
+	idList<clipSectorRef_t> batchSectors;
+	idBounds *traceBounds, batchBounds;
+	bool *done;
+	float radius;
+	trace_t trace;
+	const idTraceModel *trm;
+	listParms_t parms;
+
+	traceBounds = (idBounds *) _alloca( numTraces * sizeof( traceBounds[0] ) );
+	done = (bool *) _alloca( numTraces * sizeof( done[0] ) );
+
+	for ( i = 0; i < numTraces; i++ ) {
+		done[i] = TestHugeTranslation( results[i], mdl, start[i], end[i], trmAxis );
+	}
+
+	trm = TraceModelForClipModel( mdl );
+
+	if ( !passEntity || passEntity->entityNumber != ENTITYNUM_WORLD ) {
+		// test world
+		for ( i = 0; i < numTraces; i++ ) {
+			if ( !done[i] ) {
+				idClip::numTranslations++;
+				collisionModelManager->Translation( &results[i], start[i], end[i], trm, trmAxis, contentMask, 0, vec3_origin, mat3_default );
+				results[i].c.entityNum = results[i].fraction != 1.0f ? ENTITYNUM_WORLD : ENTITYNUM_NONE;
+				if ( results[i].fraction == 0.0f ) {
+					done[i] = true;		// blocked immediately by the world
+				}
+			}
+		}
+	} else {
+		for ( i = 0; i < numTraces; i++ ) {
+			if ( !done[i] ) {
+				memset( &results[i], 0, sizeof( results[i] ) );
+				results[i].fraction = 1.0f;
+				results[i].endpos = end[i];
+				results[i].endAxis = trmAxis;
+			}
+		}
+	}
+
+	if ( !trm ) {
+		radius = 0.0f;
+	} else {
+		radius = trm->bounds.GetRadius();
+	}
+
+	// walk the clip sectors once for all the paths that are left
+	batchBounds.Clear();
+	for ( i = 0; i < numTraces; i++ ) {
+		if ( done[i] ) {
+			continue;
+		}
+		if ( !trm ) {
+			traceBounds[i].FromPointTranslation( start[i], results[i].endpos - start[i] );
+		} else {
+			traceBounds[i].FromBoundsTranslation( trm->bounds, start[i], trmAxis, results[i].endpos - start[i] );
+		}
+		batchBounds.AddBounds( traceBounds[i] );
+	}
+
+	batchSectors.SetGranularity( 64 );
+	numBatchClipModels = 0;
+	if ( !batchBounds.IsCleared() && clipTree ) {
+		parms.bounds[0] = batchBounds[0] - vec3_boxEpsilon;
+		parms.bounds[1] = batchBounds[1] + vec3_boxEpsilon;
+		parms.contentMask = contentMask;
+		parms.list = batchClipModels;
+		parms.count = 0;
+		parms.maxCount = MAX_GENTITIES;
+
+		touchCount++;
+		ClipModelsInTree( parms );
+		numBatchClipModels = parms.count;
+	} else if ( !batchBounds.IsCleared() ) {
+		batchBounds[0] -= vec3_boxEpsilon;
+		batchBounds[1] += vec3_boxEpsilon;
+		SectorsTouchingBounds_r( clipSectors, batchBounds, idVec3( -idMath::INFINITY, -idMath::INFINITY, -idMath::INFINITY ),
+									idVec3( idMath::INFINITY, idMath::INFINITY, idMath::INFINITY ), batchSectors );
+	}
+
+	numHits = 0;
+	for ( i = 0; i < numTraces; i++ ) {
+		if ( done[i] ) {
+			numHits += ( results[i].fraction < 1.0f );
+			continue;
+		}
+
+		// the same list GetTraceClipModels would return for the trace bounds
+		parms.bounds[0] = traceBounds[i][0] - vec3_boxEpsilon;
+		parms.bounds[1] = traceBounds[i][1] + vec3_boxEpsilon;
+		parms.contentMask = contentMask;
+		parms.list = clipModelList;
+		parms.count = 0;
+		parms.maxCount = MAX_GENTITIES;
+
+		for ( j = 0; j < numBatchClipModels; j++ ) {
+			touch = batchClipModels[j];
+			if (	touch->absBounds[0][0] > parms.bounds[1][0] || touch->absBounds[1][0] < parms.bounds[0][0] ||
+					touch->absBounds[0][1] > parms.bounds[1][1] || touch->absBounds[1][1] < parms.bounds[0][1] ||
+					touch->absBounds[0][2] > parms.bounds[1][2] || touch->absBounds[1][2] < parms.bounds[0][2] ) {
+				continue;
+			}
+			clipModelList[parms.count++] = touch;
+		}
+
+		touchCount++;
+		for ( j = 0; j < batchSectors.Num(); j++ ) {
+			const clipSectorRef_t &ref = batchSectors[j];
+			if (	parms.bounds[1][0] >= ref.lo[0] && parms.bounds[0][0] <= ref.hi[0] &&
+					parms.bounds[1][1] >= ref.lo[1] && parms.bounds[0][1] <= ref.hi[1] &&
+					parms.bounds[1][2] >= ref.lo[2] && parms.bounds[0][2] <= ref.hi[2] ) {
+				ClipModelsInSector( ref.sector, parms );
+			}
+		}
+		num = parms.count;
+		FilterTraceClipModels( passEntity, clipModelList, num );
+
+		for ( j = 0; j < num; j++ ) {
+			touch = clipModelList[j];
+
+			if ( !touch ) {
+				continue;
+			}
+
+			if ( touch->renderModelHandle != -1 ) {
+				idClip::numRenderModelTraces++;
+				TraceRenderModel( trace, start[i], end[i], radius, trmAxis, touch );
+			} else {
+				idClip::numTranslations++;
+				collisionModelManager->Translation( &trace, start[i], end[i], trm, trmAxis, contentMask,
+										touch->Handle(), touch->origin, touch->axis );
+			}
+
+			if ( trace.fraction < results[i].fraction ) {
+				results[i] = trace;
+				results[i].c.entityNum = touch->entity->entityNumber;
+				results[i].c.id = touch->id;
+				if ( results[i].fraction == 0.0f ) {
+					break;
+				}
+			}
+		}
+
+		numHits += ( results[i].fraction < 1.0f );
+	}
+
+	// every field has to be the same as with a separate trace
+	if ( g_checkTraceBatch.GetBool() ) {
+		for ( i = 0; i < numTraces; i++ ) {
+			Translation( trace, start[i], end[i], mdl, trmAxis, contentMask, passEntity );
+			if ( !TracesMatch( trace, results[i] ) ) {
+				gameLocal.Warning( "idClip::TranslationBatch: trace %d of %d differs from idClip::Translation", i, numTraces );
+			}
+		}
+	}
+
+	return numHits;
+}
+
 /*
 ============
 idClip::Rotation
@@ -1609,6 +2053,75 @@ void idClip::PrintStatistics( void ) {
 	numRotations = numTranslations = numMotions = numRenderModelTraces = numContents = numContacts = 0;
 }
 
+/*
+============
+idClip::Benchmark
+
+  Lists the clip models around every linked clip model and moves every clip model
+  a little and a lot, once with the clip sectors and once with the clip model tree.
+  The clip models are put back at their original position after each move.
+============
+*/
+void idClip::Benchmark( int numIterations ) {
+	int i, j, k, m, numFound;
+	bool usedTree, useTree;
+	idList<idClipModel *> models;
+	idClipModel *clipModelList[MAX_GENTITIES];
+	idVec3 origin, offset;
+	idTimer queryTimer, moveTimer[2];
+
+	if ( !clipSectors ) {
+		gameLocal.Printf( "no map loaded\n" );
+		return;
+	}
+
+	usedTree = ( clipTree != NULL );
+	GetLinkedClipModels( models );
+
+	gameLocal.Printf( "%d linked clip models, %d iterations\n", models.Num(), numIterations );
+
+	for ( j = 0; j < 2; j++ ) {
+		useTree = ( j != 0 );
+		UseClipModelTree( useTree );
+
+		numFound = 0;
+		queryTimer.Clear();
+		queryTimer.Start();
+		for ( k = 0; k < numIterations; k++ ) {
+			for ( i = 0; i < models.Num(); i++ ) {
+				numFound += ClipModelsTouchingBounds( models[i]->absBounds.Expand( 64.0f ), -1, clipModelList, MAX_GENTITIES );
+			}
+		}
+		queryTimer.Stop();
+
+		for ( m = 0; m < 2; m++ ) {
+			offset = ( m == 0 ) ? idVec3( 2.0f, 2.0f, 0.0f ) : idVec3( 64.0f, 64.0f, 0.0f );
+			moveTimer[m].Clear();
+			moveTimer[m].Start();
+			for ( k = 0; k < numIterations; k++ ) {
+				for ( i = 0; i < models.Num(); i++ ) {
+					origin = models[i]->origin;
+					models[i]->origin = origin + offset;
+					models[i]->Link( *this );
+					models[i]->origin = origin;
+					models[i]->Link( *this );
+				}
+			}
+			moveTimer[m].Stop();
+		}
+
+		gameLocal.Printf( "%s:\n", useTree ? "clip model tree" : "clip sectors" );
+		gameLocal.Printf( "%6u msec for %d queries finding %d clip models\n", queryTimer.Milliseconds(), numIterations * models.Num(), numFound );
+		gameLocal.Printf( "%6u msec for %d small moves\n", moveTimer[0].Milliseconds(), 2 * numIterations * models.Num() );
+		gameLocal.Printf( "%6u msec for %d large moves\n", moveTimer[1].Milliseconds(), 2 * numIterations * models.Num() );
+		if ( useTree ) {
+			gameLocal.Printf( "%6d tree height, %d KB\n", clipTree->GetHeight(), (int)( clipTree->Allocated() >> 10 ) );
+		}
+	}
+
+	UseClipModelTree( usedTree );
+}
+
 /*
 ============
 idClip::DrawClipModels
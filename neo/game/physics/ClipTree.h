@@ -0,0 +1,116 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __CLIPTREE_H__
+#define __CLIPTREE_H__
+
+#include "idlib/bv/Bounds.h"
+#include "idlib/containers/List.h"
+
+/*
+===============================================================================
+
+	Dynamic bounding volume tree
+
+	Used by idClip instead of the uniformly subdivided clip sectors.
+	The leaves store bounds that are fattened by a margin so clip models
+	that only move a little do not have to be reinserted. The tree is kept
+	balanced with rotations while leaves are inserted and removed.
+
+===============================================================================
+*/
+
+#define CLIPTREE_FAT_MARGIN			8.0f
+
+class idClipModel;
+
+typedef struct clipTreeNode_s {
+	idBounds				bounds;
+	int						parent;			// next node in the free list for free nodes
+	int						children[2];	// -1 for leaf nodes
+	int						height;			// 0 for leaf nodes, -1 for free nodes
+	idClipModel *			clipModel;
+} clipTreeNode_t;
+
+class idClipTree {
+public:
+							idClipTree( void );
+
+	void					Clear( void );
+
+							// inserts a leaf for the clip model, returns the leaf number
+	int						Insert( idClipModel *clipModel, const idBounds &bounds );
+	void					Remove( int leaf );
+							// returns true if the bounds moved outside the fat leaf bounds and the leaf was reinserted
+	bool					Move( int leaf, const idBounds &bounds );
+
+	int						GetRoot( void ) const;
+	int						GetNumNodes( void ) const;			// including free nodes
+	const clipTreeNode_t &	GetNode( int index ) const;
+	int						GetNumLeafs( void ) const;
+	int						GetHeight( void ) const;
+	size_t					Allocated( void ) const;
+
+private:
+	idList<clipTreeNode_t>	nodes;
+	int						root;
+	int						freeList;
+	int						numLeafs;
+
+	int						AllocNode( void );
+	void					FreeNode( int index );
+	void					InsertLeaf( int leaf );
+	void					RemoveLeaf( int leaf );
+	int						Balance( int index );
+};
+
+ID_INLINE int idClipTree::GetRoot( void ) const {
+	return root;
+}
+
+ID_INLINE int idClipTree::GetNumNodes( void ) const {
+	return nodes.Num();
+}
+
+ID_INLINE const clipTreeNode_t &idClipTree::GetNode( int index ) const {
+	return nodes[index];
+}
+
+ID_INLINE int idClipTree::GetNumLeafs( void ) const {
+	return numLeafs;
+}
+
+ID_INLINE int idClipTree::GetHeight( void ) const {
+	return ( root != -1 ) ? nodes[root].height : 0;
+}
+
+ID_INLINE size_t idClipTree::Allocated( void ) const {
+	return nodes.Allocated();
+}
+
+#endif /* !__CLIPTREE_H__ */
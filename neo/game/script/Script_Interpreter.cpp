@@ -984,6 +984,56 @@ void idInterpreter::CallSysEvent( const function_t *func, int argsize ) {
 	popParms = 0;
 }
 
+/*
+====================
+idInterpreter::DebugInstruction
+====================
+*/
+void idInterpreter::DebugInstruction( void ) {
+	if ( !updateGameDebugger( this, &gameLocal.program, instructionPointer ) && g_debugScript.GetBool() ) {
+		static int lastLineNumber = -1;
+		if ( lastLineNumber != gameLocal.program.GetStatement( instructionPointer ).linenumber ) {
+			gameLocal.Printf( "%s (%d)\n",
+				gameLocal.program.GetFilename( gameLocal.program.GetStatement( instructionPointer ).file ),
+				gameLocal.program.GetStatement( instructionPointer ).linenumber
+				);
+			lastLineNumber = gameLocal.program.GetStatement( instructionPointer ).linenumber;
+		}
+	}
+}
+
+/*
+====================
+SCRIPT_FETCH, SCRIPT_OP, SCRIPT_NEXT
+
+Execute is written with these so the same opcode handlers can be dispatched
+either through the switch statement or through the label table.  With the label
+table every handler fetches and jumps to the next instruction by itself, which
+gives the branch predictor one indirect jump per handler to work with instead of
+the single jump of the switch.
+====================
+*/
+#define SCRIPT_FETCH()																\
+	if ( doneProcessing || threadDying ) {											\
+		break;																		\
+	}																				\
+	instructionPointer++;															\
+	if ( !--runaway ) {																\
+		Error( "runaway loop error" );												\
+	}																				\
+	st = &gameLocal.program.GetInstruction( instructionPointer );					\
+	DebugInstruction()
+
+#ifdef ID_SCRIPT_COMPUTED_GOTO
+#define SCRIPT_OP( opcode )		label_##opcode:
+#define SCRIPT_DEFAULT_OP
+#define SCRIPT_NEXT()			SCRIPT_FETCH(); goto *dispatchTable[ st->op ]
+#else
+#define SCRIPT_OP( opcode )		case opcode:
+#define SCRIPT_DEFAULT_OP		default:
+#define SCRIPT_NEXT()			continue
+#endif
+
 /*
 ====================
 idInterpreter::Execute
@@ -994,7 +1044,7 @@ bool idInterpreter::Execute( void ) {
 	varEval_t	var_b;
 	varEval_t	var_c;
 	varEval_t	var;
-	statement_t	*st;
+	const instruction_t *st;
 	int			runaway;
 	idThread	*newThread;
 	float		floatVal;
@@ -1012,50 +1062,73 @@ bool idInterpreter::Execute( void ) {
 
 	runaway = 5000000;
 
-	doneProcessing = false;
-	while( !doneProcessing && !threadDying ) {
-		instructionPointer++;
-
-		if ( !--runaway ) {
-			Error( "runaway loop error" );
-		}
-
-		// next statement
-		st = &gameLocal.program.GetStatement( instructionPointer );
+#ifdef ID_SCRIPT_COMPUTED_GOTO
+	// has to list the labels in the same order as the opcodes in Script_Compiler.h
+	static const void * const dispatchTable[ NUM_OPCODES ] = {
+		&&label_OP_RETURN, &&label_OP_UINC_F, &&label_OP_UINCP_F, &&label_OP_UDEC_F,
+		&&label_OP_UDECP_F, &&label_OP_COMP_F, &&label_OP_MUL_F, &&label_OP_MUL_V,
+		&&label_OP_MUL_FV, &&label_OP_MUL_VF, &&label_OP_DIV_F, &&label_OP_MOD_F,
+		&&label_OP_ADD_F, &&label_OP_ADD_V, &&label_OP_ADD_S, &&label_OP_ADD_FS,
+		&&label_OP_ADD_SF, &&label_OP_ADD_VS, &&label_OP_ADD_SV, &&label_OP_SUB_F,
+		&&label_OP_SUB_V, &&label_OP_EQ_F, &&label_OP_EQ_V, &&label_OP_EQ_S,
+		&&label_OP_EQ_E, &&label_OP_EQ_EO, &&label_OP_EQ_OE, &&label_OP_EQ_OO,
+		&&label_OP_NE_F, &&label_OP_NE_V, &&label_OP_NE_S, &&label_OP_NE_E,
+		&&label_OP_NE_EO, &&label_OP_NE_OE, &&label_OP_NE_OO, &&label_OP_LE,
+		&&label_OP_GE, &&label_OP_LT, &&label_OP_GT, &&label_OP_INDIRECT_F,
+		&&label_OP_INDIRECT_V, &&label_OP_INDIRECT_S, &&label_OP_INDIRECT_ENT, &&label_OP_INDIRECT_BOOL,
+		&&label_OP_INDIRECT_OBJ, &&label_OP_ADDRESS, &&label_OP_EVENTCALL, &&label_OP_OBJECTCALL,
+		&&label_OP_SYSCALL, &&label_OP_STORE_F, &&label_OP_STORE_V, &&label_OP_STORE_S,
+		&&label_OP_STORE_ENT, &&label_OP_STORE_BOOL, &&label_OP_STORE_OBJENT, &&label_OP_STORE_OBJ,
+		&&label_OP_STORE_ENTOBJ, &&label_OP_STORE_FTOS, &&label_OP_STORE_BTOS, &&label_OP_STORE_VTOS,
+		&&label_OP_STORE_FTOBOOL, &&label_OP_STORE_BOOLTOF, &&label_OP_STOREP_F, &&label_OP_STOREP_V,
+		&&label_OP_STOREP_S, &&label_OP_STOREP_ENT, &&label_OP_STOREP_FLD, &&label_OP_STOREP_BOOL,
+		&&label_OP_STOREP_OBJ, &&label_OP_STOREP_OBJENT, &&label_OP_STOREP_FTOS, &&label_OP_STOREP_BTOS,
+		&&label_OP_STOREP_VTOS, &&label_OP_STOREP_FTOBOOL, &&label_OP_STOREP_BOOLTOF, &&label_OP_UMUL_F,
+		&&label_OP_UMUL_V, &&label_OP_UDIV_F, &&label_OP_UDIV_V, &&label_OP_UMOD_F,
+		&&label_OP_UADD_F, &&label_OP_UADD_V, &&label_OP_USUB_F, &&label_OP_USUB_V,
+		&&label_OP_UAND_F, &&label_OP_UOR_F, &&label_OP_NOT_BOOL, &&label_OP_NOT_F,
+		&&label_OP_NOT_V, &&label_OP_NOT_S, &&label_OP_NOT_ENT, &&label_OP_NEG_F,
+		&&label_OP_NEG_V, &&label_OP_INT_F, &&label_OP_IF, &&label_OP_IFNOT,
+		&&label_OP_CALL, &&label_OP_THREAD, &&label_OP_OBJTHREAD, &&label_OP_PUSH_F,
+		&&label_OP_PUSH_V, &&label_OP_PUSH_S, &&label_OP_PUSH_ENT, &&label_OP_PUSH_OBJ,
+		&&label_OP_PUSH_OBJENT, &&label_OP_PUSH_FTOS, &&label_OP_PUSH_BTOF, &&label_OP_PUSH_FTOB,
+		&&label_OP_PUSH_VTOS, &&label_OP_PUSH_BTOS, &&label_OP_GOTO, &&label_OP_AND,
+		&&label_OP_AND_BOOLF, &&label_OP_AND_FBOOL, &&label_OP_AND_BOOLBOOL, &&label_OP_OR,
+		&&label_OP_OR_BOOLF, &&label_OP_OR_FBOOL, &&label_OP_OR_BOOLBOOL, &&label_OP_BITAND,
+		&&label_OP_BITOR, &&label_OP_BREAK, &&label_OP_CONTINUE,
+	};
+
+	assert( dispatchTable[ NUM_OPCODES - 1 ] != NULL );
+#endif
 
-		if ( !updateGameDebugger( this, &gameLocal.program, instructionPointer )
-			&& g_debugScript.GetBool( ) ) 
-		{
-			static int lastLineNumber = -1;
-			if ( lastLineNumber != gameLocal.program.GetStatement ( instructionPointer ).linenumber ) {				
-				gameLocal.Printf ( "%s (%d)\n", 
-					gameLocal.program.GetFilename ( gameLocal.program.GetStatement ( instructionPointer ).file ),
-					gameLocal.program.GetStatement ( instructionPointer ).linenumber
-					);
-				lastLineNumber = gameLocal.program.GetStatement ( instructionPointer ).linenumber;
-			}
-		}
+	doneProcessing = false;
+	for( ;; ) {
+		SCRIPT_FETCH();
 
+#ifdef ID_SCRIPT_COMPUTED_GOTO
+		goto *dispatchTable[ st->op ];
+#else
 		switch( st->op ) {
-		case OP_RETURN:
-			LeaveFunction( st->a );
-			break;
+#endif
+		SCRIPT_OP( OP_RETURN )
+			LeaveFunction( gameLocal.program.GetStatement( instructionPointer ).a );
+			SCRIPT_NEXT();
 
-		case OP_THREAD:
-			newThread = new idThread( this, st->a->value.functionPtr, st->b->value.argSize );
+		SCRIPT_OP( OP_THREAD )
+			newThread = new idThread( this, st->a.functionPtr, st->b.argSize );
 			newThread->Start();
 
 			// return the thread number to the script
 			gameLocal.program.ReturnFloat( newThread->GetThreadNum() );
-			PopParms( st->b->value.argSize );
-			break;
+			PopParms( st->b.argSize );
+			SCRIPT_NEXT();
 
-		case OP_OBJTHREAD:
-			var_a = GetVariable( st->a );
+		SCRIPT_OP( OP_OBJTHREAD )
+			var_a = GetVariable( st->a, st->stackA );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				func = obj->GetTypeDef()->GetFunction( st->b->value.virtualFunction );
-				assert( st->c->value.argSize == func->parmTotal );
+				func = obj->GetTypeDef()->GetFunction( st->b.virtualFunction );
+				assert( st->c.argSize == func->parmTotal );
 				newThread = new idThread( this, GetEntity( *var_a.entityNumberPtr ), func, func->parmTotal );
 				newThread->Start();
 
@@ -1065,142 +1138,142 @@ bool idInterpreter::Execute( void ) {
 				// return a null thread to the script
 				gameLocal.program.ReturnFloat( 0.0f );
 			}
-			PopParms( st->c->value.argSize );
-			break;
+			PopParms( st->c.argSize );
+			SCRIPT_NEXT();
 
-		case OP_CALL:
-			EnterFunction( st->a->value.functionPtr, false );
-			break;
+		SCRIPT_OP( OP_CALL )
+			EnterFunction( st->a.functionPtr, false );
+			SCRIPT_NEXT();
 
-		case OP_EVENTCALL:
-			CallEvent( st->a->value.functionPtr, st->b->value.argSize );
-			break;
+		SCRIPT_OP( OP_EVENTCALL )
+			CallEvent( st->a.functionPtr, st->b.argSize );
+			SCRIPT_NEXT();
 
-		case OP_OBJECTCALL:
-			var_a = GetVariable( st->a );
+		SCRIPT_OP( OP_OBJECTCALL )
+			var_a = GetVariable( st->a, st->stackA );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				func = obj->GetTypeDef()->GetFunction( st->b->value.virtualFunction );
+				func = obj->GetTypeDef()->GetFunction( st->b.virtualFunction );
 				EnterFunction( func, false );
 			} else {
 				// return a 'safe' value
 				gameLocal.program.ReturnVector( vec3_zero );
 				gameLocal.program.ReturnString( "" );
-				PopParms( st->c->value.argSize );
+				PopParms( st->c.argSize );
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_SYSCALL:
-			CallSysEvent( st->a->value.functionPtr, st->b->value.argSize );
-			break;
+		SCRIPT_OP( OP_SYSCALL )
+			CallSysEvent( st->a.functionPtr, st->b.argSize );
+			SCRIPT_NEXT();
 
-		case OP_IFNOT:
-			var_a = GetVariable( st->a );
+		SCRIPT_OP( OP_IFNOT )
+			var_a = GetVariable( st->a, st->stackA );
 			if ( *var_a.intPtr == 0 ) {
-				NextInstruction( instructionPointer + st->b->value.jumpOffset );
+				NextInstruction( instructionPointer + st->b.jumpOffset );
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_IF:
-			var_a = GetVariable( st->a );
+		SCRIPT_OP( OP_IF )
+			var_a = GetVariable( st->a, st->stackA );
 			if ( *var_a.intPtr != 0 ) {
-				NextInstruction( instructionPointer + st->b->value.jumpOffset );
+				NextInstruction( instructionPointer + st->b.jumpOffset );
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_GOTO:
-			NextInstruction( instructionPointer + st->a->value.jumpOffset );
-			break;
+		SCRIPT_OP( OP_GOTO )
+			NextInstruction( instructionPointer + st->a.jumpOffset );
+			SCRIPT_NEXT();
 
-		case OP_ADD_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_ADD_F )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = *var_a.floatPtr + *var_b.floatPtr;
-			break;
+			SCRIPT_NEXT();
 
-		case OP_ADD_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_ADD_V )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.vectorPtr = *var_a.vectorPtr + *var_b.vectorPtr;
-			break;
-
-		case OP_ADD_S:
-			SetString( st->c, GetString( st->a ) );
-			AppendString( st->c, GetString( st->b ) );
-			break;
-
-		case OP_ADD_FS:
-			var_a = GetVariable( st->a );
-			SetString( st->c, FloatToString( *var_a.floatPtr ) );
-			AppendString( st->c, GetString( st->b ) );
-			break;
-
-		case OP_ADD_SF:
-			var_b = GetVariable( st->b );
-			SetString( st->c, GetString( st->a ) );
-			AppendString( st->c, FloatToString( *var_b.floatPtr ) );
-			break;
-
-		case OP_ADD_VS:
-			var_a = GetVariable( st->a );
-			SetString( st->c, var_a.vectorPtr->ToString() );
-			AppendString( st->c, GetString( st->b ) );
-			break;
-
-		case OP_ADD_SV:
-			var_b = GetVariable( st->b );
-			SetString( st->c, GetString( st->a ) );
-			AppendString( st->c, var_b.vectorPtr->ToString() );
-			break;
-
-		case OP_SUB_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			SCRIPT_NEXT();
+
+		SCRIPT_OP( OP_ADD_S )
+			SetString( st->c, st->stackC, GetString( st->a, st->stackA ) );
+			AppendString( st->c, st->stackC, GetString( st->b, st->stackB ) );
+			SCRIPT_NEXT();
+
+		SCRIPT_OP( OP_ADD_FS )
+			var_a = GetVariable( st->a, st->stackA );
+			SetString( st->c, st->stackC, FloatToString( *var_a.floatPtr ) );
+			AppendString( st->c, st->stackC, GetString( st->b, st->stackB ) );
+			SCRIPT_NEXT();
+
+		SCRIPT_OP( OP_ADD_SF )
+			var_b = GetVariable( st->b, st->stackB );
+			SetString( st->c, st->stackC, GetString( st->a, st->stackA ) );
+			AppendString( st->c, st->stackC, FloatToString( *var_b.floatPtr ) );
+			SCRIPT_NEXT();
+
+		SCRIPT_OP( OP_ADD_VS )
+			var_a = GetVariable( st->a, st->stackA );
+			SetString( st->c, st->stackC, var_a.vectorPtr->ToString() );
+			AppendString( st->c, st->stackC, GetString( st->b, st->stackB ) );
+			SCRIPT_NEXT();
+
+		SCRIPT_OP( OP_ADD_SV )
+			var_b = GetVariable( st->b, st->stackB );
+			SetString( st->c, st->stackC, GetString( st->a, st->stackA ) );
+			AppendString( st->c, st->stackC, var_b.vectorPtr->ToString() );
+			SCRIPT_NEXT();
+
+		SCRIPT_OP( OP_SUB_F )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = *var_a.floatPtr - *var_b.floatPtr;
-			break;
+			SCRIPT_NEXT();
 
-		case OP_SUB_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_SUB_V )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.vectorPtr = *var_a.vectorPtr - *var_b.vectorPtr;
-			break;
+			SCRIPT_NEXT();
 
-		case OP_MUL_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_MUL_F )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = *var_a.floatPtr * *var_b.floatPtr;
-			break;
+			SCRIPT_NEXT();
 
-		case OP_MUL_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_MUL_V )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = *var_a.vectorPtr * *var_b.vectorPtr;
-			break;
+			SCRIPT_NEXT();
 
-		case OP_MUL_FV:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_MUL_FV )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.vectorPtr = *var_a.floatPtr * *var_b.vectorPtr;
-			break;
+			SCRIPT_NEXT();
 
-		case OP_MUL_VF:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_MUL_VF )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.vectorPtr = *var_a.vectorPtr * *var_b.floatPtr;
-			break;
+			SCRIPT_NEXT();
 
-		case OP_DIV_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_DIV_F )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 
 			if ( *var_b.floatPtr == 0.0f ) {
 				Warning( "Divide by zero" );
@@ -1208,12 +1281,12 @@ bool idInterpreter::Execute( void ) {
 			} else {
 				*var_c.floatPtr = *var_a.floatPtr / *var_b.floatPtr;
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_MOD_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable ( st->c );
+		SCRIPT_OP( OP_MOD_F )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 
 			if ( *var_b.floatPtr == 0.0f ) {
 				Warning( "Divide by zero" );
@@ -1221,252 +1294,252 @@ bool idInterpreter::Execute( void ) {
 			} else {
 				*var_c.floatPtr = static_cast<int>( *var_a.floatPtr ) % static_cast<int>( *var_b.floatPtr );
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_BITAND:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_BITAND )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = static_cast<int>( *var_a.floatPtr ) & static_cast<int>( *var_b.floatPtr );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_BITOR:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_BITOR )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = static_cast<int>( *var_a.floatPtr ) | static_cast<int>( *var_b.floatPtr );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_GE:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_GE )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = ( *var_a.floatPtr >= *var_b.floatPtr );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_LE:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_LE )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = ( *var_a.floatPtr <= *var_b.floatPtr );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_GT:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_GT )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = ( *var_a.floatPtr > *var_b.floatPtr );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_LT:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_LT )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = ( *var_a.floatPtr < *var_b.floatPtr );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_AND:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_AND )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) && ( *var_b.floatPtr != 0.0f );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_AND_BOOLF:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_AND_BOOLF )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = ( *var_a.intPtr != 0 ) && ( *var_b.floatPtr != 0.0f );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_AND_FBOOL:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_AND_FBOOL )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) && ( *var_b.intPtr != 0 );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_AND_BOOLBOOL:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_AND_BOOLBOOL )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = ( *var_a.intPtr != 0 ) && ( *var_b.intPtr != 0 );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_OR:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_OR )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) || ( *var_b.floatPtr != 0.0f );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_OR_BOOLF:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_OR_BOOLF )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = ( *var_a.intPtr != 0 ) || ( *var_b.floatPtr != 0.0f );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_OR_FBOOL:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_OR_FBOOL )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) || ( *var_b.intPtr != 0 );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_OR_BOOLBOOL:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_OR_BOOLBOOL )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = ( *var_a.intPtr != 0 ) || ( *var_b.intPtr != 0 );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_NOT_BOOL:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_NOT_BOOL )
+			var_a = GetVariable( st->a, st->stackA );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = ( *var_a.intPtr == 0 );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_NOT_F:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_NOT_F )
+			var_a = GetVariable( st->a, st->stackA );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = ( *var_a.floatPtr == 0.0f );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_NOT_V:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_NOT_V )
+			var_a = GetVariable( st->a, st->stackA );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = ( *var_a.vectorPtr == vec3_zero );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_NOT_S:
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( strlen( GetString( st->a ) ) == 0 );
-			break;
+		SCRIPT_OP( OP_NOT_S )
+			var_c = GetVariable( st->c, st->stackC );
+			*var_c.floatPtr = ( strlen( GetString( st->a, st->stackA ) ) == 0 );
+			SCRIPT_NEXT();
 
-		case OP_NOT_ENT:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_NOT_ENT )
+			var_a = GetVariable( st->a, st->stackA );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = ( GetEntity( *var_a.entityNumberPtr ) == NULL );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_NEG_F:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_NEG_F )
+			var_a = GetVariable( st->a, st->stackA );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = -*var_a.floatPtr;
-			break;
+			SCRIPT_NEXT();
 
-		case OP_NEG_V:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_NEG_V )
+			var_a = GetVariable( st->a, st->stackA );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.vectorPtr = -*var_a.vectorPtr;
-			break;
+			SCRIPT_NEXT();
 
-		case OP_INT_F:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_INT_F )
+			var_a = GetVariable( st->a, st->stackA );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = static_cast<int>( *var_a.floatPtr );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_EQ_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_EQ_F )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = ( *var_a.floatPtr == *var_b.floatPtr );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_EQ_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_EQ_V )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = ( *var_a.vectorPtr == *var_b.vectorPtr );
-			break;
-
-		case OP_EQ_S:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( idStr::Cmp( GetString( st->a ), GetString( st->b ) ) == 0 );
-			break;
-
-		case OP_EQ_E:
-		case OP_EQ_EO:
-		case OP_EQ_OE:
-		case OP_EQ_OO:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			SCRIPT_NEXT();
+
+		SCRIPT_OP( OP_EQ_S )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
+			*var_c.floatPtr = ( idStr::Cmp( GetString( st->a, st->stackA ), GetString( st->b, st->stackB ) ) == 0 );
+			SCRIPT_NEXT();
+
+		SCRIPT_OP( OP_EQ_E )
+		SCRIPT_OP( OP_EQ_EO )
+		SCRIPT_OP( OP_EQ_OE )
+		SCRIPT_OP( OP_EQ_OO )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = ( *var_a.entityNumberPtr == *var_b.entityNumberPtr );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_NE_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_NE_F )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = ( *var_a.floatPtr != *var_b.floatPtr );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_NE_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_NE_V )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = ( *var_a.vectorPtr != *var_b.vectorPtr );
-			break;
-
-		case OP_NE_S:
-			var_c = GetVariable( st->c );
-			*var_c.floatPtr = ( idStr::Cmp( GetString( st->a ), GetString( st->b ) ) != 0 );
-			break;
-
-		case OP_NE_E:
-		case OP_NE_EO:
-		case OP_NE_OE:
-		case OP_NE_OO:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
-			var_c = GetVariable( st->c );
+			SCRIPT_NEXT();
+
+		SCRIPT_OP( OP_NE_S )
+			var_c = GetVariable( st->c, st->stackC );
+			*var_c.floatPtr = ( idStr::Cmp( GetString( st->a, st->stackA ), GetString( st->b, st->stackB ) ) != 0 );
+			SCRIPT_NEXT();
+
+		SCRIPT_OP( OP_NE_E )
+		SCRIPT_OP( OP_NE_EO )
+		SCRIPT_OP( OP_NE_OE )
+		SCRIPT_OP( OP_NE_OO )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = ( *var_a.entityNumberPtr != *var_b.entityNumberPtr );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_UADD_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_UADD_F )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
 			*var_b.floatPtr += *var_a.floatPtr;
-			break;
+			SCRIPT_NEXT();
 
-		case OP_UADD_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_UADD_V )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
 			*var_b.vectorPtr += *var_a.vectorPtr;
-			break;
+			SCRIPT_NEXT();
 
-		case OP_USUB_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_USUB_F )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
 			*var_b.floatPtr -= *var_a.floatPtr;
-			break;
+			SCRIPT_NEXT();
 
-		case OP_USUB_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_USUB_V )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
 			*var_b.vectorPtr -= *var_a.vectorPtr;
-			break;
+			SCRIPT_NEXT();
 
-		case OP_UMUL_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_UMUL_F )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
 			*var_b.floatPtr *= *var_a.floatPtr;
-			break;
+			SCRIPT_NEXT();
 
-		case OP_UMUL_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_UMUL_V )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
 			*var_b.vectorPtr *= *var_a.floatPtr;
-			break;
+			SCRIPT_NEXT();
 
-		case OP_UDIV_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_UDIV_F )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
 
 			if ( *var_a.floatPtr == 0.0f ) {
 				Warning( "Divide by zero" );
@@ -1474,11 +1547,11 @@ bool idInterpreter::Execute( void ) {
 			} else {
 				*var_b.floatPtr = *var_b.floatPtr / *var_a.floatPtr;
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_UDIV_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_UDIV_V )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
 
 			if ( *var_a.floatPtr == 0.0f ) {
 				Warning( "Divide by zero" );
@@ -1486,11 +1559,11 @@ bool idInterpreter::Execute( void ) {
 			} else {
 				*var_b.vectorPtr = *var_b.vectorPtr / *var_a.floatPtr;
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_UMOD_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_UMOD_F )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
 
 			if ( *var_a.floatPtr == 0.0f ) {
 				Warning( "Divide by zero" );
@@ -1498,241 +1571,241 @@ bool idInterpreter::Execute( void ) {
 			} else {
 				*var_b.floatPtr = static_cast<int>( *var_b.floatPtr ) % static_cast<int>( *var_a.floatPtr );
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_UOR_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_UOR_F )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
 			*var_b.floatPtr = static_cast<int>( *var_b.floatPtr ) | static_cast<int>( *var_a.floatPtr );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_UAND_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_UAND_F )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
 			*var_b.floatPtr = static_cast<int>( *var_b.floatPtr ) & static_cast<int>( *var_a.floatPtr );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_UINC_F:
-			var_a = GetVariable( st->a );
+		SCRIPT_OP( OP_UINC_F )
+			var_a = GetVariable( st->a, st->stackA );
 			( *var_a.floatPtr )++;
-			break;
+			SCRIPT_NEXT();
 
-		case OP_UINCP_F:
-			var_a = GetVariable( st->a );
+		SCRIPT_OP( OP_UINCP_F )
+			var_a = GetVariable( st->a, st->stackA );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+				var.bytePtr = &obj->data[ st->b.ptrOffset ];
 				( *var.floatPtr )++;
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_UDEC_F:
-			var_a = GetVariable( st->a );
+		SCRIPT_OP( OP_UDEC_F )
+			var_a = GetVariable( st->a, st->stackA );
 			( *var_a.floatPtr )--;
-			break;
+			SCRIPT_NEXT();
 
-		case OP_UDECP_F:
-			var_a = GetVariable( st->a );
+		SCRIPT_OP( OP_UDECP_F )
+			var_a = GetVariable( st->a, st->stackA );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+				var.bytePtr = &obj->data[ st->b.ptrOffset ];
 				( *var.floatPtr )--;
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_COMP_F:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_COMP_F )
+			var_a = GetVariable( st->a, st->stackA );
+			var_c = GetVariable( st->c, st->stackC );
 			*var_c.floatPtr = ~static_cast<int>( *var_a.floatPtr );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_STORE_F:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_STORE_F )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
 			*var_b.floatPtr = *var_a.floatPtr;
-			break;
+			SCRIPT_NEXT();
 
-		case OP_STORE_ENT:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_STORE_ENT )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
 			*var_b.entityNumberPtr = *var_a.entityNumberPtr;
-			break;
+			SCRIPT_NEXT();
 
-		case OP_STORE_BOOL:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_STORE_BOOL )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
 			*var_b.intPtr = *var_a.intPtr;
-			break;
+			SCRIPT_NEXT();
 
-		case OP_STORE_OBJENT:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_STORE_OBJENT )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( !obj ) {
 				*var_b.entityNumberPtr = 0;
-			} else if ( !obj->GetTypeDef()->Inherits( st->b->TypeDef() ) ) {
+			} else if ( !obj->GetTypeDef()->Inherits( gameLocal.program.GetStatement( instructionPointer ).b->TypeDef() ) ) {
 				//Warning( "object '%s' cannot be converted to '%s'", obj->GetTypeName(), st->b->TypeDef()->Name() );
 				*var_b.entityNumberPtr = 0;
 			} else {
 				*var_b.entityNumberPtr = *var_a.entityNumberPtr;
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_STORE_OBJ:
-		case OP_STORE_ENTOBJ:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_STORE_OBJ )
+		SCRIPT_OP( OP_STORE_ENTOBJ )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
 			*var_b.entityNumberPtr = *var_a.entityNumberPtr;
-			break;
+			SCRIPT_NEXT();
 
-		case OP_STORE_S:
-			SetString( st->b, GetString( st->a ) );
-			break;
+		SCRIPT_OP( OP_STORE_S )
+			SetString( st->b, st->stackB, GetString( st->a, st->stackA ) );
+			SCRIPT_NEXT();
 
-		case OP_STORE_V:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_STORE_V )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
 			*var_b.vectorPtr = *var_a.vectorPtr;
-			break;
-
-		case OP_STORE_FTOS:
-			var_a = GetVariable( st->a );
-			SetString( st->b, FloatToString( *var_a.floatPtr ) );
-			break;
-
-		case OP_STORE_BTOS:
-			var_a = GetVariable( st->a );
-			SetString( st->b, *var_a.intPtr ? "true" : "false" );
-			break;
-
-		case OP_STORE_VTOS:
-			var_a = GetVariable( st->a );
-			SetString( st->b, var_a.vectorPtr->ToString() );
-			break;
-
-		case OP_STORE_FTOBOOL:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+			SCRIPT_NEXT();
+
+		SCRIPT_OP( OP_STORE_FTOS )
+			var_a = GetVariable( st->a, st->stackA );
+			SetString( st->b, st->stackB, FloatToString( *var_a.floatPtr ) );
+			SCRIPT_NEXT();
+
+		SCRIPT_OP( OP_STORE_BTOS )
+			var_a = GetVariable( st->a, st->stackA );
+			SetString( st->b, st->stackB, *var_a.intPtr ? "true" : "false" );
+			SCRIPT_NEXT();
+
+		SCRIPT_OP( OP_STORE_VTOS )
+			var_a = GetVariable( st->a, st->stackA );
+			SetString( st->b, st->stackB, var_a.vectorPtr->ToString() );
+			SCRIPT_NEXT();
+
+		SCRIPT_OP( OP_STORE_FTOBOOL )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
 			if ( *var_a.floatPtr != 0.0f ) {
 				*var_b.intPtr = 1;
 			} else {
 				*var_b.intPtr = 0;
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_STORE_BOOLTOF:
-			var_a = GetVariable( st->a );
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_STORE_BOOLTOF )
+			var_a = GetVariable( st->a, st->stackA );
+			var_b = GetVariable( st->b, st->stackB );
 			*var_b.floatPtr = static_cast<float>( *var_a.intPtr );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_STOREP_F:
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_STOREP_F )
+			var_b = GetVariable( st->b, st->stackB );
 			if ( var_b.evalPtr && var_b.evalPtr->floatPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetVariable( st->a, st->stackA );
 				*var_b.evalPtr->floatPtr = *var_a.floatPtr;
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_STOREP_ENT:
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_STOREP_ENT )
+			var_b = GetVariable( st->b, st->stackB );
 			if ( var_b.evalPtr && var_b.evalPtr->entityNumberPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetVariable( st->a, st->stackA );
 				*var_b.evalPtr->entityNumberPtr = *var_a.entityNumberPtr;
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_STOREP_FLD:
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_STOREP_FLD )
+			var_b = GetVariable( st->b, st->stackB );
 			if ( var_b.evalPtr && var_b.evalPtr->intPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetVariable( st->a, st->stackA );
 				*var_b.evalPtr->intPtr = *var_a.intPtr;
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_STOREP_BOOL:
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_STOREP_BOOL )
+			var_b = GetVariable( st->b, st->stackB );
 			if ( var_b.evalPtr && var_b.evalPtr->intPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetVariable( st->a, st->stackA );
 				*var_b.evalPtr->intPtr = *var_a.intPtr;
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_STOREP_S:
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_STOREP_S )
+			var_b = GetVariable( st->b, st->stackB );
 			if ( var_b.evalPtr && var_b.evalPtr->stringPtr ) {
-				idStr::Copynz( var_b.evalPtr->stringPtr, GetString( st->a ), MAX_STRING_LEN );
+				idStr::Copynz( var_b.evalPtr->stringPtr, GetString( st->a, st->stackA ), MAX_STRING_LEN );
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_STOREP_V:
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_STOREP_V )
+			var_b = GetVariable( st->b, st->stackB );
 			if ( var_b.evalPtr && var_b.evalPtr->vectorPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetVariable( st->a, st->stackA );
 				*var_b.evalPtr->vectorPtr = *var_a.vectorPtr;
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_STOREP_FTOS:
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_STOREP_FTOS )
+			var_b = GetVariable( st->b, st->stackB );
 			if ( var_b.evalPtr && var_b.evalPtr->stringPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetVariable( st->a, st->stackA );
 				idStr::Copynz( var_b.evalPtr->stringPtr, FloatToString( *var_a.floatPtr ), MAX_STRING_LEN );
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_STOREP_BTOS:
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_STOREP_BTOS )
+			var_b = GetVariable( st->b, st->stackB );
 			if ( var_b.evalPtr && var_b.evalPtr->stringPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetVariable( st->a, st->stackA );
 				if ( *var_a.floatPtr != 0.0f ) {
 					idStr::Copynz( var_b.evalPtr->stringPtr, "true", MAX_STRING_LEN );
 				} else {
 					idStr::Copynz( var_b.evalPtr->stringPtr, "false", MAX_STRING_LEN );
 				}
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_STOREP_VTOS:
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_STOREP_VTOS )
+			var_b = GetVariable( st->b, st->stackB );
 			if ( var_b.evalPtr && var_b.evalPtr->stringPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetVariable( st->a, st->stackA );
 				idStr::Copynz( var_b.evalPtr->stringPtr, var_a.vectorPtr->ToString(), MAX_STRING_LEN );
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_STOREP_FTOBOOL:
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_STOREP_FTOBOOL )
+			var_b = GetVariable( st->b, st->stackB );
 			if ( var_b.evalPtr && var_b.evalPtr->intPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetVariable( st->a, st->stackA );
 				if ( *var_a.floatPtr != 0.0f ) {
 					*var_b.evalPtr->intPtr = 1;
 				} else {
 					*var_b.evalPtr->intPtr = 0;
 				}
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_STOREP_BOOLTOF:
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_STOREP_BOOLTOF )
+			var_b = GetVariable( st->b, st->stackB );
 			if ( var_b.evalPtr && var_b.evalPtr->floatPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetVariable( st->a, st->stackA );
 				*var_b.evalPtr->floatPtr = static_cast<float>( *var_a.intPtr );
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_STOREP_OBJ:
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_STOREP_OBJ )
+			var_b = GetVariable( st->b, st->stackB );
 			if ( var_b.evalPtr && var_b.evalPtr->entityNumberPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetVariable( st->a, st->stackA );
 				*var_b.evalPtr->entityNumberPtr = *var_a.entityNumberPtr;
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_STOREP_OBJENT:
-			var_b = GetVariable( st->b );
+		SCRIPT_OP( OP_STOREP_OBJENT )
+			var_b = GetVariable( st->b, st->stackB );
 			if ( var_b.evalPtr && var_b.evalPtr->entityNumberPtr ) {
-				var_a = GetVariable( st->a );
+				var_a = GetVariable( st->a, st->stackA );
 				obj = GetScriptObject( *var_a.entityNumberPtr );
 				if ( !obj ) {
 					*var_b.evalPtr->entityNumberPtr = 0;
@@ -1740,162 +1813,165 @@ bool idInterpreter::Execute( void ) {
 				// st->b points to type_pointer, which is just a temporary that gets its type reassigned, so we store the real type in st->c
 				// so that we can do a type check during run time since we don't know what type the script object is at compile time because it
 				// comes from an entity
-				} else if ( !obj->GetTypeDef()->Inherits( st->c->TypeDef() ) ) {
+				} else if ( !obj->GetTypeDef()->Inherits( gameLocal.program.GetStatement( instructionPointer ).c->TypeDef() ) ) {
 					//Warning( "object '%s' cannot be converted to '%s'", obj->GetTypeName(), st->c->TypeDef()->Name() );
 					*var_b.evalPtr->entityNumberPtr = 0;
 				} else {
 					*var_b.evalPtr->entityNumberPtr = *var_a.entityNumberPtr;
 				}
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_ADDRESS:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_ADDRESS )
+			var_a = GetVariable( st->a, st->stackA );
+			var_c = GetVariable( st->c, st->stackC );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				var_c.evalPtr->bytePtr = &obj->data[ st->b->value.ptrOffset ];
+				var_c.evalPtr->bytePtr = &obj->data[ st->b.ptrOffset ];
 			} else {
 				var_c.evalPtr->bytePtr = NULL;
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_INDIRECT_F:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_INDIRECT_F )
+			var_a = GetVariable( st->a, st->stackA );
+			var_c = GetVariable( st->c, st->stackC );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+				var.bytePtr = &obj->data[ st->b.ptrOffset ];
 				*var_c.floatPtr = *var.floatPtr;
 			} else {
 				*var_c.floatPtr = 0.0f;
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_INDIRECT_ENT:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_INDIRECT_ENT )
+			var_a = GetVariable( st->a, st->stackA );
+			var_c = GetVariable( st->c, st->stackC );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+				var.bytePtr = &obj->data[ st->b.ptrOffset ];
 				*var_c.entityNumberPtr = *var.entityNumberPtr;
 			} else {
 				*var_c.entityNumberPtr = 0;
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_INDIRECT_BOOL:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_INDIRECT_BOOL )
+			var_a = GetVariable( st->a, st->stackA );
+			var_c = GetVariable( st->c, st->stackC );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+				var.bytePtr = &obj->data[ st->b.ptrOffset ];
 				*var_c.intPtr = *var.intPtr;
 			} else {
 				*var_c.intPtr = 0;
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_INDIRECT_S:
-			var_a = GetVariable( st->a );
+		SCRIPT_OP( OP_INDIRECT_S )
+			var_a = GetVariable( st->a, st->stackA );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
-				SetString( st->c, var.stringPtr );
+				var.bytePtr = &obj->data[ st->b.ptrOffset ];
+				SetString( st->c, st->stackC, var.stringPtr );
 			} else {
-				SetString( st->c, "" );
+				SetString( st->c, st->stackC, "" );
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_INDIRECT_V:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_INDIRECT_V )
+			var_a = GetVariable( st->a, st->stackA );
+			var_c = GetVariable( st->c, st->stackC );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( obj ) {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+				var.bytePtr = &obj->data[ st->b.ptrOffset ];
 				*var_c.vectorPtr = *var.vectorPtr;
 			} else {
 				var_c.vectorPtr->Zero();
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_INDIRECT_OBJ:
-			var_a = GetVariable( st->a );
-			var_c = GetVariable( st->c );
+		SCRIPT_OP( OP_INDIRECT_OBJ )
+			var_a = GetVariable( st->a, st->stackA );
+			var_c = GetVariable( st->c, st->stackC );
 			obj = GetScriptObject( *var_a.entityNumberPtr );
 			if ( !obj ) {
 				*var_c.entityNumberPtr = 0;
 			} else {
-				var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+				var.bytePtr = &obj->data[ st->b.ptrOffset ];
 				*var_c.entityNumberPtr = *var.entityNumberPtr;
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_PUSH_F:
-			var_a = GetVariable( st->a );
+		SCRIPT_OP( OP_PUSH_F )
+			var_a = GetVariable( st->a, st->stackA );
 			Push( *var_a.intPtr );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_PUSH_FTOS:
-			var_a = GetVariable( st->a );
+		SCRIPT_OP( OP_PUSH_FTOS )
+			var_a = GetVariable( st->a, st->stackA );
 			PushString( FloatToString( *var_a.floatPtr ) );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_PUSH_BTOF:
-			var_a = GetVariable( st->a );
+		SCRIPT_OP( OP_PUSH_BTOF )
+			var_a = GetVariable( st->a, st->stackA );
 			floatVal = *var_a.intPtr;
 			Push( *reinterpret_cast<int *>( &floatVal ) );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_PUSH_FTOB:
-			var_a = GetVariable( st->a );
+		SCRIPT_OP( OP_PUSH_FTOB )
+			var_a = GetVariable( st->a, st->stackA );
 			if ( *var_a.floatPtr != 0.0f ) {
 				Push( 1 );
 			} else {
 				Push( 0 );
 			}
-			break;
+			SCRIPT_NEXT();
 
-		case OP_PUSH_VTOS:
-			var_a = GetVariable( st->a );
+		SCRIPT_OP( OP_PUSH_VTOS )
+			var_a = GetVariable( st->a, st->stackA );
 			PushString( var_a.vectorPtr->ToString() );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_PUSH_BTOS:
-			var_a = GetVariable( st->a );
+		SCRIPT_OP( OP_PUSH_BTOS )
+			var_a = GetVariable( st->a, st->stackA );
 			PushString( *var_a.intPtr ? "true" : "false" );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_PUSH_ENT:
-			var_a = GetVariable( st->a );
+		SCRIPT_OP( OP_PUSH_ENT )
+			var_a = GetVariable( st->a, st->stackA );
 			Push( *var_a.entityNumberPtr );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_PUSH_S:
-			PushString( GetString( st->a ) );
-			break;
+		SCRIPT_OP( OP_PUSH_S )
+			PushString( GetString( st->a, st->stackA ) );
+			SCRIPT_NEXT();
 
-		case OP_PUSH_V:
-			var_a = GetVariable( st->a );
+		SCRIPT_OP( OP_PUSH_V )
+			var_a = GetVariable( st->a, st->stackA );
 			PushVector(*var_a.vectorPtr);
-			break;
+			SCRIPT_NEXT();
 
-		case OP_PUSH_OBJ:
-			var_a = GetVariable( st->a );
+		SCRIPT_OP( OP_PUSH_OBJ )
+			var_a = GetVariable( st->a, st->stackA );
 			Push( *var_a.entityNumberPtr );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_PUSH_OBJENT:
-			var_a = GetVariable( st->a );
+		SCRIPT_OP( OP_PUSH_OBJENT )
+			var_a = GetVariable( st->a, st->stackA );
 			Push( *var_a.entityNumberPtr );
-			break;
+			SCRIPT_NEXT();
 
-		case OP_BREAK:
-		case OP_CONTINUE:
-		default:
+		SCRIPT_OP( OP_BREAK )
+		SCRIPT_OP( OP_CONTINUE )
+		SCRIPT_DEFAULT_OP
 			Error( "Bad opcode %i", st->op );
-			break;
+			SCRIPT_NEXT();
+
+#ifndef ID_SCRIPT_COMPUTED_GOTO
 		}
+#endif
 	}
 
 	return threadDying;
@@ -38,6 +38,12 @@ class idThread;
 #define MAX_STACK_DEPTH	64
 #define LOCALSTACK_SIZE 	(6144 * 2)
 
+// dispatch the script opcodes through a table of label addresses on compilers that
+// support it, the switch statement is used otherwise
+#if defined( __GNUC__ ) && !defined( ID_SCRIPT_SWITCH_DISPATCH )
+#define ID_SCRIPT_COMPUTED_GOTO
+#endif
+
 typedef struct prstack_s {
 	int					s;
 	const function_t	*f;
@@ -73,9 +79,14 @@ private:
 	void				SetString( idVarDef *def, const char *from );
 	const char			*GetString( idVarDef *def );
 	varEval_t			GetVariable( idVarDef *def );
+	void				AppendString( const varEval_t &operand, bool onStack, const char *from );
+	void				SetString( const varEval_t &operand, bool onStack, const char *from );
+	const char			*GetString( const varEval_t &operand, bool onStack );
+	varEval_t			GetVariable( const varEval_t &operand, bool onStack );
 	idEntity			*GetEntity( int entnum ) const;
 	idScriptObject		*GetScriptObject( int entnum ) const;
 	void				NextInstruction( int position );
+	void				DebugInstruction( void );
 
 	void				LeaveFunction( idVarDef *returnDef );
 	void				CallEvent( const function_t *func, int argsize );
@@ -265,6 +276,60 @@ ID_INLINE varEval_t idInterpreter::GetVariable( idVarDef *def ) {
 	}
 }
 
+/*
+====================
+idInterpreter::AppendString
+====================
+*/
+ID_INLINE void idInterpreter::AppendString( const varEval_t &operand, bool onStack, const char *from ) {
+	if ( onStack ) {
+		idStr::Append( ( char * )&localstack[ localstackBase + operand.stackOffset ], MAX_STRING_LEN, from );
+	} else {
+		idStr::Append( operand.stringPtr, MAX_STRING_LEN, from );
+	}
+}
+
+/*
+====================
+idInterpreter::SetString
+====================
+*/
+ID_INLINE void idInterpreter::SetString( const varEval_t &operand, bool onStack, const char *from ) {
+	if ( onStack ) {
+		idStr::Copynz( ( char * )&localstack[ localstackBase + operand.stackOffset ], from, MAX_STRING_LEN );
+	} else {
+		idStr::Copynz( operand.stringPtr, from, MAX_STRING_LEN );
+	}
+}
+
+/*
+====================
+idInterpreter::GetString
+====================
+*/
+ID_INLINE const char *idInterpreter::GetString( const varEval_t &operand, bool onStack ) {
+	if ( onStack ) {
+		return ( char * )&localstack[ localstackBase + operand.stackOffset ];
+	} else {
+		return operand.stringPtr;
+	}
+}
+
+/*
+====================
+idInterpreter::GetVariable
+====================
+*/
+ID_INLINE varEval_t idInterpreter::GetVariable( const varEval_t &operand, bool onStack ) {
+	if ( onStack ) {
+		varEval_t val;
+		val.intPtr = ( int * )&localstack[ localstackBase + operand.stackOffset ];
+		return val;
+	} else {
+		return operand;
+	}
+}
+
 /*
 ================
 idInterpreter::GetEntity
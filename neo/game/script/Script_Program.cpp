@@ -1752,6 +1752,8 @@ Called after all files are compiled to check for errors
 void idProgram::FinishCompilation( void ) {
 	int	i;
 
+	DecodeStatements();
+
 	top_functions	= functions.Num();
 	top_statements	= statements.Num();
 	top_types		= types.Num();
@@ -1806,12 +1808,14 @@ void idProgram::CompileStats( void ) {
 	memallocated = funcMem + memused + sizeof( idProgram );
 
 	memused += statements.MemoryUsed();
+	memused += instructions.MemoryUsed();
 	memused += functions.MemoryUsed();	// name and filename of functions are shared, so no need to include them
 	memused += sizeof( variables );
 
 	gameLocal.Printf( "Memory usage:\n" );
 	gameLocal.Printf( "     Strings: %d, %d bytes\n", fileList.Num(), stringspace );
 	gameLocal.Printf( "  Statements: %d, %zd bytes\n", statements.Num(), statements.MemoryUsed() );
+	gameLocal.Printf( "Instructions: %d, %zd bytes\n", instructions.Num(), instructions.MemoryUsed() );
 	gameLocal.Printf( "   Functions: %d, %d bytes\n", functions.Num(), funcMem );
 	gameLocal.Printf( "   Variables: %d bytes\n", numVariables );
 	gameLocal.Printf( "    Mem used: %d bytes\n", memused );
@@ -1820,6 +1824,45 @@ void idProgram::CompileStats( void ) {
 	gameLocal.Printf( " Thread size: %zd bytes\n", sizeof( idThread ) );
 }
 
+/*
+================
+DecodeOperand
+================
+*/
+static void DecodeOperand( const idVarDef *def, varEval_t &value, bool &onStack ) {
+	if ( !def ) {
+		value.bytePtr = NULL;
+		onStack = false;
+	} else {
+		value = def->value;
+		onStack = ( def->initialized == idVarDef::stackVariable );
+	}
+}
+
+/*
+================
+idProgram::DecodeStatements
+
+Builds the instructions the interpreter executes from the statements.  The whole
+program is decoded again after each compile since compiling may patch statements
+and defs that were emitted by an earlier compile.
+================
+*/
+void idProgram::DecodeStatements( void ) {
+	int i;
+
+	instructions.SetNum( statements.Num() );
+	for( i = 0; i < statements.Num(); i++ ) {
+		const statement_t &statement = statements[ i ];
+		instruction_t &instruction = instructions[ i ];
+
+		instruction.op = statement.op;
+		DecodeOperand( statement.a, instruction.a, instruction.stackA );
+		DecodeOperand( statement.b, instruction.b, instruction.stackB );
+		DecodeOperand( statement.c, instruction.c, instruction.stackC );
+	}
+}
+
 /*
 ================
 idProgram::CompileText
@@ -1837,6 +1880,7 @@ bool idProgram::CompileText( const char *source, const char *text, bool console
 
 	try {
 		compiler.CompileFile( text, filename, console );
+		DecodeStatements();
 
 		// check to make sure all functions prototyped have code
 		for( i = 0; i < varDefs.Num(); i++ ) {
@@ -1945,6 +1989,7 @@ void idProgram::FreeData( void ) {
 	filename.Clear();
 	fileList.Clear();
 	statements.Clear();
+	instructions.Clear();
 	functions.Clear();
 
 	top_functions	= 0;
@@ -2156,6 +2201,7 @@ void idProgram::Restart( void ) {
 	functions.SetNum( top_functions	);
 
 	statements.SetNum( top_statements );
+	instructions.SetNum( top_statements );
 	fileList.SetNum( top_files, false );
 	filename.Clear();
 
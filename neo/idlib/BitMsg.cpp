@@ -640,12 +640,31 @@ idVec3 idBitMsg::BitsToDir( int bits, int numBits ) {
 
 const int MAX_DATA_BUFFER		= 1024;
 
+// recorded writes
+enum {
+	DELTA_RECORD_END,
+	DELTA_RECORD_BITS,
+	DELTA_RECORD_DELTA,
+	DELTA_RECORD_STRING,
+	DELTA_RECORD_DATA,
+	DELTA_RECORD_DICT,
+	DELTA_RECORD_COUNTER
+};
+const int DELTA_RECORD_OP_BITS	= 3;
+
 /*
 ================
 idBitMsgDelta::WriteBits
 ================
 */
 void idBitMsgDelta::WriteBits( int value, int numBits ) {
+	if ( record ) {
+		record->WriteBits( DELTA_RECORD_BITS, DELTA_RECORD_OP_BITS );
+		record->WriteChar( numBits );
+		record->WriteInt( value );
+		return;
+	}
+
 	if ( newBase ) {
 		newBase->WriteBits( value, numBits );
 	}
@@ -671,6 +690,14 @@ idBitMsgDelta::WriteDelta
 ================
 */
 void idBitMsgDelta::WriteDelta( int oldValue, int newValue, int numBits ) {
+	if ( record ) {
+		record->WriteBits( DELTA_RECORD_DELTA, DELTA_RECORD_OP_BITS );
+		record->WriteChar( numBits );
+		record->WriteInt( oldValue );
+		record->WriteInt( newValue );
+		return;
+	}
+
 	if ( newBase ) {
 		newBase->WriteBits( newValue, numBits );
 	}
@@ -768,6 +795,13 @@ idBitMsgDelta::WriteString
 ================
 */
 void idBitMsgDelta::WriteString( const char *s, int maxLength ) {
+	if ( record ) {
+		record->WriteBits( DELTA_RECORD_STRING, DELTA_RECORD_OP_BITS );
+		record->WriteInt( maxLength );
+		record->WriteString( s, -1, false );
+		return;
+	}
+
 	if ( newBase ) {
 		newBase->WriteString( s, maxLength );
 	}
@@ -794,6 +828,13 @@ idBitMsgDelta::WriteData
 ================
 */
 void idBitMsgDelta::WriteData( const void *data, int length ) {
+	if ( record ) {
+		record->WriteBits( DELTA_RECORD_DATA, DELTA_RECORD_OP_BITS );
+		record->WriteInt( length );
+		record->WriteData( data, length );
+		return;
+	}
+
 	if ( newBase ) {
 		newBase->WriteData( data, length );
 	}
@@ -821,6 +862,12 @@ idBitMsgDelta::WriteDict
 ================
 */
 void idBitMsgDelta::WriteDict( const idDict &dict ) {
+	if ( record ) {
+		record->WriteBits( DELTA_RECORD_DICT, DELTA_RECORD_OP_BITS );
+		record->WriteDeltaDict( dict, NULL );
+		return;
+	}
+
 	if ( newBase ) {
 		newBase->WriteDeltaDict( dict, NULL );
 	}
@@ -841,6 +888,11 @@ idBitMsgDelta::WriteDeltaByteCounter
 ================
 */
 void idBitMsgDelta::WriteDeltaByteCounter( int oldValue, int newValue ) {
+	if ( record ) {
+		WriteDeltaCounter( oldValue, newValue, 8 );
+		return;
+	}
+
 	if ( newBase ) {
 		newBase->WriteBits( newValue, 8 );
 	}
@@ -866,6 +918,11 @@ idBitMsgDelta::WriteDeltaShortCounter
 ================
 */
 void idBitMsgDelta::WriteDeltaShortCounter( int oldValue, int newValue ) {
+	if ( record ) {
+		WriteDeltaCounter( oldValue, newValue, 16 );
+		return;
+	}
+
 	if ( newBase ) {
 		newBase->WriteBits( newValue, 16 );
 	}
@@ -891,6 +948,11 @@ idBitMsgDelta::WriteDeltaIntCounter
 ================
 */
 void idBitMsgDelta::WriteDeltaIntCounter( int oldValue, int newValue ) {
+	if ( record ) {
+		WriteDeltaCounter( oldValue, newValue, 32 );
+		return;
+	}
+
 	if ( newBase ) {
 		newBase->WriteBits( newValue, 32 );
 	}
@@ -910,6 +972,83 @@ void idBitMsgDelta::WriteDeltaIntCounter( int oldValue, int newValue ) {
 	}
 }
 
+/*
+================
+idBitMsgDelta::WriteDeltaCounter
+================
+*/
+void idBitMsgDelta::WriteDeltaCounter( int oldValue, int newValue, int numBits ) {
+	record->WriteBits( DELTA_RECORD_COUNTER, DELTA_RECORD_OP_BITS );
+	record->WriteByte( numBits );
+	record->WriteInt( oldValue );
+	record->WriteInt( newValue );
+}
+
+/*
+================
+idBitMsgDelta::Replay
+
+  Writes the values recorded with InitRecord as if the code that recorded
+  them was run with this delta message.
+================
+*/
+void idBitMsgDelta::Replay( const idBitMsg &record ) {
+	int op, numBits, value, oldValue, maxLength, length;
+	char string[MAX_DATA_BUFFER];
+	byte data[MAX_DATA_BUFFER];
+	idDict dict;
+
+	record.BeginReading();
+	while ( record.GetRemainingReadBits() >= DELTA_RECORD_OP_BITS ) {
+		op = record.ReadBits( DELTA_RECORD_OP_BITS );
+		switch( op ) {
+			case DELTA_RECORD_END:
+				return;
+			case DELTA_RECORD_BITS:
+				numBits = record.ReadChar();
+				value = record.ReadInt();
+				WriteBits( value, numBits );
+				break;
+			case DELTA_RECORD_DELTA:
+				numBits = record.ReadChar();
+				oldValue = record.ReadInt();
+				value = record.ReadInt();
+				WriteDelta( oldValue, value, numBits );
+				break;
+			case DELTA_RECORD_STRING:
+				maxLength = record.ReadInt();
+				record.ReadString( string, sizeof( string ) );
+				WriteString( string, maxLength );
+				break;
+			case DELTA_RECORD_DATA:
+				length = record.ReadInt();
+				assert( length < sizeof( data ) );
+				record.ReadData( data, length );
+				WriteData( data, length );
+				break;
+			case DELTA_RECORD_DICT:
+				record.ReadDeltaDict( dict, NULL );
+				WriteDict( dict );
+				break;
+			case DELTA_RECORD_COUNTER:
+				numBits = record.ReadByte();
+				oldValue = record.ReadInt();
+				value = record.ReadInt();
+				if ( numBits == 8 ) {
+					WriteDeltaByteCounter( oldValue, value );
+				} else if ( numBits == 16 ) {
+					WriteDeltaShortCounter( oldValue, value );
+				} else {
+					WriteDeltaIntCounter( oldValue, value );
+				}
+				break;
+			default:
+				idLib::common->Error( "idBitMsgDelta::Replay: bad record op %d", op );
+				break;
+		}
+	}
+}
+
 /*
 ================
 idBitMsgDelta::ReadString
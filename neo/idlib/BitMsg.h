@@ -449,6 +449,11 @@ public:
 	void			Init( const idBitMsg *base, idBitMsg *newBase, const idBitMsg *delta );
 	bool			HasChanged( void ) const;
 
+					// records the values written instead of delta compressing them, so the writes can be
+					// replayed against any number of bases without running the code that wrote them again
+	void			InitRecord( idBitMsg *record );
+	void			Replay( const idBitMsg &record );
+
 	void			WriteBits( int value, int numBits );
 	void			WriteChar( int c );
 	void			WriteByte( int c );
@@ -504,11 +509,13 @@ private:
 	idBitMsg *		newBase;		// new base
 	idBitMsg *		writeDelta;		// delta from base to new base for writing
 	const idBitMsg *readDelta;		// delta from base to new base for reading
+	idBitMsg *		record;			// recorded writes for Replay
 	mutable bool	changed;		// true if the new base is different from the base
 
 private:
 	void			WriteDelta( int oldValue, int newValue, int numBits );
 	int				ReadDelta( int oldValue, int numBits ) const;
+	void			WriteDeltaCounter( int oldValue, int newValue, int numBits );
 };
 
 ID_INLINE idBitMsgDelta::idBitMsgDelta() {
@@ -516,6 +523,7 @@ ID_INLINE idBitMsgDelta::idBitMsgDelta() {
 	newBase = NULL;
 	writeDelta = NULL;
 	readDelta = NULL;
+	record = NULL;
 	changed = false;
 }
 
@@ -524,6 +532,7 @@ ID_INLINE void idBitMsgDelta::Init( const idBitMsg *base, idBitMsg *newBase, idB
 	this->newBase = newBase;
 	this->writeDelta = delta;
 	this->readDelta = delta;
+	this->record = NULL;
 	this->changed = false;
 }
 
@@ -532,9 +541,19 @@ ID_INLINE void idBitMsgDelta::Init( const idBitMsg *base, idBitMsg *newBase, con
 	this->newBase = newBase;
 	this->writeDelta = NULL;
 	this->readDelta = delta;
+	this->record = NULL;
 	this->changed = false;
 }
 
+ID_INLINE void idBitMsgDelta::InitRecord( idBitMsg *record ) {
+	this->base = NULL;
+	this->newBase = NULL;
+	this->writeDelta = NULL;
+	this->readDelta = NULL;
+	this->record = record;
+	this->changed = true;
+}
+
 ID_INLINE bool idBitMsgDelta::HasChanged( void ) const {
 	return changed;
 }
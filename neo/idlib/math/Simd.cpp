@@ -32,6 +32,8 @@ If you have questions concerning this license or the applicable additional terms
 #include <sys/time.h>
 #include <sys/resource.h>
 #include <mach/mach_time.h>
+#elif defined(__GNUC__) && ( defined(__i386__) || defined(__x86_64__) )
+#include <x86intrin.h>			// for __rdtsc()
 #endif
 
 #include "sys/platform.h"
@@ -43,6 +45,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "idlib/math/Simd_SSE.h"
 #include "idlib/math/Simd_SSE2.h"
 #include "idlib/math/Simd_SSE3.h"
+#include "idlib/math/Simd_AVX2.h"
 #include "idlib/math/Simd_AltiVec.h"
 #include "idlib/math/Plane.h"
 #include "idlib/bv/Bounds.h"
@@ -88,6 +91,10 @@ void idSIMD::InitProcessor( const char *module, bool forceGeneric ) {
 		if ( !processor ) {
 			if ( ( cpuid & CPUID_ALTIVEC ) ) {
 				processor = new idSIMD_AltiVec;
+#ifdef ID_HAVE_AVX2_SIMD
+			} else if ( ( cpuid & CPUID_MMX ) && ( cpuid & CPUID_SSE ) && ( cpuid & CPUID_SSE2 ) && ( cpuid & CPUID_SSE3 ) && ( cpuid & CPUID_AVX2 ) ) {
+				processor = new idSIMD_AVX2;
+#endif
 			} else if ( ( cpuid & CPUID_MMX ) && ( cpuid & CPUID_SSE ) && ( cpuid & CPUID_SSE2 ) && ( cpuid & CPUID_SSE3 ) ) {
 				processor = new idSIMD_SSE3;
 			} else if ( ( cpuid & CPUID_MMX ) && ( cpuid & CPUID_SSE ) && ( cpuid & CPUID_SSE2 ) ) {
@@ -187,6 +194,17 @@ double ticksPerNanosecond;
 #define StopRecordTime( end )				\
 	end = mach_absolute_time();
 
+#elif defined(__GNUC__) && ( defined(__i386__) || defined(__x86_64__) )
+
+#define TIME_TYPE int
+
+// only the low 32 bits are kept, the differences are way below that
+#define StartRecordTime( start )			\
+	start = (int)__rdtsc();
+
+#define StopRecordTime( end )				\
+	end = (int)__rdtsc();
+
 #else
 
 #define TIME_TYPE int
@@ -221,7 +239,8 @@ void PrintClocks( const char *string, int dataCount, int clocks, int otherClocks
 	if ( otherClocks && clocks ) {
 		otherClocks -= baseClocks;
 		int p = (int) ( (float) ( otherClocks - clocks ) * 100.0f / (float) otherClocks );
-		idLib::common->Printf( "c = %4d, clcks = %5d, %d%%\n", dataCount, clocks, p );
+		float speedup = (float) otherClocks / (float) clocks;
+		idLib::common->Printf( "c = %4d, clcks = %5d, %d%% (%.2fx)\n", dataCount, clocks, p, speedup );
 	} else {
 		idLib::common->Printf( "c = %4d, clcks = %5d\n", dataCount, clocks );
 	}
@@ -4038,6 +4057,14 @@ void idSIMD::Test_f( const idCmdArgs &args ) {
 				return;
 			}
 			p_simd = new idSIMD_SSE3();
+#ifdef ID_HAVE_AVX2_SIMD
+		} else if ( idStr::Icmp( argString, "AVX2" ) == 0 ) {
+			if ( !( cpuid & CPUID_MMX ) || !( cpuid & CPUID_SSE ) || !( cpuid & CPUID_SSE2 ) || !( cpuid & CPUID_SSE3 ) || !( cpuid & CPUID_AVX2 ) ) {
+				common->Printf( "CPU does not support MMX & SSE & SSE2 & SSE3 & AVX2\n" );
+				return;
+			}
+			p_simd = new idSIMD_AVX2();
+#endif
 		} else if ( idStr::Icmp( argString, "AltiVec" ) == 0 ) {
 			if ( !( cpuid & CPUID_ALTIVEC ) ) {
 				common->Printf( "CPU does not support AltiVec\n" );
@@ -4045,7 +4072,7 @@ void idSIMD::Test_f( const idCmdArgs &args ) {
 			}
 			p_simd = new idSIMD_AltiVec();
 		} else {
-			common->Printf( "invalid argument, use: MMX, 3DNow, SSE, SSE2, SSE3, AltiVec\n" );
+			common->Printf( "invalid argument, use: MMX, 3DNow, SSE, SSE2, SSE3, AVX2, AltiVec\n" );
 			return;
 		}
 	}
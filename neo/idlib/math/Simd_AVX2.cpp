@@ -0,0 +1,2267 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "sys/platform.h"
+#include "idlib/geometry/DrawVert.h"
+#include "idlib/geometry/JointTransform.h"
+#include "idlib/math/Vector.h"
+#include "idlib/math/Plane.h"
+#include "renderer/Model.h"
+
+#include "idlib/math/Simd_AVX2.h"
+
+//===============================================================
+//
+//	AVX2 implementation of idSIMDProcessor
+//
+//===============================================================
+
+#ifdef ID_HAVE_AVX2_SIMD
+
+#include <immintrin.h>
+
+#define DRAWVERT_FLOATS				15
+#define DRAWVERT_XYZ_OFFSET			0
+#define DRAWVERT_ST_OFFSET			3
+#define DRAWVERT_NORMAL_OFFSET		5
+#define DRAWVERT_TANGENT0_OFFSET	8
+#define DRAWVERT_TANGENT1_OFFSET	11
+
+#define JOINTQUAT_FLOATS			7
+
+/*
+============
+Transpose4x4x2
+
+  Transposes the 4x4 matrices in the low and high lanes. The strided data structures
+  are loaded with 4 wide loads and transposed instead of using gathers, which are
+  microcoded and slow on most CPUs. Everything is written out without loops so the
+  compiler keeps it all in registers.
+============
+*/
+static inline AVX2_TARGET void Transpose4x4x2( const __m256 a0, const __m256 a1, const __m256 a2, const __m256 a3, __m256 c[4] ) {
+	const __m256 t0 = _mm256_unpacklo_ps( a0, a1 );
+	const __m256 t1 = _mm256_unpacklo_ps( a2, a3 );
+	const __m256 t2 = _mm256_unpackhi_ps( a0, a1 );
+	const __m256 t3 = _mm256_unpackhi_ps( a2, a3 );
+	c[0] = _mm256_shuffle_ps( t0, t1, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+	c[1] = _mm256_shuffle_ps( t0, t1, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+	c[2] = _mm256_shuffle_ps( t2, t3, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+	c[3] = _mm256_shuffle_ps( t2, t3, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+}
+
+/*
+============
+LoadRows4
+
+  c[k][n] = r[n][k] for the eight rows of four floats at r0 ... r7
+============
+*/
+static inline AVX2_TARGET void LoadRows4( const float *r0, const float *r1, const float *r2, const float *r3,
+											const float *r4, const float *r5, const float *r6, const float *r7, __m256 c[4] ) {
+	const __m256 a0 = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( r0 ) ), _mm_loadu_ps( r4 ), 1 );
+	const __m256 a1 = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( r1 ) ), _mm_loadu_ps( r5 ), 1 );
+	const __m256 a2 = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( r2 ) ), _mm_loadu_ps( r6 ), 1 );
+	const __m256 a3 = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( r3 ) ), _mm_loadu_ps( r7 ), 1 );
+	Transpose4x4x2( a0, a1, a2, a3, c );
+}
+
+/*
+============
+LoadStrided4
+
+  c[k][n] = src[n * stride + k], the four floats of every element must be readable
+============
+*/
+static inline AVX2_TARGET void LoadStrided4( const float *src, const int stride, __m256 c[4] ) {
+	LoadRows4( src + 0 * stride, src + 1 * stride, src + 2 * stride, src + 3 * stride,
+				src + 4 * stride, src + 5 * stride, src + 6 * stride, src + 7 * stride, c );
+}
+
+/*
+============
+LoadIndexed4
+
+  c[k][n] = src[index[n] * stride + k]
+============
+*/
+static inline AVX2_TARGET void LoadIndexed4( const float *src, const int stride, const int *index, __m256 c[4] ) {
+	LoadRows4( src + index[0] * stride, src + index[1] * stride, src + index[2] * stride, src + index[3] * stride,
+				src + index[4] * stride, src + index[5] * stride, src + index[6] * stride, src + index[7] * stride, c );
+}
+
+/*
+============
+LoadVec3
+
+  loads eight consecutive idVec3 without reading past the last one
+============
+*/
+static inline AVX2_TARGET void LoadVec3( const idVec3 *src, __m256 c[4] ) {
+	const float *p = src->ToFloatPtr();
+	__m128 last = _mm_loadu_ps( p + 7 * 3 - 1 );
+	last = _mm_shuffle_ps( last, last, _MM_SHUFFLE( 3, 3, 2, 1 ) );
+	const __m256 a0 = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( p + 0 ) ), _mm_loadu_ps( p + 12 ), 1 );
+	const __m256 a1 = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( p + 3 ) ), _mm_loadu_ps( p + 15 ), 1 );
+	const __m256 a2 = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( p + 6 ) ), _mm_loadu_ps( p + 18 ), 1 );
+	const __m256 a3 = _mm256_insertf128_ps( _mm256_castps128_ps256( _mm_loadu_ps( p + 9 ) ), last, 1 );
+	Transpose4x4x2( a0, a1, a2, a3, c );
+}
+
+/*
+============
+StoreRows4
+
+  r[n][k] = c[k][n], writes four floats to each of the eight rows in order
+============
+*/
+static inline AVX2_TARGET void StoreRows4( float *r0, float *r1, float *r2, float *r3,
+											float *r4, float *r5, float *r6, float *r7, const __m256 c[4] ) {
+	__m256 a[4];
+	Transpose4x4x2( c[0], c[1], c[2], c[3], a );
+	_mm_storeu_ps( r0, _mm256_castps256_ps128( a[0] ) );
+	_mm_storeu_ps( r1, _mm256_castps256_ps128( a[1] ) );
+	_mm_storeu_ps( r2, _mm256_castps256_ps128( a[2] ) );
+	_mm_storeu_ps( r3, _mm256_castps256_ps128( a[3] ) );
+	_mm_storeu_ps( r4, _mm256_extractf128_ps( a[0], 1 ) );
+	_mm_storeu_ps( r5, _mm256_extractf128_ps( a[1], 1 ) );
+	_mm_storeu_ps( r6, _mm256_extractf128_ps( a[2], 1 ) );
+	_mm_storeu_ps( r7, _mm256_extractf128_ps( a[3], 1 ) );
+}
+
+/*
+============
+StoreVec3
+
+  stores eight consecutive idVec3 from c[0] ... c[2] without writing past the last one
+============
+*/
+static inline AVX2_TARGET void StoreVec3( idVec3 *dst, const __m256 c[4] ) {
+	float *p = dst->ToFloatPtr();
+	__m256 a[4];
+	Transpose4x4x2( c[0], c[1], c[2], c[2], a );
+	_mm_storeu_ps( p + 0, _mm256_castps256_ps128( a[0] ) );
+	_mm_storeu_ps( p + 3, _mm256_castps256_ps128( a[1] ) );
+	_mm_storeu_ps( p + 6, _mm256_castps256_ps128( a[2] ) );
+	_mm_storeu_ps( p + 9, _mm256_castps256_ps128( a[3] ) );
+	_mm_storeu_ps( p + 12, _mm256_extractf128_ps( a[0], 1 ) );
+	_mm_storeu_ps( p + 15, _mm256_extractf128_ps( a[1], 1 ) );
+	_mm_storeu_ps( p + 18, _mm256_extractf128_ps( a[2], 1 ) );
+	const __m128 last = _mm256_extractf128_ps( a[3], 1 );
+	_mm_storel_pi( (__m64 *)( p + 21 ), last );
+	_mm_store_ss( p + 23, _mm_movehl_ps( last, last ) );
+}
+
+/*
+============
+AllUsed
+
+  returns true if all eight flags starting at used are set
+============
+*/
+static ID_INLINE bool AllUsed( const bool *used ) {
+	unsigned long long bits;
+	memcpy( &bits, used, sizeof( bits ) );
+	return bits == 0x0101010101010101ULL;
+}
+
+/*
+============
+StoreStrided4
+
+  dst[n * stride + k] = c[k][n]
+============
+*/
+static inline AVX2_TARGET void StoreStrided4( float *dst, const int stride, const __m256 c[4] ) {
+	StoreRows4( dst + 0 * stride, dst + 1 * stride, dst + 2 * stride, dst + 3 * stride,
+				dst + 4 * stride, dst + 5 * stride, dst + 6 * stride, dst + 7 * stride, c );
+}
+
+/*
+============
+ReciprocalSqrt
+
+  rsqrt estimate refined with one Newton-Raphson step, zero maps to a large finite value like idMath::RSqrt
+============
+*/
+static inline AVX2_TARGET __m256 ReciprocalSqrt( __m256 x ) {
+	x = _mm256_max_ps( x, _mm256_set1_ps( 1e-30f ) );
+	const __m256 r = _mm256_rsqrt_ps( x );
+	const __m256 hx = _mm256_mul_ps( x, _mm256_set1_ps( 0.5f ) );
+	return _mm256_mul_ps( r, _mm256_sub_ps( _mm256_set1_ps( 1.5f ), _mm256_mul_ps( hx, _mm256_mul_ps( r, r ) ) ) );
+}
+
+/*
+============
+SignBits
+
+  returns the IEEE sign bit of each float as 0 or 1 in the corresponding integer lane
+============
+*/
+static inline AVX2_TARGET __m256i SignBits( const __m256 v ) {
+	return _mm256_srli_epi32( _mm256_castps_si256( v ), 31 );
+}
+
+/*
+============
+PackBytes
+
+  packs eight integers in the range [0, 255] into eight consecutive bytes
+============
+*/
+static inline AVX2_TARGET __m128i PackBytes( const __m256i v ) {
+	__m128i w = _mm_packs_epi32( _mm256_castsi256_si128( v ), _mm256_extracti128_si256( v, 1 ) );
+	return _mm_packus_epi16( w, w );
+}
+
+/*
+============
+StoreCompareBytes
+
+  stores the result of an eight wide compare as bytes, either as 0/1 or or'ed in as bit 'bitNum'
+============
+*/
+static inline AVX2_TARGET void StoreCompareBytes( byte *dst, const __m256 cmp ) {
+	const __m256i bits = _mm256_and_si256( _mm256_castps_si256( cmp ), _mm256_set1_epi32( 1 ) );
+	_mm_storel_epi64( (__m128i *)dst, PackBytes( bits ) );
+}
+
+static inline AVX2_TARGET void OrCompareBytes( byte *dst, const byte bitNum, const __m256 cmp ) {
+	__m256i bits = _mm256_and_si256( _mm256_castps_si256( cmp ), _mm256_set1_epi32( 1 ) );
+	bits = _mm256_sll_epi32( bits, _mm_cvtsi32_si128( bitNum ) );
+	_mm_storel_epi64( (__m128i *)dst, _mm_or_si128( _mm_loadl_epi64( (const __m128i *)dst ), PackBytes( bits ) ) );
+}
+
+/*
+============
+idSIMD_AVX2::GetName
+============
+*/
+const char * idSIMD_AVX2::GetName( void ) const {
+	return "MMX & SSE & SSE2 & SSE3 & AVX2";
+}
+
+/*
+============
+idSIMD_AVX2::Add
+
+  dst[i] = constant + src[i];
+============
+*/
+void VPCALL idSIMD_AVX2::Add( float *dst, const float constant, const float *src, const int count ) {
+	const __m256 c = _mm256_set1_ps( constant );
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		_mm256_storeu_ps( dst + i, _mm256_add_ps( _mm256_loadu_ps( src + i ), c ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = src[i] + constant;
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Add
+
+  dst[i] = src0[i] + src1[i];
+============
+*/
+void VPCALL idSIMD_AVX2::Add( float *dst, const float *src0, const float *src1, const int count ) {
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		_mm256_storeu_ps( dst + i, _mm256_add_ps( _mm256_loadu_ps( src0 + i ), _mm256_loadu_ps( src1 + i ) ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = src0[i] + src1[i];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Sub
+
+  dst[i] = constant - src[i];
+============
+*/
+void VPCALL idSIMD_AVX2::Sub( float *dst, const float constant, const float *src, const int count ) {
+	const __m256 c = _mm256_set1_ps( constant );
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		_mm256_storeu_ps( dst + i, _mm256_sub_ps( c, _mm256_loadu_ps( src + i ) ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant - src[i];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Sub
+
+  dst[i] = src0[i] - src1[i];
+============
+*/
+void VPCALL idSIMD_AVX2::Sub( float *dst, const float *src0, const float *src1, const int count ) {
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		_mm256_storeu_ps( dst + i, _mm256_sub_ps( _mm256_loadu_ps( src0 + i ), _mm256_loadu_ps( src1 + i ) ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = src0[i] - src1[i];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Mul
+
+  dst[i] = constant * src[i];
+============
+*/
+void VPCALL idSIMD_AVX2::Mul( float *dst, const float constant, const float *src, const int count ) {
+	const __m256 c = _mm256_set1_ps( constant );
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		_mm256_storeu_ps( dst + i, _mm256_mul_ps( c, _mm256_loadu_ps( src + i ) ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant * src[i];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Mul
+
+  dst[i] = src0[i] * src1[i];
+============
+*/
+void VPCALL idSIMD_AVX2::Mul( float *dst, const float *src0, const float *src1, const int count ) {
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		_mm256_storeu_ps( dst + i, _mm256_mul_ps( _mm256_loadu_ps( src0 + i ), _mm256_loadu_ps( src1 + i ) ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = src0[i] * src1[i];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Div
+
+  dst[i] = constant / src[i];
+============
+*/
+void VPCALL idSIMD_AVX2::Div( float *dst, const float constant, const float *src, const int count ) {
+	const __m256 c = _mm256_set1_ps( constant );
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		_mm256_storeu_ps( dst + i, _mm256_div_ps( c, _mm256_loadu_ps( src + i ) ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant / src[i];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Div
+
+  dst[i] = src0[i] / src1[i];
+============
+*/
+void VPCALL idSIMD_AVX2::Div( float *dst, const float *src0, const float *src1, const int count ) {
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		_mm256_storeu_ps( dst + i, _mm256_div_ps( _mm256_loadu_ps( src0 + i ), _mm256_loadu_ps( src1 + i ) ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = src0[i] / src1[i];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MulAdd
+
+  dst[i] += constant * src[i];
+============
+*/
+void VPCALL idSIMD_AVX2::MulAdd( float *dst, const float constant, const float *src, const int count ) {
+	const __m256 c = _mm256_set1_ps( constant );
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		_mm256_storeu_ps( dst + i, _mm256_add_ps( _mm256_mul_ps( c, _mm256_loadu_ps( src + i ) ), _mm256_loadu_ps( dst + i ) ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] += constant * src[i];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MulAdd
+
+  dst[i] += src0[i] * src1[i];
+============
+*/
+void VPCALL idSIMD_AVX2::MulAdd( float *dst, const float *src0, const float *src1, const int count ) {
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		_mm256_storeu_ps( dst + i, _mm256_add_ps( _mm256_mul_ps( _mm256_loadu_ps( src0 + i ), _mm256_loadu_ps( src1 + i ) ), _mm256_loadu_ps( dst + i ) ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] += src0[i] * src1[i];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MulSub
+
+  dst[i] -= constant * src[i];
+============
+*/
+void VPCALL idSIMD_AVX2::MulSub( float *dst, const float constant, const float *src, const int count ) {
+	const __m256 c = _mm256_set1_ps( constant );
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		_mm256_storeu_ps( dst + i, _mm256_sub_ps( _mm256_loadu_ps( dst + i ), _mm256_mul_ps( c, _mm256_loadu_ps( src + i ) ) ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] -= constant * src[i];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MulSub
+
+  dst[i] -= src0[i] * src1[i];
+============
+*/
+void VPCALL idSIMD_AVX2::MulSub( float *dst, const float *src0, const float *src1, const int count ) {
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		_mm256_storeu_ps( dst + i, _mm256_sub_ps( _mm256_loadu_ps( dst + i ), _mm256_mul_ps( _mm256_loadu_ps( src0 + i ), _mm256_loadu_ps( src1 + i ) ) ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] -= src0[i] * src1[i];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Dot
+
+  dst[i] = constant * src[i];
+============
+*/
+void VPCALL idSIMD_AVX2::Dot( float *dst, const idVec3 &constant, const idVec3 *src, const int count ) {
+	const __m256 cx = _mm256_set1_ps( constant.x );
+	const __m256 cy = _mm256_set1_ps( constant.y );
+	const __m256 cz = _mm256_set1_ps( constant.z );
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		__m256 v[4];
+		LoadVec3( src + i, v );
+		__m256 d = _mm256_mul_ps( cx, v[0] );
+		d = _mm256_add_ps( _mm256_mul_ps( cy, v[1] ), d );
+		d = _mm256_add_ps( _mm256_mul_ps( cz, v[2] ), d );
+		_mm256_storeu_ps( dst + i, d );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant * src[i];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Dot
+
+  dst[i] = constant * src[i].Normal() + src[i][3];
+============
+*/
+void VPCALL idSIMD_AVX2::Dot( float *dst, const idVec3 &constant, const idPlane *src, const int count ) {
+	const __m256 cx = _mm256_set1_ps( constant.x );
+	const __m256 cy = _mm256_set1_ps( constant.y );
+	const __m256 cz = _mm256_set1_ps( constant.z );
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		__m256 p[4];
+		LoadStrided4( src[i].ToFloatPtr(), 4, p );
+		__m256 d = _mm256_add_ps( _mm256_mul_ps( cx, p[0] ), p[3] );
+		d = _mm256_add_ps( _mm256_mul_ps( cy, p[1] ), d );
+		d = _mm256_add_ps( _mm256_mul_ps( cz, p[2] ), d );
+		_mm256_storeu_ps( dst + i, d );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant * src[i].Normal() + src[i][3];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Dot
+
+  dst[i] = constant * src[i].xyz;
+============
+*/
+void VPCALL idSIMD_AVX2::Dot( float *dst, const idVec3 &constant, const idDrawVert *src, const int count ) {
+	const __m256 cx = _mm256_set1_ps( constant.x );
+	const __m256 cy = _mm256_set1_ps( constant.y );
+	const __m256 cz = _mm256_set1_ps( constant.z );
+
+	assert( sizeof( idDrawVert ) == DRAWVERT_FLOATS * sizeof( float ) );
+
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		__m256 v[4];
+		LoadStrided4( src[i].xyz.ToFloatPtr(), DRAWVERT_FLOATS, v );
+		__m256 d = _mm256_mul_ps( cx, v[0] );
+		d = _mm256_add_ps( _mm256_mul_ps( cy, v[1] ), d );
+		d = _mm256_add_ps( _mm256_mul_ps( cz, v[2] ), d );
+		_mm256_storeu_ps( dst + i, d );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant * src[i].xyz;
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Dot
+
+  dst[i] = constant.Normal() * src[i] + constant[3];
+============
+*/
+void VPCALL idSIMD_AVX2::Dot( float *dst, const idPlane &constant, const idVec3 *src, const int count ) {
+	const __m256 cx = _mm256_set1_ps( constant[0] );
+	const __m256 cy = _mm256_set1_ps( constant[1] );
+	const __m256 cz = _mm256_set1_ps( constant[2] );
+	const __m256 cd = _mm256_set1_ps( constant[3] );
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		__m256 v[4];
+		LoadVec3( src + i, v );
+		__m256 d = _mm256_add_ps( _mm256_mul_ps( cx, v[0] ), cd );
+		d = _mm256_add_ps( _mm256_mul_ps( cy, v[1] ), d );
+		d = _mm256_add_ps( _mm256_mul_ps( cz, v[2] ), d );
+		_mm256_storeu_ps( dst + i, d );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant.Normal() * src[i] + constant[3];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Dot
+
+  dst[i] = constant.Normal() * src[i].Normal() + constant[3] * src[i][3];
+============
+*/
+void VPCALL idSIMD_AVX2::Dot( float *dst, const idPlane &constant, const idPlane *src, const int count ) {
+	const __m256 cx = _mm256_set1_ps( constant[0] );
+	const __m256 cy = _mm256_set1_ps( constant[1] );
+	const __m256 cz = _mm256_set1_ps( constant[2] );
+	const __m256 cd = _mm256_set1_ps( constant[3] );
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		__m256 p[4];
+		LoadStrided4( src[i].ToFloatPtr(), 4, p );
+		__m256 d = _mm256_mul_ps( cd, p[3] );
+		d = _mm256_add_ps( _mm256_mul_ps( cx, p[0] ), d );
+		d = _mm256_add_ps( _mm256_mul_ps( cy, p[1] ), d );
+		d = _mm256_add_ps( _mm256_mul_ps( cz, p[2] ), d );
+		_mm256_storeu_ps( dst + i, d );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant.Normal() * src[i].Normal() + constant[3] * src[i][3];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Dot
+
+  dst[i] = constant.Normal() * src[i].xyz + constant[3];
+============
+*/
+void VPCALL idSIMD_AVX2::Dot( float *dst, const idPlane &constant, const idDrawVert *src, const int count ) {
+	const __m256 cx = _mm256_set1_ps( constant[0] );
+	const __m256 cy = _mm256_set1_ps( constant[1] );
+	const __m256 cz = _mm256_set1_ps( constant[2] );
+	const __m256 cd = _mm256_set1_ps( constant[3] );
+
+	assert( sizeof( idDrawVert ) == DRAWVERT_FLOATS * sizeof( float ) );
+
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		__m256 v[4];
+		LoadStrided4( src[i].xyz.ToFloatPtr(), DRAWVERT_FLOATS, v );
+		__m256 d = _mm256_add_ps( _mm256_mul_ps( cx, v[0] ), cd );
+		d = _mm256_add_ps( _mm256_mul_ps( cy, v[1] ), d );
+		d = _mm256_add_ps( _mm256_mul_ps( cz, v[2] ), d );
+		_mm256_storeu_ps( dst + i, d );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = constant.Normal() * src[i].xyz + constant[3];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Dot
+
+  dst[i] = src0[i] * src1[i];
+============
+*/
+void VPCALL idSIMD_AVX2::Dot( float *dst, const idVec3 *src0, const idVec3 *src1, const int count ) {
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		__m256 a[4], b[4];
+		LoadVec3( src0 + i, a );
+		LoadVec3( src1 + i, b );
+		__m256 d = _mm256_mul_ps( a[0], b[0] );
+		d = _mm256_add_ps( _mm256_mul_ps( a[1], b[1] ), d );
+		d = _mm256_add_ps( _mm256_mul_ps( a[2], b[2] ), d );
+		_mm256_storeu_ps( dst + i, d );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = src0[i] * src1[i];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Dot
+
+  dot = src1[0] * src2[0] + src1[1] * src2[1] + src1[2] * src2[2] + ...
+
+  accumulates in double precision like the generic version
+============
+*/
+void VPCALL idSIMD_AVX2::Dot( float &dot, const float *src1, const float *src2, const int count ) {
+	__m256d s0 = _mm256_setzero_pd();
+	__m256d s1 = _mm256_setzero_pd();
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		const __m256 a = _mm256_loadu_ps( src1 + i );
+		const __m256 b = _mm256_loadu_ps( src2 + i );
+		s0 = _mm256_add_pd( _mm256_mul_pd( _mm256_cvtps_pd( _mm256_castps256_ps128( a ) ), _mm256_cvtps_pd( _mm256_castps256_ps128( b ) ) ), s0 );
+		s1 = _mm256_add_pd( _mm256_mul_pd( _mm256_cvtps_pd( _mm256_extractf128_ps( a, 1 ) ), _mm256_cvtps_pd( _mm256_extractf128_ps( b, 1 ) ) ), s1 );
+	}
+	s0 = _mm256_add_pd( s0, s1 );
+	__m128d s = _mm_add_pd( _mm256_castpd256_pd128( s0 ), _mm256_extractf128_pd( s0, 1 ) );
+	double sum = _mm_cvtsd_f64( _mm_add_sd( s, _mm_unpackhi_pd( s, s ) ) );
+	for ( ; i < count; i++ ) {
+		sum += src1[i] * src2[i];
+	}
+	dot = sum;
+}
+
+/*
+============
+idSIMD_AVX2::CmpGT
+
+  dst[i] = src0[i] > constant;
+============
+*/
+void VPCALL idSIMD_AVX2::CmpGT( byte *dst, const float *src0, const float constant, const int count ) {
+	const __m256 c = _mm256_set1_ps( constant );
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		StoreCompareBytes( dst + i, _mm256_cmp_ps( _mm256_loadu_ps( src0 + i ), c, _CMP_GT_OQ ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = src0[i] > constant;
+	}
+}
+
+/*
+============
+idSIMD_AVX2::CmpGT
+
+  dst[i] |= ( src0[i] > constant ) << bitNum;
+============
+*/
+void VPCALL idSIMD_AVX2::CmpGT( byte *dst, const byte bitNum, const float *src0, const float constant, const int count ) {
+	const __m256 c = _mm256_set1_ps( constant );
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		OrCompareBytes( dst + i, bitNum, _mm256_cmp_ps( _mm256_loadu_ps( src0 + i ), c, _CMP_GT_OQ ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] |= ( src0[i] > constant ) << bitNum;
+	}
+}
+
+/*
+============
+idSIMD_AVX2::CmpGE
+
+  dst[i] = src0[i] >= constant;
+============
+*/
+void VPCALL idSIMD_AVX2::CmpGE( byte *dst, const float *src0, const float constant, const int count ) {
+	const __m256 c = _mm256_set1_ps( constant );
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		StoreCompareBytes( dst + i, _mm256_cmp_ps( _mm256_loadu_ps( src0 + i ), c, _CMP_GE_OQ ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = src0[i] >= constant;
+	}
+}
+
+/*
+============
+idSIMD_AVX2::CmpGE
+
+  dst[i] |= ( src0[i] >= constant ) << bitNum;
+============
+*/
+void VPCALL idSIMD_AVX2::CmpGE( byte *dst, const byte bitNum, const float *src0, const float constant, const int count ) {
+	const __m256 c = _mm256_set1_ps( constant );
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		OrCompareBytes( dst + i, bitNum, _mm256_cmp_ps( _mm256_loadu_ps( src0 + i ), c, _CMP_GE_OQ ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] |= ( src0[i] >= constant ) << bitNum;
+	}
+}
+
+/*
+============
+idSIMD_AVX2::CmpLT
+
+  dst[i] = src0[i] < constant;
+============
+*/
+void VPCALL idSIMD_AVX2::CmpLT( byte *dst, const float *src0, const float constant, const int count ) {
+	const __m256 c = _mm256_set1_ps( constant );
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		StoreCompareBytes( dst + i, _mm256_cmp_ps( _mm256_loadu_ps( src0 + i ), c, _CMP_LT_OQ ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = src0[i] < constant;
+	}
+}
+
+/*
+============
+idSIMD_AVX2::CmpLT
+
+  dst[i] |= ( src0[i] < constant ) << bitNum;
+============
+*/
+void VPCALL idSIMD_AVX2::CmpLT( byte *dst, const byte bitNum, const float *src0, const float constant, const int count ) {
+	const __m256 c = _mm256_set1_ps( constant );
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		OrCompareBytes( dst + i, bitNum, _mm256_cmp_ps( _mm256_loadu_ps( src0 + i ), c, _CMP_LT_OQ ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] |= ( src0[i] < constant ) << bitNum;
+	}
+}
+
+/*
+============
+idSIMD_AVX2::CmpLE
+
+  dst[i] = src0[i] <= constant;
+============
+*/
+void VPCALL idSIMD_AVX2::CmpLE( byte *dst, const float *src0, const float constant, const int count ) {
+	const __m256 c = _mm256_set1_ps( constant );
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		StoreCompareBytes( dst + i, _mm256_cmp_ps( _mm256_loadu_ps( src0 + i ), c, _CMP_LE_OQ ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = src0[i] <= constant;
+	}
+}
+
+/*
+============
+idSIMD_AVX2::CmpLE
+
+  dst[i] |= ( src0[i] <= constant ) << bitNum;
+============
+*/
+void VPCALL idSIMD_AVX2::CmpLE( byte *dst, const byte bitNum, const float *src0, const float constant, const int count ) {
+	const __m256 c = _mm256_set1_ps( constant );
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		OrCompareBytes( dst + i, bitNum, _mm256_cmp_ps( _mm256_loadu_ps( src0 + i ), c, _CMP_LE_OQ ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] |= ( src0[i] <= constant ) << bitNum;
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MinMax
+============
+*/
+void VPCALL idSIMD_AVX2::MinMax( float &min, float &max, const float *src, const int count ) {
+	__m256 vmin = _mm256_set1_ps( idMath::INFINITY );
+	__m256 vmax = _mm256_set1_ps( -idMath::INFINITY );
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		const __m256 v = _mm256_loadu_ps( src + i );
+		vmin = _mm256_min_ps( vmin, v );
+		vmax = _mm256_max_ps( vmax, v );
+	}
+	ALIGN16( float mins[8] );
+	ALIGN16( float maxs[8] );
+	_mm256_storeu_ps( mins, vmin );
+	_mm256_storeu_ps( maxs, vmax );
+	min = idMath::INFINITY; max = -idMath::INFINITY;
+	for ( int j = 0; j < 8; j++ ) {
+		if ( mins[j] < min ) { min = mins[j]; }
+		if ( maxs[j] > max ) { max = maxs[j]; }
+	}
+	for ( ; i < count; i++ ) {
+		if ( src[i] < min ) { min = src[i]; }
+		if ( src[i] > max ) { max = src[i]; }
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MinMax
+============
+*/
+void VPCALL idSIMD_AVX2::MinMax( idVec2 &min, idVec2 &max, const idVec2 *src, const int count ) {
+	__m256 vmin = _mm256_set1_ps( idMath::INFINITY );
+	__m256 vmax = _mm256_set1_ps( -idMath::INFINITY );
+	int i = 0;
+	for ( ; i + 4 <= count; i += 4 ) {
+		const __m256 v = _mm256_loadu_ps( src[i].ToFloatPtr() );
+		vmin = _mm256_min_ps( vmin, v );
+		vmax = _mm256_max_ps( vmax, v );
+	}
+	ALIGN16( float mins[8] );
+	ALIGN16( float maxs[8] );
+	_mm256_storeu_ps( mins, vmin );
+	_mm256_storeu_ps( maxs, vmax );
+	min[0] = min[1] = idMath::INFINITY; max[0] = max[1] = -idMath::INFINITY;
+	for ( int j = 0; j < 8; j++ ) {
+		if ( mins[j] < min[j&1] ) { min[j&1] = mins[j]; }
+		if ( maxs[j] > max[j&1] ) { max[j&1] = maxs[j]; }
+	}
+	for ( ; i < count; i++ ) {
+		const idVec2 &v = src[i];
+		if ( v[0] < min[0] ) { min[0] = v[0]; } if ( v[0] > max[0] ) { max[0] = v[0]; }
+		if ( v[1] < min[1] ) { min[1] = v[1]; } if ( v[1] > max[1] ) { max[1] = v[1]; }
+	}
+}
+
+/*
+============
+MinMax3
+
+  keeps track of the eight wide min and max of idVec3 components
+============
+*/
+static inline AVX2_TARGET void MinMax3Init( __m256 mm[6] ) {
+	mm[0] = mm[1] = mm[2] = _mm256_set1_ps( idMath::INFINITY );
+	mm[3] = mm[4] = mm[5] = _mm256_set1_ps( -idMath::INFINITY );
+}
+
+static inline AVX2_TARGET void MinMax3Add( __m256 mm[6], const __m256 v[4] ) {
+	mm[0] = _mm256_min_ps( mm[0], v[0] );
+	mm[1] = _mm256_min_ps( mm[1], v[1] );
+	mm[2] = _mm256_min_ps( mm[2], v[2] );
+	mm[3] = _mm256_max_ps( mm[3], v[0] );
+	mm[4] = _mm256_max_ps( mm[4], v[1] );
+	mm[5] = _mm256_max_ps( mm[5], v[2] );
+}
+
+static inline AVX2_TARGET void MinMax3Resolve( idVec3 &min, idVec3 &max, const __m256 mm[6] ) {
+	ALIGN16( float tmp[6][8] );
+	for ( int k = 0; k < 6; k++ ) {
+		_mm256_storeu_ps( tmp[k], mm[k] );
+	}
+	min[0] = min[1] = min[2] = idMath::INFINITY; max[0] = max[1] = max[2] = -idMath::INFINITY;
+	for ( int n = 0; n < 8; n++ ) {
+		for ( int k = 0; k < 3; k++ ) {
+			if ( tmp[k][n] < min[k] ) { min[k] = tmp[k][n]; }
+			if ( tmp[3+k][n] > max[k] ) { max[k] = tmp[3+k][n]; }
+		}
+	}
+}
+
+static ID_INLINE void MinMax3Scalar( idVec3 &min, idVec3 &max, const idVec3 &v ) {
+	if ( v[0] < min[0] ) { min[0] = v[0]; } if ( v[0] > max[0] ) { max[0] = v[0]; }
+	if ( v[1] < min[1] ) { min[1] = v[1]; } if ( v[1] > max[1] ) { max[1] = v[1]; }
+	if ( v[2] < min[2] ) { min[2] = v[2]; } if ( v[2] > max[2] ) { max[2] = v[2]; }
+}
+
+/*
+============
+idSIMD_AVX2::MinMax
+============
+*/
+void VPCALL idSIMD_AVX2::MinMax( idVec3 &min, idVec3 &max, const idVec3 *src, const int count ) {
+	__m256 mm[6];
+	MinMax3Init( mm );
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		__m256 v[4];
+		LoadVec3( src + i, v );
+		MinMax3Add( mm, v );
+	}
+	MinMax3Resolve( min, max, mm );
+	for ( ; i < count; i++ ) {
+		MinMax3Scalar( min, max, src[i] );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MinMax
+============
+*/
+void VPCALL idSIMD_AVX2::MinMax( idVec3 &min, idVec3 &max, const idDrawVert *src, const int count ) {
+	assert( sizeof( idDrawVert ) == DRAWVERT_FLOATS * sizeof( float ) );
+
+	__m256 mm[6];
+	MinMax3Init( mm );
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		__m256 v[4];
+		LoadStrided4( src[i].xyz.ToFloatPtr(), DRAWVERT_FLOATS, v );
+		MinMax3Add( mm, v );
+	}
+	MinMax3Resolve( min, max, mm );
+	for ( ; i < count; i++ ) {
+		MinMax3Scalar( min, max, src[i].xyz );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MinMax
+============
+*/
+void VPCALL idSIMD_AVX2::MinMax( idVec3 &min, idVec3 &max, const idDrawVert *src, const int *indexes, const int count ) {
+	assert( sizeof( idDrawVert ) == DRAWVERT_FLOATS * sizeof( float ) );
+
+	__m256 mm[6];
+	MinMax3Init( mm );
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		__m256 v[4];
+		LoadIndexed4( src->xyz.ToFloatPtr(), DRAWVERT_FLOATS, indexes + i, v );
+		MinMax3Add( mm, v );
+	}
+	MinMax3Resolve( min, max, mm );
+	for ( ; i < count; i++ ) {
+		MinMax3Scalar( min, max, src[indexes[i]].xyz );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Clamp
+============
+*/
+void VPCALL idSIMD_AVX2::Clamp( float *dst, const float *src, const float min, const float max, const int count ) {
+	const __m256 vmin = _mm256_set1_ps( min );
+	const __m256 vmax = _mm256_set1_ps( max );
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		_mm256_storeu_ps( dst + i, _mm256_min_ps( _mm256_max_ps( _mm256_loadu_ps( src + i ), vmin ), vmax ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = src[i] < min ? min : src[i] > max ? max : src[i];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::ClampMin
+============
+*/
+void VPCALL idSIMD_AVX2::ClampMin( float *dst, const float *src, const float min, const int count ) {
+	const __m256 vmin = _mm256_set1_ps( min );
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		_mm256_storeu_ps( dst + i, _mm256_max_ps( _mm256_loadu_ps( src + i ), vmin ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = src[i] < min ? min : src[i];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::ClampMax
+============
+*/
+void VPCALL idSIMD_AVX2::ClampMax( float *dst, const float *src, const float max, const int count ) {
+	const __m256 vmax = _mm256_set1_ps( max );
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		_mm256_storeu_ps( dst + i, _mm256_min_ps( _mm256_loadu_ps( src + i ), vmax ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = src[i] > max ? max : src[i];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Zero16
+============
+*/
+void VPCALL idSIMD_AVX2::Zero16( float *dst, const int count ) {
+	const __m256 zero = _mm256_setzero_ps();
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		_mm256_storeu_ps( dst + i, zero );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = 0.0f;
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Negate16
+============
+*/
+void VPCALL idSIMD_AVX2::Negate16( float *dst, const int count ) {
+	const __m256 signBit = _mm256_castsi256_ps( _mm256_set1_epi32( 1 << 31 ) );
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		_mm256_storeu_ps( dst + i, _mm256_xor_ps( _mm256_loadu_ps( dst + i ), signBit ) );
+	}
+	unsigned int *ptr = reinterpret_cast<unsigned int *>(dst);
+	for ( ; i < count; i++ ) {
+		ptr[i] ^= ( 1 << 31 );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Copy16
+============
+*/
+void VPCALL idSIMD_AVX2::Copy16( float *dst, const float *src, const int count ) {
+	int i = 0;
+	for ( ; i + 8 <= count; i += 8 ) {
+		_mm256_storeu_ps( dst + i, _mm256_loadu_ps( src + i ) );
+	}
+	for ( ; i < count; i++ ) {
+		dst[i] = src[i];
+	}
+}
+
+/*
+============
+idSIMD_AVX2::Add16
+============
+*/
+void VPCALL idSIMD_AVX2::Add16( float *dst, const float *src1, const float *src2, const int count ) {
+	Add( dst, src1, src2, count );
+}
+
+/*
+============
+idSIMD_AVX2::Sub16
+============
+*/
+void VPCALL idSIMD_AVX2::Sub16( float *dst, const float *src1, const float *src2, const int count ) {
+	Sub( dst, src1, src2, count );
+}
+
+/*
+============
+idSIMD_AVX2::Mul16
+============
+*/
+void VPCALL idSIMD_AVX2::Mul16( float *dst, const float *src1, const float constant, const int count ) {
+	Mul( dst, constant, src1, count );
+}
+
+/*
+============
+idSIMD_AVX2::AddAssign16
+============
+*/
+void VPCALL idSIMD_AVX2::AddAssign16( float *dst, const float *src, const int count ) {
+	Add( dst, dst, src, count );
+}
+
+/*
+============
+idSIMD_AVX2::SubAssign16
+============
+*/
+void VPCALL idSIMD_AVX2::SubAssign16( float *dst, const float *src, const int count ) {
+	Sub( dst, dst, src, count );
+}
+
+/*
+============
+idSIMD_AVX2::MulAssign16
+============
+*/
+void VPCALL idSIMD_AVX2::MulAssign16( float *dst, const float constant, const int count ) {
+	Mul( dst, constant, dst, count );
+}
+
+/*
+============
+idSIMD_AVX2::ConvertJointQuatsToJointMats
+============
+*/
+void VPCALL idSIMD_AVX2::ConvertJointQuatsToJointMats( idJointMat *jointMats, const idJointQuat *jointQuats, const int numJoints ) {
+	int i;
+
+	assert( sizeof( idJointQuat ) == JOINTQUAT_FLOATS * sizeof( float ) );
+	assert( sizeof( idJointMat ) == 12 * sizeof( float ) );
+
+	const __m256 one = _mm256_set1_ps( 1.0f );
+
+	for ( i = 0; i + 8 <= numJoints; i += 8 ) {
+		const float *q = jointQuats[i].q.ToFloatPtr();
+
+		__m256 v[4], t[4];
+		LoadStrided4( q + 0, JOINTQUAT_FLOATS, v );
+		LoadStrided4( q + 3, JOINTQUAT_FLOATS, t );
+
+		const __m256 x = v[0];
+		const __m256 y = v[1];
+		const __m256 z = v[2];
+		const __m256 w = v[3];
+
+		const __m256 x2 = _mm256_add_ps( x, x );
+		const __m256 y2 = _mm256_add_ps( y, y );
+		const __m256 z2 = _mm256_add_ps( z, z );
+
+		const __m256 xx = _mm256_mul_ps( x, x2 );
+		const __m256 xy = _mm256_mul_ps( x, y2 );
+		const __m256 xz = _mm256_mul_ps( x, z2 );
+
+		const __m256 yy = _mm256_mul_ps( y, y2 );
+		const __m256 yz = _mm256_mul_ps( y, z2 );
+		const __m256 zz = _mm256_mul_ps( z, z2 );
+
+		const __m256 wx = _mm256_mul_ps( w, x2 );
+		const __m256 wy = _mm256_mul_ps( w, y2 );
+		const __m256 wz = _mm256_mul_ps( w, z2 );
+
+		// idJointMat is the transpose of idQuat::ToMat3() with the translation in the fourth column
+		__m256 m[3][4];
+		m[0][0] = _mm256_sub_ps( one, _mm256_add_ps( yy, zz ) );
+		m[0][1] = _mm256_add_ps( xy, wz );
+		m[0][2] = _mm256_sub_ps( xz, wy );
+		m[0][3] = t[1];
+
+		m[1][0] = _mm256_sub_ps( xy, wz );
+		m[1][1] = _mm256_sub_ps( one, _mm256_add_ps( xx, zz ) );
+		m[1][2] = _mm256_add_ps( yz, wx );
+		m[1][3] = t[2];
+
+		m[2][0] = _mm256_add_ps( xz, wy );
+		m[2][1] = _mm256_sub_ps( yz, wx );
+		m[2][2] = _mm256_sub_ps( one, _mm256_add_ps( xx, yy ) );
+		m[2][3] = t[3];
+
+		float *dst = jointMats[i].ToFloatPtr();
+		StoreStrided4( dst + 0 * 4, 12, m[0] );
+		StoreStrided4( dst + 1 * 4, 12, m[1] );
+		StoreStrided4( dst + 2 * 4, 12, m[2] );
+	}
+
+	for ( ; i < numJoints; i++ ) {
+		jointMats[i].SetRotation( jointQuats[i].q.ToMat3() );
+		jointMats[i].SetTranslation( jointQuats[i].t );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::TransformJoints
+
+  Every joint depends on its parent so this works one joint at a time, but each
+  3x4 row is transformed with a single four wide operation. The operations are
+  done in the same order as idJointMat::operator*= so the result is exact.
+============
+*/
+void VPCALL idSIMD_AVX2::TransformJoints( idJointMat *jointMats, const int *parents, const int firstJoint, const int lastJoint ) {
+	const __m128 translationMask = _mm_castsi128_ps( _mm_setr_epi32( 0, 0, 0, -1 ) );
+
+	for ( int i = firstJoint; i <= lastJoint; i++ ) {
+		assert( parents[i] < i );
+		float *m = jointMats[i].ToFloatPtr();
+		const float *a = jointMats[parents[i]].ToFloatPtr();
+
+		const __m128 r0 = _mm_loadu_ps( m + 0 );
+		const __m128 r1 = _mm_loadu_ps( m + 4 );
+		const __m128 r2 = _mm_loadu_ps( m + 8 );
+
+		for ( int r = 0; r < 3; r++ ) {
+			__m128 d = _mm_mul_ps( _mm_set1_ps( a[r * 4 + 0] ), r0 );
+			d = _mm_add_ps( d, _mm_mul_ps( _mm_set1_ps( a[r * 4 + 1] ), r1 ) );
+			d = _mm_add_ps( d, _mm_mul_ps( _mm_set1_ps( a[r * 4 + 2] ), r2 ) );
+			d = _mm_add_ps( d, _mm_and_ps( _mm_set1_ps( a[r * 4 + 3] ), translationMask ) );
+			_mm_storeu_ps( m + r * 4, d );
+		}
+	}
+}
+
+/*
+============
+idSIMD_AVX2::UntransformJoints
+
+  Same order of operations as idJointMat::operator/=.
+============
+*/
+void VPCALL idSIMD_AVX2::UntransformJoints( idJointMat *jointMats, const int *parents, const int firstJoint, const int lastJoint ) {
+	const __m128 translationMask = _mm_castsi128_ps( _mm_setr_epi32( 0, 0, 0, -1 ) );
+
+	for ( int i = lastJoint; i >= firstJoint; i-- ) {
+		assert( parents[i] < i );
+		float *m = jointMats[i].ToFloatPtr();
+		const float *a = jointMats[parents[i]].ToFloatPtr();
+
+		const __m128 r0 = _mm_sub_ps( _mm_loadu_ps( m + 0 ), _mm_and_ps( _mm_set1_ps( a[0 * 4 + 3] ), translationMask ) );
+		const __m128 r1 = _mm_sub_ps( _mm_loadu_ps( m + 4 ), _mm_and_ps( _mm_set1_ps( a[1 * 4 + 3] ), translationMask ) );
+		const __m128 r2 = _mm_sub_ps( _mm_loadu_ps( m + 8 ), _mm_and_ps( _mm_set1_ps( a[2 * 4 + 3] ), translationMask ) );
+
+		for ( int r = 0; r < 3; r++ ) {
+			__m128 d = _mm_mul_ps( _mm_set1_ps( a[0 * 4 + r] ), r0 );
+			d = _mm_add_ps( d, _mm_mul_ps( _mm_set1_ps( a[1 * 4 + r] ), r1 ) );
+			d = _mm_add_ps( d, _mm_mul_ps( _mm_set1_ps( a[2 * 4 + r] ), r2 ) );
+			_mm_storeu_ps( m + r * 4, d );
+		}
+	}
+}
+
+/*
+============
+idSIMD_AVX2::TransformVerts
+
+  The first two rows of each joint matrix are processed in one eight wide register, the
+  weighted rows are summed and reduced horizontally once per vertex.
+============
+*/
+void VPCALL idSIMD_AVX2::TransformVerts( idDrawVert *verts, const int numVerts, const idJointMat *joints, const idVec4 *weights, const int *index, const int numWeights ) {
+	const byte *jointsPtr = (const byte *)joints;
+
+	for ( int j = 0, i = 0; i < numVerts; i++ ) {
+		const float *m = ( (const idJointMat *)( jointsPtr + index[j*2+0] ) )->ToFloatPtr();
+		__m256 w = _mm256_broadcast_ps( (const __m128 *)weights[j].ToFloatPtr() );
+		__m256 acc01 = _mm256_mul_ps( _mm256_loadu_ps( m ), w );
+		__m128 acc2 = _mm_mul_ps( _mm_loadu_ps( m + 8 ), _mm256_castps256_ps128( w ) );
+
+		while( index[j*2+1] == 0 ) {
+			j++;
+			m = ( (const idJointMat *)( jointsPtr + index[j*2+0] ) )->ToFloatPtr();
+			w = _mm256_broadcast_ps( (const __m128 *)weights[j].ToFloatPtr() );
+			acc01 = _mm256_add_ps( _mm256_mul_ps( _mm256_loadu_ps( m ), w ), acc01 );
+			acc2 = _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( m + 8 ), _mm256_castps256_ps128( w ) ), acc2 );
+		}
+		j++;
+
+		const __m128 r01 = _mm_hadd_ps( _mm256_castps256_ps128( acc01 ), _mm256_extractf128_ps( acc01, 1 ) );
+		const __m128 xyz = _mm_hadd_ps( r01, _mm_hadd_ps( acc2, acc2 ) );
+
+		float *dst = verts[i].xyz.ToFloatPtr();
+		_mm_storel_pi( (__m64 *)dst, xyz );
+		_mm_store_ss( dst + 2, _mm_movehl_ps( xyz, xyz ) );
+	}
+}
+
+/*
+============
+PlaneDistances
+
+  distances of eight vertices to 'numPlanes' planes
+============
+*/
+static inline AVX2_TARGET void PlaneDistances( __m256 *dist, const idPlane *planes, const int numPlanes, const __m256 v[4] ) {
+	for ( int p = 0; p < numPlanes; p++ ) {
+		__m256 d = _mm256_add_ps( _mm256_mul_ps( _mm256_set1_ps( planes[p][0] ), v[0] ), _mm256_set1_ps( planes[p][3] ) );
+		d = _mm256_add_ps( _mm256_mul_ps( _mm256_set1_ps( planes[p][1] ), v[1] ), d );
+		dist[p] = _mm256_add_ps( _mm256_mul_ps( _mm256_set1_ps( planes[p][2] ), v[2] ), d );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::TracePointCull
+============
+*/
+void VPCALL idSIMD_AVX2::TracePointCull( byte *cullBits, byte &totalOr, const float radius, const idPlane *planes, const idDrawVert *verts, const int numVerts ) {
+	const __m256 r = _mm256_set1_ps( radius );
+	__m256i vOr = _mm256_setzero_si256();
+	byte tOr = 0;
+	int i;
+
+	assert( sizeof( idDrawVert ) == DRAWVERT_FLOATS * sizeof( float ) );
+
+	for ( i = 0; i + 8 <= numVerts; i += 8 ) {
+		__m256 v[4], d[4];
+		LoadStrided4( verts[i].xyz.ToFloatPtr(), DRAWVERT_FLOATS, v );
+		PlaneDistances( d, planes, 4, v );
+
+		__m256i bits = _mm256_set1_epi32( 0x0F );		// flip lower four bits
+		for ( int p = 0; p < 4; p++ ) {
+			bits = _mm256_xor_si256( bits, _mm256_slli_epi32( SignBits( _mm256_add_ps( d[p], r ) ), p ) );
+			bits = _mm256_or_si256( bits, _mm256_slli_epi32( SignBits( _mm256_sub_ps( d[p], r ) ), 4 + p ) );
+		}
+		vOr = _mm256_or_si256( vOr, bits );
+		_mm_storel_epi64( (__m128i *)( cullBits + i ), PackBytes( bits ) );
+	}
+
+	ALIGN16( int ors[8] );
+	_mm256_storeu_si256( (__m256i *)ors, vOr );
+	for ( int n = 0; n < 8; n++ ) {
+		tOr |= ors[n];
+	}
+
+	for ( ; i < numVerts; i++ ) {
+		byte bits;
+		float d0, d1, d2, d3, t;
+		const idVec3 &v = verts[i].xyz;
+
+		d0 = planes[0].Distance( v );
+		d1 = planes[1].Distance( v );
+		d2 = planes[2].Distance( v );
+		d3 = planes[3].Distance( v );
+
+		t = d0 + radius;
+		bits  = FLOATSIGNBITSET( t ) << 0;
+		t = d1 + radius;
+		bits |= FLOATSIGNBITSET( t ) << 1;
+		t = d2 + radius;
+		bits |= FLOATSIGNBITSET( t ) << 2;
+		t = d3 + radius;
+		bits |= FLOATSIGNBITSET( t ) << 3;
+
+		t = d0 - radius;
+		bits |= FLOATSIGNBITSET( t ) << 4;
+		t = d1 - radius;
+		bits |= FLOATSIGNBITSET( t ) << 5;
+		t = d2 - radius;
+		bits |= FLOATSIGNBITSET( t ) << 6;
+		t = d3 - radius;
+		bits |= FLOATSIGNBITSET( t ) << 7;
+
+		bits ^= 0x0F;		// flip lower four bits
+
+		tOr |= bits;
+		cullBits[i] = bits;
+	}
+
+	totalOr = tOr;
+}
+
+/*
+============
+idSIMD_AVX2::DecalPointCull
+============
+*/
+void VPCALL idSIMD_AVX2::DecalPointCull( byte *cullBits, const idPlane *planes, const idDrawVert *verts, const int numVerts ) {
+	int i;
+
+	assert( sizeof( idDrawVert ) == DRAWVERT_FLOATS * sizeof( float ) );
+
+	for ( i = 0; i + 8 <= numVerts; i += 8 ) {
+		__m256 v[4], d[6];
+		LoadStrided4( verts[i].xyz.ToFloatPtr(), DRAWVERT_FLOATS, v );
+		PlaneDistances( d, planes, 6, v );
+
+		__m256i bits = _mm256_set1_epi32( 0x3F );		// flip lower 6 bits
+		for ( int p = 0; p < 6; p++ ) {
+			bits = _mm256_xor_si256( bits, _mm256_slli_epi32( SignBits( d[p] ), p ) );
+		}
+		_mm_storel_epi64( (__m128i *)( cullBits + i ), PackBytes( bits ) );
+	}
+
+	for ( ; i < numVerts; i++ ) {
+		byte bits;
+		const idVec3 &v = verts[i].xyz;
+
+		bits = 0;
+		for ( int p = 0; p < 6; p++ ) {
+			float d = planes[p].Distance( v );
+			bits |= FLOATSIGNBITSET( d ) << p;
+		}
+		cullBits[i] = bits ^ 0x3F;		// flip lower 6 bits
+	}
+}
+
+/*
+============
+idSIMD_AVX2::OverlayPointCull
+============
+*/
+void VPCALL idSIMD_AVX2::OverlayPointCull( byte *cullBits, idVec2 *texCoords, const idPlane *planes, const idDrawVert *verts, const int numVerts ) {
+	const __m256 one = _mm256_set1_ps( 1.0f );
+	int i;
+
+	assert( sizeof( idDrawVert ) == DRAWVERT_FLOATS * sizeof( float ) );
+
+	for ( i = 0; i + 8 <= numVerts; i += 8 ) {
+		__m256 v[4], d[2];
+		LoadStrided4( verts[i].xyz.ToFloatPtr(), DRAWVERT_FLOATS, v );
+		PlaneDistances( d, planes, 2, v );
+
+		// interleave the two distances into texture coordinates
+		const __m256 lo = _mm256_unpacklo_ps( d[0], d[1] );
+		const __m256 hi = _mm256_unpackhi_ps( d[0], d[1] );
+		_mm256_storeu_ps( texCoords[i+0].ToFloatPtr(), _mm256_permute2f128_ps( lo, hi, 0x20 ) );
+		_mm256_storeu_ps( texCoords[i+4].ToFloatPtr(), _mm256_permute2f128_ps( lo, hi, 0x31 ) );
+
+		__m256i bits = SignBits( d[0] );
+		bits = _mm256_or_si256( bits, _mm256_slli_epi32( SignBits( d[1] ), 1 ) );
+		bits = _mm256_or_si256( bits, _mm256_slli_epi32( SignBits( _mm256_sub_ps( one, d[0] ) ), 2 ) );
+		bits = _mm256_or_si256( bits, _mm256_slli_epi32( SignBits( _mm256_sub_ps( one, d[1] ) ), 3 ) );
+		_mm_storel_epi64( (__m128i *)( cullBits + i ), PackBytes( bits ) );
+	}
+
+	for ( ; i < numVerts; i++ ) {
+		byte bits;
+		float d0, d1;
+		const idVec3 &v = verts[i].xyz;
+
+		texCoords[i][0] = d0 = planes[0].Distance( v );
+		texCoords[i][1] = d1 = planes[1].Distance( v );
+
+		bits  = FLOATSIGNBITSET( d0 ) << 0;
+		d0 = 1.0f - d0;
+		bits |= FLOATSIGNBITSET( d1 ) << 1;
+		d1 = 1.0f - d1;
+		bits |= FLOATSIGNBITSET( d0 ) << 2;
+		bits |= FLOATSIGNBITSET( d1 ) << 3;
+
+		cullBits[i] = bits;
+	}
+}
+
+/*
+============
+TrianglePlanes
+
+  Derives the planes of the eight triangles starting at 'indexes', optionally also the two tangents.
+============
+*/
+typedef struct {
+	__m256	plane[4];
+	__m256	t0[3];
+	__m256	t1[3];
+} triPlanes8_t;
+
+static inline AVX2_TARGET void LoadCorner( const idDrawVert *verts, const int *indexes, const bool st, __m256 v[5] ) {
+	const float *p0 = verts[indexes[0 * 3]].xyz.ToFloatPtr();
+	const float *p1 = verts[indexes[1 * 3]].xyz.ToFloatPtr();
+	const float *p2 = verts[indexes[2 * 3]].xyz.ToFloatPtr();
+	const float *p3 = verts[indexes[3 * 3]].xyz.ToFloatPtr();
+	const float *p4 = verts[indexes[4 * 3]].xyz.ToFloatPtr();
+	const float *p5 = verts[indexes[5 * 3]].xyz.ToFloatPtr();
+	const float *p6 = verts[indexes[6 * 3]].xyz.ToFloatPtr();
+	const float *p7 = verts[indexes[7 * 3]].xyz.ToFloatPtr();
+
+	LoadRows4( p0, p1, p2, p3, p4, p5, p6, p7, v );
+	if ( st ) {
+		__m256 t[4];
+		LoadRows4( p0 + 1, p1 + 1, p2 + 1, p3 + 1, p4 + 1, p5 + 1, p6 + 1, p7 + 1, t );
+		v[4] = t[3];
+	}
+}
+
+static inline AVX2_TARGET void TrianglePlanes( triPlanes8_t &out, const idDrawVert *verts, const int *indexes, const bool tangents ) {
+	__m256 a[5], b[5], c[5];
+
+	LoadCorner( verts, indexes + 0, tangents, a );
+	LoadCorner( verts, indexes + 1, tangents, b );
+	LoadCorner( verts, indexes + 2, tangents, c );
+
+	__m256 d0[5], d1[5];
+	d0[0] = _mm256_sub_ps( b[0], a[0] );
+	d0[1] = _mm256_sub_ps( b[1], a[1] );
+	d0[2] = _mm256_sub_ps( b[2], a[2] );
+	d1[0] = _mm256_sub_ps( c[0], a[0] );
+	d1[1] = _mm256_sub_ps( c[1], a[1] );
+	d1[2] = _mm256_sub_ps( c[2], a[2] );
+	if ( tangents ) {
+		d0[3] = _mm256_sub_ps( b[3], a[3] );
+		d0[4] = _mm256_sub_ps( b[4], a[4] );
+		d1[3] = _mm256_sub_ps( c[3], a[3] );
+		d1[4] = _mm256_sub_ps( c[4], a[4] );
+	}
+
+	// normal
+	__m256 n0 = _mm256_sub_ps( _mm256_mul_ps( d1[1], d0[2] ), _mm256_mul_ps( d1[2], d0[1] ) );
+	__m256 n1 = _mm256_sub_ps( _mm256_mul_ps( d1[2], d0[0] ), _mm256_mul_ps( d1[0], d0[2] ) );
+	__m256 n2 = _mm256_sub_ps( _mm256_mul_ps( d1[0], d0[1] ), _mm256_mul_ps( d1[1], d0[0] ) );
+
+	__m256 f = ReciprocalSqrt( _mm256_add_ps( _mm256_mul_ps( n0, n0 ), _mm256_add_ps( _mm256_mul_ps( n1, n1 ), _mm256_mul_ps( n2, n2 ) ) ) );
+	out.plane[0] = _mm256_mul_ps( n0, f );
+	out.plane[1] = _mm256_mul_ps( n1, f );
+	out.plane[2] = _mm256_mul_ps( n2, f );
+
+	// idPlane::FitThroughPoint
+	out.plane[3] = _mm256_xor_ps( _mm256_add_ps( _mm256_mul_ps( out.plane[0], a[0] ), _mm256_add_ps( _mm256_mul_ps( out.plane[1], a[1] ), _mm256_mul_ps( out.plane[2], a[2] ) ) ),
+								_mm256_castsi256_ps( _mm256_set1_epi32( 1 << 31 ) ) );
+
+	if ( !tangents ) {
+		return;
+	}
+
+	// area sign bit
+	const __m256 area = _mm256_sub_ps( _mm256_mul_ps( d0[3], d1[4] ), _mm256_mul_ps( d0[4], d1[3] ) );
+	const __m256 signBit = _mm256_and_ps( area, _mm256_castsi256_ps( _mm256_set1_epi32( 1 << 31 ) ) );
+
+	// first tangent
+	__m256 t0 = _mm256_sub_ps( _mm256_mul_ps( d0[0], d1[4] ), _mm256_mul_ps( d0[4], d1[0] ) );
+	__m256 t1 = _mm256_sub_ps( _mm256_mul_ps( d0[1], d1[4] ), _mm256_mul_ps( d0[4], d1[1] ) );
+	__m256 t2 = _mm256_sub_ps( _mm256_mul_ps( d0[2], d1[4] ), _mm256_mul_ps( d0[4], d1[2] ) );
+	f = _mm256_xor_ps( ReciprocalSqrt( _mm256_add_ps( _mm256_mul_ps( t0, t0 ), _mm256_add_ps( _mm256_mul_ps( t1, t1 ), _mm256_mul_ps( t2, t2 ) ) ) ), signBit );
+	out.t0[0] = _mm256_mul_ps( t0, f );
+	out.t0[1] = _mm256_mul_ps( t1, f );
+	out.t0[2] = _mm256_mul_ps( t2, f );
+
+	// second tangent
+	t0 = _mm256_sub_ps( _mm256_mul_ps( d0[3], d1[0] ), _mm256_mul_ps( d0[0], d1[3] ) );
+	t1 = _mm256_sub_ps( _mm256_mul_ps( d0[3], d1[1] ), _mm256_mul_ps( d0[1], d1[3] ) );
+	t2 = _mm256_sub_ps( _mm256_mul_ps( d0[3], d1[2] ), _mm256_mul_ps( d0[2], d1[3] ) );
+	f = _mm256_xor_ps( ReciprocalSqrt( _mm256_add_ps( _mm256_mul_ps( t0, t0 ), _mm256_add_ps( _mm256_mul_ps( t1, t1 ), _mm256_mul_ps( t2, t2 ) ) ) ), signBit );
+	out.t1[0] = _mm256_mul_ps( t0, f );
+	out.t1[1] = _mm256_mul_ps( t1, f );
+	out.t1[2] = _mm256_mul_ps( t2, f );
+}
+
+/*
+============
+idSIMD_AVX2::DeriveTriPlanes
+============
+*/
+void VPCALL idSIMD_AVX2::DeriveTriPlanes( idPlane *planes, const idDrawVert *verts, const int numVerts, const int *indexes, const int numIndexes ) {
+	int i;
+
+	assert( sizeof( idDrawVert ) == DRAWVERT_FLOATS * sizeof( float ) );
+
+	for ( i = 0; i + 3 * 8 <= numIndexes; i += 3 * 8 ) {
+		triPlanes8_t tri;
+
+		TrianglePlanes( tri, verts, indexes + i, false );
+		StoreStrided4( planes->ToFloatPtr(), 4, tri.plane );
+		planes += 8;
+	}
+
+	for ( ; i < numIndexes; i += 3 ) {
+		const idDrawVert *a, *b, *c;
+		float d0[3], d1[3], f;
+		idVec3 n;
+
+		a = verts + indexes[i + 0];
+		b = verts + indexes[i + 1];
+		c = verts + indexes[i + 2];
+
+		d0[0] = b->xyz[0] - a->xyz[0];
+		d0[1] = b->xyz[1] - a->xyz[1];
+		d0[2] = b->xyz[2] - a->xyz[2];
+
+		d1[0] = c->xyz[0] - a->xyz[0];
+		d1[1] = c->xyz[1] - a->xyz[1];
+		d1[2] = c->xyz[2] - a->xyz[2];
+
+		n[0] = d1[1] * d0[2] - d1[2] * d0[1];
+		n[1] = d1[2] * d0[0] - d1[0] * d0[2];
+		n[2] = d1[0] * d0[1] - d1[1] * d0[0];
+
+		f = idMath::RSqrt( n.x * n.x + n.y * n.y + n.z * n.z );
+
+		n.x *= f;
+		n.y *= f;
+		n.z *= f;
+
+		planes->SetNormal( n );
+		planes->FitThroughPoint( a->xyz );
+		planes++;
+	}
+}
+
+/*
+============
+AccumulateTangents
+============
+*/
+static ID_INLINE void AccumulateTangents( idDrawVert *v, bool &used, const idVec3 &n, const idVec3 &t0, const idVec3 &t1 ) {
+	if ( used ) {
+		v->normal += n;
+		v->tangents[0] += t0;
+		v->tangents[1] += t1;
+	} else {
+		v->normal = n;
+		v->tangents[0] = t0;
+		v->tangents[1] = t1;
+		used = true;
+	}
+}
+
+/*
+============
+idSIMD_AVX2::DeriveTangents
+
+	The planes and tangents of eight triangles are derived at once, the results are then
+	accumulated into the vertices in triangle order like the generic version.
+============
+*/
+void VPCALL idSIMD_AVX2::DeriveTangents( idPlane *planes, idDrawVert *verts, const int numVerts, const int *indexes, const int numIndexes ) {
+	int i;
+
+	assert( sizeof( idDrawVert ) == DRAWVERT_FLOATS * sizeof( float ) );
+
+	bool *used = (bool *)_alloca16( numVerts * sizeof( used[0] ) );
+	memset( used, 0, numVerts * sizeof( used[0] ) );
+
+	idPlane *planesPtr = planes;
+
+	for ( i = 0; i + 3 * 8 <= numIndexes; i += 3 * 8 ) {
+		triPlanes8_t tri;
+
+		TrianglePlanes( tri, verts, indexes + i, true );
+		StoreStrided4( planesPtr->ToFloatPtr(), 4, tri.plane );
+
+		ALIGN16( float t0[3][8] );
+		ALIGN16( float t1[3][8] );
+		_mm256_storeu_ps( t0[0], tri.t0[0] );
+		_mm256_storeu_ps( t0[1], tri.t0[1] );
+		_mm256_storeu_ps( t0[2], tri.t0[2] );
+		_mm256_storeu_ps( t1[0], tri.t1[0] );
+		_mm256_storeu_ps( t1[1], tri.t1[1] );
+		_mm256_storeu_ps( t1[2], tri.t1[2] );
+
+		for ( int n = 0; n < 8; n++ ) {
+			const idVec3 &normal = planesPtr[n].Normal();
+			const idVec3 tangent0( t0[0][n], t0[1][n], t0[2][n] );
+			const idVec3 tangent1( t1[0][n], t1[1][n], t1[2][n] );
+
+			for ( int c = 0; c < 3; c++ ) {
+				const int v = indexes[i + n * 3 + c];
+				AccumulateTangents( verts + v, used[v], normal, tangent0, tangent1 );
+			}
+		}
+		planesPtr += 8;
+	}
+
+	for ( ; i < numIndexes; i += 3 ) {
+		idDrawVert *a, *b, *c;
+		unsigned int signBit;
+		float d0[5], d1[5], f, area;
+		idVec3 n, t0, t1;
+
+		int v0 = indexes[i + 0];
+		int v1 = indexes[i + 1];
+		int v2 = indexes[i + 2];
+
+		a = verts + v0;
+		b = verts + v1;
+		c = verts + v2;
+
+		d0[0] = b->xyz[0] - a->xyz[0];
+		d0[1] = b->xyz[1] - a->xyz[1];
+		d0[2] = b->xyz[2] - a->xyz[2];
+		d0[3] = b->st[0] - a->st[0];
+		d0[4] = b->st[1] - a->st[1];
+
+		d1[0] = c->xyz[0] - a->xyz[0];
+		d1[1] = c->xyz[1] - a->xyz[1];
+		d1[2] = c->xyz[2] - a->xyz[2];
+		d1[3] = c->st[0] - a->st[0];
+		d1[4] = c->st[1] - a->st[1];
+
+		// normal
+		n[0] = d1[1] * d0[2] - d1[2] * d0[1];
+		n[1] = d1[2] * d0[0] - d1[0] * d0[2];
+		n[2] = d1[0] * d0[1] - d1[1] * d0[0];
+
+		f = idMath::RSqrt( n.x * n.x + n.y * n.y + n.z * n.z );
+
+		n.x *= f;
+		n.y *= f;
+		n.z *= f;
+
+		planesPtr->SetNormal( n );
+		planesPtr->FitThroughPoint( a->xyz );
+		planesPtr++;
+
+		// area sign bit
+		area = d0[3] * d1[4] - d0[4] * d1[3];
+		signBit = ( *(unsigned int *)&area ) & ( 1 << 31 );
+
+		// first tangent
+		t0[0] = d0[0] * d1[4] - d0[4] * d1[0];
+		t0[1] = d0[1] * d1[4] - d0[4] * d1[1];
+		t0[2] = d0[2] * d1[4] - d0[4] * d1[2];
+
+		f = idMath::RSqrt( t0.x * t0.x + t0.y * t0.y + t0.z * t0.z );
+		*(unsigned int *)&f ^= signBit;
+
+		t0.x *= f;
+		t0.y *= f;
+		t0.z *= f;
+
+		// second tangent
+		t1[0] = d0[3] * d1[0] - d0[0] * d1[3];
+		t1[1] = d0[3] * d1[1] - d0[1] * d1[3];
+		t1[2] = d0[3] * d1[2] - d0[2] * d1[3];
+
+		f = idMath::RSqrt( t1.x * t1.x + t1.y * t1.y + t1.z * t1.z );
+		*(unsigned int *)&f ^= signBit;
+
+		t1.x *= f;
+		t1.y *= f;
+		t1.z *= f;
+
+		AccumulateTangents( a, used[v0], n, t0, t1 );
+		AccumulateTangents( b, used[v1], n, t0, t1 );
+		AccumulateTangents( c, used[v2], n, t0, t1 );
+	}
+}
+
+/*
+============
+StoreTangentSpace
+
+  stores the normal and both tangents of eight consecutive vertices
+============
+*/
+static inline AVX2_TARGET void StoreTangentSpace( idDrawVert *verts, const __m256 n[3], const __m256 t0[3], const __m256 t1[3] ) {
+	float *dst = verts->normal.ToFloatPtr();
+	const __m256 c0[4] = { n[0], n[1], n[2], t0[0] };
+	const __m256 c1[4] = { t0[0], t0[1], t0[2], t1[0] };
+	const __m256 c2[4] = { t0[2], t1[0], t1[1], t1[2] };
+
+	// the normal and tangents are nine consecutive floats written as three overlapping vec4 stores
+	StoreStrided4( dst + 0, DRAWVERT_FLOATS, c0 );
+	StoreStrided4( dst + 3, DRAWVERT_FLOATS, c1 );
+	StoreStrided4( dst + 5, DRAWVERT_FLOATS, c2 );
+}
+
+/*
+============
+idSIMD_AVX2::DeriveUnsmoothedTangents
+============
+*/
+void VPCALL idSIMD_AVX2::DeriveUnsmoothedTangents( idDrawVert *verts, const dominantTri_s *dominantTris, const int numVerts ) {
+	int i;
+
+	assert( sizeof( idDrawVert ) == DRAWVERT_FLOATS * sizeof( float ) );
+
+	for ( i = 0; i + 8 <= numVerts; i += 8 ) {
+		const dominantTri_s *dt = dominantTris + i;
+		const int v2[8] = { dt[0].v2, dt[1].v2, dt[2].v2, dt[3].v2, dt[4].v2, dt[5].v2, dt[6].v2, dt[7].v2 };
+		const int v3[8] = { dt[0].v3, dt[1].v3, dt[2].v3, dt[3].v3, dt[4].v3, dt[5].v3, dt[6].v3, dt[7].v3 };
+
+		// the scales are loaded together with v3 to stay inside the dominant triangle
+		__m256 s[4];
+		LoadRows4( dt[0].normalizationScale - 1, dt[1].normalizationScale - 1, dt[2].normalizationScale - 1, dt[3].normalizationScale - 1,
+					dt[4].normalizationScale - 1, dt[5].normalizationScale - 1, dt[6].normalizationScale - 1, dt[7].normalizationScale - 1, s );
+
+		__m256 a[4], at[4], b[4], bt[4], c[4], ct[4];
+		LoadStrided4( verts[i].xyz.ToFloatPtr(), DRAWVERT_FLOATS, a );
+		LoadStrided4( verts[i].xyz.ToFloatPtr() + 1, DRAWVERT_FLOATS, at );
+		LoadIndexed4( verts->xyz.ToFloatPtr(), DRAWVERT_FLOATS, v2, b );
+		LoadIndexed4( verts->xyz.ToFloatPtr() + 1, DRAWVERT_FLOATS, v2, bt );
+		LoadIndexed4( verts->xyz.ToFloatPtr(), DRAWVERT_FLOATS, v3, c );
+		LoadIndexed4( verts->xyz.ToFloatPtr() + 1, DRAWVERT_FLOATS, v3, ct );
+
+		// same order of operations as the generic version
+		const __m256 d0 = _mm256_sub_ps( b[0], a[0] );
+		const __m256 d1 = _mm256_sub_ps( b[1], a[1] );
+		const __m256 d2 = _mm256_sub_ps( b[2], a[2] );
+		const __m256 d4 = _mm256_sub_ps( bt[3], at[3] );
+
+		const __m256 d5 = _mm256_sub_ps( c[0], a[0] );
+		const __m256 d6 = _mm256_sub_ps( c[1], a[1] );
+		const __m256 d7 = _mm256_sub_ps( c[2], a[2] );
+		const __m256 d9 = _mm256_sub_ps( ct[3], at[3] );
+
+		const __m256 s0 = s[1];
+		const __m256 s1 = s[2];
+		const __m256 s2 = s[3];
+
+		__m256 n[3], t0[3], t1[3];
+		n[0] = _mm256_mul_ps( s2, _mm256_sub_ps( _mm256_mul_ps( d6, d2 ), _mm256_mul_ps( d7, d1 ) ) );
+		n[1] = _mm256_mul_ps( s2, _mm256_sub_ps( _mm256_mul_ps( d7, d0 ), _mm256_mul_ps( d5, d2 ) ) );
+		n[2] = _mm256_mul_ps( s2, _mm256_sub_ps( _mm256_mul_ps( d5, d1 ), _mm256_mul_ps( d6, d0 ) ) );
+
+		t0[0] = _mm256_mul_ps( s0, _mm256_sub_ps( _mm256_mul_ps( d0, d9 ), _mm256_mul_ps( d4, d5 ) ) );
+		t0[1] = _mm256_mul_ps( s0, _mm256_sub_ps( _mm256_mul_ps( d1, d9 ), _mm256_mul_ps( d4, d6 ) ) );
+		t0[2] = _mm256_mul_ps( s0, _mm256_sub_ps( _mm256_mul_ps( d2, d9 ), _mm256_mul_ps( d4, d7 ) ) );
+
+		// bitangent, see DERIVE_UNSMOOTHED_BITANGENT in the generic version
+		t1[0] = _mm256_mul_ps( s1, _mm256_sub_ps( _mm256_mul_ps( n[2], t0[1] ), _mm256_mul_ps( n[1], t0[2] ) ) );
+		t1[1] = _mm256_mul_ps( s1, _mm256_sub_ps( _mm256_mul_ps( n[0], t0[2] ), _mm256_mul_ps( n[2], t0[0] ) ) );
+		t1[2] = _mm256_mul_ps( s1, _mm256_sub_ps( _mm256_mul_ps( n[1], t0[0] ), _mm256_mul_ps( n[0], t0[1] ) ) );
+
+		StoreTangentSpace( verts + i, n, t0, t1 );
+	}
+
+	for ( ; i < numVerts; i++ ) {
+		const dominantTri_s &dt = dominantTris[i];
+		idDrawVert *a = verts + i;
+		const idDrawVert *b = verts + dt.v2;
+		const idDrawVert *c = verts + dt.v3;
+
+		float d0 = b->xyz[0] - a->xyz[0];
+		float d1 = b->xyz[1] - a->xyz[1];
+		float d2 = b->xyz[2] - a->xyz[2];
+		float d4 = b->st[1] - a->st[1];
+
+		float d5 = c->xyz[0] - a->xyz[0];
+		float d6 = c->xyz[1] - a->xyz[1];
+		float d7 = c->xyz[2] - a->xyz[2];
+		float d9 = c->st[1] - a->st[1];
+
+		float s0 = dt.normalizationScale[0];
+		float s1 = dt.normalizationScale[1];
+		float s2 = dt.normalizationScale[2];
+
+		float n0 = s2 * ( d6 * d2 - d7 * d1 );
+		float n1 = s2 * ( d7 * d0 - d5 * d2 );
+		float n2 = s2 * ( d5 * d1 - d6 * d0 );
+
+		float t0 = s0 * ( d0 * d9 - d4 * d5 );
+		float t1 = s0 * ( d1 * d9 - d4 * d6 );
+		float t2 = s0 * ( d2 * d9 - d4 * d7 );
+
+		a->normal.Set( n0, n1, n2 );
+		a->tangents[0].Set( t0, t1, t2 );
+		a->tangents[1].Set( s1 * ( n2 * t1 - n1 * t2 ), s1 * ( n0 * t2 - n2 * t0 ), s1 * ( n1 * t0 - n0 * t1 ) );
+	}
+}
+
+/*
+============
+idSIMD_AVX2::NormalizeTangents
+============
+*/
+void VPCALL idSIMD_AVX2::NormalizeTangents( idDrawVert *verts, const int numVerts ) {
+	int i;
+
+	assert( sizeof( idDrawVert ) == DRAWVERT_FLOATS * sizeof( float ) );
+
+	for ( i = 0; i + 8 <= numVerts; i += 8 ) {
+		const float *base = verts[i].normal.ToFloatPtr();		// normal and both tangents are consecutive
+
+		__m256 c0[4], c1[4], c2[4];
+		LoadStrided4( base + 0, DRAWVERT_FLOATS, c0 );
+		LoadStrided4( base + 3, DRAWVERT_FLOATS, c1 );
+		LoadStrided4( base + 5, DRAWVERT_FLOATS, c2 );
+
+		__m256 v[9] = { c0[0], c0[1], c0[2], c1[0], c1[1], c1[2], c2[1], c2[2], c2[3] };
+
+		__m256 f = ReciprocalSqrt( _mm256_add_ps( _mm256_mul_ps( v[0], v[0] ), _mm256_add_ps( _mm256_mul_ps( v[1], v[1] ), _mm256_mul_ps( v[2], v[2] ) ) ) );
+		v[0] = _mm256_mul_ps( v[0], f );
+		v[1] = _mm256_mul_ps( v[1], f );
+		v[2] = _mm256_mul_ps( v[2], f );
+
+		for ( int j = 1; j <= 2; j++ ) {
+			__m256 *t = &v[j * 3];
+			const __m256 d = _mm256_add_ps( _mm256_mul_ps( t[0], v[0] ), _mm256_add_ps( _mm256_mul_ps( t[1], v[1] ), _mm256_mul_ps( t[2], v[2] ) ) );
+			t[0] = _mm256_sub_ps( t[0], _mm256_mul_ps( d, v[0] ) );
+			t[1] = _mm256_sub_ps( t[1], _mm256_mul_ps( d, v[1] ) );
+			t[2] = _mm256_sub_ps( t[2], _mm256_mul_ps( d, v[2] ) );
+			f = ReciprocalSqrt( _mm256_add_ps( _mm256_mul_ps( t[0], t[0] ), _mm256_add_ps( _mm256_mul_ps( t[1], t[1] ), _mm256_mul_ps( t[2], t[2] ) ) ) );
+			t[0] = _mm256_mul_ps( t[0], f );
+			t[1] = _mm256_mul_ps( t[1], f );
+			t[2] = _mm256_mul_ps( t[2], f );
+		}
+
+		StoreTangentSpace( verts + i, &v[0], &v[3], &v[6] );
+	}
+
+	if ( i < numVerts ) {
+		idSIMD_Generic::NormalizeTangents( verts + i, numVerts - i );
+	}
+}
+
+/*
+============
+MarkUsedVerts
+============
+*/
+static ID_INLINE bool *MarkUsedVerts( bool *used, const int numVerts, const int *indexes, const int numIndexes ) {
+	memset( used, 0, numVerts * sizeof( used[0] ) );
+	for ( int i = numIndexes - 1; i >= 0; i-- ) {
+		used[indexes[i]] = true;
+	}
+	return used;
+}
+
+/*
+============
+LoadTextureSpace
+
+  loads the position, tangents and normal of eight consecutive vertices
+============
+*/
+static inline AVX2_TARGET void LoadTextureSpace( const idDrawVert *verts, __m256 xyz[4], __m256 t0[4], __m256 t1[4], __m256 n[4] ) {
+	const float *v = verts->xyz.ToFloatPtr();
+	LoadStrided4( v + DRAWVERT_XYZ_OFFSET, DRAWVERT_FLOATS, xyz );
+	LoadStrided4( v + DRAWVERT_NORMAL_OFFSET, DRAWVERT_FLOATS, n );
+	LoadStrided4( v + DRAWVERT_TANGENT0_OFFSET, DRAWVERT_FLOATS, t0 );
+	LoadStrided4( v + DRAWVERT_TANGENT1_OFFSET, DRAWVERT_FLOATS, t1 );
+}
+
+/*
+============
+Dot3
+
+  d.x * a[0] + d.y * a[1] + d.z * a[2] for eight vectors
+============
+*/
+static inline AVX2_TARGET __m256 Dot3( const __m256 dx, const __m256 dy, const __m256 dz, const __m256 a[4] ) {
+	return _mm256_add_ps( _mm256_mul_ps( dz, a[2] ), _mm256_add_ps( _mm256_mul_ps( dy, a[1] ), _mm256_mul_ps( dx, a[0] ) ) );
+}
+
+/*
+============
+idSIMD_AVX2::CreateTextureSpaceLightVectors
+
+	Calculates light vectors in texture space for the given triangle vertices.
+	For each vertex the direction towards the light origin is projected onto texture space.
+	The light vectors are only calculated for the vertices referenced by the indexes.
+============
+*/
+void VPCALL idSIMD_AVX2::CreateTextureSpaceLightVectors( idVec3 *lightVectors, const idVec3 &lightOrigin, const idDrawVert *verts, const int numVerts, const int *indexes, const int numIndexes ) {
+	int i;
+
+	assert( sizeof( idDrawVert ) == DRAWVERT_FLOATS * sizeof( float ) );
+
+	bool *used = MarkUsedVerts( (bool *)_alloca16( numVerts * sizeof( bool ) ), numVerts, indexes, numIndexes );
+
+	const __m256 lx = _mm256_set1_ps( lightOrigin.x );
+	const __m256 ly = _mm256_set1_ps( lightOrigin.y );
+	const __m256 lz = _mm256_set1_ps( lightOrigin.z );
+
+	for ( i = 0; i + 8 <= numVerts; i += 8 ) {
+		__m256 xyz[4], t0[4], t1[4], n[4];
+		LoadTextureSpace( verts + i, xyz, t0, t1, n );
+
+		const __m256 dx = _mm256_sub_ps( lx, xyz[0] );
+		const __m256 dy = _mm256_sub_ps( ly, xyz[1] );
+		const __m256 dz = _mm256_sub_ps( lz, xyz[2] );
+
+		__m256 l[4];
+		l[0] = Dot3( dx, dy, dz, t0 );
+		l[1] = Dot3( dx, dy, dz, t1 );
+		l[2] = Dot3( dx, dy, dz, n );
+		l[3] = l[2];
+
+		if ( AllUsed( used + i ) ) {
+			StoreVec3( lightVectors + i, l );
+			continue;
+		}
+
+		ALIGN16( float r[8][4] );
+		StoreStrided4( r[0], 4, l );
+		for ( int n = 0; n < 8; n++ ) {
+			if ( used[i+n] ) {
+				lightVectors[i+n].Set( r[n][0], r[n][1], r[n][2] );
+			}
+		}
+	}
+
+	for ( ; i < numVerts; i++ ) {
+		if ( !used[i] ) {
+			continue;
+		}
+
+		const idDrawVert *v = &verts[i];
+
+		idVec3 lightDir = lightOrigin - v->xyz;
+
+		lightVectors[i][0] = lightDir * v->tangents[0];
+		lightVectors[i][1] = lightDir * v->tangents[1];
+		lightVectors[i][2] = lightDir * v->normal;
+	}
+}
+
+/*
+============
+idSIMD_AVX2::CreateSpecularTextureCoords
+
+	Calculates specular texture coordinates for the given triangle vertices.
+	For each vertex the normalized direction towards the light origin is added to the
+	normalized direction towards the view origin and the result is projected onto texture space.
+	The texture coordinates are only calculated for the vertices referenced by the indexes.
+============
+*/
+void VPCALL idSIMD_AVX2::CreateSpecularTextureCoords( idVec4 *texCoords, const idVec3 &lightOrigin, const idVec3 &viewOrigin, const idDrawVert *verts, const int numVerts, const int *indexes, const int numIndexes ) {
+	int i;
+
+	assert( sizeof( idDrawVert ) == DRAWVERT_FLOATS * sizeof( float ) );
+
+	bool *used = MarkUsedVerts( (bool *)_alloca16( numVerts * sizeof( bool ) ), numVerts, indexes, numIndexes );
+
+	for ( i = 0; i + 8 <= numVerts; i += 8 ) {
+		__m256 xyz[4], t0[4], t1[4], n[4];
+		LoadTextureSpace( verts + i, xyz, t0, t1, n );
+
+		const __m256 lx = _mm256_sub_ps( _mm256_set1_ps( lightOrigin.x ), xyz[0] );
+		const __m256 ly = _mm256_sub_ps( _mm256_set1_ps( lightOrigin.y ), xyz[1] );
+		const __m256 lz = _mm256_sub_ps( _mm256_set1_ps( lightOrigin.z ), xyz[2] );
+		const __m256 ex = _mm256_sub_ps( _mm256_set1_ps( viewOrigin.x ), xyz[0] );
+		const __m256 ey = _mm256_sub_ps( _mm256_set1_ps( viewOrigin.y ), xyz[1] );
+		const __m256 ez = _mm256_sub_ps( _mm256_set1_ps( viewOrigin.z ), xyz[2] );
+
+		const __m256 il = ReciprocalSqrt( _mm256_add_ps( _mm256_mul_ps( lx, lx ), _mm256_add_ps( _mm256_mul_ps( ly, ly ), _mm256_mul_ps( lz, lz ) ) ) );
+		const __m256 ie = ReciprocalSqrt( _mm256_add_ps( _mm256_mul_ps( ex, ex ), _mm256_add_ps( _mm256_mul_ps( ey, ey ), _mm256_mul_ps( ez, ez ) ) ) );
+
+		const __m256 hx = _mm256_add_ps( _mm256_mul_ps( lx, il ), _mm256_mul_ps( ex, ie ) );
+		const __m256 hy = _mm256_add_ps( _mm256_mul_ps( ly, il ), _mm256_mul_ps( ey, ie ) );
+		const __m256 hz = _mm256_add_ps( _mm256_mul_ps( lz, il ), _mm256_mul_ps( ez, ie ) );
+
+		__m256 t[4];
+		t[0] = Dot3( hx, hy, hz, t0 );
+		t[1] = Dot3( hx, hy, hz, t1 );
+		t[2] = Dot3( hx, hy, hz, n );
+		t[3] = _mm256_set1_ps( 1.0f );
+
+		if ( AllUsed( used + i ) ) {
+			StoreStrided4( texCoords[i].ToFloatPtr(), 4, t );
+			continue;
+		}
+
+		ALIGN16( float r[8][4] );
+		StoreStrided4( r[0], 4, t );
+		for ( int n = 0; n < 8; n++ ) {
+			if ( used[i+n] ) {
+				_mm_storeu_ps( texCoords[i+n].ToFloatPtr(), _mm_load_ps( r[n] ) );
+			}
+		}
+	}
+
+	for ( ; i < numVerts; i++ ) {
+		if ( !used[i] ) {
+			continue;
+		}
+
+		const idDrawVert *v = &verts[i];
+
+		idVec3 lightDir = lightOrigin - v->xyz;
+		idVec3 viewDir = viewOrigin - v->xyz;
+
+		float ilength;
+
+		ilength = idMath::RSqrt( lightDir * lightDir );
+		lightDir[0] *= ilength;
+		lightDir[1] *= ilength;
+		lightDir[2] *= ilength;
+
+		ilength = idMath::RSqrt( viewDir * viewDir );
+		viewDir[0] *= ilength;
+		viewDir[1] *= ilength;
+		viewDir[2] *= ilength;
+
+		lightDir += viewDir;
+
+		texCoords[i][0] = lightDir * v->tangents[0];
+		texCoords[i][1] = lightDir * v->tangents[1];
+		texCoords[i][2] = lightDir * v->normal;
+		texCoords[i][3] = 1.0f;
+	}
+}
+
+/*
+============
+idSIMD_AVX2::CreateShadowCache
+
+  The vertex remapping is inherently serial, but each vertex pair is written with two
+  four wide stores. The fourth float of the position load is the first texture coordinate
+  and is masked away.
+============
+*/
+int VPCALL idSIMD_AVX2::CreateShadowCache( idVec4 *vertexCache, int *vertRemap, const idVec3 &lightOrigin, const idDrawVert *verts, const int numVerts ) {
+	const __m128 xyzMask = _mm_castsi128_ps( _mm_setr_epi32( -1, -1, -1, 0 ) );
+	const __m128 wOne = _mm_setr_ps( 0.0f, 0.0f, 0.0f, 1.0f );
+	const __m128 origin = _mm_setr_ps( lightOrigin[0], lightOrigin[1], lightOrigin[2], 0.0f );
+	int outVerts = 0;
+
+	for ( int i = 0; i < numVerts; i++ ) {
+		if ( vertRemap[i] ) {
+			continue;
+		}
+		const __m128 v = _mm_and_ps( _mm_loadu_ps( verts[i].xyz.ToFloatPtr() ), xyzMask );
+		_mm_storeu_ps( vertexCache[outVerts+0].ToFloatPtr(), _mm_or_ps( v, wOne ) );
+		// R_SetupProjection() builds the projection matrix with a slight crunch
+		// for depth, which keeps this w=0 division from rasterizing right at the
+		// wrap around point and causing depth fighting with the rear caps
+		_mm_storeu_ps( vertexCache[outVerts+1].ToFloatPtr(), _mm_sub_ps( v, origin ) );
+		vertRemap[i] = outVerts;
+		outVerts += 2;
+	}
+	return outVerts;
+}
+
+/*
+============
+idSIMD_AVX2::CreateVertexProgramShadowCache
+============
+*/
+int VPCALL idSIMD_AVX2::CreateVertexProgramShadowCache( idVec4 *vertexCache, const idDrawVert *verts, const int numVerts ) {
+	const __m128 xyzMask = _mm_castsi128_ps( _mm_setr_epi32( -1, -1, -1, 0 ) );
+	const __m128 wOne = _mm_setr_ps( 0.0f, 0.0f, 0.0f, 1.0f );
+
+	for ( int i = 0; i < numVerts; i++ ) {
+		const __m128 v = _mm_and_ps( _mm_loadu_ps( verts[i].xyz.ToFloatPtr() ), xyzMask );
+		_mm256_storeu_ps( vertexCache[i*2].ToFloatPtr(), _mm256_set_m128( v, _mm_or_ps( v, wOne ) ) );
+	}
+	return numVerts * 2;
+}
+
+/*
+============
+MixSpeakers
+
+  Mixes four sample frames at a time into 'numSpeakers' interleaved speakers. The speaker
+  volumes are ramped from lastV to currentV over MIXBUFFER_SAMPLES frames. 'sampleIndex'
+  maps each of the numSpeakers * 4 outputs to one of the eight input samples. The volume
+  ramp is stepped one frame at a time like the generic version so the result is exact.
+============
+*/
+static inline AVX2_TARGET void MixSpeakers( float *mixBuffer, const float *samples, const int samplesPerFrame, const int numSpeakers,
+											const float *lastV, const float *currentV, const int *sampleIndex ) {
+	const int numBlocks = numSpeakers * 4 / 8;
+	ALIGN16( float gain[24] );
+	ALIGN16( float step[24] );
+
+	assert( numBlocks <= 3 );
+
+	for ( int s = 0; s < numSpeakers; s++ ) {
+		const float inc = ( currentV[s] - lastV[s] ) / MIXBUFFER_SAMPLES;
+		float v = lastV[s];
+		for ( int f = 0; f < 4; f++ ) {
+			gain[f * numSpeakers + s] = v;
+			step[f * numSpeakers + s] = inc;
+			v += inc;
+		}
+	}
+
+	__m256 g[3], st[3];
+	__m256i idx[3];
+	for ( int b = 0; b < numBlocks; b++ ) {
+		g[b] = _mm256_loadu_ps( gain + b * 8 );
+		st[b] = _mm256_loadu_ps( step + b * 8 );
+		idx[b] = _mm256_loadu_si256( (const __m256i *)( sampleIndex + b * 8 ) );
+	}
+
+	for ( int j = 0; j < MIXBUFFER_SAMPLES; j += 4 ) {
+		const __m256 in = ( samplesPerFrame == 1 ) ? _mm256_castps128_ps256( _mm_loadu_ps( samples + j ) ) : _mm256_loadu_ps( samples + j * 2 );
+		float *out = mixBuffer + j * numSpeakers;
+		for ( int b = 0; b < numBlocks; b++ ) {
+			const __m256 s = _mm256_permutevar8x32_ps( in, idx[b] );
+			_mm256_storeu_ps( out + b * 8, _mm256_add_ps( _mm256_loadu_ps( out + b * 8 ), _mm256_mul_ps( s, g[b] ) ) );
+			g[b] = _mm256_add_ps( _mm256_add_ps( _mm256_add_ps( _mm256_add_ps( g[b], st[b] ), st[b] ), st[b] ), st[b] );
+		}
+	}
+}
+
+/*
+============
+idSIMD_AVX2::MixSoundSixSpeakerMono
+============
+*/
+void VPCALL idSIMD_AVX2::MixSoundSixSpeakerMono( float *mixBuffer, const float *samples, const int numSamples, const float lastV[6], const float currentV[6] ) {
+	static const int sampleIndex[24] = {
+		0, 0, 0, 0, 0, 0, 1, 1,
+		1, 1, 1, 1, 2, 2, 2, 2,
+		2, 2, 3, 3, 3, 3, 3, 3
+	};
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	MixSpeakers( mixBuffer, samples, 1, 6, lastV, currentV, sampleIndex );
+}
+
+/*
+============
+idSIMD_AVX2::MixSoundSixSpeakerStereo
+
+  the left, center, lfe and back left speakers take the left sample, right and back right the right one
+============
+*/
+void VPCALL idSIMD_AVX2::MixSoundSixSpeakerStereo( float *mixBuffer, const float *samples, const int numSamples, const float lastV[6], const float currentV[6] ) {
+	static const int sampleIndex[24] = {
+		0, 1, 0, 0, 0, 1, 2, 3,
+		2, 2, 2, 3, 4, 5, 4, 4,
+		4, 5, 6, 7, 6, 6, 6, 7
+	};
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	MixSpeakers( mixBuffer, samples, 2, 6, lastV, currentV, sampleIndex );
+}
+
+/*
+============
+idSIMD_AVX2::MixedSoundToSamples
+============
+*/
+void VPCALL idSIMD_AVX2::MixedSoundToSamples( short *samples, const float *mixBuffer, const int numSamples ) {
+	const __m256 vmin = _mm256_set1_ps( -32768.0f );
+	const __m256 vmax = _mm256_set1_ps( 32767.0f );
+	int i = 0;
+
+	for ( ; i + 8 <= numSamples; i += 8 ) {
+		const __m256 v = _mm256_min_ps( _mm256_max_ps( _mm256_loadu_ps( mixBuffer + i ), vmin ), vmax );
+		const __m256i s = _mm256_cvttps_epi32( v );
+		_mm_storeu_si128( (__m128i *)( samples + i ), _mm_packs_epi32( _mm256_castsi256_si128( s ), _mm256_extracti128_si256( s, 1 ) ) );
+	}
+
+	for ( ; i < numSamples; i++ ) {
+		if ( mixBuffer[i] <= -32768.0f ) {
+			samples[i] = -32768;
+		} else if ( mixBuffer[i] >= 32767.0f ) {
+			samples[i] = 32767;
+		} else {
+			samples[i] = (short) mixBuffer[i];
+		}
+	}
+}
+
+#endif /* ID_HAVE_AVX2_SIMD */
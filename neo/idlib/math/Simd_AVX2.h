@@ -0,0 +1,143 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __MATH_SIMD_AVX2_H__
+#define __MATH_SIMD_AVX2_H__
+
+#include "idlib/math/Simd_SSE3.h"
+
+/*
+===============================================================================
+
+	AVX2 implementation of idSIMDProcessor
+
+	Written with <immintrin.h> intrinsics for GCC and clang on x86_64.
+	The rest of the engine is not built with -mavx2, so each function is
+	compiled for AVX2 through the target attribute and must only ever
+	be called after idSIMD::InitProcessor() checked CPUID_AVX2.
+
+	No fused multiply-add is used, the engine is built with -ffp-contract=off
+	so all processors round the same way and demos and physics stay in sync.
+
+	The idMatX solvers are inherited, their generic versions are already
+	specialized for the small (N <= 6) matrices the LCP solvers use. Memcpy and
+	Memset are inherited as well, the C library versions already use AVX.
+	BlendJoints is inherited because gathering and scattering the seven float
+	joints costs as much as the scalar slerp it would replace. The up-sampling
+	and two speaker mixing are inherited because the SSE versions are faster.
+
+===============================================================================
+*/
+
+#if defined(__GNUC__) && defined(__x86_64__) && ( defined(__clang__) || __GNUC__ > 4 || ( __GNUC__ == 4 && __GNUC_MINOR__ >= 9 ) )
+#define ID_HAVE_AVX2_SIMD
+#define AVX2_TARGET		__attribute__((target("avx2")))
+#else
+#define AVX2_TARGET
+#endif
+
+class idSIMD_AVX2 : public idSIMD_SSE3 {
+public:
+#ifdef ID_HAVE_AVX2_SIMD
+	virtual const char * VPCALL GetName( void ) const;
+
+	AVX2_TARGET virtual void VPCALL Add( float *dst,			const float constant,	const float *src,		const int count );
+	AVX2_TARGET virtual void VPCALL Add( float *dst,			const float *src0,		const float *src1,		const int count );
+	AVX2_TARGET virtual void VPCALL Sub( float *dst,			const float constant,	const float *src,		const int count );
+	AVX2_TARGET virtual void VPCALL Sub( float *dst,			const float *src0,		const float *src1,		const int count );
+	AVX2_TARGET virtual void VPCALL Mul( float *dst,			const float constant,	const float *src,		const int count );
+	AVX2_TARGET virtual void VPCALL Mul( float *dst,			const float *src0,		const float *src1,		const int count );
+	AVX2_TARGET virtual void VPCALL Div( float *dst,			const float constant,	const float *src,		const int count );
+	AVX2_TARGET virtual void VPCALL Div( float *dst,			const float *src0,		const float *src1,		const int count );
+	AVX2_TARGET virtual void VPCALL MulAdd( float *dst,			const float constant,	const float *src,		const int count );
+	AVX2_TARGET virtual void VPCALL MulAdd( float *dst,			const float *src0,		const float *src1,		const int count );
+	AVX2_TARGET virtual void VPCALL MulSub( float *dst,			const float constant,	const float *src,		const int count );
+	AVX2_TARGET virtual void VPCALL MulSub( float *dst,			const float *src0,		const float *src1,		const int count );
+
+	AVX2_TARGET virtual void VPCALL Dot( float *dst,			const idVec3 &constant,	const idVec3 *src,		const int count );
+	AVX2_TARGET virtual void VPCALL Dot( float *dst,			const idVec3 &constant,	const idPlane *src,		const int count );
+	AVX2_TARGET virtual void VPCALL Dot( float *dst,			const idVec3 &constant,	const idDrawVert *src,	const int count );
+	AVX2_TARGET virtual void VPCALL Dot( float *dst,			const idPlane &constant,const idVec3 *src,		const int count );
+	AVX2_TARGET virtual void VPCALL Dot( float *dst,			const idPlane &constant,const idPlane *src,		const int count );
+	AVX2_TARGET virtual void VPCALL Dot( float *dst,			const idPlane &constant,const idDrawVert *src,	const int count );
+	AVX2_TARGET virtual void VPCALL Dot( float *dst,			const idVec3 *src0,		const idVec3 *src1,		const int count );
+	AVX2_TARGET virtual void VPCALL Dot( float &dot,			const float *src1,		const float *src2,		const int count );
+
+	AVX2_TARGET virtual void VPCALL CmpGT( byte *dst,			const float *src0,		const float constant,	const int count );
+	AVX2_TARGET virtual void VPCALL CmpGT( byte *dst,			const byte bitNum,		const float *src0,		const float constant,	const int count );
+	AVX2_TARGET virtual void VPCALL CmpGE( byte *dst,			const float *src0,		const float constant,	const int count );
+	AVX2_TARGET virtual void VPCALL CmpGE( byte *dst,			const byte bitNum,		const float *src0,		const float constant,	const int count );
+	AVX2_TARGET virtual void VPCALL CmpLT( byte *dst,			const float *src0,		const float constant,	const int count );
+	AVX2_TARGET virtual void VPCALL CmpLT( byte *dst,			const byte bitNum,		const float *src0,		const float constant,	const int count );
+	AVX2_TARGET virtual void VPCALL CmpLE( byte *dst,			const float *src0,		const float constant,	const int count );
+	AVX2_TARGET virtual void VPCALL CmpLE( byte *dst,			const byte bitNum,		const float *src0,		const float constant,	const int count );
+
+	AVX2_TARGET virtual void VPCALL MinMax( float &min,			float &max,				const float *src,		const int count );
+	AVX2_TARGET virtual void VPCALL MinMax( idVec2 &min,		idVec2 &max,			const idVec2 *src,		const int count );
+	AVX2_TARGET virtual void VPCALL MinMax( idVec3 &min,		idVec3 &max,			const idVec3 *src,		const int count );
+	AVX2_TARGET virtual void VPCALL MinMax( idVec3 &min,		idVec3 &max,			const idDrawVert *src,	const int count );
+	AVX2_TARGET virtual void VPCALL MinMax( idVec3 &min,		idVec3 &max,			const idDrawVert *src,	const int *indexes,		const int count );
+
+	AVX2_TARGET virtual void VPCALL Clamp( float *dst,			const float *src,		const float min,		const float max,		const int count );
+	AVX2_TARGET virtual void VPCALL ClampMin( float *dst,		const float *src,		const float min,		const int count );
+	AVX2_TARGET virtual void VPCALL ClampMax( float *dst,		const float *src,		const float max,		const int count );
+
+	AVX2_TARGET virtual void VPCALL Zero16( float *dst,			const int count );
+	AVX2_TARGET virtual void VPCALL Negate16( float *dst,		const int count );
+	AVX2_TARGET virtual void VPCALL Copy16( float *dst,			const float *src,		const int count );
+	AVX2_TARGET virtual void VPCALL Add16( float *dst,			const float *src1,		const float *src2,		const int count );
+	AVX2_TARGET virtual void VPCALL Sub16( float *dst,			const float *src1,		const float *src2,		const int count );
+	AVX2_TARGET virtual void VPCALL Mul16( float *dst,			const float *src1,		const float constant,	const int count );
+	AVX2_TARGET virtual void VPCALL AddAssign16( float *dst,	const float *src,		const int count );
+	AVX2_TARGET virtual void VPCALL SubAssign16( float *dst,	const float *src,		const int count );
+	AVX2_TARGET virtual void VPCALL MulAssign16( float *dst,	const float constant,	const int count );
+
+	AVX2_TARGET virtual void VPCALL ConvertJointQuatsToJointMats( idJointMat *jointMats, const idJointQuat *jointQuats, const int numJoints );
+	AVX2_TARGET virtual void VPCALL TransformJoints( idJointMat *jointMats, const int *parents, const int firstJoint, const int lastJoint );
+	AVX2_TARGET virtual void VPCALL UntransformJoints( idJointMat *jointMats, const int *parents, const int firstJoint, const int lastJoint );
+	AVX2_TARGET virtual void VPCALL TransformVerts( idDrawVert *verts, const int numVerts, const idJointMat *joints, const idVec4 *weights, const int *index, const int numWeights );
+	AVX2_TARGET virtual void VPCALL TracePointCull( byte *cullBits, byte &totalOr, const float radius, const idPlane *planes, const idDrawVert *verts, const int numVerts );
+	AVX2_TARGET virtual void VPCALL DecalPointCull( byte *cullBits, const idPlane *planes, const idDrawVert *verts, const int numVerts );
+	AVX2_TARGET virtual void VPCALL OverlayPointCull( byte *cullBits, idVec2 *texCoords, const idPlane *planes, const idDrawVert *verts, const int numVerts );
+	AVX2_TARGET virtual void VPCALL DeriveTriPlanes( idPlane *planes, const idDrawVert *verts, const int numVerts, const int *indexes, const int numIndexes );
+	AVX2_TARGET virtual void VPCALL DeriveTangents( idPlane *planes, idDrawVert *verts, const int numVerts, const int *indexes, const int numIndexes );
+	AVX2_TARGET virtual void VPCALL DeriveUnsmoothedTangents( idDrawVert *verts, const dominantTri_s *dominantTris, const int numVerts );
+	AVX2_TARGET virtual void VPCALL NormalizeTangents( idDrawVert *verts, const int numVerts );
+	AVX2_TARGET virtual void VPCALL CreateTextureSpaceLightVectors( idVec3 *lightVectors, const idVec3 &lightOrigin, const idDrawVert *verts, const int numVerts, const int *indexes, const int numIndexes );
+	AVX2_TARGET virtual void VPCALL CreateSpecularTextureCoords( idVec4 *texCoords, const idVec3 &lightOrigin, const idVec3 &viewOrigin, const idDrawVert *verts, const int numVerts, const int *indexes, const int numIndexes );
+	AVX2_TARGET virtual int  VPCALL CreateShadowCache( idVec4 *vertexCache, int *vertRemap, const idVec3 &lightOrigin, const idDrawVert *verts, const int numVerts );
+	AVX2_TARGET virtual int  VPCALL CreateVertexProgramShadowCache( idVec4 *vertexCache, const idDrawVert *verts, const int numVerts );
+
+	AVX2_TARGET virtual void VPCALL MixSoundSixSpeakerMono( float *mixBuffer, const float *samples, const int numSamples, const float lastV[6], const float currentV[6] );
+	AVX2_TARGET virtual void VPCALL MixSoundSixSpeakerStereo( float *mixBuffer, const float *samples, const int numSamples, const float lastV[6], const float currentV[6] );
+	AVX2_TARGET virtual void VPCALL MixedSoundToSamples( short *samples, const float *mixBuffer, const int numSamples );
+
+#endif
+};
+
+#endif /* !__MATH_SIMD_AVX2_H__ */
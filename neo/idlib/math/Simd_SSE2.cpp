@@ -239,6 +239,276 @@ void VPCALL idSIMD_SSE2::CmpLT( byte *dst, const byte bitNum, const float *src0,
 	}
 }
 
+#define SPLATPS( v, a, b, c, d )	_mm_shuffle_ps( (v), (v), R_SHUFFLEPS( a, b, c, d ) )
+
+/*
+============
+StoreDuplicated
+
+  writes the four floats of 'v' 'times' times each, 'width' floats are kept together
+============
+*/
+static inline void StoreDuplicated( float *dest, const __m128 v, const int times, const int width ) {
+	if ( times == 1 ) {
+		_mm_storeu_ps( dest, v );
+	} else if ( width == 1 ) {
+		if ( times == 2 ) {
+			_mm_storeu_ps( dest + 0, _mm_unpacklo_ps( v, v ) );
+			_mm_storeu_ps( dest + 4, _mm_unpackhi_ps( v, v ) );
+		} else {
+			_mm_storeu_ps( dest + 0, SPLATPS( v, 0, 0, 0, 0 ) );
+			_mm_storeu_ps( dest + 4, SPLATPS( v, 1, 1, 1, 1 ) );
+			_mm_storeu_ps( dest + 8, SPLATPS( v, 2, 2, 2, 2 ) );
+			_mm_storeu_ps( dest + 12, SPLATPS( v, 3, 3, 3, 3 ) );
+		}
+	} else {
+		const __m128 lo = _mm_movelh_ps( v, v );
+		const __m128 hi = _mm_movehl_ps( v, v );
+		if ( times == 2 ) {
+			_mm_storeu_ps( dest + 0, lo );
+			_mm_storeu_ps( dest + 4, hi );
+		} else {
+			_mm_storeu_ps( dest + 0, lo );
+			_mm_storeu_ps( dest + 4, lo );
+			_mm_storeu_ps( dest + 8, hi );
+			_mm_storeu_ps( dest + 12, hi );
+		}
+	}
+}
+
+/*
+============
+idSIMD_SSE2::UpSamplePCMTo44kHz
+
+  Duplicate samples for 44kHz output.
+============
+*/
+void VPCALL idSIMD_SSE2::UpSamplePCMTo44kHz( float *dest, const short *src, const int numSamples, const int kHz, const int numChannels ) {
+	int times;
+
+	if ( kHz == 11025 ) {
+		times = 4;
+	} else if ( kHz == 22050 ) {
+		times = 2;
+	} else if ( kHz == 44100 ) {
+		times = 1;
+	} else {
+		assert( 0 );
+		return;
+	}
+
+	int i = 0;
+	for ( ; i + 4 <= numSamples; i += 4 ) {
+		const __m128i s = _mm_loadl_epi64( (const __m128i *)( src + i ) );
+		const __m128 v = _mm_cvtepi32_ps( _mm_srai_epi32( _mm_unpacklo_epi16( s, s ), 16 ) );
+		StoreDuplicated( dest + i * times, v, times, numChannels );
+	}
+
+	if ( i < numSamples ) {
+		idSIMD_Generic::UpSamplePCMTo44kHz( dest + i * times, src + i, numSamples - i, kHz, numChannels );
+	}
+}
+
+/*
+============
+idSIMD_SSE2::UpSampleOGGTo44kHz
+
+  Duplicate samples for 44kHz output.
+============
+*/
+void VPCALL idSIMD_SSE2::UpSampleOGGTo44kHz( float *dest, const float * const *ogg, const int numSamples, const int kHz, const int numChannels ) {
+	int times;
+
+	if ( kHz == 11025 ) {
+		times = 4;
+	} else if ( kHz == 22050 ) {
+		times = 2;
+	} else if ( kHz == 44100 ) {
+		times = 1;
+	} else {
+		assert( 0 );
+		return;
+	}
+
+	const __m128 scale = _mm_set1_ps( 32768.0f );
+	int i = 0;
+
+	if ( numChannels == 1 ) {
+		for ( ; i + 4 <= numSamples; i += 4 ) {
+			StoreDuplicated( dest + i * times, _mm_mul_ps( _mm_loadu_ps( ogg[0] + i ), scale ), times, 1 );
+		}
+		if ( i < numSamples ) {
+			const float *rest[1] = { ogg[0] + i };
+			idSIMD_Generic::UpSampleOGGTo44kHz( dest + i * times, rest, numSamples - i, kHz, numChannels );
+		}
+	} else {
+		const int numFrames = numSamples >> 1;
+		for ( ; i + 4 <= numFrames; i += 4 ) {
+			const __m128 l = _mm_mul_ps( _mm_loadu_ps( ogg[0] + i ), scale );
+			const __m128 r = _mm_mul_ps( _mm_loadu_ps( ogg[1] + i ), scale );
+			StoreDuplicated( dest + i * 2 * times + 0, _mm_unpacklo_ps( l, r ), times, 2 );
+			StoreDuplicated( dest + i * 2 * times + 4 * times, _mm_unpackhi_ps( l, r ), times, 2 );
+		}
+		if ( i < numFrames ) {
+			const float *rest[2] = { ogg[0] + i, ogg[1] + i };
+			idSIMD_Generic::UpSampleOGGTo44kHz( dest + i * 2 * times, rest, numSamples - i * 2, kHz, numChannels );
+		}
+	}
+}
+
+/*
+============
+InitMixGains
+
+  Sets up the speaker volumes of four sample frames, ramped from lastV to currentV over
+  MIXBUFFER_SAMPLES frames. The ramp is stepped one frame at a time like the generic
+  version so the result is exact.
+============
+*/
+static inline void InitMixGains( __m128 *gain, __m128 *step, const int numSpeakers, const float *lastV, const float *currentV ) {
+	ALIGN16( float g[24] );
+	ALIGN16( float s[24] );
+
+	for ( int i = 0; i < numSpeakers; i++ ) {
+		const float inc = ( currentV[i] - lastV[i] ) / MIXBUFFER_SAMPLES;
+		float v = lastV[i];
+		for ( int f = 0; f < 4; f++ ) {
+			g[f * numSpeakers + i] = v;
+			s[f * numSpeakers + i] = inc;
+			v += inc;
+		}
+	}
+	for ( int b = 0; b < numSpeakers; b++ ) {
+		gain[b] = _mm_load_ps( g + b * 4 );
+		step[b] = _mm_load_ps( s + b * 4 );
+	}
+}
+
+/*
+============
+MixBlock
+
+  adds four sample frames, spread over 'numVecs' vectors, to the mix buffer and steps the volumes
+============
+*/
+static inline void MixBlock( float *out, const __m128 *samples, __m128 *gain, const __m128 *step, const int numVecs ) {
+	for ( int b = 0; b < numVecs; b++ ) {
+		_mm_storeu_ps( out + b * 4, _mm_add_ps( _mm_loadu_ps( out + b * 4 ), _mm_mul_ps( samples[b], gain[b] ) ) );
+		gain[b] = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_add_ps( gain[b], step[b] ), step[b] ), step[b] ), step[b] );
+	}
+}
+
+/*
+============
+idSIMD_SSE2::MixSoundTwoSpeakerMono
+============
+*/
+void VPCALL idSIMD_SSE2::MixSoundTwoSpeakerMono( float *mixBuffer, const float *samples, const int numSamples, const float lastV[2], const float currentV[2] ) {
+	__m128 gain[2], step[2], s[2];
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	InitMixGains( gain, step, 2, lastV, currentV );
+
+	for ( int j = 0; j < MIXBUFFER_SAMPLES; j += 4 ) {
+		const __m128 in = _mm_loadu_ps( samples + j );
+		s[0] = _mm_unpacklo_ps( in, in );
+		s[1] = _mm_unpackhi_ps( in, in );
+		MixBlock( mixBuffer + j * 2, s, gain, step, 2 );
+	}
+}
+
+/*
+============
+idSIMD_SSE2::MixSoundTwoSpeakerStereo
+============
+*/
+void VPCALL idSIMD_SSE2::MixSoundTwoSpeakerStereo( float *mixBuffer, const float *samples, const int numSamples, const float lastV[2], const float currentV[2] ) {
+	__m128 gain[2], step[2], s[2];
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	InitMixGains( gain, step, 2, lastV, currentV );
+
+	for ( int j = 0; j < MIXBUFFER_SAMPLES; j += 4 ) {
+		s[0] = _mm_loadu_ps( samples + j * 2 + 0 );
+		s[1] = _mm_loadu_ps( samples + j * 2 + 4 );
+		MixBlock( mixBuffer + j * 2, s, gain, step, 2 );
+	}
+}
+
+/*
+============
+idSIMD_SSE2::MixSoundSixSpeakerMono
+============
+*/
+void VPCALL idSIMD_SSE2::MixSoundSixSpeakerMono( float *mixBuffer, const float *samples, const int numSamples, const float lastV[6], const float currentV[6] ) {
+	__m128 gain[6], step[6], s[6];
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	InitMixGains( gain, step, 6, lastV, currentV );
+
+	for ( int j = 0; j < MIXBUFFER_SAMPLES; j += 4 ) {
+		const __m128 in = _mm_loadu_ps( samples + j );
+		s[0] = SPLATPS( in, 0, 0, 0, 0 );
+		s[1] = SPLATPS( in, 0, 0, 1, 1 );
+		s[2] = SPLATPS( in, 1, 1, 1, 1 );
+		s[3] = SPLATPS( in, 2, 2, 2, 2 );
+		s[4] = SPLATPS( in, 2, 2, 3, 3 );
+		s[5] = SPLATPS( in, 3, 3, 3, 3 );
+		MixBlock( mixBuffer + j * 6, s, gain, step, 6 );
+	}
+}
+
+/*
+============
+idSIMD_SSE2::MixSoundSixSpeakerStereo
+
+  the left, center, lfe and back left speakers take the left sample, right and back right the right one
+============
+*/
+void VPCALL idSIMD_SSE2::MixSoundSixSpeakerStereo( float *mixBuffer, const float *samples, const int numSamples, const float lastV[6], const float currentV[6] ) {
+	__m128 gain[6], step[6], s[6];
+
+	assert( numSamples == MIXBUFFER_SAMPLES );
+
+	InitMixGains( gain, step, 6, lastV, currentV );
+
+	for ( int j = 0; j < MIXBUFFER_SAMPLES; j += 4 ) {
+		const __m128 in0 = _mm_loadu_ps( samples + j * 2 + 0 );
+		const __m128 in1 = _mm_loadu_ps( samples + j * 2 + 4 );
+		s[0] = SPLATPS( in0, 0, 1, 0, 0 );
+		s[1] = in0;
+		s[2] = SPLATPS( in0, 2, 2, 2, 3 );
+		s[3] = SPLATPS( in1, 0, 1, 0, 0 );
+		s[4] = in1;
+		s[5] = SPLATPS( in1, 2, 2, 2, 3 );
+		MixBlock( mixBuffer + j * 6, s, gain, step, 6 );
+	}
+}
+
+/*
+============
+idSIMD_SSE2::MixedSoundToSamples
+============
+*/
+void VPCALL idSIMD_SSE2::MixedSoundToSamples( short *samples, const float *mixBuffer, const int numSamples ) {
+	const __m128 vmin = _mm_set1_ps( -32768.0f );
+	const __m128 vmax = _mm_set1_ps( 32767.0f );
+	int i = 0;
+
+	for ( ; i + 8 <= numSamples; i += 8 ) {
+		const __m128 v0 = _mm_min_ps( _mm_max_ps( _mm_loadu_ps( mixBuffer + i + 0 ), vmin ), vmax );
+		const __m128 v1 = _mm_min_ps( _mm_max_ps( _mm_loadu_ps( mixBuffer + i + 4 ), vmin ), vmax );
+		_mm_storeu_si128( (__m128i *)( samples + i ), _mm_packs_epi32( _mm_cvttps_epi32( v0 ), _mm_cvttps_epi32( v1 ) ) );
+	}
+
+	if ( i < numSamples ) {
+		idSIMD_Generic::MixedSoundToSamples( samples + i, mixBuffer + i, numSamples - i );
+	}
+}
+
 #elif defined(_MSC_VER) && defined(_M_IX86)
 
 #include <xmmintrin.h>
@@ -168,6 +168,16 @@ typedef enum {
 
 #define	MAX_IMAGE_NAME	256
 
+// the mip levels of a 2D image before they are uploaded
+const int MAX_IMAGE_LEVELS = 16;
+
+typedef struct {
+	int			numLevels;
+	int			width, height;		// size of the first level
+	byte *		levels[MAX_IMAGE_LEVELS];	// allocated with R_StaticAlloc()
+	bool		compressed;			// levels are blocks of the internalFormat made by R_CompressImage()
+} imageMipLevels_t;
+
 class idImage {
 public:
 				idImage();
@@ -229,6 +239,11 @@ public:
 	bool		CheckPrecompressedImage( bool fullLoad );
 	void		UploadPrecompressedImage( byte *data, int len );
 	void		ActuallyLoadImage( bool checkForPrecompressed, bool fromBackEnd );
+	bool		CanLoadInJob() const;
+	bool		LoadMipLevels( imageMipLevels_t &mips );		// can run in a job
+	void		FinishLoadImage( imageMipLevels_t &mips );
+	void		GenerateMipLevels( const byte *pic, int width, int height, imageMipLevels_t &mips );	// can run in a job
+	void		UploadMipLevels( imageMipLevels_t &mips );
 	void		StartBackgroundImageLoad();
 	int			BitsForInternalFormat( int internalFormat ) const;
 	void		UploadCompressedNormalMap( int width, int height, const byte *rgba, int mipLevel );
@@ -263,6 +278,7 @@ public:
 	bool				referencedOutsideLevelLoad;
 	bool				levelLoadReferenced;	// for determining if it needs to be purged
 	bool				precompressedFile;		// true when it was loaded from a .d3t file
+	bool				softwareCompressed;		// true when the levels were compressed by R_CompressImage()
 	bool				defaulted;				// true if the default image was generated because a file couldn't be loaded
 	ID_TIME_T				timestamp;				// the most recent of all images used in creation, for reloadImages command
 
@@ -302,6 +318,7 @@ ID_INLINE idImage::idImage() {
 	referencedOutsideLevelLoad = false;
 	levelLoadReferenced = false;
 	precompressedFile = false;
+	softwareCompressed = false;
 	defaulted = false;
 	timestamp = 0;
 	bindCount = 0;
@@ -399,6 +416,8 @@ public:
 	static idCVar		image_useNormalCompression;	// 1 = use 256 color compression for normal maps if available, 2 = use rxgb compression
 	static idCVar		image_useOffLineCompression; // will write a batch file with commands for the offline compression
 	static idCVar		image_preload;				// if 0, dynamically load all images
+	static idCVar		image_parallelLoad;			// 1 = decode and mip map images on the job threads during level load
+	static idCVar		image_softwareCompression;	// 1 = compress textures on the CPU and cache them as .dds files, 2 = don't cache them
 	static idCVar		image_cacheMinK;			// maximum K of precompressed files to read at specification time,
 													// the remainder will be dynamically cached
 	static idCVar		image_cacheMegs;			// maximum bytes set aside for temporary loading of full-sized precompressed images
@@ -441,6 +460,7 @@ public:
 	//--------------------------------------------------------
 
 	idImage *			AllocImage( const char *name );
+	void				LoadImagesInJobs( const idList<idImage *> &jobImages );
 	void				SetNormalPalette();
 	void				ChangeTextureFilter();
 
@@ -498,6 +518,12 @@ void R_HorizontalFlip( byte *data, int width, int height );
 void R_VerticalFlip( byte *data, int width, int height );
 void R_RotatePic( byte *data, int width );
 
+// block compression of the formats SelectInternalFormat() picks
+bool R_CanCompressImage( int internalFormat );
+int R_CompressedImageSize( int internalFormat, int width, int height );
+void R_CompressImage( int internalFormat, const byte *rgba, int width, int height, byte *out );
+void R_ImageCompressBench_f( const idCmdArgs &args );
+
 /*
 ====================================================================
 
@@ -510,6 +536,16 @@ void R_LoadImage( const char *name, byte **pic, int *width, int *height, ID_TIME
 // pic is in top to bottom raster format
 bool R_LoadCubeImages( const char *cname, cubeFiles_t extensions, byte *pic[6], int *size, ID_TIME_T *timestamp );
 
+// while image load jobs are active, these are safe to use from the job threads
+void R_BeginImageLoadJobs( void );
+void R_EndImageLoadJobs( void );
+bool R_ImageLoadJobsActive( void );
+void R_ImageLoadPrintf( const char *fmt, ... ) id_attribute((format(printf,1,2)));
+void R_ImageLoadWarning( const char *fmt, ... ) id_attribute((format(printf,1,2)));
+void R_ImageLoadError( const char *fmt, ... ) id_attribute((format(printf,1,2)));
+int R_ReadImageFile( const char *name, void **buffer, ID_TIME_T *timestamp );
+void R_FreeImageFile( void *buffer );
+
 /*
 ====================================================================
 
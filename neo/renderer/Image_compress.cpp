@@ -0,0 +1,818 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "sys/platform.h"
+#include "idlib/math/Random.h"
+#include "framework/CmdSystem.h"
+#include "renderer/tr_local.h"
+
+#include "renderer/Image.h"
+
+/*
+====================================================================
+
+Block compression on the CPU, so the mip levels don't have to be
+compressed by the driver and can be cached as .dds files.
+
+The endpoints of a block are fit along the principal axis of its
+colors and refined once by least squares. BC7 blocks only use mode 6
+(one subset, 7 bit endpoints with a p-bit, 4 bit indices), which is
+good enough for the single material textures of the game.
+
+====================================================================
+*/
+
+typedef byte	block_t[16][4];
+
+/*
+================
+R_FetchBlock
+
+Edge pixels are repeated for the levels smaller than a block
+================
+*/
+static void R_FetchBlock( const byte *rgba, int width, int height, int bx, int by, block_t block ) {
+	for ( int y = 0; y < 4; y++ ) {
+		const int sy = Min( by * 4 + y, height - 1 );
+		for ( int x = 0; x < 4; x++ ) {
+			const int sx = Min( bx * 4 + x, width - 1 );
+			const byte *in = rgba + ( sy * width + sx ) * 4;
+			block[y * 4 + x][0] = in[0];
+			block[y * 4 + x][1] = in[1];
+			block[y * 4 + x][2] = in[2];
+			block[y * 4 + x][3] = in[3];
+		}
+	}
+}
+
+/*
+================
+R_FitBlockLine
+
+Sets lo and hi to the extent of the block along the principal axis of the first numChannels channels
+================
+*/
+static void R_FitBlockLine( const block_t block, int numChannels, float lo[4], float hi[4] ) {
+	float	mean[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	float	cov[4][4];
+	float	axis[4];
+	int		i, a, b;
+
+	for ( i = 0; i < 16; i++ ) {
+		for ( a = 0; a < numChannels; a++ ) {
+			mean[a] += block[i][a];
+		}
+	}
+	for ( a = 0; a < numChannels; a++ ) {
+		mean[a] *= 1.0f / 16.0f;
+	}
+
+	memset( cov, 0, sizeof( cov ) );
+	for ( i = 0; i < 16; i++ ) {
+		float d[4];
+		for ( a = 0; a < numChannels; a++ ) {
+			d[a] = block[i][a] - mean[a];
+		}
+		for ( a = 0; a < numChannels; a++ ) {
+			for ( b = a; b < numChannels; b++ ) {
+				cov[a][b] += d[a] * d[b];
+			}
+		}
+	}
+	for ( a = 0; a < numChannels; a++ ) {
+		for ( b = 0; b < a; b++ ) {
+			cov[a][b] = cov[b][a];
+		}
+	}
+
+	// power iteration, starting with the column of the largest variance
+	int largest = 0;
+	for ( a = 1; a < numChannels; a++ ) {
+		if ( cov[a][a] > cov[largest][largest] ) {
+			largest = a;
+		}
+	}
+	for ( a = 0; a < numChannels; a++ ) {
+		axis[a] = cov[a][largest];
+	}
+	for ( int iteration = 0; iteration < 8; iteration++ ) {
+		float next[4];
+		float scale = 0.0f;
+		for ( a = 0; a < numChannels; a++ ) {
+			next[a] = 0.0f;
+			for ( b = 0; b < numChannels; b++ ) {
+				next[a] += cov[a][b] * axis[b];
+			}
+			scale = Max( scale, idMath::Fabs( next[a] ) );
+		}
+		if ( scale < 1e-6f ) {
+			break;
+		}
+		for ( a = 0; a < numChannels; a++ ) {
+			axis[a] = next[a] / scale;
+		}
+	}
+
+	float length = 0.0f;
+	for ( a = 0; a < numChannels; a++ ) {
+		length += axis[a] * axis[a];
+	}
+	if ( length < 1e-6f ) {
+		// all pixels are the same
+		for ( a = 0; a < numChannels; a++ ) {
+			lo[a] = hi[a] = mean[a];
+		}
+		return;
+	}
+	length = idMath::InvSqrt( length );
+	for ( a = 0; a < numChannels; a++ ) {
+		axis[a] *= length;
+	}
+
+	float minT = 0.0f, maxT = 0.0f;
+	for ( i = 0; i < 16; i++ ) {
+		float t = 0.0f;
+		for ( a = 0; a < numChannels; a++ ) {
+			t += ( block[i][a] - mean[a] ) * axis[a];
+		}
+		minT = Min( minT, t );
+		maxT = Max( maxT, t );
+	}
+	for ( a = 0; a < numChannels; a++ ) {
+		lo[a] = idMath::ClampFloat( 0.0f, 255.0f, mean[a] + axis[a] * minT );
+		hi[a] = idMath::ClampFloat( 0.0f, 255.0f, mean[a] + axis[a] * maxT );
+	}
+}
+
+/*
+================
+R_RefitBlockLine
+
+Least squares endpoints for the interpolation weights of the chosen indices,
+weights[i] is the share of e1 in pixel i. Returns false if the system is singular.
+================
+*/
+static bool R_RefitBlockLine( const block_t block, int numChannels, const float weights[16], float e0[4], float e1[4] ) {
+	float	aa = 0.0f, ab = 0.0f, bb = 0.0f;
+	float	ax[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	float	bx[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	int		i, c;
+
+	for ( i = 0; i < 16; i++ ) {
+		const float b = weights[i];
+		const float a = 1.0f - b;
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+		for ( c = 0; c < numChannels; c++ ) {
+			ax[c] += a * block[i][c];
+			bx[c] += b * block[i][c];
+		}
+	}
+
+	const float det = aa * bb - ab * ab;
+	if ( idMath::Fabs( det ) < 1e-6f ) {
+		return false;
+	}
+	const float invDet = 1.0f / det;
+	for ( c = 0; c < numChannels; c++ ) {
+		e0[c] = idMath::ClampFloat( 0.0f, 255.0f, ( ax[c] * bb - bx[c] * ab ) * invDet );
+		e1[c] = idMath::ClampFloat( 0.0f, 255.0f, ( bx[c] * aa - ax[c] * ab ) * invDet );
+	}
+	return true;
+}
+
+/*
+====================================================================
+
+DXT
+
+====================================================================
+*/
+
+static int R_PackColor565( const float c[3] ) {
+	const int r = idMath::ClampInt( 0, 31, idMath::Ftoi( c[0] * ( 31.0f / 255.0f ) + 0.5f ) );
+	const int g = idMath::ClampInt( 0, 63, idMath::Ftoi( c[1] * ( 63.0f / 255.0f ) + 0.5f ) );
+	const int b = idMath::ClampInt( 0, 31, idMath::Ftoi( c[2] * ( 31.0f / 255.0f ) + 0.5f ) );
+	return ( r << 11 ) | ( g << 5 ) | b;
+}
+
+static void R_UnpackColor565( int c, int rgb[3] ) {
+	const int r = ( c >> 11 ) & 31;
+	const int g = ( c >> 5 ) & 63;
+	const int b = c & 31;
+	rgb[0] = ( r << 3 ) | ( r >> 2 );
+	rgb[1] = ( g << 2 ) | ( g >> 4 );
+	rgb[2] = ( b << 3 ) | ( b >> 2 );
+}
+
+static void R_ColorBlockPalette( int c0, int c1, int palette[4][3] ) {
+	R_UnpackColor565( c0, palette[0] );
+	R_UnpackColor565( c1, palette[1] );
+	for ( int c = 0; c < 3; c++ ) {
+		palette[2][c] = ( 2 * palette[0][c] + palette[1][c] ) / 3;
+		palette[3][c] = ( palette[0][c] + 2 * palette[1][c] ) / 3;
+	}
+}
+
+/*
+================
+R_ColorBlockIndices
+
+Picks the four color mode palette entry of every pixel, returns the squared error
+================
+*/
+static int R_ColorBlockIndices( const block_t block, int c0, int c1, unsigned int &indices, float weights[16] ) {
+	static const float paletteWeights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+	int palette[4][3];
+	int error = 0;
+
+	R_ColorBlockPalette( c0, c1, palette );
+
+	indices = 0;
+	for ( int i = 0; i < 16; i++ ) {
+		int best = 0;
+		int bestError = INT_MAX;
+		for ( int p = 0; p < 4; p++ ) {
+			const int dr = block[i][0] - palette[p][0];
+			const int dg = block[i][1] - palette[p][1];
+			const int db = block[i][2] - palette[p][2];
+			const int e = dr * dr + dg * dg + db * db;
+			if ( e < bestError ) {
+				bestError = e;
+				best = p;
+			}
+		}
+		indices |= best << ( i * 2 );
+		weights[i] = paletteWeights[best];
+		error += bestError;
+	}
+	return error;
+}
+
+/*
+================
+R_CompressColorBlock
+
+DXT1 without alpha, and the color half of DXT3 and DXT5
+================
+*/
+static void R_CompressColorBlock( const block_t block, byte out[8] ) {
+	float			lo[4], hi[4];
+	float			weights[16];
+	unsigned int	indices;
+
+	R_FitBlockLine( block, 3, lo, hi );
+
+	int c0 = R_PackColor565( hi );
+	int c1 = R_PackColor565( lo );
+	int error = R_ColorBlockIndices( block, c0, c1, indices, weights );
+
+	if ( error > 0 && R_RefitBlockLine( block, 3, weights, hi, lo ) ) {
+		unsigned int refitIndices;
+		const int refit0 = R_PackColor565( hi );
+		const int refit1 = R_PackColor565( lo );
+		const int refitError = R_ColorBlockIndices( block, refit0, refit1, refitIndices, weights );
+		if ( refitError < error ) {
+			c0 = refit0;
+			c1 = refit1;
+			indices = refitIndices;
+		}
+	}
+
+	// c0 > c1 selects the four color mode
+	if ( c0 < c1 ) {
+		idSwap( c0, c1 );
+		indices ^= 0x55555555;
+	} else if ( c0 == c1 ) {
+		indices = 0;
+	}
+
+	out[0] = c0 & 255;
+	out[1] = c0 >> 8;
+	out[2] = c1 & 255;
+	out[3] = c1 >> 8;
+	out[4] = indices & 255;
+	out[5] = ( indices >> 8 ) & 255;
+	out[6] = ( indices >> 16 ) & 255;
+	out[7] = indices >> 24;
+}
+
+/*
+================
+R_CompressExplicitAlphaBlock
+
+The alpha half of DXT3
+================
+*/
+static void R_CompressExplicitAlphaBlock( const block_t block, byte out[8] ) {
+	memset( out, 0, 8 );
+	for ( int i = 0; i < 16; i++ ) {
+		const int a = ( block[i][3] * 15 + 127 ) / 255;
+		out[i >> 1] |= a << ( ( i & 1 ) * 4 );
+	}
+}
+
+/*
+================
+R_CompressInterpolatedAlphaBlock
+
+The alpha half of DXT5, always in the eight value mode
+================
+*/
+static void R_CompressInterpolatedAlphaBlock( const block_t block, byte out[8] ) {
+	int		a0 = 0, a1 = 255;
+	int		palette[8];
+	int		i;
+
+	for ( i = 0; i < 16; i++ ) {
+		a0 = Max( a0, (int)block[i][3] );
+		a1 = Min( a1, (int)block[i][3] );
+	}
+
+	memset( out, 0, 8 );
+	out[0] = a0;
+	out[1] = a1;
+	if ( a0 == a1 ) {
+		return;
+	}
+
+	palette[0] = a0;
+	palette[1] = a1;
+	for ( i = 2; i < 8; i++ ) {
+		palette[i] = ( ( 8 - i ) * a0 + ( i - 1 ) * a1 ) / 7;
+	}
+
+	unsigned long long indices = 0;
+	for ( i = 0; i < 16; i++ ) {
+		int best = 0;
+		int bestError = INT_MAX;
+		for ( int p = 0; p < 8; p++ ) {
+			const int e = abs( block[i][3] - palette[p] );
+			if ( e < bestError ) {
+				bestError = e;
+				best = p;
+			}
+		}
+		indices |= (unsigned long long)best << ( i * 3 );
+	}
+	for ( i = 0; i < 6; i++ ) {
+		out[2 + i] = ( indices >> ( i * 8 ) ) & 255;
+	}
+}
+
+/*
+====================================================================
+
+BC7
+
+====================================================================
+*/
+
+static const int bc7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+/*
+================
+R_QuantizeBC7Endpoint
+
+7 bits per channel and a p-bit shared by the channels, returns the 8 bit endpoint
+================
+*/
+static void R_QuantizeBC7Endpoint( const float c[4], int endpoint[4], int &pBit ) {
+	int bestError = INT_MAX;
+
+	for ( int p = 0; p < 2; p++ ) {
+		int e[4];
+		int error = 0;
+		for ( int i = 0; i < 4; i++ ) {
+			const int q = idMath::ClampInt( 0, 127, idMath::Ftoi( ( c[i] - p ) * 0.5f + 0.5f ) );
+			e[i] = ( q << 1 ) | p;
+			const int d = idMath::Ftoi( c[i] + 0.5f ) - e[i];
+			error += d * d;
+		}
+		if ( error < bestError ) {
+			bestError = error;
+			pBit = p;
+			memcpy( endpoint, e, sizeof( e ) );
+		}
+	}
+}
+
+static int R_BC7BlockIndices( const block_t block, const int e0[4], const int e1[4], int indices[16], float weights[16] ) {
+	int palette[16][4];
+	int error = 0;
+
+	for ( int p = 0; p < 16; p++ ) {
+		for ( int c = 0; c < 4; c++ ) {
+			palette[p][c] = ( ( 64 - bc7Weights4[p] ) * e0[c] + bc7Weights4[p] * e1[c] + 32 ) >> 6;
+		}
+	}
+
+	for ( int i = 0; i < 16; i++ ) {
+		int best = 0;
+		int bestError = INT_MAX;
+		for ( int p = 0; p < 16; p++ ) {
+			int e = 0;
+			for ( int c = 0; c < 4; c++ ) {
+				const int d = block[i][c] - palette[p][c];
+				e += d * d;
+			}
+			if ( e < bestError ) {
+				bestError = e;
+				best = p;
+			}
+		}
+		indices[i] = best;
+		weights[i] = bc7Weights4[best] * ( 1.0f / 64.0f );
+		error += bestError;
+	}
+	return error;
+}
+
+static void R_WriteBits( byte *out, int &bitPos, int value, int numBits ) {
+	for ( int i = 0; i < numBits; i++, bitPos++ ) {
+		if ( value & ( 1 << i ) ) {
+			out[bitPos >> 3] |= 1 << ( bitPos & 7 );
+		}
+	}
+}
+
+/*
+================
+R_CompressBC7Block
+================
+*/
+static void R_CompressBC7Block( const block_t block, byte out[16] ) {
+	float	lo[4], hi[4];
+	float	weights[16];
+	int		e0[4], e1[4], p0, p1;
+	int		indices[16];
+	int		i, c;
+
+	R_FitBlockLine( block, 4, lo, hi );
+
+	R_QuantizeBC7Endpoint( lo, e0, p0 );
+	R_QuantizeBC7Endpoint( hi, e1, p1 );
+	int error = R_BC7BlockIndices( block, e0, e1, indices, weights );
+
+	if ( error > 0 && R_RefitBlockLine( block, 4, weights, lo, hi ) ) {
+		int refit0[4], refit1[4], refitP0, refitP1;
+		int refitIndices[16];
+		R_QuantizeBC7Endpoint( lo, refit0, refitP0 );
+		R_QuantizeBC7Endpoint( hi, refit1, refitP1 );
+		const int refitError = R_BC7BlockIndices( block, refit0, refit1, refitIndices, weights );
+		if ( refitError < error ) {
+			memcpy( e0, refit0, sizeof( e0 ) );
+			memcpy( e1, refit1, sizeof( e1 ) );
+			memcpy( indices, refitIndices, sizeof( indices ) );
+			p0 = refitP0;
+			p1 = refitP1;
+		}
+	}
+
+	// the high bit of the first index is implicitly zero
+	if ( indices[0] & 8 ) {
+		for ( c = 0; c < 4; c++ ) {
+			idSwap( e0[c], e1[c] );
+		}
+		idSwap( p0, p1 );
+		for ( i = 0; i < 16; i++ ) {
+			indices[i] = 15 - indices[i];
+		}
+	}
+
+	memset( out, 0, 16 );
+	int bitPos = 0;
+	R_WriteBits( out, bitPos, 1 << 6, 7 );		// mode 6
+	for ( c = 0; c < 4; c++ ) {
+		R_WriteBits( out, bitPos, e0[c] >> 1, 7 );
+		R_WriteBits( out, bitPos, e1[c] >> 1, 7 );
+	}
+	R_WriteBits( out, bitPos, p0, 1 );
+	R_WriteBits( out, bitPos, p1, 1 );
+	R_WriteBits( out, bitPos, indices[0], 3 );
+	for ( i = 1; i < 16; i++ ) {
+		R_WriteBits( out, bitPos, indices[i], 4 );
+	}
+	assert( bitPos == 128 );
+}
+
+/*
+====================================================================
+
+Images
+
+====================================================================
+*/
+
+/*
+================
+R_CanCompressImage
+
+The formats SelectInternalFormat() picks that R_CompressImage() can make
+================
+*/
+bool R_CanCompressImage( int internalFormat ) {
+	switch ( internalFormat ) {
+	case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+	case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+	case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+	case GL_COMPRESSED_RGBA_BPTC_UNORM:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/*
+================
+R_CompressedImageSize
+================
+*/
+int R_CompressedImageSize( int internalFormat, int width, int height ) {
+	const int blockBytes = ( internalFormat == GL_COMPRESSED_RGB_S3TC_DXT1_EXT ) ? 8 : 16;
+	return ( ( width + 3 ) / 4 ) * ( ( height + 3 ) / 4 ) * blockBytes;
+}
+
+typedef struct {
+	int				internalFormat;
+	const byte *	rgba;
+	int				width;
+	int				height;
+	byte *			out;
+} compressImageParms_t;
+
+static void R_CompressBlockRows( void *data, int first, int last ) {
+	const compressImageParms_t *parms = (const compressImageParms_t *)data;
+	const int blocksWide = ( parms->width + 3 ) / 4;
+	const int blockBytes = ( parms->internalFormat == GL_COMPRESSED_RGB_S3TC_DXT1_EXT ) ? 8 : 16;
+	block_t block;
+
+	for ( int by = first; by < last; by++ ) {
+		byte *out = parms->out + by * blocksWide * blockBytes;
+		for ( int bx = 0; bx < blocksWide; bx++, out += blockBytes ) {
+			R_FetchBlock( parms->rgba, parms->width, parms->height, bx, by, block );
+			switch ( parms->internalFormat ) {
+			case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+				R_CompressColorBlock( block, out );
+				break;
+			case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+				R_CompressExplicitAlphaBlock( block, out );
+				R_CompressColorBlock( block, out + 8 );
+				break;
+			case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+				R_CompressInterpolatedAlphaBlock( block, out );
+				R_CompressColorBlock( block, out + 8 );
+				break;
+			case GL_COMPRESSED_RGBA_BPTC_UNORM:
+				R_CompressBC7Block( block, out );
+				break;
+			}
+		}
+	}
+}
+
+/*
+================
+R_CompressImage
+
+Compresses an RGBA image into R_CompressedImageSize() bytes at out.
+The rows of blocks are spread over the job threads, image load jobs
+compress their images on their own thread.
+================
+*/
+void R_CompressImage( int internalFormat, const byte *rgba, int width, int height, byte *out ) {
+	compressImageParms_t parms;
+
+	assert( R_CanCompressImage( internalFormat ) );
+
+	parms.internalFormat = internalFormat;
+	parms.rgba = rgba;
+	parms.width = width;
+	parms.height = height;
+	parms.out = out;
+
+	const int blocksWide = ( width + 3 ) / 4;
+	const int blocksHigh = ( height + 3 ) / 4;
+
+	// jobs must not wait on other jobs
+	if ( Sys_JobThreadIndex() != 0 || R_ImageLoadJobsActive() ) {
+		R_CompressBlockRows( &parms, 0, blocksHigh );
+		return;
+	}
+
+	Sys_ParallelFor( R_CompressBlockRows, &parms, blocksHigh, Max( 1, 256 / blocksWide ) );
+}
+
+/*
+====================================================================
+
+imageCompressBench
+
+====================================================================
+*/
+
+/*
+================
+R_DecompressBlock
+
+Only decodes what R_CompressImage() makes, that is mode 6 for BC7
+================
+*/
+static void R_DecompressBlock( int internalFormat, const byte *in, block_t block ) {
+	int i, c;
+
+	if ( internalFormat == GL_COMPRESSED_RGBA_BPTC_UNORM ) {
+		int e0[4], e1[4];
+		int bitPos = 7;
+		for ( c = 0; c < 4; c++ ) {
+			e0[c] = e1[c] = 0;
+			for ( i = 0; i < 7; i++, bitPos++ ) {
+				e0[c] |= ( ( in[bitPos >> 3] >> ( bitPos & 7 ) ) & 1 ) << ( i + 1 );
+			}
+			for ( i = 0; i < 7; i++, bitPos++ ) {
+				e1[c] |= ( ( in[bitPos >> 3] >> ( bitPos & 7 ) ) & 1 ) << ( i + 1 );
+			}
+		}
+		const int p0 = ( in[bitPos >> 3] >> ( bitPos & 7 ) ) & 1;
+		bitPos++;
+		const int p1 = ( in[bitPos >> 3] >> ( bitPos & 7 ) ) & 1;
+		bitPos++;
+		for ( i = 0; i < 16; i++ ) {
+			const int numBits = ( i == 0 ) ? 3 : 4;
+			int index = 0;
+			for ( int b = 0; b < numBits; b++, bitPos++ ) {
+				index |= ( ( in[bitPos >> 3] >> ( bitPos & 7 ) ) & 1 ) << b;
+			}
+			for ( c = 0; c < 4; c++ ) {
+				block[i][c] = ( ( 64 - bc7Weights4[index] ) * ( e0[c] | p0 ) + bc7Weights4[index] * ( e1[c] | p1 ) + 32 ) >> 6;
+			}
+		}
+		return;
+	}
+
+	const byte *color = ( internalFormat == GL_COMPRESSED_RGB_S3TC_DXT1_EXT ) ? in : in + 8;
+	int palette[4][3];
+	R_ColorBlockPalette( color[0] | ( color[1] << 8 ), color[2] | ( color[3] << 8 ), palette );
+	for ( i = 0; i < 16; i++ ) {
+		const int p = ( color[4 + ( i >> 2 )] >> ( ( i & 3 ) * 2 ) ) & 3;
+		block[i][0] = palette[p][0];
+		block[i][1] = palette[p][1];
+		block[i][2] = palette[p][2];
+		block[i][3] = 255;
+	}
+
+	if ( internalFormat == GL_COMPRESSED_RGBA_S3TC_DXT3_EXT ) {
+		for ( i = 0; i < 16; i++ ) {
+			block[i][3] = ( ( in[i >> 1] >> ( ( i & 1 ) * 4 ) ) & 15 ) * 17;
+		}
+	} else if ( internalFormat == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT ) {
+		int alphas[8];
+		alphas[0] = in[0];
+		alphas[1] = in[1];
+		for ( i = 2; i < 8; i++ ) {
+			alphas[i] = ( ( 8 - i ) * alphas[0] + ( i - 1 ) * alphas[1] ) / 7;
+		}
+		unsigned long long indices = 0;
+		for ( i = 0; i < 6; i++ ) {
+			indices |= (unsigned long long)in[2 + i] << ( i * 8 );
+		}
+		for ( i = 0; i < 16; i++ ) {
+			block[i][3] = alphas[( indices >> ( i * 3 ) ) & 7];
+		}
+	}
+}
+
+/*
+================
+R_ImageCompressBench_f
+
+Compresses an image to every format with one thread and with the job threads,
+and prints the time and the error of the decoded blocks. No rendering context is needed.
+================
+*/
+void R_ImageCompressBench_f( const idCmdArgs &args ) {
+	static const struct {
+		int			internalFormat;
+		const char *name;
+	} formats[] = {
+		{ GL_COMPRESSED_RGB_S3TC_DXT1_EXT, "DXT1" },
+		{ GL_COMPRESSED_RGBA_S3TC_DXT3_EXT, "DXT3" },
+		{ GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, "DXT5" },
+		{ GL_COMPRESSED_RGBA_BPTC_UNORM, "BC7" }
+	};
+	byte	*pic = NULL;
+	int		width, height;
+	int		i, f;
+
+	const int numIterations = ( args.Argc() > 2 ) ? atoi( args.Argv( 2 ) ) : 4;
+	if ( numIterations < 1 ) {
+		common->Printf( "usage: imageCompressBench [image] [iterations]\n" );
+		return;
+	}
+
+	if ( args.Argc() > 1 && idStr::Icmp( args.Argv( 1 ), "-" ) != 0 ) {
+		R_LoadImageProgram( args.Argv( 1 ), &pic, &width, &height, NULL );
+		if ( pic == NULL ) {
+			common->Printf( "couldn't load image %s\n", args.Argv( 1 ) );
+			return;
+		}
+	} else {
+		// gradients with some noise and a smooth alpha channel
+		idRandom random( 1 );
+		width = height = 1024;
+		pic = (byte *)R_StaticAlloc( width * height * 4 );
+		for ( int y = 0; y < height; y++ ) {
+			for ( int x = 0; x < width; x++ ) {
+				byte *p = pic + ( y * width + x ) * 4;
+				p[0] = idMath::ClampInt( 0, 255, x / 4 + random.RandomInt( 16 ) );
+				p[1] = idMath::ClampInt( 0, 255, y / 4 + random.RandomInt( 16 ) );
+				p[2] = ( ( x / 32 + y / 32 ) & 1 ) ? 200 : 40;
+				p[3] = ( x + y ) / 8;
+			}
+		}
+	}
+
+	common->Printf( "imageCompressBench: %dx%d, %d iterations, %d job threads\n", width, height, numIterations, Sys_NumJobThreads() );
+
+	const int blocksWide = ( width + 3 ) / 4;
+	const int blocksHigh = ( height + 3 ) / 4;
+	const double megaPixels = width * height * 1e-6;
+	byte *out = (byte *)R_StaticAlloc( blocksWide * blocksHigh * 16 );
+
+	for ( f = 0; f < (int)( sizeof( formats ) / sizeof( formats[0] ) ); f++ ) {
+		compressImageParms_t parms;
+		parms.internalFormat = formats[f].internalFormat;
+		parms.rgba = pic;
+		parms.width = width;
+		parms.height = height;
+		parms.out = out;
+
+		double start = Sys_MillisecondsPrecise();
+		for ( i = 0; i < numIterations; i++ ) {
+			R_CompressBlockRows( &parms, 0, blocksHigh );
+		}
+		const double serialMsec = ( Sys_MillisecondsPrecise() - start ) / numIterations;
+
+		start = Sys_MillisecondsPrecise();
+		for ( i = 0; i < numIterations; i++ ) {
+			R_CompressImage( parms.internalFormat, pic, width, height, out );
+		}
+		const double parallelMsec = ( Sys_MillisecondsPrecise() - start ) / numIterations;
+
+		// the error of the decoded image
+		const int blockBytes = ( parms.internalFormat == GL_COMPRESSED_RGB_S3TC_DXT1_EXT ) ? 8 : 16;
+		double colorError = 0.0, alphaError = 0.0;
+		for ( int by = 0; by < blocksHigh; by++ ) {
+			for ( int bx = 0; bx < blocksWide; bx++ ) {
+				block_t source, decoded;
+				R_FetchBlock( pic, width, height, bx, by, source );
+				R_DecompressBlock( parms.internalFormat, out + ( by * blocksWide + bx ) * blockBytes, decoded );
+				for ( i = 0; i < 16; i++ ) {
+					for ( int c = 0; c < 3; c++ ) {
+						const int d = source[i][c] - decoded[i][c];
+						colorError += d * d;
+					}
+					const int d = source[i][3] - decoded[i][3];
+					alphaError += d * d;
+				}
+			}
+		}
+		const double numSamples = blocksWide * blocksHigh * 16.0;
+
+		// DXT1 drops the alpha channel
+		const bool hasAlpha = ( parms.internalFormat != GL_COMPRESSED_RGB_S3TC_DXT1_EXT );
+
+		common->Printf( "%-5s %8.1f ms single %8.1f ms jobs (%6.1f MPixel/s), rms error rgb %5.2f alpha %s\n", formats[f].name,
+						serialMsec, parallelMsec, megaPixels * 1000.0 / Max( parallelMsec, 0.001 ),
+						idMath::Sqrt( colorError / ( numSamples * 3.0 ) ), hasAlpha ? va( "%5.2f", idMath::Sqrt( alphaError / numSamples ) ) : "-" );
+	}
+
+	R_StaticFree( out );
+	R_StaticFree( pic );
+}
@@ -47,6 +47,181 @@ void R_LoadImage( const char *name, byte **pic, int *width, int *height, bool ma
 
 */
 
+/*
+================================================================================
+
+  Image load jobs
+
+  idImageManager::EndLevelLoad() loads images on the job threads. The file system,
+  idHeap and the console aren't thread safe, so while the jobs run, file reads and
+  R_StaticAlloc() take CRITICAL_SECTION_TWO, prints are queued for the main thread
+  and errors are thrown back to the job that hit them.
+
+================================================================================
+*/
+
+typedef struct {
+	idStr		text;
+	bool		warning;
+} imageLoadMessage_t;
+
+static bool							imageLoadJobs = false;
+static idList<imageLoadMessage_t>	imageLoadMessages;
+static idStr						imageLoadError;		// the first error a job ran into
+
+/*
+================
+R_BeginImageLoadJobs
+================
+*/
+void R_BeginImageLoadJobs( void ) {
+	imageLoadJobs = true;
+}
+
+/*
+================
+R_EndImageLoadJobs
+
+Prints the queued messages, and throws the error of a failed job on the main thread.
+================
+*/
+void R_EndImageLoadJobs( void ) {
+	imageLoadJobs = false;
+
+	for ( int i = 0; i < imageLoadMessages.Num(); i++ ) {
+		if ( imageLoadMessages[i].warning ) {
+			common->Warning( "%s", imageLoadMessages[i].text.c_str() );
+		} else {
+			common->Printf( "%s", imageLoadMessages[i].text.c_str() );
+		}
+	}
+	imageLoadMessages.Clear();
+
+	if ( imageLoadError.Length() ) {
+		idStr error = imageLoadError;
+		imageLoadError.Clear();
+		common->Error( "%s", error.c_str() );
+	}
+}
+
+/*
+================
+R_ImageLoadJobsActive
+================
+*/
+bool R_ImageLoadJobsActive( void ) {
+	return imageLoadJobs;
+}
+
+/*
+================
+R_QueueImageLoadMessage
+================
+*/
+static void R_QueueImageLoadMessage( const char *text, bool warning ) {
+	Sys_EnterCriticalSection( CRITICAL_SECTION_TWO );
+	imageLoadMessage_t &message = imageLoadMessages.Alloc();
+	message.text = text;
+	message.warning = warning;
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_TWO );
+}
+
+/*
+================
+R_ImageLoadPrintf
+================
+*/
+void R_ImageLoadPrintf( const char *fmt, ... ) {
+	va_list		argptr;
+	char		text[MAX_STRING_CHARS];
+
+	va_start( argptr, fmt );
+	idStr::vsnPrintf( text, sizeof( text ), fmt, argptr );
+	va_end( argptr );
+
+	if ( imageLoadJobs ) {
+		R_QueueImageLoadMessage( text, false );
+	} else {
+		common->Printf( "%s", text );
+	}
+}
+
+/*
+================
+R_ImageLoadWarning
+================
+*/
+void R_ImageLoadWarning( const char *fmt, ... ) {
+	va_list		argptr;
+	char		text[MAX_STRING_CHARS];
+
+	va_start( argptr, fmt );
+	idStr::vsnPrintf( text, sizeof( text ), fmt, argptr );
+	va_end( argptr );
+
+	if ( imageLoadJobs ) {
+		R_QueueImageLoadMessage( text, true );
+	} else {
+		common->Warning( "%s", text );
+	}
+}
+
+/*
+================
+R_ImageLoadError
+================
+*/
+void R_ImageLoadError( const char *fmt, ... ) {
+	va_list		argptr;
+	char		text[MAX_STRING_CHARS];
+
+	va_start( argptr, fmt );
+	idStr::vsnPrintf( text, sizeof( text ), fmt, argptr );
+	va_end( argptr );
+
+	if ( !imageLoadJobs ) {
+		common->Error( "%s", text );
+	}
+
+	Sys_EnterCriticalSection( CRITICAL_SECTION_TWO );
+	if ( !imageLoadError.Length() ) {
+		imageLoadError = text;
+	}
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_TWO );
+
+	throw idException( text );
+}
+
+/*
+================
+R_ReadImageFile
+================
+*/
+int R_ReadImageFile( const char *name, void **buffer, ID_TIME_T *timestamp ) {
+	if ( !imageLoadJobs ) {
+		return fileSystem->ReadFile( name, buffer, timestamp );
+	}
+	Sys_EnterCriticalSection( CRITICAL_SECTION_TWO );
+	int length = fileSystem->ReadFile( name, buffer, timestamp );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_TWO );
+	return length;
+}
+
+/*
+================
+R_FreeImageFile
+================
+*/
+void R_FreeImageFile( void *buffer ) {
+	if ( !imageLoadJobs ) {
+		fileSystem->FreeFile( buffer );
+		return;
+	}
+	Sys_EnterCriticalSection( CRITICAL_SECTION_TWO );
+	fileSystem->FreeFile( buffer );
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_TWO );
+}
+
 /*
 ================
 R_WriteTGA
@@ -222,7 +397,7 @@ static void LoadBMP( const char *name, byte **pic, int *width, int *height, ID_T
 	byte		*bmpRGBA;
 
 	if ( !pic ) {
-		fileSystem->ReadFile ( name, NULL, timestamp );
+		R_ReadImageFile ( name, NULL, timestamp );
 		return;	// just getting timestamp
 	}
 
@@ -231,7 +406,7 @@ static void LoadBMP( const char *name, byte **pic, int *width, int *height, ID_T
 	//
 	// load the file
 	//
-	length = fileSystem->ReadFile( name, (void **)&buffer, timestamp );
+	length = R_ReadImageFile( name, (void **)&buffer, timestamp );
 	if ( !buffer ) {
 		return;
 	}
@@ -276,19 +451,19 @@ static void LoadBMP( const char *name, byte **pic, int *width, int *height, ID_T
 
 	if ( bmpHeader.id[0] != 'B' && bmpHeader.id[1] != 'M' )
 	{
-		common->Error( "LoadBMP: only Windows-style BMP files supported (%s)\n", name );
+		R_ImageLoadError( "LoadBMP: only Windows-style BMP files supported (%s)\n", name );
 	}
 	if ( bmpHeader.fileSize != length )
 	{
-		common->Error( "LoadBMP: header size does not match file size (%u vs. %d) (%s)\n", bmpHeader.fileSize, length, name );
+		R_ImageLoadError( "LoadBMP: header size does not match file size (%u vs. %d) (%s)\n", bmpHeader.fileSize, length, name );
 	}
 	if ( bmpHeader.compression != 0 )
 	{
-		common->Error( "LoadBMP: only uncompressed BMP files supported (%s)\n", name );
+		R_ImageLoadError( "LoadBMP: only uncompressed BMP files supported (%s)\n", name );
 	}
 	if ( bmpHeader.bitsPerPixel < 8 )
 	{
-		common->Error( "LoadBMP: monochrome and 4-bit BMP files not supported (%s)\n", name );
+		R_ImageLoadError( "LoadBMP: monochrome and 4-bit BMP files not supported (%s)\n", name );
 	}
 
 	columns = bmpHeader.width;
@@ -354,13 +529,13 @@ static void LoadBMP( const char *name, byte **pic, int *width, int *height, ID_T
 				*pixbuf++ = alpha;
 				break;
 			default:
-				common->Error( "LoadBMP: illegal pixel_size '%d' in file '%s'\n", bmpHeader.bitsPerPixel, name );
+				R_ImageLoadError( "LoadBMP: illegal pixel_size '%d' in file '%s'\n", bmpHeader.bitsPerPixel, name );
 				break;
 			}
 		}
 	}
 
-	fileSystem->FreeFile( buffer );
+	R_FreeImageFile( buffer );
 
 }
 
@@ -390,7 +565,7 @@ static void LoadPCX ( const char *filename, byte **pic, byte **palette, int *wid
 	int		xmax, ymax;
 
 	if ( !pic ) {
-		fileSystem->ReadFile( filename, NULL, timestamp );
+		R_ReadImageFile( filename, NULL, timestamp );
 		return;	// just getting timestamp
 	}
 
@@ -400,7 +575,7 @@ static void LoadPCX ( const char *filename, byte **pic, byte **palette, int *wid
 	//
 	// load the file
 	//
-	len = fileSystem->ReadFile( filename, (void **)&raw, timestamp );
+	len = R_ReadImageFile( filename, (void **)&raw, timestamp );
 	if (!raw) {
 		return;
 	}
@@ -421,7 +596,7 @@ static void LoadPCX ( const char *filename, byte **pic, byte **palette, int *wid
 		|| xmax >= 1024
 		|| ymax >= 1024)
 	{
-		common->Printf( "Bad pcx file %s (%i x %i) (%i x %i)\n", filename, xmax+1, ymax+1, pcx->xmax, pcx->ymax);
+		R_ImageLoadPrintf( "Bad pcx file %s (%i x %i) (%i x %i)\n", filename, xmax+1, ymax+1, pcx->xmax, pcx->ymax);
 		return;
 	}
 
@@ -465,12 +640,12 @@ static void LoadPCX ( const char *filename, byte **pic, byte **palette, int *wid
 
 	if ( raw - (byte *)pcx > len)
 	{
-		common->Printf( "PCX file %s was malformed", filename );
+		R_ImageLoadPrintf( "PCX file %s was malformed", filename );
 		R_StaticFree (*pic);
 		*pic = NULL;
 	}
 
-	fileSystem->FreeFile( pcx );
+	R_FreeImageFile( pcx );
 }
 
 
@@ -486,7 +661,7 @@ static void LoadPCX32 ( const char *filename, byte **pic, int *width, int *heigh
 	byte	*pic32;
 
 	if ( !pic ) {
-		fileSystem->ReadFile( filename, NULL, timestamp );
+		R_ReadImageFile( filename, NULL, timestamp );
 		return;	// just getting timestamp
 	}
 	LoadPCX (filename, &pic8, &palette, width, height, timestamp);
@@ -533,7 +708,7 @@ static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_T
 	byte		*targa_rgba;
 
 	if ( !pic ) {
-		fileSystem->ReadFile( name, NULL, timestamp );
+		R_ReadImageFile( name, NULL, timestamp );
 		return;	// just getting timestamp
 	}
 
@@ -542,7 +717,7 @@ static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_T
 	//
 	// load the file
 	//
-	fileSize = fileSystem->ReadFile( name, (void **)&buffer, timestamp );
+	fileSize = R_ReadImageFile( name, (void **)&buffer, timestamp );
 	if ( !buffer ) {
 		return;
 	}
@@ -570,21 +745,21 @@ static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_T
 	targa_header.attributes = *buf_p++;
 
 	if ( targa_header.image_type != 2 && targa_header.image_type != 10 && targa_header.image_type != 3 ) {
-		common->Error( "LoadTGA( %s ): Only type 2 (RGB), 3 (gray), and 10 (RGB) TGA images supported\n", name );
+		R_ImageLoadError( "LoadTGA( %s ): Only type 2 (RGB), 3 (gray), and 10 (RGB) TGA images supported\n", name );
 	}
 
 	if ( targa_header.colormap_type != 0 ) {
-		common->Error( "LoadTGA( %s ): colormaps not supported\n", name );
+		R_ImageLoadError( "LoadTGA( %s ): colormaps not supported\n", name );
 	}
 
 	if ( ( targa_header.pixel_size != 32 && targa_header.pixel_size != 24 ) && targa_header.image_type != 3 ) {
-		common->Error( "LoadTGA( %s ): Only 32 or 24 bit images supported (no colormaps)\n", name );
+		R_ImageLoadError( "LoadTGA( %s ): Only 32 or 24 bit images supported (no colormaps)\n", name );
 	}
 
 	if ( targa_header.image_type == 2 || targa_header.image_type == 3 ) {
 		numBytes = targa_header.width * targa_header.height * ( targa_header.pixel_size >> 3 );
 		if ( numBytes > fileSize - 18 - targa_header.id_length ) {
-			common->Error( "LoadTGA( %s ): incomplete file\n", name );
+			R_ImageLoadError( "LoadTGA( %s ): incomplete file\n", name );
 		}
 	}
 
@@ -648,7 +823,7 @@ static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_T
 					*pixbuf++ = alphabyte;
 					break;
 				default:
-					common->Error( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
+					R_ImageLoadError( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
 					break;
 				}
 			}
@@ -682,7 +857,7 @@ static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_T
 								alphabyte = *buf_p++;
 								break;
 						default:
-							common->Error( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
+							R_ImageLoadError( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
 							break;
 					}
 
@@ -727,7 +902,7 @@ static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_T
 									*pixbuf++ = alphabyte;
 									break;
 							default:
-								common->Error( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
+								R_ImageLoadError( "LoadTGA( %s ): illegal pixel_size '%d'\n", name, targa_header.pixel_size );
 								break;
 						}
 						column++;
@@ -752,7 +927,7 @@ static void LoadTGA( const char *name, byte **pic, int *width, int *height, ID_T
 		R_VerticalFlip( *pic, *width, *height );
 	}
 
-	fileSystem->FreeFile( buffer );
+	R_FreeImageFile( buffer );
 }
 
 /*
@@ -766,29 +941,23 @@ static void LoadJPG( const char *filename, unsigned char **pic, int *width, int
 		*pic = NULL;		// until proven otherwise
 	}
 
-	idFile *f = fileSystem->OpenFileRead( filename );
-	if ( !f ) {
-		return;
-	}
-	int len = f->Length();
-	if ( timestamp ) {
-		*timestamp = f->Timestamp();
-	}
 	if ( !pic ) {
-		fileSystem->CloseFile( f );
+		R_ReadImageFile( filename, NULL, timestamp );
 		return;	// just getting timestamp
 	}
-	byte *fbuffer = (byte *)Mem_ClearedAlloc( len );
-	f->Read( fbuffer, len );
-	fileSystem->CloseFile( f );
+	byte *fbuffer;
+	int len = R_ReadImageFile( filename, (void **)&fbuffer, timestamp );
+	if ( !fbuffer ) {
+		return;
+	}
 
 	int w=0, h=0, comp=0;
 	byte* decodedImageData = stbi_load_from_memory( fbuffer, len, &w, &h, &comp, 4 );
 
-	Mem_Free( fbuffer );
+	R_FreeImageFile( fbuffer );
 
 	if ( decodedImageData == NULL ) {
-		common->Warning( "stb_image was unable to load JPG %s : %s\n",
+		R_ImageLoadWarning( "stb_image was unable to load JPG %s : %s\n",
 					filename, stbi_failure_reason());
 		return;
 	}
@@ -906,7 +1075,7 @@ void R_LoadImage( const char *cname, byte **pic, int *width, int *height, ID_TIM
 			int outHeight = scaled_height;
 			resampledBuffer = R_ResampleTexture( *pic, w, h, outWidth, outHeight );
 			if ( outWidth != scaled_width || outHeight != scaled_height ) {
-				common->Warning( "Texture '%s' didn't have power-of-two size *and* was too big, scaled from %dx%d to %dx%d",
+				R_ImageLoadWarning( "Texture '%s' didn't have power-of-two size *and* was too big, scaled from %dx%d to %dx%d",
 				                 name.c_str(), w, h, outWidth, outHeight );
 			}
 
@@ -53,6 +53,10 @@ idCVar idImageManager::image_forceDownSize( "image_forceDownSize", "0", CVAR_REN
 idCVar idImageManager::image_roundDown( "image_roundDown", "1", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_BOOL, "round bad sizes down to nearest power of two" );
 idCVar idImageManager::image_colorMipLevels( "image_colorMipLevels", "0", CVAR_RENDERER | CVAR_BOOL, "development aid to see texture mip usage" );
 idCVar idImageManager::image_preload( "image_preload", "1", CVAR_RENDERER | CVAR_BOOL | CVAR_ARCHIVE, "if 0, dynamically load all images" );
+idCVar idImageManager::image_parallelLoad( "image_parallelLoad", "1", CVAR_RENDERER | CVAR_BOOL | CVAR_ARCHIVE, "1 = decode and mip map images on the job threads during level load" );
+idCVar idImageManager::image_softwareCompression( "image_softwareCompression", "1", CVAR_RENDERER | CVAR_INTEGER | CVAR_ARCHIVE,
+		"1 = compress DXT/BPTC textures on the CPU instead of in the driver and cache them as .dds files, "
+		"2 = compress them on the CPU without caching them, 0 = let the driver compress them", 0, 2 );
 idCVar idImageManager::image_useCompression( "image_useCompression", "1", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_INTEGER,
 		"Compress textures on load so they use less VRAM. 1 = compress with S3TC/DXT when uploading 2 = compress with BPTC when uploading (if available) "
 		"0 = upload uncompressed (unless image_usePrecompressedTextures is 1 and it's loaded from a precompressed .dds file)" );
@@ -1418,6 +1422,8 @@ void idImageManager::SetNormalPalette( void ) {
 		return;
 	}
 
+	R_SyncRenderThread();
+
 	qglColorTableEXT( GL_SHARED_TEXTURE_PALETTE_EXT,
 					   GL_RGB,
 					   256,
@@ -1888,6 +1894,7 @@ void idImageManager::CompleteBackgroundImageLoads() {
 			numActiveBackgroundImageLoads--;
 			fileSystem->CloseFile( image->bgl.f );
 			// upload the image
+			R_SyncRenderThread();
 			image->UploadPrecompressedImage( (byte *)image->bgl.file.buffer, image->bgl.file.length );
 			R_StaticFree( image->bgl.file.buffer );
 			if ( image_showBackgroundLoads.GetBool() ) {
@@ -2014,6 +2021,7 @@ void idImageManager::Init() {
 	cmdSystem->AddCommand( "reloadImages", R_ReloadImages_f, CMD_FL_RENDERER, "reloads images" );
 	cmdSystem->AddCommand( "listImages", R_ListImages_f, CMD_FL_RENDERER, "lists images" );
 	cmdSystem->AddCommand( "combineCubeImages", R_CombineCubeImages_f, CMD_FL_RENDERER, "combines six images for roq compression" );
+	cmdSystem->AddCommand( "imageCompressBench", R_ImageCompressBench_f, CMD_FL_RENDERER, "measures the texture block compression, usage: imageCompressBench [image] [iterations]" );
 
 	// should forceLoadImages be here?
 }
@@ -2101,6 +2109,10 @@ void idImageManager::EndLevelLoad() {
 		}
 	}
 
+	// image files are decoded and mip mapped by jobs, and uploaded afterwards
+	const bool useJobs = image_parallelLoad.GetBool() && Sys_NumJobThreads() > 0;
+	idList<idImage *> jobImages;
+
 	// load the ones we do need, if we are preloading
 	for ( int i = 0 ; i < images.Num() ; i++ ) {
 		idImage	*image = images[ i ];
@@ -2111,7 +2123,15 @@ void idImageManager::EndLevelLoad() {
 		if ( image->levelLoadReferenced && image->texnum == idImage::TEXTURE_NOT_LOADED && !image->partialImage ) {
 //			common->Printf( "Loading %s\n", image->imgName.c_str() );
 			loadCount++;
-			image->ActuallyLoadImage( true, false );
+			if ( useJobs && image->CanLoadInJob() ) {
+				// precompressed images are uploaded as they are read
+				if ( !image_usePrecompressedTextures.GetBool() || !image->CheckPrecompressedImage( true ) ) {
+					jobImages.Append( image );
+					continue;
+				}
+			} else {
+				image->ActuallyLoadImage( true, false );
+			}
 
 			if ( ( loadCount & 15 ) == 0 ) {
 				session->PacifierUpdate();
@@ -2119,6 +2139,10 @@ void idImageManager::EndLevelLoad() {
 		}
 	}
 
+	if ( jobImages.Num() ) {
+		LoadImagesInJobs( jobImages );
+	}
+
 	int	end = Sys_Milliseconds();
 	common->Printf( "%5i purged from previous\n", purgeCount );
 	common->Printf( "%5i kept from previous\n", keepCount );
@@ -2126,6 +2150,77 @@ void idImageManager::EndLevelLoad() {
 	common->Printf( "all images loaded in %5.1f seconds\n", (end-start) * 0.001 );
 }
 
+/*
+====================
+LoadImageJobs
+====================
+*/
+typedef struct {
+	idImage *			image;
+	imageMipLevels_t	mips;
+} imageLoadJob_t;
+
+static void LoadImageJobs( void *data, int first, int last ) {
+	imageLoadJob_t *jobs = (imageLoadJob_t *)data;
+
+	for ( int i = first; i < last; i++ ) {
+		try {
+			jobs[i].image->LoadMipLevels( jobs[i].mips );
+		} catch ( idException & ) {
+			// R_EndImageLoadJobs() raises the error again on the main thread
+			jobs[i].mips.numLevels = 0;
+		}
+	}
+}
+
+/*
+====================
+LoadImagesInJobs
+
+Decodes, resamples and mip maps the images on the job threads, a few
+images per thread at a time so the mip levels don't pile up, and uploads
+them on the main thread in between.
+====================
+*/
+void idImageManager::LoadImagesInJobs( const idList<idImage *> &jobImages ) {
+	const int batchSize = 2 * ( Sys_NumJobThreads() + 1 );
+	imageLoadJob_t *jobs = new imageLoadJob_t[batchSize];
+	double decodeMsec = 0.0;
+	double uploadMsec = 0.0;
+
+	for ( int batchStart = 0; batchStart < jobImages.Num(); batchStart += batchSize ) {
+		const int count = Min( batchSize, jobImages.Num() - batchStart );
+
+		for ( int i = 0; i < count; i++ ) {
+			jobs[i].image = jobImages[batchStart + i];
+			jobs[i].mips.numLevels = 0;
+		}
+
+		double start = Sys_MillisecondsPrecise();
+
+		R_BeginImageLoadJobs();
+		Sys_ParallelFor( LoadImageJobs, jobs, count );
+		R_EndImageLoadJobs();
+
+		double decoded = Sys_MillisecondsPrecise();
+
+		for ( int i = 0; i < count; i++ ) {
+			jobs[i].image->FinishLoadImage( jobs[i].mips );
+		}
+
+		double uploaded = Sys_MillisecondsPrecise();
+		decodeMsec += decoded - start;
+		uploadMsec += uploaded - decoded;
+
+		session->PacifierUpdate();
+	}
+
+	delete[] jobs;
+
+	common->Printf( "%5i images decoded in %1.0f msec on %i threads, uploaded in %1.0f msec\n",
+		jobImages.Num(), decodeMsec, Sys_NumJobThreads() + 1, uploadMsec );
+}
+
 /*
 ===============
 idImageManager::StartBuild
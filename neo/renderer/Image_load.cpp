@@ -515,10 +515,7 @@ There is no way to specify explicit mip map levels
 void idImage::GenerateImage( const byte *pic, int width, int height,
 					   textureFilter_t filterParm, bool allowDownSizeParm,
 					   textureRepeat_t repeatParm, textureDepth_t depthParm ) {
-	bool	preserveBorder;
-	byte		*scaledBuffer;
-	int			scaled_width, scaled_height;
-	byte		*shrunk;
+	imageMipLevels_t	mips;
 
 	PurgeImage();
 
@@ -535,6 +532,24 @@ void idImage::GenerateImage( const byte *pic, int width, int height,
 		return;
 	}
 
+	GenerateMipLevels( pic, width, height, mips );
+	UploadMipLevels( mips );
+}
+
+/*
+================
+GenerateMipLevels
+
+The part of GenerateImage() that doesn't touch OpenGL, so image load
+jobs can run it. Sets internalFormat and the upload size.
+================
+*/
+void idImage::GenerateMipLevels( const byte *pic, int width, int height, imageMipLevels_t &mips ) {
+	bool	preserveBorder;
+	byte		*scaledBuffer;
+	int			scaled_width, scaled_height;
+	byte		*shrunk;
+
 	// don't let mip mapping smear the texture into the clamped border
 	if ( repeat == TR_CLAMP_TO_ZERO ) {
 		preserveBorder = true;
@@ -547,7 +562,7 @@ void idImage::GenerateImage( const byte *pic, int width, int height,
 	scaled_height = MakePowerOfTwo( height );
 
 	if ( scaled_width != width || scaled_height != height ) {
-		common->Error( "R_CreateImage: not a power of 2 image" );
+		R_ImageLoadError( "R_CreateImage: not a power of 2 image" );
 	}
 
 	// Optionally modify our width/height based on options/hardware
@@ -555,9 +570,6 @@ void idImage::GenerateImage( const byte *pic, int width, int height,
 
 	scaledBuffer = NULL;
 
-	// generate the texture number
-	qglGenTextures( 1, &texnum );
-
 	// select proper internal format before we resample
 	internalFormat = SelectInternalFormat( &pic, 1, width, height, depth );
 
@@ -662,33 +674,16 @@ void idImage::GenerateImage( const byte *pic, int width, int height,
 			scaledBuffer[ i ] = 0;
 		}
 	}
-	// upload the main image level
-	Bind();
-
-
-	if ( internalFormat == GL_COLOR_INDEX8_EXT ) {
-		/*
-		if ( depth == TD_BUMP ) {
-			for ( int i = 0; i < scaled_width * scaled_height * 4; i += 4 ) {
-				scaledBuffer[ i ] = scaledBuffer[ i + 3 ];
-				scaledBuffer[ i + 3 ] = 0;
-			}
-		}
-		*/
-		UploadCompressedNormalMap( scaled_width, scaled_height, scaledBuffer, 0 );
-	} else {
-		qglTexImage2D( GL_TEXTURE_2D, 0, internalFormat, scaled_width, scaled_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, scaledBuffer );
-	}
 
-	// create and upload the mip map levels, which we do in all cases, even if we don't think they are needed
-	int		miplevel;
+	mips.width = scaled_width;
+	mips.height = scaled_height;
+	mips.levels[0] = scaledBuffer;
+	mips.numLevels = 1;
 
-	miplevel = 0;
+	// create the mip map levels, which we do in all cases, even if we don't think they are needed
 	while ( scaled_width > 1 || scaled_height > 1 ) {
 		// preserve the border after mip map unless repeating
-		shrunk = R_MipMap( scaledBuffer, scaled_width, scaled_height, preserveBorder );
-		R_StaticFree( scaledBuffer );
-		scaledBuffer = shrunk;
+		scaledBuffer = R_MipMap( scaledBuffer, scaled_width, scaled_height, preserveBorder );
 
 		scaled_width >>= 1;
 		scaled_height >>= 1;
@@ -698,28 +693,89 @@ void idImage::GenerateImage( const byte *pic, int width, int height,
 		if ( scaled_height < 1 ) {
 			scaled_height = 1;
 		}
-		miplevel++;
 
 		// this is a visualization tool that shades each mip map
 		// level with a different color so you can see the
 		// rasterizer's texture level selection algorithm
 		// Changing the color doesn't help with lumminance/alpha/intensity formats...
 		if ( depth == TD_DIFFUSE && globalImages->image_colorMipLevels.GetBool() ) {
-			R_BlendOverTexture( (byte *)scaledBuffer, scaled_width * scaled_height, mipBlendColors[miplevel] );
+			R_BlendOverTexture( (byte *)scaledBuffer, scaled_width * scaled_height, mipBlendColors[mips.numLevels] );
 		}
 
-		// upload the mip map
+		assert( mips.numLevels < MAX_IMAGE_LEVELS );
+		mips.levels[mips.numLevels++] = scaledBuffer;
+	}
+
+	// compress the levels here instead of leaving it to the driver
+	mips.compressed = false;
+	softwareCompressed = false;
+	if ( globalImages->image_softwareCompression.GetInteger() != 0 && R_CanCompressImage( internalFormat ) ) {
+		scaled_width = mips.width;
+		scaled_height = mips.height;
+		for ( int miplevel = 0; miplevel < mips.numLevels; miplevel++ ) {
+			byte *compressed = (byte *)R_StaticAlloc( R_CompressedImageSize( internalFormat, scaled_width, scaled_height ) );
+			R_CompressImage( internalFormat, mips.levels[miplevel], scaled_width, scaled_height, compressed );
+			R_StaticFree( mips.levels[miplevel] );
+			mips.levels[miplevel] = compressed;
+
+			scaled_width = Max( scaled_width >> 1, 1 );
+			scaled_height = Max( scaled_height >> 1, 1 );
+		}
+		mips.compressed = true;
+		softwareCompressed = true;
+	}
+}
+
+/*
+================
+UploadMipLevels
+
+Uploads and frees the levels built by GenerateMipLevels()
+================
+*/
+void idImage::UploadMipLevels( imageMipLevels_t &mips ) {
+	int		scaled_width = mips.width;
+	int		scaled_height = mips.height;
+
+	R_SyncRenderThread();
+
+	// generate the texture number
+	qglGenTextures( 1, &texnum );
+
+	// upload the main image level
+	Bind();
+
+	for ( int miplevel = 0; miplevel < mips.numLevels; miplevel++ ) {
 		if ( internalFormat == GL_COLOR_INDEX8_EXT ) {
-			UploadCompressedNormalMap( scaled_width, scaled_height, scaledBuffer, miplevel );
+			/*
+			if ( depth == TD_BUMP ) {
+				for ( int i = 0; i < scaled_width * scaled_height * 4; i += 4 ) {
+					scaledBuffer[ i ] = scaledBuffer[ i + 3 ];
+					scaledBuffer[ i + 3 ] = 0;
+				}
+			}
+			*/
+			UploadCompressedNormalMap( scaled_width, scaled_height, mips.levels[miplevel], miplevel );
+		} else if ( mips.compressed ) {
+			qglCompressedTexImage2DARB( GL_TEXTURE_2D, miplevel, internalFormat, scaled_width, scaled_height, 0,
+				R_CompressedImageSize( internalFormat, scaled_width, scaled_height ), mips.levels[miplevel] );
 		} else {
 			qglTexImage2D( GL_TEXTURE_2D, miplevel, internalFormat, scaled_width, scaled_height,
-				0, GL_RGBA, GL_UNSIGNED_BYTE, scaledBuffer );
+				0, GL_RGBA, GL_UNSIGNED_BYTE, mips.levels[miplevel] );
 		}
-	}
+		R_StaticFree( mips.levels[miplevel] );
+		mips.levels[miplevel] = NULL;
 
-	if ( scaledBuffer != 0 ) {
-		R_StaticFree( scaledBuffer );
+		scaled_width >>= 1;
+		scaled_height >>= 1;
+		if ( scaled_width < 1 ) {
+			scaled_width = 1;
+		}
+		if ( scaled_height < 1 ) {
+			scaled_height = 1;
+		}
 	}
+	mips.numLevels = 0;
 
 	SetImageFilterAndRepeat();
 
@@ -1048,7 +1104,13 @@ void idImage::WritePrecompressedImage() {
 
 	// Always write the precompressed image if we're making a build
 	if ( !com_makingBuild.GetBool() ) {
-		if ( !globalImages->image_writePrecompressedTextures.GetBool() || !globalImages->image_usePrecompressedTextures.GetBool() ) {
+		// images compressed on the CPU are cached, so they are only compressed once,
+		// unless CheckPrecompressedImage() wouldn't use the .dds file
+		bool cache = softwareCompressed && globalImages->image_softwareCompression.GetInteger() == 1;
+		if ( depth == TD_BUMP && globalImages->image_useNormalCompression.GetInteger() != 2 ) {
+			cache = false;
+		}
+		if ( ( !globalImages->image_writePrecompressedTextures.GetBool() && !cache ) || !globalImages->image_usePrecompressedTextures.GetBool() ) {
 			return;
 		}
 	}
@@ -1481,6 +1543,8 @@ has completed
 void idImage::UploadPrecompressedImage( byte *data, int len ) {
 	ddsFileHeader_t	*header = (ddsFileHeader_t *)(data + 4);
 
+	R_SyncRenderThread();
+
 	// ( not byte swapping dwReserved1 dwReserved2 )
 	header->dwSize = LittleInt( header->dwSize );
 	header->dwFlags = LittleInt( header->dwFlags );
@@ -1730,6 +1794,77 @@ void	idImage::ActuallyLoadImage( bool checkForPrecompressed, bool fromBackEnd )
 	}
 }
 
+/*
+===============
+CanLoadInJob
+
+Image files that image load jobs can decode and mip map,
+ActuallyLoadImage() handles everything else.
+===============
+*/
+bool idImage::CanLoadInJob() const {
+	if ( generatorFunction || isPartialImage || cubeFiles != CF_2D ) {
+		return false;
+	}
+	// these write files while generating the image
+	if ( globalImages->image_writeTGA.GetBool() || globalImages->image_writeNormalTGA.GetBool() ) {
+		return false;
+	}
+	return true;
+}
+
+/*
+===============
+LoadMipLevels
+
+The part of ActuallyLoadImage() that image load jobs run,
+returns false if the image couldn't be loaded.
+===============
+*/
+bool idImage::LoadMipLevels( imageMipLevels_t &mips ) {
+	int		width, height;
+	byte	*pic;
+
+	mips.numLevels = 0;
+
+	R_LoadImageProgram( imgName, &pic, &width, &height, &timestamp, &depth );
+
+	if ( pic == NULL ) {
+		return false;
+	}
+
+	// build a hash for checking duplicate image files
+	imageHash = MD4_BlockChecksum( pic, width * height * 4 );
+
+	GenerateMipLevels( pic, width, height, mips );
+
+	R_StaticFree( pic );
+
+	return true;
+}
+
+/*
+===============
+FinishLoadImage
+
+Uploads the mip levels an image load job built
+===============
+*/
+void idImage::FinishLoadImage( imageMipLevels_t &mips ) {
+	if ( mips.numLevels == 0 ) {
+		common->Warning( "Couldn't load image: %s", imgName.c_str() );
+		MakeDefault();
+		return;
+	}
+
+	PurgeImage();
+	UploadMipLevels( mips );
+	precompressedFile = false;
+
+	// write out the precompressed version of this file if needed
+	WritePrecompressedImage();
+}
+
 //=========================================================================================================
 
 /*
@@ -1738,6 +1873,8 @@ PurgeImage
 ===============
 */
 void idImage::PurgeImage() {
+	R_SyncRenderThread();
+
 	if ( texnum != TEXTURE_NOT_LOADED ) {
 		qglDeleteTextures( 1, &texnum );	// this should be the ONLY place it is ever called!
 		texnum = TEXTURE_NOT_LOADED;
@@ -1759,6 +1896,8 @@ Automatically enables 2D mapping, cube mapping, or 3D texturing if needed
 ==============
 */
 void idImage::Bind() {
+	R_SyncRenderThread();
+
 	// if this is an image that we are caching, move it to the front of the LRU chain
 	if ( partialImage ) {
 		if ( cacheUsageNext ) {
@@ -1774,8 +1913,20 @@ void idImage::Bind() {
 		cacheUsagePrev->cacheUsageNext = this;
 	}
 
-	// load the image if necessary (FIXME: not SMP safe!)
+	// load the image if necessary
 	if ( texnum == TEXTURE_NOT_LOADED ) {
+		if ( R_OnRenderThread() ) {
+			// the render thread can't load, the main thread
+			// will do it after this frame
+			R_DeferImageLoad( this );
+			if ( partialImage ) {
+				partialImage->Bind();
+			} else {
+				globalImages->defaultImage->Bind();
+			}
+			return;
+		}
+
 		if ( partialImage ) {
 			// if we have a partial image, go ahead and use that
 			this->partialImage->Bind();
@@ -1823,16 +1974,19 @@ void idImage::Bind() {
 		if ( tmu->current2DMap != texnum ) {
 			tmu->current2DMap = texnum;
 			qglBindTexture( GL_TEXTURE_2D, texnum );
+			backEnd.pc.c_textureBinds++;
 		}
 	} else if ( type == TT_CUBIC ) {
 		if ( tmu->currentCubeMap != texnum ) {
 			tmu->currentCubeMap = texnum;
 			qglBindTexture( GL_TEXTURE_CUBE_MAP_EXT, texnum );
+			backEnd.pc.c_textureBinds++;
 		}
 	} else if ( type == TT_3D ) {
 		if ( tmu->current3DMap != texnum ) {
 			tmu->current3DMap = texnum;
 			qglBindTexture( GL_TEXTURE_3D, texnum );
+			backEnd.pc.c_textureBinds++;
 		}
 	}
 
@@ -1851,6 +2005,8 @@ do any enable / disable changes
 ==============
 */
 void idImage::BindFragment() {
+	R_SyncRenderThread();
+
 	// if this is an image that we are caching, move it to the front of the LRU chain
 	if ( partialImage ) {
 		if ( cacheUsageNext ) {
@@ -1866,8 +2022,20 @@ void idImage::BindFragment() {
 		cacheUsagePrev->cacheUsageNext = this;
 	}
 
-	// load the image if necessary (FIXME: not SMP safe!)
+	// load the image if necessary
 	if ( texnum == TEXTURE_NOT_LOADED ) {
+		if ( R_OnRenderThread() ) {
+			// the render thread can't load, the main thread
+			// will do it after this frame
+			R_DeferImageLoad( this );
+			if ( partialImage ) {
+				partialImage->BindFragment();
+			} else {
+				globalImages->defaultImage->BindFragment();
+			}
+			return;
+		}
+
 		if ( partialImage ) {
 			// if we have a partial image, go ahead and use that
 			this->partialImage->BindFragment();
@@ -1889,6 +2057,7 @@ void idImage::BindFragment() {
 	bindCount++;
 
 	// bind the texture
+	backEnd.pc.c_textureBinds++;
 	if ( type == TT_2D ) {
 		qglBindTexture( GL_TEXTURE_2D, texnum );
 	} else if ( type == TT_RECT ) {
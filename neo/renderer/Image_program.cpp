@@ -330,8 +330,9 @@ static void R_ImageAdd( byte *data1, int width1, int height1, byte *data2, int w
 }
 
 
-// we build a canonical token form of the image program here
-static char parseBuffer[MAX_IMAGE_NAME];
+// we build a canonical token form of the image program here,
+// per thread because images are loaded by jobs during level load
+static ID_THREAD_LOCAL char parseBuffer[MAX_IMAGE_NAME];
 
 /*
 ===================
@@ -614,6 +615,11 @@ void R_LoadImageProgram( const char *name, byte **pic, int *width, int *height,
 
 	src.LoadMemory( name, strlen(name), name );
 	src.SetFlags( LEXFL_NOFATALERRORS | LEXFL_NOSTRINGCONCAT | LEXFL_NOSTRINGESCAPECHARS | LEXFL_ALLOWPATHNAMES );
+	if ( R_ImageLoadJobsActive() ) {
+		// the console can't be used by jobs, the material parser already
+		// complained about a broken image program
+		src.SetFlags( src.GetFlags() | LEXFL_NOERRORS | LEXFL_NOWARNINGS );
+	}
 
 	parseBuffer[0] = 0;
 	if ( timestamps ) {
@@ -500,12 +500,10 @@ idInteraction *idInteraction::AllocAndLink( idRenderEntityLocal *edef, idRenderL
 	}
 
 	// update the interaction table
-	if ( renderWorld->interactionTable ) {
-		int index = ldef->index * renderWorld->interactionTableWidth + edef->index;
-		if ( renderWorld->interactionTable[index] != NULL ) {
+	if ( renderWorld->interactionTable.IsInitialized() ) {
+		if ( !renderWorld->interactionTable.Add( interaction ) ) {
 			common->Error( "idInteraction::AllocAndLink: non NULL table entry" );
 		}
-		renderWorld->interactionTable[ index ] = interaction;
 	}
 
 	return interaction;
@@ -592,12 +590,10 @@ void idInteraction::UnlinkAndFree( void ) {
 
 	// clear the table pointer
 	idRenderWorldLocal *renderWorld = this->lightDef->world;
-	if ( renderWorld->interactionTable ) {
-		int index = this->lightDef->index * renderWorld->interactionTableWidth + this->entityDef->index;
-		if ( renderWorld->interactionTable[index] != this ) {
+	if ( renderWorld->interactionTable.IsInitialized() ) {
+		if ( !renderWorld->interactionTable.Remove( this ) ) {
 			common->Error( "idInteraction::UnlinkAndFree: interactionTable wasn't set" );
 		}
-		renderWorld->interactionTable[index] = NULL;
 	}
 
 	Unlink();
@@ -1245,6 +1241,152 @@ void idInteraction::AddActiveInteraction( void ) {
 	}
 }
 
+/*
+===========================================================================
+
+idInteractionTable
+
+===========================================================================
+*/
+
+/*
+===============
+idInteractionTable::idInteractionTable
+===============
+*/
+idInteractionTable::idInteractionTable( void ) {
+	slots = NULL;
+	numSlots = 0;
+	numUsed = 0;
+}
+
+/*
+===============
+idInteractionTable::~idInteractionTable
+===============
+*/
+idInteractionTable::~idInteractionTable( void ) {
+	Shutdown();
+}
+
+/*
+===============
+idInteractionTable::Init
+===============
+*/
+void idInteractionTable::Init( int numInteractions ) {
+	Shutdown();
+	numSlots = idMath::CeilPowerOfTwo( Max( numInteractions * 2, 1024 ) );
+	slots = (slot_t *)R_ClearedStaticAlloc( numSlots * sizeof( slots[0] ) );
+	numUsed = 0;
+}
+
+/*
+===============
+idInteractionTable::Shutdown
+===============
+*/
+void idInteractionTable::Shutdown( void ) {
+	if ( slots != NULL ) {
+		R_StaticFree( slots );
+	}
+	slots = NULL;
+	numSlots = 0;
+	numUsed = 0;
+}
+
+/*
+===============
+idInteractionTable::Resize
+===============
+*/
+void idInteractionTable::Resize( int newNumSlots ) {
+	slot_t *oldSlots = slots;
+	int oldNumSlots = numSlots;
+
+	slots = (slot_t *)R_ClearedStaticAlloc( newNumSlots * sizeof( slots[0] ) );
+	numSlots = newNumSlots;
+
+	for ( int i = 0; i < oldNumSlots; i++ ) {
+		if ( oldSlots[i].interaction == NULL ) {
+			continue;
+		}
+		int j = Hash( oldSlots[i].lightIndex, oldSlots[i].entityIndex );
+		while ( slots[j].interaction != NULL ) {
+			j = ( j + 1 ) & ( numSlots - 1 );
+		}
+		slots[j] = oldSlots[i];
+	}
+
+	R_StaticFree( oldSlots );
+}
+
+/*
+===============
+idInteractionTable::Add
+===============
+*/
+bool idInteractionTable::Add( idInteraction *interaction ) {
+	const int lightIndex = interaction->lightDef->index;
+	const int entityIndex = interaction->entityDef->index;
+
+	if ( ( numUsed + 1 ) * 2 > numSlots ) {
+		Resize( numSlots * 2 );
+	}
+
+	int i = Hash( lightIndex, entityIndex );
+	while ( slots[i].interaction != NULL ) {
+		if ( slots[i].lightIndex == lightIndex && slots[i].entityIndex == entityIndex ) {
+			return false;
+		}
+		i = ( i + 1 ) & ( numSlots - 1 );
+	}
+
+	slots[i].lightIndex = lightIndex;
+	slots[i].entityIndex = entityIndex;
+	slots[i].interaction = interaction;
+	numUsed++;
+	return true;
+}
+
+/*
+===============
+idInteractionTable::Remove
+
+Shifts the following entries of the probe sequence back instead of
+leaving a deleted marker, so lookups never get slower over time.
+===============
+*/
+bool idInteractionTable::Remove( const idInteraction *interaction ) {
+	const int lightIndex = interaction->lightDef->index;
+	const int entityIndex = interaction->entityDef->index;
+	const int mask = numSlots - 1;
+
+	int i = Hash( lightIndex, entityIndex );
+	while ( slots[i].interaction != NULL ) {
+		if ( slots[i].lightIndex == lightIndex && slots[i].entityIndex == entityIndex ) {
+			break;
+		}
+		i = ( i + 1 ) & mask;
+	}
+	if ( slots[i].interaction != interaction ) {
+		return false;
+	}
+
+	for ( int j = ( i + 1 ) & mask; slots[j].interaction != NULL; j = ( j + 1 ) & mask ) {
+		// the entry can fill the hole if the hole is between its hash slot and itself
+		const int home = Hash( slots[j].lightIndex, slots[j].entityIndex );
+		if ( ( ( j - home ) & mask ) >= ( ( j - i ) & mask ) ) {
+			slots[i] = slots[j];
+			i = j;
+		}
+	}
+
+	slots[i].interaction = NULL;
+	numUsed--;
+	return true;
+}
+
 /*
 ===================
 R_ShowInteractionMemory_f
@@ -1307,4 +1449,11 @@ void R_ShowInteractionMemory_f( const idCmdArgs &args ) {
 	common->Printf( "%i deferred interactions, %i empty interactions\n", deferredInteractions, emptyInteractions );
 	common->Printf( "%5i indexes %5i verts in %5i light tris\n", lightTriIndexes, lightTriVerts, lightTris );
 	common->Printf( "%5i indexes %5i verts in %5i shadow tris\n", shadowTriIndexes, shadowTriVerts, shadowTris );
+
+	const idInteractionTable &table = tr.primaryWorld->interactionTable;
+	if ( table.IsInitialized() ) {
+		common->Printf( "interactionTable: %i of %i slots used totalling %ik\n", table.Num(), table.Size(), table.MemoryUsed() / 1024 );
+	} else {
+		common->Printf( "no interactionTable\n" );
+	}
 }
@@ -178,6 +178,76 @@ private:
 	idScreenRect			CalcInteractionScissorRectangle( const idFrustum &viewFrustum );
 };
 
+/*
+===============================================================================
+
+	Light / entity interaction lookup.
+
+	Open addressing hash keyed on the lightDef and entityDef index, so
+	the memory grows with the number of interactions instead of with
+	lightDefs * entityDefs.  The interactions stay linked on their light
+	and entity, which is what all the per light and per entity loops use.
+
+===============================================================================
+*/
+
+class idInteractionTable {
+public:
+							idInteractionTable( void );
+							~idInteractionTable( void );
+
+	// allocates room for at least numInteractions, the table grows as needed
+	void					Init( int numInteractions );
+	void					Shutdown( void );
+	bool					IsInitialized( void ) const { return ( slots != NULL ); }
+
+	idInteraction *			Find( int lightIndex, int entityIndex ) const;
+
+	// returns false if there already is an interaction for the light and entity
+	bool					Add( idInteraction *interaction );
+
+	// returns false if the interaction wasn't in the table
+	bool					Remove( const idInteraction *interaction );
+
+	int						Num( void ) const { return numUsed; }
+	int						Size( void ) const { return numSlots; }
+	int						MemoryUsed( void ) const { return numSlots * sizeof( slots[0] ); }
+
+private:
+	typedef struct {
+		int					lightIndex;
+		int					entityIndex;
+		idInteraction *		interaction;		// NULL = free slot
+	} slot_t;
+
+	slot_t *				slots;
+	int						numSlots;			// always a power of two
+	int						numUsed;			// kept at most half of numSlots
+
+	int						Hash( int lightIndex, int entityIndex ) const;
+	void					Resize( int newNumSlots );
+};
+
+ID_INLINE int idInteractionTable::Hash( int lightIndex, int entityIndex ) const {
+	unsigned int h = (unsigned int)lightIndex * 0x9E3779B1u ^ (unsigned int)entityIndex * 0x85EBCA77u;
+	return ( h ^ ( h >> 15 ) ) & ( numSlots - 1 );
+}
+
+ID_INLINE idInteraction *idInteractionTable::Find( int lightIndex, int entityIndex ) const {
+	if ( slots == NULL ) {
+		return NULL;
+	}
+	for ( int i = Hash( lightIndex, entityIndex ); ; i = ( i + 1 ) & ( numSlots - 1 ) ) {
+		const slot_t &slot = slots[i];
+		if ( slot.interaction == NULL ) {
+			return NULL;
+		}
+		if ( slot.lightIndex == lightIndex && slot.entityIndex == entityIndex ) {
+			return slot.interaction;
+		}
+	}
+}
+
 
 void R_CalcInteractionFacing( const idRenderEntityLocal *ent, const srfTriangles_t *tri, const idRenderLightLocal *light, srfCullInfo_t &cullInfo );
 void R_CalcInteractionCullBits( const idRenderEntityLocal *ent, const srfTriangles_t *tri, const idRenderLightLocal *light, srfCullInfo_t &cullInfo );
@@ -147,6 +147,7 @@ public:
 
 	void						ParseMesh( idLexer &parser, int numJoints, const idJointMat *joints );
 	void						UpdateSurface( const struct renderEntity_s *ent, const idJointMat *joints, modelSurface_t *surf );
+	void						DeformSurface( const struct renderEntity_s *ent, const idJointMat *joints, srfTriangles_t *tri );
 	idBounds					CalcBounds( const idJointMat *joints );
 	int							NearestJoint( int a, int b, int c ) const;
 	int							NumVerts( void ) const;
@@ -186,6 +187,9 @@ public:
 	virtual const idJointQuat *	GetDefaultPose( void ) const;
 	virtual int					NearestJoint( int surfaceNum, int a, int b, int c ) const;
 
+	static void					BeginDeferredDeforms( void );
+	static void					FinishDeferredDeforms( void );
+
 private:
 	idList<idMD5Joint>			joints;
 	idList<idJointQuat>			defaultPose;
@@ -195,6 +199,8 @@ private:
 	void						GetFrameBounds( const renderEntity_t *ent, idBounds &bounds ) const;
 	void						DrawJoints( const renderEntity_t *ent, const struct viewDef_s *view ) const;
 	void						ParseJoint( idLexer &parser, idMD5Joint *joint, idJointQuat *defaultPose );
+
+	static void					DeformDeferredModels( void *data, int first, int last );
 };
 
 /*
@@ -44,6 +44,24 @@ static int c_numVerts = 0;
 static int c_numWeights = 0;
 static int c_numWeightJoints = 0;
 
+// while deferring, UpdateSurface() only allocates the surface and queues the
+// vertex skinning, which FinishDeferredDeforms() then runs on the job threads
+typedef struct {
+	idMD5Mesh *					mesh;
+	srfTriangles_t *			tri;
+} md5DeferredSurf_t;
+
+typedef struct {
+	const renderEntity_t *		ent;
+	idRenderModelStatic *		staticModel;
+	int							firstSurf;
+	int							numSurfs;
+} md5DeferredModel_t;
+
+static bool							md5DeferDeforms = false;
+static idList<md5DeferredSurf_t>	md5DeferredSurfs;
+static idList<md5DeferredModel_t>	md5DeferredModels;
+
 typedef struct vertexWeight_s {
 	int							vert;
 	int							joint;
@@ -285,7 +303,7 @@ idMD5Mesh::UpdateSurface
 ====================
 */
 void idMD5Mesh::UpdateSurface( const struct renderEntity_s *ent, const idJointMat *entJoints, modelSurface_t *surf ) {
-	int i, base;
+	int i;
 	srfTriangles_t *tri;
 
 	tr.pc.c_deformedSurfaces++;
@@ -334,6 +352,31 @@ void idMD5Mesh::UpdateSurface( const struct renderEntity_s *ent, const idJointMa
 		}
 	}
 
+	if ( md5DeferDeforms ) {
+		// the job threads can't touch the triangle allocators, so grab the face planes now
+		if ( !r_useDeferredTangents.GetBool() && tri->dominantTris == NULL && tri->facePlanes == NULL ) {
+			R_AllocStaticTriSurfPlanes( tri, tri->numIndexes );
+		}
+		md5DeferredSurf_t &deferred = md5DeferredSurfs.Alloc();
+		deferred.mesh = this;
+		deferred.tri = tri;
+		return;
+	}
+
+	DeformSurface( ent, entJoints, tri );
+}
+
+/*
+====================
+idMD5Mesh::DeformSurface
+
+Skins the vertexes of a surface set up by UpdateSurface.  This doesn't allocate
+anything or touch any shared state, so it is safe to run on a job thread.
+====================
+*/
+void idMD5Mesh::DeformSurface( const struct renderEntity_s *ent, const idJointMat *entJoints, srfTriangles_t *tri ) {
+	int i, base;
+
 	if ( ent->shaderParms[ SHADERPARM_MD5_SKINSCALE ] != 0.0f ) {
 		TransformScaledVerts( tri->verts, entJoints, ent->shaderParms[ SHADERPARM_MD5_SKINSCALE ] );
 	} else {
@@ -772,6 +815,8 @@ idRenderModel *idRenderModelMD5::InstantiateDynamicModel( const struct renderEnt
 
 	staticModel->bounds.Clear();
 
+	const int firstDeferred = md5DeferredSurfs.Num();
+
 	if ( r_showSkel.GetInteger() ) {
 		if ( ( view != NULL ) && ( !r_skipSuppress.GetBool() || !ent->suppressSurfaceInViewID || ( ent->suppressSurfaceInViewID != view->renderView.viewID ) ) ) {
 			// only draw the skeleton
@@ -818,13 +863,75 @@ idRenderModel *idRenderModelMD5::InstantiateDynamicModel( const struct renderEnt
 
 		mesh->UpdateSurface( ent, ent->joints, surf );
 
-		staticModel->bounds.AddPoint( surf->geometry->bounds[0] );
-		staticModel->bounds.AddPoint( surf->geometry->bounds[1] );
+		if ( !md5DeferDeforms ) {
+			staticModel->bounds.AddPoint( surf->geometry->bounds[0] );
+			staticModel->bounds.AddPoint( surf->geometry->bounds[1] );
+		}
+	}
+
+	if ( md5DeferDeforms && md5DeferredSurfs.Num() > firstDeferred ) {
+		md5DeferredModel_t &deferred = md5DeferredModels.Alloc();
+		deferred.ent = ent;
+		deferred.staticModel = staticModel;
+		deferred.firstSurf = firstDeferred;
+		deferred.numSurfs = md5DeferredSurfs.Num() - firstDeferred;
 	}
 
 	return staticModel;
 }
 
+/*
+====================
+idRenderModelMD5::BeginDeferredDeforms
+
+Until FinishDeferredDeforms is called, InstantiateDynamicModel only sets up the
+snapshot surfaces and leaves their vertexes and bounds for the job threads.
+The snapshots must not be used before then.
+====================
+*/
+void idRenderModelMD5::BeginDeferredDeforms( void ) {
+	assert( !md5DeferDeforms );
+
+	md5DeferredSurfs.SetGranularity( 256 );
+	md5DeferredModels.SetGranularity( 64 );
+	md5DeferredSurfs.SetNum( 0, false );
+	md5DeferredModels.SetNum( 0, false );
+	md5DeferDeforms = true;
+}
+
+/*
+====================
+idRenderModelMD5::DeformDeferredModels
+====================
+*/
+void idRenderModelMD5::DeformDeferredModels( void *data, int first, int last ) {
+	for ( int i = first; i < last; i++ ) {
+		const md5DeferredModel_t &deferred = md5DeferredModels[i];
+		const md5DeferredSurf_t *surfs = &md5DeferredSurfs[deferred.firstSurf];
+
+		for ( int j = 0; j < deferred.numSurfs; j++ ) {
+			surfs[j].mesh->DeformSurface( deferred.ent, deferred.ent->joints, surfs[j].tri );
+			deferred.staticModel->bounds.AddPoint( surfs[j].tri->bounds[0] );
+			deferred.staticModel->bounds.AddPoint( surfs[j].tri->bounds[1] );
+		}
+	}
+}
+
+/*
+====================
+idRenderModelMD5::FinishDeferredDeforms
+
+Every snapshot is only written by the job that owns it, so the result is the
+same as deforming them one after another.
+====================
+*/
+void idRenderModelMD5::FinishDeferredDeforms( void ) {
+	assert( md5DeferDeforms );
+
+	md5DeferDeforms = false;
+	Sys_ParallelFor( DeformDeferredModels, NULL, md5DeferredModels.Num() );
+}
+
 /*
 ====================
 idRenderModelMD5::IsDynamicModel
@@ -79,6 +79,11 @@ static void R_PerformanceCounters( void ) {
 		}
 	}
 
+	if ( r_showStateChanges.GetBool() ) {
+		common->Printf( "stateChanges:%i textureBinds:%i materialChanges:%i\n",
+			backEnd.pc.c_stateChanges, backEnd.pc.c_textureBinds, backEnd.pc.c_materialChanges );
+	}
+
 	if ( r_showDynamic.GetBool() ) {
 		common->Printf( "callback:%i md5:%i dfrmVerts:%i dfrmTris:%i tangTris:%i guis:%i\n",
 			tr.pc.c_entityDefCallbacks,
@@ -96,6 +101,12 @@ static void R_PerformanceCounters( void ) {
 			tr.pc.c_box_cull_in, tr.pc.c_box_cull_out );
 	}
 
+	if ( r_showOcclusionCulling.GetInteger() ) {
+		common->Printf( "occluderTris:%i tests:%i occludedEntities:%i occludedLights:%i (%i usec)\n",
+			tr.pc.c_occluderTris, tr.pc.c_occlusionTests, tr.pc.c_occludedEntities,
+			tr.pc.c_occludedLights, tr.pc.occlusionUsec );
+	}
+
 	if ( r_showAlloc.GetBool() ) {
 		common->Printf( "alloc:%i free:%i\n", tr.pc.c_alloc, tr.pc.c_free );
 	}
@@ -117,6 +128,15 @@ static void R_PerformanceCounters( void ) {
 		int	m1 = frameData ? frameData->memoryHighwater : 0;
 		common->Printf( "frameData: %i (%i)\n", R_CountFrameData(), m1 );
 	}
+	if ( r_frameAllocStats.GetBool() && frameData ) {
+		R_CountFrameData();
+		for ( int i = 0; i <= MAX_JOB_THREADS; i++ ) {
+			const frameArena_t &arena = frameData->arenas[i];
+			if ( arena.highwater ) {
+				common->Printf( "frameAlloc %s: %ik (%ik)\n", i ? va( "JobWorker%i", i - 1 ) : "main", arena.frameBytes >> 10, arena.highwater >> 10 );
+			}
+		}
+	}
 	if ( r_showLightScale.GetBool() ) {
 		common->Printf( "lightScale: %f\n", backEnd.pc.maxLightValue );
 	}
@@ -150,7 +170,12 @@ static void R_IssueRenderCommands( void ) {
 	// r_skipRender is usually more usefull, because it will still
 	// draw 2D graphics
 	if ( !r_skipBackEnd.GetBool() ) {
-		RB_ExecuteBackEndCommands( frameData->cmdHead );
+		if ( R_RenderThreadActive() ) {
+			// returns right away, the list stays valid until the frameData is reused
+			R_IssueRenderThreadCommands( frameData->cmdHead );
+		} else {
+			RB_ExecuteBackEndCommands( frameData->cmdHead );
+		}
 	}
 
 	R_ClearCommandChain();
@@ -254,20 +279,28 @@ static void R_CheckCvars( void ) {
 
 		if ( r_gammaInShader.GetBool() ) {
 			common->Printf( "Will apply r_gamma and r_brightness in shaders\n" );
-			GLimp_ResetGamma(); // reset hardware gamma
+			if ( !r_nullGL.GetBool() ) {
+				GLimp_ResetGamma(); // reset hardware gamma
+			}
 		} else {
 			common->Printf( "Will apply r_gamma and r_brightness in hardware (possibly on all screens)\n" );
 			R_SetColorMappings();
 		}
 	}
 
+	// r_nullGL has no window or context these could be applied to
 	if ( r_swapInterval.IsModified() ) {
-		GLimp_SetSwapInterval( r_swapInterval.GetInteger() );
+		if ( !r_nullGL.GetBool() ) {
+			R_SyncRenderThread();
+			GLimp_SetSwapInterval( r_swapInterval.GetInteger() );
+		}
 		r_swapInterval.ClearModified();
 	}
 
 	if ( r_windowResizable.IsModified() ) {
-		GLimp_SetWindowResizable( r_windowResizable.GetBool() );
+		if ( !r_nullGL.GetBool() ) {
+			GLimp_SetWindowResizable( r_windowResizable.GetBool() );
+		}
 		r_windowResizable.ClearModified();
 	}
 }
@@ -529,7 +562,9 @@ void idRenderSystemLocal::SetBackEndRenderer() {
 
 	backEndRenderer = BE_BAD;
 
-	if ( idStr::Icmp( r_renderer.GetString(), "arb2" ) == 0 ) {
+	if ( r_nullGL.GetBool() ) {
+		backEndRenderer = BE_NULL;
+	} else if ( idStr::Icmp( r_renderer.GetString(), "arb2" ) == 0 ) {
 		if ( glConfig.allowARB2Path ) {
 			backEndRenderer = BE_ARB2;
 		}
@@ -552,6 +587,12 @@ void idRenderSystemLocal::SetBackEndRenderer() {
 		backEndRendererHasVertexPrograms = true;
 		backEndRendererMaxLight = 999;
 		break;
+	case BE_NULL:
+		// same front end work as ARB2, so the timings are comparable
+		common->Printf( "using null renderSystem\n" );
+		backEndRendererHasVertexPrograms = true;
+		backEndRendererMaxLight = 999;
+		break;
 	default:
 		common->FatalError( "SetbackEndRenderer: bad back end" );
 	}
@@ -679,6 +720,10 @@ void idRenderSystemLocal::EndFrame( int *frontEndMsec, int *backEndMsec ) {
 		return;
 	}
 
+	// with r_smp wait for the back end of the last frame, so its
+	// counters are valid and its frameData can be reused below
+	R_FinishRenderThreadFrame();
+
 	// close any gui drawing
 	guiModel->EmitFullScreen();
 	guiModel->Clear();
@@ -697,8 +742,10 @@ void idRenderSystemLocal::EndFrame( int *frontEndMsec, int *backEndMsec ) {
 	// check for dynamic changes that require some initialization
 	R_CheckCvars();
 
-	// check for errors
-	GL_CheckErrors();
+	// check for errors, the render thread has the context
+	if ( !R_RenderThreadActive() ) {
+		GL_CheckErrors();
+	}
 
 	// add the swapbuffers command
 	cmd = (emptyCommand_t *)R_GetCommandBuffer( sizeof( *cmd ) );
@@ -933,6 +980,7 @@ void idRenderSystemLocal::CaptureRenderToFile( const char *fileName, bool fixAlp
 	guiModel->EmitFullScreen();
 	guiModel->Clear();
 	R_IssueRenderCommands();
+	R_SyncRenderThread();
 
 	qglReadBuffer( GL_BACK );
 
@@ -976,6 +1024,9 @@ FreeRenderWorld
 ==============
 */
 void idRenderSystemLocal::FreeRenderWorld( idRenderWorld *rw ) {
+	// the back end may still draw the last frame of it
+	R_WaitForRenderThread();
+
 	if ( primaryWorld == rw ) {
 		primaryWorld = NULL;
 	}
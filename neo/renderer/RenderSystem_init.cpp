@@ -74,16 +74,18 @@ idCVar r_useNodeCommonChildren( "r_useNodeCommonChildren", "1", CVAR_RENDERER |
 idCVar r_useShadowProjectedCull( "r_useShadowProjectedCull", "1", CVAR_RENDERER | CVAR_BOOL, "discard triangles outside light volume before shadowing" );
 idCVar r_useShadowVertexProgram( "r_useShadowVertexProgram", "1", CVAR_RENDERER | CVAR_BOOL, "do the shadow projection in the vertex program on capable cards" );
 idCVar r_useShadowSurfaceScissor( "r_useShadowSurfaceScissor", "1", CVAR_RENDERER | CVAR_BOOL, "scissor shadows by the scissor rect of the interaction surfaces" );
-idCVar r_useInteractionTable( "r_useInteractionTable", "1", CVAR_RENDERER | CVAR_BOOL, "create a full entityDefs * lightDefs table to make finding interactions faster" );
+idCVar r_useInteractionTable( "r_useInteractionTable", "1", CVAR_RENDERER | CVAR_BOOL, "create a lightDef / entityDef hash table to make finding interactions faster" );
 idCVar r_useTurboShadow( "r_useTurboShadow", "1", CVAR_RENDERER | CVAR_BOOL, "use the infinite projection with W technique for dynamic shadows" );
 idCVar r_useTwoSidedStencil( "r_useTwoSidedStencil", "1", CVAR_RENDERER | CVAR_BOOL, "do stencil shadows in one pass with different ops on each side" );
 idCVar r_useDeferredTangents( "r_useDeferredTangents", "1", CVAR_RENDERER | CVAR_BOOL, "defer tangents calculations after deform" );
 idCVar r_useCachedDynamicModels( "r_useCachedDynamicModels", "1", CVAR_RENDERER | CVAR_BOOL, "cache snapshots of dynamic models" );
+idCVar r_parallelDynamicModels( "r_parallelDynamicModels", "1", CVAR_RENDERER | CVAR_BOOL, "deform visible md5 models on the job threads" );
 
 idCVar r_useVertexBuffers( "r_useVertexBuffers", "1", CVAR_RENDERER | CVAR_INTEGER, "use ARB_vertex_buffer_object for vertexes", 0, 1, idCmdSystem::ArgCompletion_Integer<0,1>  );
 idCVar r_useIndexBuffers( "r_useIndexBuffers", "0", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_INTEGER, "use ARB_vertex_buffer_object for indexes", 0, 1, idCmdSystem::ArgCompletion_Integer<0,1>  );
 
 idCVar r_useStateCaching( "r_useStateCaching", "1", CVAR_RENDERER | CVAR_BOOL, "avoid redundant state changes in GL_*() calls" );
+idCVar r_useStateSorting( "r_useStateSorting", "1", CVAR_RENDERER | CVAR_BOOL, "sort opaque surfaces by distance, material and entity to reduce state changes" );
 idCVar r_useInfiniteFarZ( "r_useInfiniteFarZ", "1", CVAR_RENDERER | CVAR_BOOL, "use the no-far-clip-plane trick" );
 
 idCVar r_znear( "r_znear", "3", CVAR_RENDERER | CVAR_FLOAT, "near Z clip plane distance", 0.001f, 200.0f );
@@ -107,6 +109,8 @@ idCVar r_skipInteractions( "r_skipInteractions", "0", CVAR_RENDERER | CVAR_BOOL,
 idCVar r_skipDynamicTextures( "r_skipDynamicTextures", "0", CVAR_RENDERER | CVAR_BOOL, "don't dynamically create textures" );
 idCVar r_skipCopyTexture( "r_skipCopyTexture", "0", CVAR_RENDERER | CVAR_BOOL, "do all rendering, but don't actually copyTexSubImage2D" );
 idCVar r_skipBackEnd( "r_skipBackEnd", "0", CVAR_RENDERER | CVAR_BOOL, "don't draw anything" );
+idCVar r_smp( "r_smp", "0", CVAR_RENDERER | CVAR_BOOL | CVAR_ARCHIVE, "run the back end in a render thread, overlapped with the next frame's game and front end (vid_restart to apply)" );
+idCVar r_nullGL( "r_nullGL", "0", CVAR_RENDERER | CVAR_BOOL | CVAR_INIT, "don't create a window or GL context, only run the front end and count and hash the render commands it creates (for timeDemo without a display)" );
 idCVar r_skipRender( "r_skipRender", "0", CVAR_RENDERER | CVAR_BOOL, "skip 3D rendering, but pass 2D" );
 idCVar r_skipRenderContext( "r_skipRenderContext", "0", CVAR_RENDERER | CVAR_BOOL, "NULL the rendering context during backend 3D rendering" );
 idCVar r_skipTranslucent( "r_skipTranslucent", "0", CVAR_RENDERER | CVAR_BOOL, "skip the translucent interaction rendering" );
@@ -132,6 +136,7 @@ idCVar r_useLightScissors( "r_useLightScissors", "1", CVAR_RENDERER | CVAR_BOOL,
 idCVar r_useClippedLightScissors( "r_useClippedLightScissors", "1", CVAR_RENDERER | CVAR_INTEGER, "0 = full screen when near clipped, 1 = exact when near clipped, 2 = exact always", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
 idCVar r_useEntityCulling( "r_useEntityCulling", "1", CVAR_RENDERER | CVAR_BOOL, "0 = none, 1 = box" );
 idCVar r_useEntityScissors( "r_useEntityScissors", "0", CVAR_RENDERER | CVAR_BOOL, "1 = use custom scissor rectangle for each entity" );
+idCVar r_useOcclusionCulling( "r_useOcclusionCulling", "0", CVAR_RENDERER | CVAR_BOOL | CVAR_ARCHIVE, "1 = cull entities and lights behind the world with a software depth buffer" );
 idCVar r_useInteractionCulling( "r_useInteractionCulling", "1", CVAR_RENDERER | CVAR_BOOL, "1 = cull interactions" );
 idCVar r_useInteractionScissors( "r_useInteractionScissors", "2", CVAR_RENDERER | CVAR_INTEGER, "1 = use a custom scissor rectangle for each shadow interaction, 2 = also crop using portal scissors", -2, 2, idCmdSystem::ArgCompletion_Integer<-2,2> );
 idCVar r_useShadowCulling( "r_useShadowCulling", "1", CVAR_RENDERER | CVAR_BOOL, "try to cull shadows from partially visible lights" );
@@ -206,11 +211,14 @@ idCVar r_showTris( "r_showTris", "0", CVAR_RENDERER | CVAR_INTEGER, "enables wir
 idCVar r_showSurfaceInfo( "r_showSurfaceInfo", "0", CVAR_RENDERER | CVAR_BOOL, "show surface material name under crosshair" );
 idCVar r_showNormals( "r_showNormals", "0", CVAR_RENDERER | CVAR_FLOAT, "draws wireframe normals" );
 idCVar r_showMemory( "r_showMemory", "0", CVAR_RENDERER | CVAR_BOOL, "print frame memory utilization" );
+idCVar r_frameAllocStats( "r_frameAllocStats", "0", CVAR_RENDERER | CVAR_BOOL, "print frame memory utilization of each thread" );
 idCVar r_showCull( "r_showCull", "0", CVAR_RENDERER | CVAR_BOOL, "report sphere and box culling stats" );
+idCVar r_showOcclusionCulling( "r_showOcclusionCulling", "0", CVAR_RENDERER | CVAR_INTEGER, "1 = report occlusion culling stats, 2 = also show culled rects, 3 = also draw occluders", 0, 3, idCmdSystem::ArgCompletion_Integer<0,3> );
 idCVar r_showInteractions( "r_showInteractions", "0", CVAR_RENDERER | CVAR_BOOL, "report interaction generation activity" );
 idCVar r_showDepth( "r_showDepth", "0", CVAR_RENDERER | CVAR_BOOL, "display the contents of the depth buffer and the depth range" );
 idCVar r_showSurfaces( "r_showSurfaces", "0", CVAR_RENDERER | CVAR_BOOL, "report surface/light/shadow counts" );
 idCVar r_showPrimitives( "r_showPrimitives", "0", CVAR_RENDERER | CVAR_INTEGER, "report drawsurf/index/vertex counts" );
+idCVar r_showStateChanges( "r_showStateChanges", "0", CVAR_RENDERER | CVAR_BOOL, "report GL state changes, texture binds and material changes each frame" );
 idCVar r_showEdges( "r_showEdges", "0", CVAR_RENDERER | CVAR_BOOL, "draw the sil edges" );
 idCVar r_showTexturePolarity( "r_showTexturePolarity", "0", CVAR_RENDERER | CVAR_BOOL, "shade triangles by texture area polarity" );
 idCVar r_showTangentSpace( "r_showTangentSpace", "0", CVAR_RENDERER | CVAR_INTEGER, "shade triangles by tangent space, 1 = use 1st tangent vector, 2 = use 2nd tangent vector, 3 = use normal vector", 0, 3, idCmdSystem::ArgCompletion_Integer<0,3> );
@@ -368,6 +376,20 @@ DebugCallback( GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei l
 
 }
 
+/*
+=================
+R_ExtensionPointer
+
+With r_nullGL the GL functions are stubs that don't need a context
+=================
+*/
+static GLExtension_t R_ExtensionPointer( const char *name ) {
+	if ( r_nullGL.GetBool() ) {
+		return R_NullGL_ExtensionPointer( name );
+	}
+	return GLimp_ExtensionPointer( name );
+}
+
 /*
 =================
 R_CheckExtension
@@ -395,10 +417,10 @@ static void R_CheckPortableExtensions( void ) {
 	// GL_ARB_multitexture
 	glConfig.multitextureAvailable = R_CheckExtension( "GL_ARB_multitexture" );
 	if ( glConfig.multitextureAvailable ) {
-		qglMultiTexCoord2fARB = (void(APIENTRY *)(GLenum, GLfloat, GLfloat))GLimp_ExtensionPointer( "glMultiTexCoord2fARB" );
-		qglMultiTexCoord2fvARB = (void(APIENTRY *)(GLenum, GLfloat *))GLimp_ExtensionPointer( "glMultiTexCoord2fvARB" );
-		qglActiveTextureARB = (void(APIENTRY *)(GLenum))GLimp_ExtensionPointer( "glActiveTextureARB" );
-		qglClientActiveTextureARB = (void(APIENTRY *)(GLenum))GLimp_ExtensionPointer( "glClientActiveTextureARB" );
+		qglMultiTexCoord2fARB = (void(APIENTRY *)(GLenum, GLfloat, GLfloat))R_ExtensionPointer( "glMultiTexCoord2fARB" );
+		qglMultiTexCoord2fvARB = (void(APIENTRY *)(GLenum, GLfloat *))R_ExtensionPointer( "glMultiTexCoord2fvARB" );
+		qglActiveTextureARB = (void(APIENTRY *)(GLenum))R_ExtensionPointer( "glActiveTextureARB" );
+		qglClientActiveTextureARB = (void(APIENTRY *)(GLenum))R_ExtensionPointer( "glClientActiveTextureARB" );
 		qglGetIntegerv( GL_MAX_TEXTURE_UNITS_ARB, (GLint *)&glConfig.maxTextureUnits );
 		if ( glConfig.maxTextureUnits > MAX_MULTITEXTURE_UNITS ) {
 			glConfig.maxTextureUnits = MAX_MULTITEXTURE_UNITS;
@@ -429,8 +451,8 @@ static void R_CheckPortableExtensions( void ) {
 	// DRI drivers may have GL_ARB_texture_compression but no GL_EXT_texture_compression_s3tc
 	if ( R_CheckExtension( "GL_ARB_texture_compression" ) && R_CheckExtension( "GL_EXT_texture_compression_s3tc" ) ) {
 		glConfig.textureCompressionAvailable = true;
-		qglCompressedTexImage2DARB = (PFNGLCOMPRESSEDTEXIMAGE2DARBPROC)GLimp_ExtensionPointer( "glCompressedTexImage2DARB" );
-		qglGetCompressedTexImageARB = (PFNGLGETCOMPRESSEDTEXIMAGEARBPROC)GLimp_ExtensionPointer( "glGetCompressedTexImageARB" );
+		qglCompressedTexImage2DARB = (PFNGLCOMPRESSEDTEXIMAGE2DARBPROC)R_ExtensionPointer( "glCompressedTexImage2DARB" );
+		qglGetCompressedTexImageARB = (PFNGLGETCOMPRESSEDTEXIMAGEARBPROC)R_ExtensionPointer( "glGetCompressedTexImageARB" );
 		if ( R_CheckExtension( "GL_ARB_texture_compression_bptc" ) ) {
 			glConfig.bptcTextureCompressionAvailable = true;
 		}
@@ -462,7 +484,7 @@ static void R_CheckPortableExtensions( void ) {
 	// GL_EXT_shared_texture_palette
 	glConfig.sharedTexturePaletteAvailable = R_CheckExtension( "GL_EXT_shared_texture_palette" );
 	if ( glConfig.sharedTexturePaletteAvailable ) {
-		qglColorTableEXT = ( void ( APIENTRY * ) ( int, int, int, int, int, const void * ) ) GLimp_ExtensionPointer( "glColorTableEXT" );
+		qglColorTableEXT = ( void ( APIENTRY * ) ( int, int, int, int, int, const void * ) ) R_ExtensionPointer( "glColorTableEXT" );
 	}
 
 	// GL_EXT_texture3D (not currently used for anything)
@@ -470,7 +492,7 @@ static void R_CheckPortableExtensions( void ) {
 	if ( glConfig.texture3DAvailable ) {
 		qglTexImage3D =
 			(void (APIENTRY *)(GLenum, GLint, GLint, GLsizei, GLsizei, GLsizei, GLint, GLenum, GLenum, const GLvoid *) )
-			GLimp_ExtensionPointer( "glTexImage3D" );
+			R_ExtensionPointer( "glTexImage3D" );
 	}
 
 	// EXT_stencil_wrap
@@ -488,16 +510,16 @@ static void R_CheckPortableExtensions( void ) {
 	// GL_EXT_stencil_two_side
 	glConfig.twoSidedStencilAvailable = R_CheckExtension( "GL_EXT_stencil_two_side" );
 	if ( glConfig.twoSidedStencilAvailable )
-		qglActiveStencilFaceEXT = (PFNGLACTIVESTENCILFACEEXTPROC)GLimp_ExtensionPointer( "glActiveStencilFaceEXT" );
+		qglActiveStencilFaceEXT = (PFNGLACTIVESTENCILFACEEXTPROC)R_ExtensionPointer( "glActiveStencilFaceEXT" );
 
 	if( glConfig.glVersion >= 2.0) {
 		common->Printf( "...got GL2.0+ glStencilOpSeparate()\n" );
-		qglStencilOpSeparate = (PFNGLSTENCILOPSEPARATEPROC)GLimp_ExtensionPointer( "glStencilOpSeparate" );
+		qglStencilOpSeparate = (PFNGLSTENCILOPSEPARATEPROC)R_ExtensionPointer( "glStencilOpSeparate" );
 	} else if( R_CheckExtension( "GL_ATI_separate_stencil" ) ) {
 		common->Printf( "...got glStencilOpSeparateATI() (GL_ATI_separate_stencil)\n" );
 		// the ATI version of glStencilOpSeparate() has the same signature and should also
 		// behave identical to the GL2 version (in Mesa3D it's just an alias)
-		qglStencilOpSeparate = (PFNGLSTENCILOPSEPARATEPROC)GLimp_ExtensionPointer( "glStencilOpSeparateATI" );
+		qglStencilOpSeparate = (PFNGLSTENCILOPSEPARATEPROC)R_ExtensionPointer( "glStencilOpSeparateATI" );
 	} else {
 		common->Printf( "X..don't have glStencilOpSeparateATI() or (GL2.0+) glStencilOpSeparate()\n" );
 		qglStencilOpSeparate = NULL;
@@ -506,30 +528,30 @@ static void R_CheckPortableExtensions( void ) {
 	// ARB_vertex_buffer_object
 	glConfig.ARBVertexBufferObjectAvailable = R_CheckExtension( "GL_ARB_vertex_buffer_object" );
 	if(glConfig.ARBVertexBufferObjectAvailable) {
-		qglBindBufferARB = (PFNGLBINDBUFFERARBPROC)GLimp_ExtensionPointer( "glBindBufferARB");
-		qglDeleteBuffersARB = (PFNGLDELETEBUFFERSARBPROC)GLimp_ExtensionPointer( "glDeleteBuffersARB");
-		qglGenBuffersARB = (PFNGLGENBUFFERSARBPROC)GLimp_ExtensionPointer( "glGenBuffersARB");
-		qglIsBufferARB = (PFNGLISBUFFERARBPROC)GLimp_ExtensionPointer( "glIsBufferARB");
-		qglBufferDataARB = (PFNGLBUFFERDATAARBPROC)GLimp_ExtensionPointer( "glBufferDataARB");
-		qglBufferSubDataARB = (PFNGLBUFFERSUBDATAARBPROC)GLimp_ExtensionPointer( "glBufferSubDataARB");
-		qglGetBufferSubDataARB = (PFNGLGETBUFFERSUBDATAARBPROC)GLimp_ExtensionPointer( "glGetBufferSubDataARB");
-		qglMapBufferARB = (PFNGLMAPBUFFERARBPROC)GLimp_ExtensionPointer( "glMapBufferARB");
-		qglUnmapBufferARB = (PFNGLUNMAPBUFFERARBPROC)GLimp_ExtensionPointer( "glUnmapBufferARB");
-		qglGetBufferParameterivARB = (PFNGLGETBUFFERPARAMETERIVARBPROC)GLimp_ExtensionPointer( "glGetBufferParameterivARB");
-		qglGetBufferPointervARB = (PFNGLGETBUFFERPOINTERVARBPROC)GLimp_ExtensionPointer( "glGetBufferPointervARB");
+		qglBindBufferARB = (PFNGLBINDBUFFERARBPROC)R_ExtensionPointer( "glBindBufferARB");
+		qglDeleteBuffersARB = (PFNGLDELETEBUFFERSARBPROC)R_ExtensionPointer( "glDeleteBuffersARB");
+		qglGenBuffersARB = (PFNGLGENBUFFERSARBPROC)R_ExtensionPointer( "glGenBuffersARB");
+		qglIsBufferARB = (PFNGLISBUFFERARBPROC)R_ExtensionPointer( "glIsBufferARB");
+		qglBufferDataARB = (PFNGLBUFFERDATAARBPROC)R_ExtensionPointer( "glBufferDataARB");
+		qglBufferSubDataARB = (PFNGLBUFFERSUBDATAARBPROC)R_ExtensionPointer( "glBufferSubDataARB");
+		qglGetBufferSubDataARB = (PFNGLGETBUFFERSUBDATAARBPROC)R_ExtensionPointer( "glGetBufferSubDataARB");
+		qglMapBufferARB = (PFNGLMAPBUFFERARBPROC)R_ExtensionPointer( "glMapBufferARB");
+		qglUnmapBufferARB = (PFNGLUNMAPBUFFERARBPROC)R_ExtensionPointer( "glUnmapBufferARB");
+		qglGetBufferParameterivARB = (PFNGLGETBUFFERPARAMETERIVARBPROC)R_ExtensionPointer( "glGetBufferParameterivARB");
+		qglGetBufferPointervARB = (PFNGLGETBUFFERPOINTERVARBPROC)R_ExtensionPointer( "glGetBufferPointervARB");
 	}
 
 	// ARB_vertex_program
 	glConfig.ARBVertexProgramAvailable = R_CheckExtension( "GL_ARB_vertex_program" );
 	if (glConfig.ARBVertexProgramAvailable) {
-		qglVertexAttribPointerARB = (PFNGLVERTEXATTRIBPOINTERARBPROC)GLimp_ExtensionPointer( "glVertexAttribPointerARB" );
-		qglEnableVertexAttribArrayARB = (PFNGLENABLEVERTEXATTRIBARRAYARBPROC)GLimp_ExtensionPointer( "glEnableVertexAttribArrayARB" );
-		qglDisableVertexAttribArrayARB = (PFNGLDISABLEVERTEXATTRIBARRAYARBPROC)GLimp_ExtensionPointer( "glDisableVertexAttribArrayARB" );
-		qglProgramStringARB = (PFNGLPROGRAMSTRINGARBPROC)GLimp_ExtensionPointer( "glProgramStringARB" );
-		qglBindProgramARB = (PFNGLBINDPROGRAMARBPROC)GLimp_ExtensionPointer( "glBindProgramARB" );
-		qglGenProgramsARB = (PFNGLGENPROGRAMSARBPROC)GLimp_ExtensionPointer( "glGenProgramsARB" );
-		qglProgramEnvParameter4fvARB = (PFNGLPROGRAMENVPARAMETER4FVARBPROC)GLimp_ExtensionPointer( "glProgramEnvParameter4fvARB" );
-		qglProgramLocalParameter4fvARB = (PFNGLPROGRAMLOCALPARAMETER4FVARBPROC)GLimp_ExtensionPointer( "glProgramLocalParameter4fvARB" );
+		qglVertexAttribPointerARB = (PFNGLVERTEXATTRIBPOINTERARBPROC)R_ExtensionPointer( "glVertexAttribPointerARB" );
+		qglEnableVertexAttribArrayARB = (PFNGLENABLEVERTEXATTRIBARRAYARBPROC)R_ExtensionPointer( "glEnableVertexAttribArrayARB" );
+		qglDisableVertexAttribArrayARB = (PFNGLDISABLEVERTEXATTRIBARRAYARBPROC)R_ExtensionPointer( "glDisableVertexAttribArrayARB" );
+		qglProgramStringARB = (PFNGLPROGRAMSTRINGARBPROC)R_ExtensionPointer( "glProgramStringARB" );
+		qglBindProgramARB = (PFNGLBINDPROGRAMARBPROC)R_ExtensionPointer( "glBindProgramARB" );
+		qglGenProgramsARB = (PFNGLGENPROGRAMSARBPROC)R_ExtensionPointer( "glGenProgramsARB" );
+		qglProgramEnvParameter4fvARB = (PFNGLPROGRAMENVPARAMETER4FVARBPROC)R_ExtensionPointer( "glProgramEnvParameter4fvARB" );
+		qglProgramLocalParameter4fvARB = (PFNGLPROGRAMLOCALPARAMETER4FVARBPROC)R_ExtensionPointer( "glProgramLocalParameter4fvARB" );
 	}
 
 	// ARB_fragment_program
@@ -539,10 +561,10 @@ static void R_CheckPortableExtensions( void ) {
 		glConfig.ARBFragmentProgramAvailable = R_CheckExtension( "GL_ARB_fragment_program" );
 		if (glConfig.ARBFragmentProgramAvailable) {
 			// these are the same as ARB_vertex_program
-			qglProgramStringARB = (PFNGLPROGRAMSTRINGARBPROC)GLimp_ExtensionPointer( "glProgramStringARB" );
-			qglBindProgramARB = (PFNGLBINDPROGRAMARBPROC)GLimp_ExtensionPointer( "glBindProgramARB" );
-			qglProgramEnvParameter4fvARB = (PFNGLPROGRAMENVPARAMETER4FVARBPROC)GLimp_ExtensionPointer( "glProgramEnvParameter4fvARB" );
-			qglProgramLocalParameter4fvARB = (PFNGLPROGRAMLOCALPARAMETER4FVARBPROC)GLimp_ExtensionPointer( "glProgramLocalParameter4fvARB" );
+			qglProgramStringARB = (PFNGLPROGRAMSTRINGARBPROC)R_ExtensionPointer( "glProgramStringARB" );
+			qglBindProgramARB = (PFNGLBINDPROGRAMARBPROC)R_ExtensionPointer( "glBindProgramARB" );
+			qglProgramEnvParameter4fvARB = (PFNGLPROGRAMENVPARAMETER4FVARBPROC)R_ExtensionPointer( "glProgramEnvParameter4fvARB" );
+			qglProgramLocalParameter4fvARB = (PFNGLPROGRAMLOCALPARAMETER4FVARBPROC)R_ExtensionPointer( "glProgramLocalParameter4fvARB" );
 		}
 	}
 
@@ -555,7 +577,7 @@ static void R_CheckPortableExtensions( void ) {
 	// GL_EXT_depth_bounds_test
 	glConfig.depthBoundsTestAvailable = R_CheckExtension( "EXT_depth_bounds_test" );
 	if ( glConfig.depthBoundsTestAvailable ) {
-		qglDepthBoundsEXT = (PFNGLDEPTHBOUNDSEXTPROC)GLimp_ExtensionPointer( "glDepthBoundsEXT" );
+		qglDepthBoundsEXT = (PFNGLDEPTHBOUNDSEXTPROC)R_ExtensionPointer( "glDepthBoundsEXT" );
 	}
 
 	// GL_ARB_debug_output
@@ -563,7 +585,7 @@ static void R_CheckPortableExtensions( void ) {
 	if ( glConfig.haveDebugContext ) {
 		if ( strstr( glConfig.extensions_string, "GL_ARB_debug_output" ) ) {
 			glConfig.glDebugOutputAvailable = true;
-			qglDebugMessageCallbackARB = (PFNGLDEBUGMESSAGECALLBACKARBPROC)GLimp_ExtensionPointer( "glDebugMessageCallbackARB" );
+			qglDebugMessageCallbackARB = (PFNGLDEBUGMESSAGECALLBACKARBPROC)R_ExtensionPointer( "glDebugMessageCallbackARB" );
 			if ( r_glDebugContext.GetBool() ) {
 				common->Printf( "...using GL_ARB_debug_output (r_glDebugContext is set)\n" );
 				qglDebugMessageCallbackARB(DebugCallback, NULL);
@@ -790,7 +812,17 @@ void R_InitOpenGL( void ) {
 	//
 	// initialize OS specific portions of the renderSystem
 	//
-	for ( i = 0 ; i < 2 ; i++ ) {
+	if ( r_nullGL.GetBool() ) {
+		// no window, so there is nothing the mode could fail on
+		R_GetModeInfo( &glConfig.vidWidth, &glConfig.vidHeight, r_mode.GetInteger() );
+		glConfig.winWidth = glConfig.vidWidth;
+		glConfig.winHeight = glConfig.vidHeight;
+		glConfig.isFullscreen = false;
+		glConfig.haveDebugContext = false;
+		common->Printf( "r_nullGL is set, not creating a window\n" );
+	}
+
+	for ( i = 0 ; i < 2 && !r_nullGL.GetBool() ; i++ ) {
 		// set the parameters we are trying
 		R_GetModeInfo( &glConfig.vidWidth, &glConfig.vidHeight, r_mode.GetInteger() );
 
@@ -821,7 +853,7 @@ void R_InitOpenGL( void ) {
 
 // load qgl function pointers
 #define QGLPROC(name, rettype, args) \
-	q##name = (rettype(APIENTRYP)args)GLimp_ExtensionPointer(#name); \
+	q##name = (rettype(APIENTRYP)args)R_ExtensionPointer(#name); \
 	if (!q##name) \
 		common->FatalError("Unable to initialize OpenGL (%s)", #name);
 
@@ -902,6 +934,9 @@ void R_InitOpenGL( void ) {
 		}
 	}
 #endif
+
+	// with r_smp the context is handed to the render thread
+	R_StartRenderThread();
 }
 
 /*
@@ -1241,6 +1276,7 @@ R_RenderingFPS
 ================
 */
 static float R_RenderingFPS( const renderView_t *renderView ) {
+	R_SyncRenderThread();
 	qglFinish();
 
 	int		start = Sys_Milliseconds();
@@ -1253,6 +1289,7 @@ static float R_RenderingFPS( const renderView_t *renderView ) {
 		renderSystem->BeginFrame( glConfig.vidWidth, glConfig.vidHeight );
 		tr.primaryWorld->RenderScene( renderView );
 		renderSystem->EndFrame( NULL, NULL );
+		R_SyncRenderThread();
 		qglFinish();
 		count++;
 		end = Sys_Milliseconds();
@@ -1331,6 +1368,9 @@ void R_ReadTiledPixels( int width, int height, byte *buffer, renderView_t *ref =
 	int	oldWidth = glConfig.vidWidth;
 	int oldHeight = glConfig.vidHeight;
 
+	// the back end reads the viewport offsets
+	R_SyncRenderThread();
+
 	tr.tiledViewport[0] = width;
 	tr.tiledViewport[1] = height;
 
@@ -1349,6 +1389,7 @@ void R_ReadTiledPixels( int width, int height, byte *buffer, renderView_t *ref =
 			} else {
 				session->UpdateScreen(false);
 			}
+			R_SyncRenderThread();
 
 			int w = oldWidth;
 			if ( xo + w > width ) {
@@ -1656,6 +1697,7 @@ void R_StencilShot( void ) {
 
 	byte *byteBuffer = (byte *)Mem_Alloc(pix);
 
+	R_SyncRenderThread();
 	qglReadPixels( 0, 0, width, height, GL_STENCIL_INDEX , GL_UNSIGNED_BYTE, byteBuffer );
 
 	for ( i = 0 ; i < pix ; i++ ) {
@@ -2002,7 +2044,9 @@ void R_SetColorMappings( void ) {
 		gammaTable[i] = inf;
 	}
 
-	GLimp_SetGamma( gammaTable, gammaTable, gammaTable );
+	if ( !r_nullGL.GetBool() ) {
+		GLimp_SetGamma( gammaTable, gammaTable, gammaTable );
+	}
 }
 
 
@@ -2104,6 +2148,11 @@ void R_VidRestart_f( const idCmdArgs &args ) {
 		full = true;
 	}
 
+	// without a window there is nothing to resize
+	if ( r_nullGL.GetBool() ) {
+		full = true;
+	}
+
 	// DG: in partial mode, try to just resize the window (and make it fullscreen or windowed)
 	//     instead of doing a full vid_restart. Still falls back to a full vid_restart
 	//     in case this doesn't work (for example because MSAA settings have changed)
@@ -2124,6 +2173,7 @@ void R_VidRestart_f( const idCmdArgs &args ) {
 			parms.multiSamples = forceWindow ? -1 : r_multiSamples.GetInteger();
 			parms.stereo = false;
 
+			R_SyncRenderThread();
 			if ( GLimp_SetScreenParms( parms ) ) {
 				common->Printf( "'vid_restart partial' succeeded in changing resolution and/or fullscreen mode\n" );
 				return;
@@ -2140,6 +2190,9 @@ void R_VidRestart_f( const idCmdArgs &args ) {
 	// this could take a while, so give them the cursor back ASAP
 	Sys_GrabMouseCursor( false );
 
+	// the back end runs on the main thread again until R_InitOpenGL()
+	R_StopRenderThread();
+
 	// dump ambient caches
 	renderModelManager->FreeModelVertexCaches();
 
@@ -2288,6 +2341,8 @@ void R_InitCommands( void ) {
 	cmdSystem->AddCommand( "makeAmbientMap", R_MakeAmbientMap_f, CMD_FL_RENDERER|CMD_FL_CHEAT, "makes an ambient map" );
 	cmdSystem->AddCommand( "benchmark", R_Benchmark_f, CMD_FL_RENDERER, "benchmark" );
 	cmdSystem->AddCommand( "gfxInfo", GfxInfo_f, CMD_FL_RENDERER, "show graphics info" );
+	cmdSystem->AddCommand( "frameAllocBench", R_FrameAllocBench_f, CMD_FL_RENDERER, "checks and times frame allocations from the job threads, usage: frameAllocBench [allocations]" );
+	cmdSystem->AddCommand( "nullGLStats", R_NullGLStats_f, CMD_FL_RENDERER, "prints what the null back end counted since the last timeDemo or 'nullGLStats reset'" );
 	cmdSystem->AddCommand( "modulateLights", R_ModulateLights_f, CMD_FL_RENDERER | CMD_FL_CHEAT, "modifies shader parms on all lights" );
 	cmdSystem->AddCommand( "testImage", R_TestImage_f, CMD_FL_RENDERER | CMD_FL_CHEAT, "displays the given image centered on screen", idCmdSystem::ArgCompletion_ImageName );
 	cmdSystem->AddCommand( "testVideo", R_TestVideo_f, CMD_FL_RENDERER | CMD_FL_CHEAT, "displays the given cinematic", idCmdSystem::ArgCompletion_VideoName );
@@ -2322,7 +2377,6 @@ void idRenderSystemLocal::Clear( void ) {
 	backEndRendererHasVertexPrograms = false;
 	backEndRendererMaxLight = 1.0f;
 	ambientLightVector.Zero();
-	sortOffset = 0;
 	worlds.Clear();
 	primaryWorld = NULL;
 	memset( &primaryRenderView, 0, sizeof( primaryRenderView ) );
@@ -2401,6 +2455,8 @@ void idRenderSystemLocal::Shutdown( void ) {
 
 	common->SetRefreshOnPrint( false ); // without a renderer there's nothing to refresh
 
+	R_StopRenderThread();
+
 	R_DoneFreeType( );
 
 	if ( glConfig.isInitialized ) {
@@ -2437,6 +2493,8 @@ idRenderSystemLocal::BeginLevelLoad
 ========================
 */
 void idRenderSystemLocal::BeginLevelLoad( void ) {
+	R_SyncRenderThread();
+
 	renderModelManager->BeginLevelLoad();
 	globalImages->BeginLevelLoad();
 }
@@ -2447,6 +2505,8 @@ idRenderSystemLocal::EndLevelLoad
 ========================
 */
 void idRenderSystemLocal::EndLevelLoad( void ) {
+	R_SyncRenderThread();
+
 	renderModelManager->EndLevelLoad();
 	globalImages->EndLevelLoad();
 	if ( r_forceLoadImages.GetBool() ) {
@@ -2485,6 +2545,7 @@ void idRenderSystemLocal::InitOpenGL( void ) {
 
 		globalImages->ReloadAllImages();
 
+		R_SyncRenderThread();
 		err = qglGetError();
 		if ( err != GL_NO_ERROR ) {
 			common->Printf( "glGetError() = 0x%x\n", err );
@@ -2499,6 +2560,8 @@ idRenderSystemLocal::ShutdownOpenGL
 */
 void idRenderSystemLocal::ShutdownOpenGL( void ) {
 
+	R_StopRenderThread();
+
 	R_ShutdownFrameData();
 
 	// as the input is tied to the window, it should be shut down when the window
@@ -141,10 +141,6 @@ idRenderWorldLocal::idRenderWorldLocal() {
 
 	doublePortals = NULL;
 	numInterAreaPortals = 0;
-
-	interactionTable = 0;
-	interactionTableWidth = 0;
-	interactionTableHeight = 0;
 }
 
 /*
@@ -162,19 +158,6 @@ idRenderWorldLocal::~idRenderWorldLocal() {
 	RB_ClearDebugText( 0 );
 }
 
-/*
-===================
-ResizeInteractionTable
-===================
-*/
-void idRenderWorldLocal::ResizeInteractionTable() {
-	// we overflowed the interaction table, so dump it
-	// we may want to resize this in the future if it turns out to be common
-	common->Printf( "idRenderWorldLocal::ResizeInteractionTable: overflowed interactionTableWidth, dumping\n" );
-	R_StaticFree( interactionTable );
-	interactionTable = NULL;
-}
-
 /*
 ===================
 AddEntityDef
@@ -185,9 +168,6 @@ qhandle_t idRenderWorldLocal::AddEntityDef( const renderEntity_t *re ){
 	int entityHandle = entityDefs.FindNull();
 	if ( entityHandle == -1 ) {
 		entityHandle = entityDefs.Append( NULL );
-		if ( interactionTable && entityDefs.Num() > interactionTableWidth ) {
-			ResizeInteractionTable();
-		}
 	}
 
 	UpdateEntityDef( entityHandle, re );
@@ -364,9 +344,6 @@ qhandle_t idRenderWorldLocal::AddLightDef( const renderLight_t *rlight ) {
 
 	if ( lightHandle == -1 ) {
 		lightHandle = lightDefs.Append( NULL );
-		if ( interactionTable && lightDefs.Num() > interactionTableHeight ) {
-			ResizeInteractionTable();
-		}
 	}
 	UpdateLightDef( lightHandle, rlight );
 
@@ -1504,28 +1481,30 @@ void idRenderWorldLocal::GenerateAllInteractions() {
 
 	// build the interaction table
 	if ( r_useInteractionTable.GetBool() ) {
-		interactionTableWidth = entityDefs.Num() + 100;
-		interactionTableHeight = lightDefs.Num() + 100;
-		int	size =  interactionTableWidth * interactionTableHeight * sizeof( *interactionTable );
-		interactionTable = (idInteraction **)R_ClearedStaticAlloc( size );
-
 		int	count = 0;
 		for ( int i = 0 ; i < this->lightDefs.Num() ; i++ ) {
 			idRenderLightLocal	*ldef = this->lightDefs[i];
 			if ( !ldef ) {
 				continue;
 			}
-			idInteraction	*inter;
-			for ( inter = ldef->firstInteraction; inter != NULL; inter = inter->lightNext ) {
-				idRenderEntityLocal	*edef = inter->entityDef;
-				int index = ldef->index * interactionTableWidth + edef->index;
-
-				interactionTable[ index ] = inter;
+			for ( idInteraction *inter = ldef->firstInteraction; inter != NULL; inter = inter->lightNext ) {
 				count++;
 			}
 		}
 
-		common->Printf( "interactionTable size: %i bytes\n", size );
+		interactionTable.Init( count );
+
+		for ( int i = 0 ; i < this->lightDefs.Num() ; i++ ) {
+			idRenderLightLocal	*ldef = this->lightDefs[i];
+			if ( !ldef ) {
+				continue;
+			}
+			for ( idInteraction *inter = ldef->firstInteraction; inter != NULL; inter = inter->lightNext ) {
+				interactionTable.Add( inter );
+			}
+		}
+
+		common->Printf( "interactionTable size: %i bytes\n", interactionTable.MemoryUsed() );
 		common->Printf( "%d interaction take %zd bytes\n", count, count * sizeof( idInteraction ) );
 	}
 
@@ -63,6 +63,8 @@ void idRenderWorldLocal::FreeWorld() {
 		if ( area->entityRefs.areaNext != &area->entityRefs ) {
 			common->Error( "FreeWorld: unexpected remaining entityRefs" );
 		}
+
+		R_FreeAreaOccluders( area );
 	}
 
 	if ( portalAreas ) {
@@ -441,10 +443,7 @@ void idRenderWorldLocal::FreeDefs() {
 
 	generateAllInteractionsCalled = false;
 
-	if ( interactionTable ) {
-		R_StaticFree( interactionTable );
-		interactionTable = NULL;
-	}
+	interactionTable.Shutdown();
 
 	// free all lightDefs
 	for ( i = 0 ; i < lightDefs.Num() ; i++ ) {
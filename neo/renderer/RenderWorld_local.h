@@ -67,6 +67,9 @@ typedef struct portalArea_s {
 	portal_t *		portals;		// never changes after load
 	areaReference_t	entityRefs;		// head/tail of doubly linked list, may change
 	areaReference_t	lightRefs;		// head/tail of doubly linked list, may change
+	bool			occludersBuilt;	// set the first time R_RenderOcclusionBuffer sees the area
+	idVec3 *		occluderVerts;	// three per opaque triangle, in the winding they occlude from
+	int				numOccluderVerts;
 } portalArea_t;
 
 
@@ -164,13 +167,9 @@ public:
 	idBlockAlloc<areaNumRef_t, 1024>	areaNumRefAllocator;
 
 	// all light / entity interactions are referenced here for fast lookup without
-	// having to crawl the doubly linked lists.  EnntityDefs are sequential for better
-	// cache access, because the table is accessed by light in idRenderWorldLocal::CreateLightDefInteractions()
-	// Growing this table is time consuming, so we add a pad value to the number
-	// of entityDefs and lightDefs
-	idInteraction **		interactionTable;
-	int						interactionTableWidth;		// entityDefs
-	int						interactionTableHeight;		// lightDefs
+	// having to crawl the doubly linked lists, it is built by GenerateAllInteractions()
+	// and grows with the number of interactions from then on
+	idInteractionTable		interactionTable;
 
 
 	bool					generateAllInteractionsCalled;
@@ -242,7 +241,6 @@ public:
 	//--------------------------
 	// RenderWorld.cpp
 
-	void					ResizeInteractionTable();
 
 	void					AddEntityRefToArea( idRenderEntityLocal *def, portalArea_t *area );
 	void					AddLightRefToArea( idRenderLightLocal *light, portalArea_t *area );
@@ -159,8 +159,9 @@ void idVertexCache::Init() {
 
 	virtualMemory = false;
 
-	// use ARB_vertex_buffer_object unless explicitly disabled
-	if( r_useVertexBuffers.GetInteger() && glConfig.ARBVertexBufferObjectAvailable ) {
+	// use ARB_vertex_buffer_object unless explicitly disabled,
+	// or the front end doesn't have the GL context (r_smp)
+	if( r_useVertexBuffers.GetInteger() && glConfig.ARBVertexBufferObjectAvailable && !r_smp.GetBool() ) {
 		common->Printf( "using ARB_vertex_buffer_object memory\n" );
 	} else {
 		virtualMemory = true;
@@ -172,8 +173,10 @@ void idVertexCache::Init() {
 	freeStaticHeaders.next = freeStaticHeaders.prev = &freeStaticHeaders;
 	staticHeaders.next = staticHeaders.prev = &staticHeaders;
 	freeDynamicHeaders.next = freeDynamicHeaders.prev = &freeDynamicHeaders;
-	dynamicHeaders.next = dynamicHeaders.prev = &dynamicHeaders;
-	deferredFreeList.next = deferredFreeList.prev = &deferredFreeList;
+	for ( int i = 0 ; i < NUM_VERTEX_FRAMES ; i++ ) {
+		dynamicHeaders[i].next = dynamicHeaders[i].prev = &dynamicHeaders[i];
+		deferredFreeList[i].next = deferredFreeList[i].prev = &deferredFreeList[i];
+	}
 
 	// set up the dynamic frame memory
 	frameBytes = FRAME_MEMORY_BYTES;
@@ -203,6 +206,9 @@ the cached data isn't valid
 ===========
 */
 void idVertexCache::PurgeAll() {
+	// the back end may still be drawing from them
+	R_SyncRenderThread();
+
 	while( staticHeaders.next != &staticHeaders ) {
 		ActuallyFree( staticHeaders.next );
 	}
@@ -352,10 +358,10 @@ void idVertexCache::Free( vertCache_t *block ) {
 	block->next->prev = block->prev;
 	block->prev->next = block->next;
 
-	block->next = deferredFreeList.next;
-	block->prev = &deferredFreeList;
-	deferredFreeList.next->prev = block;
-	deferredFreeList.next = block;
+	block->next = deferredFreeList[listNum].next;
+	block->prev = &deferredFreeList[listNum];
+	deferredFreeList[listNum].next->prev = block;
+	deferredFreeList[listNum].next = block;
 }
 
 /*
@@ -401,8 +407,8 @@ vertCache_t	*idVertexCache::AllocFrameTemp( void *data, int size ) {
 	block = freeDynamicHeaders.next;
 	block->next->prev = block->prev;
 	block->prev->next = block->next;
-	block->next = dynamicHeaders.next;
-	block->prev = &dynamicHeaders;
+	block->next = dynamicHeaders[listNum].next;
+	block->prev = &dynamicHeaders[listNum];
 	block->next->prev = block;
 	block->prev->next = block;
 
@@ -480,20 +486,23 @@ void idVertexCache::EndFrame() {
 	dynamicCountThisFrame = 0;
 	tempOverflow = false;
 
-	// free all the deferred free headers
-	while( deferredFreeList.next != &deferredFreeList ) {
-		ActuallyFree( deferredFreeList.next );
+	// free the deferred free headers and the frame temp headers of the
+	// frame that last used this listNum, the back end is done with it
+	// even if it runs in the render thread
+	vertCache_t	*deferred = &deferredFreeList[listNum];
+	while( deferred->next != deferred ) {
+		ActuallyFree( deferred->next );
 	}
 
-	// free all the frame temp headers
-	vertCache_t	*block = dynamicHeaders.next;
-	if ( block != &dynamicHeaders ) {
+	vertCache_t	*dynamic = &dynamicHeaders[listNum];
+	vertCache_t	*block = dynamic->next;
+	if ( block != dynamic ) {
 		block->prev = &freeDynamicHeaders;
-		dynamicHeaders.prev->next = freeDynamicHeaders.next;
-		freeDynamicHeaders.next->prev = dynamicHeaders.prev;
+		dynamic->prev->next = freeDynamicHeaders.next;
+		freeDynamicHeaders.next->prev = dynamic->prev;
 		freeDynamicHeaders.next = block;
 
-		dynamicHeaders.next = dynamicHeaders.prev = &dynamicHeaders;
+		dynamic->next = dynamic->prev = dynamic;
 	}
 }
 
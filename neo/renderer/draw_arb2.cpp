@@ -138,7 +138,7 @@ void	RB_ARB2_DrawInteraction( const drawInteraction_t *din ) {
 	din->specularImage->Bind();
 
 	// draw it
-	RB_DrawElementsWithCounters( din->surf->geo );
+	RB_DrawElementsWithCounters( din->surf );
 }
 
 
@@ -196,7 +196,7 @@ void RB_ARB2_CreateDrawInteractions( const drawSurf_t *surf ) {
 		// perform setup here that will not change over multiple interaction passes
 
 		// set the vertex pointers
-		idDrawVert	*ac = (idDrawVert *)vertexCache.Position( surf->geo->ambientCache );
+		idDrawVert	*ac = (idDrawVert *)vertexCache.Position( surf->ambientCache );
 		qglColorPointer( 4, GL_UNSIGNED_BYTE, sizeof( idDrawVert ), ac->color );
 		qglVertexAttribPointerARB( 11, 3, GL_FLOAT, false, sizeof( idDrawVert ), ac->normal.ToFloatPtr() );
 		qglVertexAttribPointerARB( 10, 3, GL_FLOAT, false, sizeof( idDrawVert ), ac->tangents[1].ToFloatPtr() );
@@ -765,6 +765,8 @@ R_ReloadARBPrograms_f
 void R_ReloadARBPrograms_f( const idCmdArgs &args ) {
 	int		i;
 
+	R_SyncRenderThread();
+
 	common->Printf( "----- R_ReloadARBPrograms -----\n" );
 	for ( i = 0 ; progs[i].name[0] ; i++ ) {
 		R_LoadARBProgram( i );
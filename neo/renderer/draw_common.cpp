@@ -357,9 +357,7 @@ void RB_T_FillDepthBuffer( const drawSurf_t *surf ) {
 	const shaderStage_t *pStage;
 	const float	*regs;
 	float		color[4];
-	const srfTriangles_t	*tri;
 
-	tri = surf->geo;
 	shader = surf->material;
 
 	// update the clip plane if needed
@@ -379,7 +377,7 @@ void RB_T_FillDepthBuffer( const drawSurf_t *surf ) {
 	}
 
 	// some deforms may disable themselves by setting numIndexes = 0
-	if ( !tri->numIndexes ) {
+	if ( !surf->numIndexes ) {
 		return;
 	}
 
@@ -389,8 +387,8 @@ void RB_T_FillDepthBuffer( const drawSurf_t *surf ) {
 		return;
 	}
 
-	if ( !tri->ambientCache ) {
-		common->Printf( "RB_T_FillDepthBuffer: !tri->ambientCache\n" );
+	if ( !surf->ambientCache ) {
+		common->Printf( "RB_T_FillDepthBuffer: !surf->ambientCache\n" );
 		return;
 	}
 
@@ -430,7 +428,7 @@ void RB_T_FillDepthBuffer( const drawSurf_t *surf ) {
 		color[3] = 1;
 	}
 
-	idDrawVert *ac = (idDrawVert *)vertexCache.Position( tri->ambientCache );
+	idDrawVert *ac = (idDrawVert *)vertexCache.Position( surf->ambientCache );
 	qglVertexPointer( 3, GL_FLOAT, sizeof( idDrawVert ), ac->xyz.ToFloatPtr() );
 	qglTexCoordPointer( 2, GL_FLOAT, sizeof( idDrawVert ), reinterpret_cast<void *>(&ac->st) );
 
@@ -482,7 +480,7 @@ void RB_T_FillDepthBuffer( const drawSurf_t *surf ) {
 			RB_PrepareStageTexturing( pStage, surf, ac );
 
 			// draw it
-			RB_DrawElementsWithCounters( tri );
+			RB_DrawElementsWithCounters( surf );
 
 			RB_FinishStageTexturing( pStage, surf, ac );
 		}
@@ -498,7 +496,7 @@ void RB_T_FillDepthBuffer( const drawSurf_t *surf ) {
 		globalImages->whiteImage->Bind();
 
 		// draw it
-		RB_DrawElementsWithCounters( tri );
+		RB_DrawElementsWithCounters( surf );
 	}
 
 
@@ -783,12 +781,12 @@ void RB_STD_T_RenderShaderPasses( const drawSurf_t *surf ) {
 	}
 
 	// some deforms may disable themselves by setting numIndexes = 0
-	if ( !tri->numIndexes ) {
+	if ( !surf->numIndexes ) {
 		return;
 	}
 
-	if ( !tri->ambientCache ) {
-		common->Printf( "RB_T_RenderShaderPasses: !tri->ambientCache\n" );
+	if ( !surf->ambientCache ) {
+		common->Printf( "RB_T_RenderShaderPasses: !surf->ambientCache\n" );
 		return;
 	}
 
@@ -816,7 +814,7 @@ void RB_STD_T_RenderShaderPasses( const drawSurf_t *surf ) {
 		RB_EnterModelDepthHack( surf->space->modelDepthHack );
 	}
 
-	idDrawVert *ac = (idDrawVert *)vertexCache.Position( tri->ambientCache );
+	idDrawVert *ac = (idDrawVert *)vertexCache.Position( surf->ambientCache );
 	qglVertexPointer( 3, GL_FLOAT, sizeof( idDrawVert ), ac->xyz.ToFloatPtr() );
 	qglTexCoordPointer( 2, GL_FLOAT, sizeof( idDrawVert ), reinterpret_cast<void *>(&ac->st) );
 
@@ -899,7 +897,7 @@ void RB_STD_T_RenderShaderPasses( const drawSurf_t *surf ) {
 			qglEnable( GL_FRAGMENT_PROGRAM_ARB );
 
 			// draw it
-			RB_DrawElementsWithCounters( tri );
+			RB_DrawElementsWithCounters( surf );
 
 			for ( int i = 1 ; i < newStage->numFragmentProgramImages ; i++ ) {
 				if ( newStage->fragmentProgramImages[i] ) {
@@ -1081,7 +1079,7 @@ void RB_STD_T_RenderShaderPasses( const drawSurf_t *surf ) {
 			qglProgramEnvParameter4fvARB( GL_FRAGMENT_PROGRAM_ARB, PP_PARTICLE_COLCHAN_MASK, parm );
 			
 			// draw it
-			RB_DrawElementsWithCounters( tri );
+			RB_DrawElementsWithCounters( surf );
 
 			// Clean up GL state
 			GL_SelectTexture( 1 );
@@ -1168,7 +1166,7 @@ void RB_STD_T_RenderShaderPasses( const drawSurf_t *surf ) {
 		}
 
 		// bind the texture
-		RB_BindVariableStageImage( &pStage->texture, regs );
+		RB_BindVariableStageImage( &pStage->texture, regs, surf->cinematicFrames ? &surf->cinematicFrames[stage] : NULL );
 
 		// set the state
 		GL_State( pStage->drawStateBits );
@@ -1176,7 +1174,7 @@ void RB_STD_T_RenderShaderPasses( const drawSurf_t *surf ) {
 		RB_PrepareStageTexturing( pStage, surf, ac );
 
 		// draw it
-		RB_DrawElementsWithCounters( tri );
+		RB_DrawElementsWithCounters( surf );
 
 		RB_FinishStageTexturing( pStage, surf, ac );
 
@@ -1247,13 +1245,14 @@ int RB_STD_DrawShaderPasses( drawSurf_t **drawSurfs, int numDrawSurfs ) {
 	// because we want to defer the matrix load because many
 	// surfaces won't draw any ambient passes
 	backEnd.currentSpace = NULL;
+	const idMaterial *lastMaterial = NULL;
 	for (i = 0  ; i < numDrawSurfs ; i++ ) {
 		if ( drawSurfs[i]->material->SuppressInSubview() ) {
 			continue;
 		}
 
 		if ( backEnd.viewDef->isXraySubview && drawSurfs[i]->space->entityDef ) {
-			if ( drawSurfs[i]->space->entityDef->parms.xrayIndex != 2 ) {
+			if ( drawSurfs[i]->space->xrayIndex != 2 ) {
 				continue;
 			}
 		}
@@ -1264,6 +1263,11 @@ int RB_STD_DrawShaderPasses( drawSurf_t **drawSurfs, int numDrawSurfs ) {
 			break;
 		}
 
+		if ( drawSurfs[i]->material != lastMaterial ) {
+			lastMaterial = drawSurfs[i]->material;
+			backEnd.pc.c_materialChanges++;
+		}
+
 		RB_STD_T_RenderShaderPasses( drawSurfs[i] );
 	}
 
@@ -1291,8 +1295,6 @@ the shadow volumes face INSIDE
 =====================
 */
 static void RB_T_Shadow( const drawSurf_t *surf ) {
-	const srfTriangles_t	*tri;
-
 	// set the light position if we are using a vertex program to project the rear surfaces
 	if ( tr.backEndRendererHasVertexPrograms && r_useShadowVertexProgram.GetBool()
 		&& surf->space != backEnd.currentSpace ) {
@@ -1303,25 +1305,23 @@ static void RB_T_Shadow( const drawSurf_t *surf ) {
 		qglProgramEnvParameter4fvARB( GL_VERTEX_PROGRAM_ARB, PP_LIGHT_ORIGIN, localLight.ToFloatPtr() );
 	}
 
-	tri = surf->geo;
-
-	if ( !tri->shadowCache ) {
+	if ( !surf->shadowCache ) {
 		return;
 	}
 
-	qglVertexPointer( 4, GL_FLOAT, sizeof( shadowCache_t ), vertexCache.Position(tri->shadowCache) );
+	qglVertexPointer( 4, GL_FLOAT, sizeof( shadowCache_t ), vertexCache.Position(surf->shadowCache) );
 
 	// we always draw the sil planes, but we may not need to draw the front or rear caps
 	int	numIndexes;
 	bool external = false;
 
 	if ( !r_useExternalShadows.GetInteger() ) {
-		numIndexes = tri->numIndexes;
+		numIndexes = surf->numIndexes;
 	} else if ( r_useExternalShadows.GetInteger() == 2 ) { // force to no caps for testing
-		numIndexes = tri->numShadowIndexesNoCaps;
+		numIndexes = surf->numShadowIndexesNoCaps;
 	} else if ( !(surf->dsFlags & DSF_VIEW_INSIDE_SHADOW) ) {
 		// if we aren't inside the shadow projection, no caps are ever needed needed
-		numIndexes = tri->numShadowIndexesNoCaps;
+		numIndexes = surf->numShadowIndexesNoCaps;
 		external = true;
 	} else if ( !backEnd.vLight->viewInsideLight && !(surf->geo->shadowCapPlaneBits & SHADOW_CAP_INFINITE) ) {
 		// if we are inside the shadow projection, but outside the light, and drawing
@@ -1329,15 +1329,15 @@ static void RB_T_Shadow( const drawSurf_t *surf ) {
 		if ( backEnd.vLight->viewSeesShadowPlaneBits & surf->geo->shadowCapPlaneBits ) {
 			// we can see through a rear cap, so we need to draw it, but we can skip the
 			// caps on the actual surface
-			numIndexes = tri->numShadowIndexesNoFrontCaps;
+			numIndexes = surf->numShadowIndexesNoFrontCaps;
 		} else {
 			// we don't need to draw any caps
-			numIndexes = tri->numShadowIndexesNoCaps;
+			numIndexes = surf->numShadowIndexesNoCaps;
 		}
 		external = true;
 	} else {
 		// must draw everything
-		numIndexes = tri->numIndexes;
+		numIndexes = surf->numIndexes;
 	}
 
 	// set depth bounds
@@ -1357,15 +1357,15 @@ static void RB_T_Shadow( const drawSurf_t *surf ) {
 		} else {
 			// draw different color for turboshadows
 			if ( surf->geo->shadowCapPlaneBits & SHADOW_CAP_INFINITE ) {
-				if ( numIndexes == tri->numIndexes ) {
+				if ( numIndexes == surf->numIndexes ) {
 					qglColor3f( 1/backEnd.overBright, 0.1/backEnd.overBright, 0.1/backEnd.overBright );
 				} else {
 					qglColor3f( 1/backEnd.overBright, 0.4/backEnd.overBright, 0.1/backEnd.overBright );
 				}
 			} else {
-				if ( numIndexes == tri->numIndexes ) {
+				if ( numIndexes == surf->numIndexes ) {
 					qglColor3f( 0.1/backEnd.overBright, 1/backEnd.overBright, 0.1/backEnd.overBright );
-				} else if ( numIndexes == tri->numShadowIndexesNoFrontCaps ) {
+				} else if ( numIndexes == surf->numShadowIndexesNoFrontCaps ) {
 					qglColor3f( 0.1/backEnd.overBright, 1/backEnd.overBright, 0.6/backEnd.overBright );
 				} else {
 					qglColor3f( 0.6/backEnd.overBright, 1/backEnd.overBright, 0.1/backEnd.overBright );
@@ -1376,7 +1376,7 @@ static void RB_T_Shadow( const drawSurf_t *surf ) {
 		qglStencilOp( GL_KEEP, GL_KEEP, GL_KEEP );
 		qglDisable( GL_STENCIL_TEST );
 		GL_Cull( CT_TWO_SIDED );
-		RB_DrawShadowElementsWithCounters( tri, numIndexes );
+		RB_DrawShadowElementsWithCounters( surf, numIndexes );
 		GL_Cull( CT_FRONT_SIDED );
 		qglEnable( GL_STENCIL_TEST );
 
@@ -1395,13 +1395,13 @@ static void RB_T_Shadow( const drawSurf_t *surf ) {
 			if ( !external ) {
 				qglStencilOpSeparate( firstFace, GL_KEEP, tr.stencilDecr, tr.stencilDecr );
 				qglStencilOpSeparate( secondFace, GL_KEEP, tr.stencilIncr, tr.stencilIncr );
-				RB_DrawShadowElementsWithCounters( tri, numIndexes );
+				RB_DrawShadowElementsWithCounters( surf, numIndexes );
 			}
 
 			qglStencilOpSeparate( firstFace, GL_KEEP, GL_KEEP, tr.stencilIncr );
 			qglStencilOpSeparate( secondFace, GL_KEEP, GL_KEEP, tr.stencilDecr );
 
-			RB_DrawShadowElementsWithCounters( tri, numIndexes );
+			RB_DrawShadowElementsWithCounters( surf, numIndexes );
 
 		} else { // DG: this is the original code:
 			// patent-free work around
@@ -1410,20 +1410,20 @@ static void RB_T_Shadow( const drawSurf_t *surf ) {
 				// that get clipped by the near or far clip plane
 				qglStencilOp( GL_KEEP, tr.stencilDecr, tr.stencilDecr );
 				GL_Cull( CT_FRONT_SIDED );
-				RB_DrawShadowElementsWithCounters( tri, numIndexes );
+				RB_DrawShadowElementsWithCounters( surf, numIndexes );
 				qglStencilOp( GL_KEEP, tr.stencilIncr, tr.stencilIncr );
 				GL_Cull( CT_BACK_SIDED );
-				RB_DrawShadowElementsWithCounters( tri, numIndexes );
+				RB_DrawShadowElementsWithCounters( surf, numIndexes );
 			}
 
 			// traditional depth-pass stencil shadows
 			qglStencilOp( GL_KEEP, GL_KEEP, tr.stencilIncr );
 			GL_Cull( CT_FRONT_SIDED );
-			RB_DrawShadowElementsWithCounters( tri, numIndexes );
+			RB_DrawShadowElementsWithCounters( surf, numIndexes );
 
 			qglStencilOp( GL_KEEP, GL_KEEP, tr.stencilDecr );
 			GL_Cull( CT_BACK_SIDED );
-			RB_DrawShadowElementsWithCounters( tri, numIndexes );
+			RB_DrawShadowElementsWithCounters( surf, numIndexes );
 		}
 	} else { // use the formerly patented "Carmack's Reverse" Z-Fail code
 		if( useStencilOpSeperate ) {
@@ -1438,7 +1438,7 @@ static void RB_T_Shadow( const drawSurf_t *surf ) {
 				qglStencilOpSeparate( secondFace, GL_KEEP, GL_KEEP, tr.stencilDecr );
 			}
 			GL_Cull( CT_TWO_SIDED );
-			RB_DrawShadowElementsWithCounters( tri, numIndexes );
+			RB_DrawShadowElementsWithCounters( surf, numIndexes );
 
 		} else { // Z-Fail without glStencilOpSeparate()
 
@@ -1448,20 +1448,20 @@ static void RB_T_Shadow( const drawSurf_t *surf ) {
 			if ( !external ) {
 				qglStencilOp( GL_KEEP, tr.stencilDecr, GL_KEEP );
 				GL_Cull( CT_FRONT_SIDED );
-				RB_DrawShadowElementsWithCounters( tri, numIndexes );
+				RB_DrawShadowElementsWithCounters( surf, numIndexes );
 				qglStencilOp( GL_KEEP, tr.stencilIncr, GL_KEEP );
 				GL_Cull( CT_BACK_SIDED );
-				RB_DrawShadowElementsWithCounters( tri, numIndexes );
+				RB_DrawShadowElementsWithCounters( surf, numIndexes );
 			}
 			// traditional depth-pass stencil shadows
 			else {
 				qglStencilOp( GL_KEEP, GL_KEEP, tr.stencilIncr );
 				GL_Cull( CT_FRONT_SIDED );
-				RB_DrawShadowElementsWithCounters( tri, numIndexes );
+				RB_DrawShadowElementsWithCounters( surf, numIndexes );
 
 				qglStencilOp( GL_KEEP, GL_KEEP, tr.stencilDecr );
 				GL_Cull( CT_BACK_SIDED );
-				RB_DrawShadowElementsWithCounters( tri, numIndexes );
+				RB_DrawShadowElementsWithCounters( surf, numIndexes );
 			}
 		}
 	}
@@ -1547,10 +1547,6 @@ RB_T_BlendLight
 =====================
 */
 static void RB_T_BlendLight( const drawSurf_t *surf ) {
-	const srfTriangles_t *tri;
-
-	tri = surf->geo;
-
 	if ( backEnd.currentSpace != surf->space ) {
 		idPlane	lightProject[4];
 		int		i;
@@ -1569,15 +1565,15 @@ static void RB_T_BlendLight( const drawSurf_t *surf ) {
 	}
 
 	// this gets used for both blend lights and shadow draws
-	if ( tri->ambientCache ) {
-		idDrawVert	*ac = (idDrawVert *)vertexCache.Position( tri->ambientCache );
+	if ( surf->ambientCache ) {
+		idDrawVert	*ac = (idDrawVert *)vertexCache.Position( surf->ambientCache );
 		qglVertexPointer( 3, GL_FLOAT, sizeof( idDrawVert ), ac->xyz.ToFloatPtr() );
-	} else if ( tri->shadowCache ) {
-		shadowCache_t	*sc = (shadowCache_t *)vertexCache.Position( tri->shadowCache );
+	} else if ( surf->shadowCache ) {
+		shadowCache_t	*sc = (shadowCache_t *)vertexCache.Position( surf->shadowCache );
 		qglVertexPointer( 3, GL_FLOAT, sizeof( shadowCache_t ), sc->xyz.ToFloatPtr() );
 	}
 
-	RB_DrawElementsWithCounters( tri );
+	RB_DrawElementsWithCounters( surf );
 }
 
 
@@ -1721,12 +1717,15 @@ static void RB_FogPass( const drawSurf_t *drawSurfs,  const drawSurf_t *drawSurf
 	frustumTris = backEnd.vLight->frustumTris;
 
 	// if we ran out of vertex cache memory, skip it
-	if ( !frustumTris->ambientCache ) {
+	if ( !backEnd.vLight->frustumTrisAmbientCache ) {
 		return;
 	}
 	memset( &ds, 0, sizeof( ds ) );
 	ds.space = &backEnd.viewDef->worldSpace;
 	ds.geo = frustumTris;
+	ds.ambientCache = backEnd.vLight->frustumTrisAmbientCache;
+	ds.numVerts = frustumTris->numVerts;
+	ds.numIndexes = frustumTris->numIndexes;
 	ds.scissorRect = backEnd.viewDef->scissor;
 
 	// find the current color and density of the fog
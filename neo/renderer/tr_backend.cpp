@@ -380,6 +380,7 @@ void GL_State( int stateBits ) {
 	}
 
 	backEnd.glState.glStateBits = stateBits;
+	backEnd.pc.c_stateChanges++;
 }
 
 
@@ -649,13 +650,21 @@ void RB_ExecuteBackEndCommands( const emptyCommand_t *cmds ) {
 		return;
 	}
 
+	if ( tr.backEndRenderer == BE_NULL ) {
+		RB_NullGL_ExecuteBackEndCommands( cmds );
+		return;
+	}
+
 	backEndStartTime = Sys_Milliseconds();
 
 	// needed for editor rendering
 	RB_SetDefaultGLState();
 
-	// upload any image loads that have completed
-	globalImages->CompleteBackgroundImageLoads();
+	// upload any image loads that have completed, the
+	// render thread leaves that to R_FinishRenderThreadFrame()
+	if ( !R_OnRenderThread() ) {
+		globalImages->CompleteBackgroundImageLoads();
+	}
 
 	for ( ; cmds ; cmds = (const emptyCommand_t *)cmds->next ) {
 		switch ( cmds->commandId ) {
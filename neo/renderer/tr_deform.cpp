@@ -61,7 +61,7 @@ static void R_FinishDeform( drawSurf_t *drawSurf, srfTriangles_t *newTri, idDraw
 	newTri->ambientCache = vertexCache.AllocFrameTemp( ac, newTri->numVerts * sizeof( idDrawVert ) );
 	// if we are out of vertex cache, leave it the way it is
 	if ( newTri->ambientCache ) {
-		drawSurf->geo = newTri;
+		R_SetDrawSurfGeo( drawSurf, newTri );
 	}
 }
 
@@ -402,7 +402,7 @@ static void R_FlareDeform( drawSurf_t *surf ) {
 	float distFromPlane = localViewer * plane.Normal() + plane[3];
 	if ( distFromPlane <= 0 ) {
 		newTri->numIndexes = 0;
-		surf->geo = newTri;
+		R_SetDrawSurfGeo( surf, newTri );
 		return;
 	}
 
@@ -543,7 +543,7 @@ static void R_FlareDeform( drawSurf_t *surf ) {
 	float distFromPlane = localViewer * plane.Normal() + plane[3];
 	if ( distFromPlane <= 0 ) {
 		newTri->numIndexes = 0;
-		surf->geo = newTri;
+		R_SetDrawSurfGeo( surf, newTri );
 		return;
 	}
 
@@ -27,6 +27,7 @@ If you have questions concerning this license or the applicable additional terms
 */
 
 #include "sys/platform.h"
+#include "idlib/containers/StaticList.h"
 #include "idlib/math/Interpolate.h"
 #include "framework/Game.h"
 #include "renderer/VertexCache.h"
@@ -395,6 +396,7 @@ viewEntity_t *R_SetEntityDefViewEntity( idRenderEntityLocal *def ) {
 	// set the model and modelview matricies
 	vModel = (viewEntity_t *)R_ClearedFrameAlloc( sizeof( *vModel ) );
 	vModel->entityDef = def;
+	vModel->xrayIndex = def->parms.xrayIndex;
 
 	// the scissorRect will be expanded as the model bounds is accepted into visible portal chains
 	vModel->scissorRect.Clear();
@@ -505,8 +507,10 @@ viewLight_t *R_SetLightDefViewLight( idRenderLightLocal *light ) {
 	vLight->lightProject[3] = light->lightProject[3];
 	vLight->fogPlane = light->frustum[5];
 	vLight->frustumTris = light->frustumTris;
+	vLight->frustumTrisAmbientCache = NULL;		// set in R_AddLightSurfaces for fog lights
 	vLight->falloffImage = light->falloffImage;
 	vLight->lightShader = light->lightShader;
+	vLight->noSpecular = light->parms.noSpecular;
 	vLight->shaderRegisters = NULL;		// allocated and evaluated in R_AddLightSurfaces
 
 	// link the view light
@@ -590,11 +594,10 @@ void idRenderWorldLocal::CreateLightDefInteractions( idRenderLightLocal *ldef )
 
 			// if any of the edef's interaction match this light, we don't
 			// need to consider it.
-			if ( r_useInteractionTable.GetBool() && this->interactionTable ) {
-				// allocating these tables may take several megs on big maps, but it saves 3% to 5% of
-				// the CPU time.  The table is updated at interaction::AllocAndLink() and interaction::UnlinkAndFree()
-				int index = ldef->index * this->interactionTableWidth + edef->index;
-				inter = this->interactionTable[ index ];
+			if ( r_useInteractionTable.GetBool() && this->interactionTable.IsInitialized() ) {
+				// this saves 3% to 5% of the CPU time on big maps.
+				// The table is updated at interaction::AllocAndLink() and interaction::UnlinkAndFree()
+				inter = this->interactionTable.Find( ldef->index, edef->index );
 				if ( inter ) {
 					// if this entity wasn't in view already, the scissor rect will be empty,
 					// so it will only be used for shadow casting
@@ -659,6 +662,25 @@ void idRenderWorldLocal::CreateLightDefInteractions( idRenderLightLocal *ldef )
 
 //===============================================================================================================
 
+/*
+=================
+R_SetDrawSurfGeo
+
+The back end only uses the cache handles and counts copied here,
+geo's can change while it draws when the render thread is running
+=================
+*/
+void R_SetDrawSurfGeo( drawSurf_t *drawSurf, const srfTriangles_t *tri ) {
+	drawSurf->geo = tri;
+	drawSurf->ambientCache = tri->ambientCache;
+	drawSurf->indexCache = tri->indexCache;
+	drawSurf->shadowCache = tri->shadowCache;
+	drawSurf->numVerts = tri->numVerts;
+	drawSurf->numIndexes = tri->numIndexes;
+	drawSurf->numShadowIndexesNoFrontCaps = tri->numShadowIndexesNoFrontCaps;
+	drawSurf->numShadowIndexesNoCaps = tri->numShadowIndexesNoCaps;
+}
+
 /*
 =================
 R_LinkLightSurf
@@ -674,12 +696,13 @@ void R_LinkLightSurf( const drawSurf_t **link, const srfTriangles_t *tri, const
 
 	drawSurf = (drawSurf_t *)R_FrameAlloc( sizeof( *drawSurf ) );
 
-	drawSurf->geo = tri;
+	R_SetDrawSurfGeo( drawSurf, tri );
 	drawSurf->space = space;
 	drawSurf->material = shader;
 	drawSurf->scissorRect = scissor;
 	drawSurf->dsFlags = 0;
 	drawSurf->particle_radius = 0.0f; // #3878
+	drawSurf->cinematicFrames = NULL;
 
 	if ( viewInsideShadow ) {
 		drawSurf->dsFlags |= DSF_VIEW_INSIDE_SHADOW;
@@ -980,6 +1003,14 @@ void R_AddLightSurfaces( void ) {
 			}
 		}
 
+		if ( R_CullLightByOcclusion( vLight ) ) {
+			// nothing the light touches can be seen, so drop it
+			// the same way as a light that doesn't add anything
+			*ptr = vLight->next;
+			light->viewCount = -1;
+			continue;
+		}
+
 #if 0
 		// this never happens, because CullLightByPortals() does a more precise job
 		if ( vLight->scissorRect.IsEmpty() ) {
@@ -1017,6 +1048,7 @@ void R_AddLightSurfaces( void ) {
 			}
 			// touch the surface so it won't get purged
 			vertexCache.Touch( light->frustumTris->ambientCache );
+			vLight->frustumTrisAmbientCache = light->frustumTris->ambientCache;
 		}
 
 		// add the prelight shadows for the static world geometry
@@ -1104,6 +1136,40 @@ bool R_IssueEntityDefCallback( idRenderEntityLocal *def ) {
 	return update;
 }
 
+/*
+===================
+R_FinishEntityDefDynamicModel
+
+Adds the overlays to a freshly instantiated snapshot and makes it the current dynamic model
+===================
+*/
+static void R_FinishEntityDefDynamicModel( idRenderEntityLocal *def ) {
+	if ( def->cachedDynamicModel ) {
+
+		// add any overlays to the snapshot of the dynamic model
+		if ( def->overlay && !r_skipOverlays.GetBool() ) {
+			def->overlay->AddOverlaySurfacesToModel( def->cachedDynamicModel );
+		} else {
+			idRenderModelOverlay::RemoveOverlaySurfacesFromModel( def->cachedDynamicModel );
+		}
+
+		if ( r_checkBounds.GetBool() ) {
+			idBounds b = def->cachedDynamicModel->Bounds();
+			if (	b[0][0] < def->referenceBounds[0][0] - CHECK_BOUNDS_EPSILON ||
+					b[0][1] < def->referenceBounds[0][1] - CHECK_BOUNDS_EPSILON ||
+					b[0][2] < def->referenceBounds[0][2] - CHECK_BOUNDS_EPSILON ||
+					b[1][0] > def->referenceBounds[1][0] + CHECK_BOUNDS_EPSILON ||
+					b[1][1] > def->referenceBounds[1][1] + CHECK_BOUNDS_EPSILON ||
+					b[1][2] > def->referenceBounds[1][2] + CHECK_BOUNDS_EPSILON ) {
+				common->Printf( "entity %i dynamic model exceeded reference bounds\n", def->index );
+			}
+		}
+	}
+
+	def->dynamicModel = def->cachedDynamicModel;
+	def->dynamicModelFrameCount = tr.frameCount;
+}
+
 /*
 ===================
 R_EntityDefDynamicModel
@@ -1117,8 +1183,9 @@ it and any necessary overlays
 idRenderModel *R_EntityDefDynamicModel( idRenderEntityLocal *def ) {
 	bool callbackUpdate;
 
-	// allow deferred entities to construct themselves
-	if ( def->parms.callback ) {
+	// allow deferred entities to construct themselves, unless
+	// R_DeformVisibleModels has already done it for this view
+	if ( def->parms.callback && def->callbackViewCount != tr.viewCount ) {
 		callbackUpdate = R_IssueEntityDefCallback( def );
 	} else {
 		callbackUpdate = false;
@@ -1147,30 +1214,7 @@ idRenderModel *R_EntityDefDynamicModel( idRenderEntityLocal *def ) {
 		// instantiate the snapshot of the dynamic model, possibly reusing memory from the cached snapshot
 		def->cachedDynamicModel = model->InstantiateDynamicModel( &def->parms, tr.viewDef, def->cachedDynamicModel );
 
-		if ( def->cachedDynamicModel ) {
-
-			// add any overlays to the snapshot of the dynamic model
-			if ( def->overlay && !r_skipOverlays.GetBool() ) {
-				def->overlay->AddOverlaySurfacesToModel( def->cachedDynamicModel );
-			} else {
-				idRenderModelOverlay::RemoveOverlaySurfacesFromModel( def->cachedDynamicModel );
-			}
-
-			if ( r_checkBounds.GetBool() ) {
-				idBounds b = def->cachedDynamicModel->Bounds();
-				if (	b[0][0] < def->referenceBounds[0][0] - CHECK_BOUNDS_EPSILON ||
-						b[0][1] < def->referenceBounds[0][1] - CHECK_BOUNDS_EPSILON ||
-						b[0][2] < def->referenceBounds[0][2] - CHECK_BOUNDS_EPSILON ||
-						b[1][0] > def->referenceBounds[1][0] + CHECK_BOUNDS_EPSILON ||
-						b[1][1] > def->referenceBounds[1][1] + CHECK_BOUNDS_EPSILON ||
-						b[1][2] > def->referenceBounds[1][2] + CHECK_BOUNDS_EPSILON ) {
-					common->Printf( "entity %i dynamic model exceeded reference bounds\n", def->index );
-				}
-			}
-		}
-
-		def->dynamicModel = def->cachedDynamicModel;
-		def->dynamicModelFrameCount = tr.frameCount;
+		R_FinishEntityDefDynamicModel( def );
 	}
 
 	// set model depth hack value
@@ -1188,6 +1232,81 @@ idRenderModel *R_EntityDefDynamicModel( idRenderEntityLocal *def ) {
 	return def->dynamicModel;
 }
 
+typedef struct {
+	idCinematic *			cinematic;
+	int						time;
+	cinData_t				frame;
+} frameCinematic_t;
+
+static idStaticList<frameCinematic_t, 64>	frameCinematics;	// frames already copied to frame memory
+static int									frameCinematicsFrameCount = -1;
+
+/*
+=================
+R_DecodeCinematics
+
+The back end only uploads the frames of cinematic stages, decoding reads
+files and allocates. With the render thread running the next frame decodes
+into the same buffer while the back end uploads, so the frame is copied to
+frame memory, once per frame for cinematics on several surfaces.
+=================
+*/
+static const cinData_t *R_DecodeCinematics( const idMaterial *shader ) {
+	cinData_t	*frames = NULL;
+
+	if ( r_skipDynamicTextures.GetBool() ) {
+		return NULL;
+	}
+
+	if ( frameCinematicsFrameCount != tr.frameCount ) {
+		frameCinematics.Clear();
+		frameCinematicsFrameCount = tr.frameCount;
+	}
+
+	// offset time by shaderParm[7] (FIXME: make the time offset a parameter of the shader?)
+	// We make no attempt to optimize for cinematics going at a lower framerate than the renderer.
+	int cinTime = (int)( 1000 * ( tr.viewDef->floatTime + tr.viewDef->renderView.shaderParms[11] ) );
+
+	for ( int i = 0; i < shader->GetNumStages(); i++ ) {
+		idCinematic *cinematic = shader->GetStage( i )->texture.cinematic;
+		if ( !cinematic ) {
+			continue;
+		}
+		if ( !frames ) {
+			frames = (cinData_t *)R_ClearedFrameAlloc( shader->GetNumStages() * sizeof( frames[0] ) );
+		}
+
+		int j;
+		for ( j = 0; j < frameCinematics.Num(); j++ ) {
+			if ( frameCinematics[j].cinematic == cinematic && frameCinematics[j].time == cinTime ) {
+				break;
+			}
+		}
+		if ( j < frameCinematics.Num() ) {
+			frames[i] = frameCinematics[j].frame;
+			continue;
+		}
+
+		frames[i] = cinematic->ImageForTime( cinTime );
+
+		if ( frames[i].image && R_RenderThreadActive() ) {
+			int size = frames[i].imageWidth * frames[i].imageHeight * 4;
+			byte *copy = (byte *)R_FrameAlloc( size );
+			SIMDProcessor->Memcpy( copy, frames[i].image, size );
+			frames[i].image = copy;
+		}
+
+		if ( frameCinematics.Num() < frameCinematics.Max() ) {
+			frameCinematic_t *cached = frameCinematics.Alloc();
+			cached->cinematic = cinematic;
+			cached->time = cinTime;
+			cached->frame = frames[i];
+		}
+	}
+
+	return frames;
+}
+
 /*
 =================
 R_AddDrawSurf
@@ -1202,11 +1321,11 @@ void R_AddDrawSurf( const srfTriangles_t *tri, const viewEntity_t *space, const
 	float			generatedShaderParms[MAX_ENTITY_SHADER_PARMS];
 
 	drawSurf = (drawSurf_t *)R_FrameAlloc( sizeof( *drawSurf ) );
-	drawSurf->geo = tri;
+	R_SetDrawSurfGeo( drawSurf, tri );
 	drawSurf->space = space;
 	drawSurf->material = shader;
 	drawSurf->scissorRect = scissor;
-	drawSurf->sort = shader->GetSort() + tr.sortOffset;
+	drawSurf->sort = shader->GetSort();
 
 	if ( soft_particle_radius != -1.0f )	// #3878
 	{
@@ -1219,9 +1338,7 @@ void R_AddDrawSurf( const srfTriangles_t *tri, const viewEntity_t *space, const
 		drawSurf->particle_radius = 0.0f;
 	}
 
-	// bumping this offset each time causes surfaces with equal sort orders to still
-	// deterministically draw in the order they are added
-	tr.sortOffset += 0.000001f;
+	drawSurf->sortKey = R_DrawSurfSortKey( drawSurf, tr.viewDef->numDrawSurfs );
 
 	// if it doesn't fit, resize the list
 	if ( tr.viewDef->numDrawSurfs == tr.viewDef->maxDrawSurfs ) {
@@ -1305,6 +1422,9 @@ void R_AddDrawSurf( const srfTriangles_t *tri, const viewEntity_t *space, const
 			break;
 	}
 
+	// the back end only uploads the cinematic frames
+	drawSurf->cinematicFrames = R_DecodeCinematics( shader );
+
 	// check for gui surfaces
 	idUserInterface	*gui = NULL;
 
@@ -1484,6 +1604,98 @@ idScreenRect R_CalcEntityScissorRectangle( viewEntity_t *vEntity ) {
 	return R_ScreenRectFromViewFrustumBounds( bounds );
 }
 
+/*
+===================
+R_DeformVisibleModels
+
+Instantiates the md5 models of every entity with a visible rectangle up front,
+so that the vertex skinning can run on the job threads.  Everything else is still
+done here in entity order, and R_AddModelSurfaces then finds the snapshots ready.
+===================
+*/
+static void R_DeformVisibleModels( void ) {
+	viewEntity_t		*vEntity;
+	idRenderEntityLocal	**defs;
+	int					numEntities, numDefs;
+
+	numEntities = 0;
+	for ( vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
+		numEntities++;
+	}
+	defs = (idRenderEntityLocal **)R_FrameAlloc( numEntities * sizeof( defs[0] ) );
+	numDefs = 0;
+
+	idRenderModelMD5::BeginDeferredDeforms();
+
+	for ( vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
+		idRenderEntityLocal *def = vEntity->entityDef;
+
+		if ( r_useEntityScissors.GetBool() ) {
+			// calculate the screen area covered by the entity
+			idScreenRect scissorRect = R_CalcEntityScissorRectangle( vEntity );
+			// intersect with the portal crossing scissor rectangle
+			vEntity->scissorRect.Intersect( scissorRect );
+
+			if ( r_showEntityScissors.GetBool() ) {
+				R_ShowColoredScreenRect( vEntity->scissorRect, def->index );
+			}
+		}
+
+		R_CullEntityByOcclusion( vEntity );
+
+		if ( vEntity->scissorRect.IsEmpty() ) {
+			continue;
+		}
+		if ( tr.viewDef->isXraySubview && def->parms.xrayIndex == 1 ) {
+			continue;
+		} else if ( !tr.viewDef->isXraySubview && def->parms.xrayIndex == 2 ) {
+			continue;
+		}
+		if ( dynamic_cast<const idRenderModelMD5 *>( def->parms.hModel ) == NULL ) {
+			continue;
+		}
+
+		// the callback has to see the same time as in R_AddModelSurfaces
+		bool callbackUpdate = false;
+		if ( def->parms.callback ) {
+			float oldFloatTime = tr.viewDef->floatTime;
+			int oldTime = tr.viewDef->renderView.time;
+
+			game->SelectTimeGroup( def->parms.timeGroup );
+			if ( def->parms.timeGroup ) {
+				tr.viewDef->floatTime = game->GetTimeGroupTime( def->parms.timeGroup ) * 0.001;
+				tr.viewDef->renderView.time = game->GetTimeGroupTime( def->parms.timeGroup );
+			}
+
+			callbackUpdate = R_IssueEntityDefCallback( def );
+			def->callbackViewCount = tr.viewCount;
+
+			tr.viewDef->floatTime = oldFloatTime;
+			tr.viewDef->renderView.time = oldTime;
+		}
+
+		idRenderModel *model = def->parms.hModel;
+		if ( dynamic_cast<idRenderModelMD5 *>( model ) == NULL ) {
+			continue;
+		}
+		if ( callbackUpdate ) {
+			R_ClearEntityDefDynamicModel( def );
+		}
+		if ( def->dynamicModel ) {
+			continue;
+		}
+
+		def->cachedDynamicModel = model->InstantiateDynamicModel( &def->parms, tr.viewDef, def->cachedDynamicModel );
+		defs[numDefs++] = def;
+	}
+
+	idRenderModelMD5::FinishDeferredDeforms();
+
+	for ( int i = 0; i < numDefs; i++ ) {
+		R_FinishEntityDefDynamicModel( defs[i] );
+	}
+}
+
 /*
 ===================
 R_AddModelSurfaces
@@ -1504,11 +1716,17 @@ void R_AddModelSurfaces( void ) {
 	tr.viewDef->numDrawSurfs = 0;
 	tr.viewDef->maxDrawSurfs = 0;	// will be set to INITIAL_DRAWSURFS on R_AddDrawSurf
 
+	// build the visible md5 snapshots in parallel, this also does the entity scissors
+	const bool deformed = r_parallelDynamicModels.GetBool() && Sys_NumJobThreads() > 0;
+	if ( deformed ) {
+		R_DeformVisibleModels();
+	}
+
 	// go through each entity that is either visible to the view, or to
 	// any light that intersects the view (for shadows)
 	for ( vEntity = tr.viewDef->viewEntitys; vEntity; vEntity = vEntity->next ) {
 
-		if ( r_useEntityScissors.GetBool() ) {
+		if ( r_useEntityScissors.GetBool() && !deformed ) {
 			// calculate the screen area covered by the entity
 			idScreenRect scissorRect = R_CalcEntityScissorRectangle( vEntity );
 			// intersect with the portal crossing scissor rectangle
@@ -1519,6 +1737,10 @@ void R_AddModelSurfaces( void ) {
 			}
 		}
 
+		if ( !deformed ) {
+			R_CullEntityByOcclusion( vEntity );
+		}
+
 		float oldFloatTime = 0.0f;
 		int oldTime = 0;
 
@@ -31,6 +31,7 @@ If you have questions concerning this license or the applicable additional terms
 
 class idScreenRect; // yay for include recursion
 
+#include "renderer/Cinematic.h"
 #include "renderer/Image.h"
 #include "renderer/Interaction.h"
 #include "renderer/MegaTexture.h"
@@ -43,8 +44,8 @@ class idRenderWorldLocal;
 
 // everything that is needed by the backend needs
 // to be double buffered to allow it to run in
-// parallel on a dual cpu machine
-const int SMP_FRAMES = 1;
+// parallel on a dual cpu machine (r_smp)
+const int SMP_FRAMES = 2;
 
 const int FALLOFF_TEXTURE_SIZE =	64;
 
@@ -113,9 +114,19 @@ static const int	DSF_SOFT_PARTICLE		= 2; // #3878 - soft particles
 
 typedef struct drawSurf_s {
 	const srfTriangles_t	*geo;
+	// copied from geo by R_SetDrawSurfGeo(), with r_smp the front end of the next
+	// frame can free or replace geo's caches while the back end draws this one
+	struct vertCache_s		*ambientCache;
+	struct vertCache_s		*indexCache;
+	struct vertCache_s		*shadowCache;
+	int						numVerts;
+	int						numIndexes;
+	int						numShadowIndexesNoFrontCaps;
+	int						numShadowIndexesNoCaps;
 	const struct viewEntity_s *space;
 	const idMaterial		*material;	// may be NULL for shadow volumes
 	float					sort;		// material->sort, modified by gui / entity sort offsets
+	unsigned long long		sortKey;	// order in R_SortDrawSurfs(), see R_DrawSurfSortKey()
 	const float				*shaderRegisters;	// evaluated and adjusted for referenceShaders
 	const struct drawSurf_s	*nextOnLight;	// viewLight chains
 	idScreenRect			scissorRect;	// for scissor clipping, local inside renderView viewport
@@ -123,6 +134,7 @@ typedef struct drawSurf_s {
 	struct vertCache_s		*dynamicTexCoords;	// float * in vertex cache memory
 	// specular directions for non vertex program cards, skybox texcoords, etc
 	float					particle_radius;	// The radius of individual quads for soft particles #3878
+	const cinData_t			*cinematicFrames;	// indexed by stage, decoded by R_DecodeCinematics(), NULL without cinematic stages
 } drawSurf_t;
 
 
@@ -268,6 +280,8 @@ public:
 	int						dynamicModelFrameCount;	// continuously animating dynamic models will recreate
 													// dynamicModel if this doesn't == tr.viewCount
 	idRenderModel *			cachedDynamicModel;
+	int						callbackViewCount;		// if == tr.viewCount, R_DeformVisibleModels already
+													// issued the callback for this view
 
 	idBounds				referenceBounds;		// the local bounds used to place entityRefs, either from parms or a model
 
@@ -327,9 +341,11 @@ typedef struct viewLight_s {
 	idPlane					lightProject[4];			// light project used by backend
 	idPlane					fogPlane;					// fog plane for backend fog volume rendering
 	const srfTriangles_t *	frustumTris;				// light frustum for backend fog volume rendering
+	struct vertCache_s *	frustumTrisAmbientCache;	// frustumTris->ambientCache used by backend
 	const idMaterial *		lightShader;				// light shader used by backend
 	const float	*			shaderRegisters;			// shader registers used by backend
 	idImage *				falloffImage;				// falloff image used by backend
+	bool					noSpecular;					// lightDef->parms.noSpecular used by backend
 
 	const struct drawSurf_s	*globalShadows;				// shadow everything
 	const struct drawSurf_s	*localInteractions;			// don't get local shadows
@@ -360,6 +376,7 @@ typedef struct viewEntity_s {
 
 	bool				weaponDepthHack;
 	float				modelDepthHack;
+	int					xrayIndex;				// entityDef->parms.xrayIndex used by backend
 
 	float				modelMatrix[16];		// local coords to global coords
 	float				modelViewMatrix[16];	// local coords to eye coords
@@ -518,22 +535,36 @@ const int	INITIAL_DRAWSURFS =			0x4000;
 typedef struct frameMemoryBlock_s {
 	struct frameMemoryBlock_s *next;
 	int		size;
-	int		used;
+	volatile int used;		// bumped atomically, may overshoot size once the block is full
 	int		poop;			// so that base is 16 byte aligned
 	byte	base[4];	// dynamically allocated as [size]
 } frameMemoryBlock_t;
 
+// every thread that calls R_FrameAlloc bumps through its own small block
+// carved from the shared memory blocks, so it doesn't need a lock
+typedef struct {
+	byte *	base;
+	int		size;
+	int		used;
+	int		frameBytes;		// allocated by this thread since the last R_ToggleSmpFrame
+	int		highwater;		// max frameBytes on any frame
+	byte	pad[64 - sizeof( byte * ) - 4 * sizeof( int )];	// keep the arenas on separate cache lines
+} frameArena_t;
+
 // all of the information needed by the back end must be
 // contained in a frameData_t.  This entire structure is
 // duplicated so the front and back end can run in parallel
-// on an SMP machine (OBSOLETE: this capability has been removed)
+// on an SMP machine, when the render thread is running
 typedef struct {
 	// one or more blocks of memory for all frame
 	// temporary allocations
 	frameMemoryBlock_t	*memory;
 
 	// alloc will point somewhere into the memory chain
-	frameMemoryBlock_t	*alloc;
+	frameMemoryBlock_t * volatile alloc;
+
+	// indexed by Sys_JobThreadIndex()
+	frameArena_t		arenas[MAX_JOB_THREADS + 1];
 
 	srfTriangles_t *	firstDeferredFreeTriSurf;
 	srfTriangles_t *	lastDeferredFreeTriSurf;
@@ -590,6 +621,9 @@ typedef struct {
 	int		c_tangentIndexes;	// R_DeriveTangents()
 	int		c_entityUpdates, c_lightUpdates, c_entityReferences, c_lightReferences;
 	int		c_guiSurfs;
+	int		c_occluderTris;		// R_RenderOcclusionBuffer()
+	int		c_occlusionTests, c_occludedEntities, c_occludedLights;
+	int		occlusionUsec;
 	int		frontEndMsec;		// sum of time in all RE_RenderScene's in a frame
 } performanceCounters_t;
 
@@ -633,6 +667,10 @@ typedef struct {
 	int		c_vboIndexes;
 	float	c_overDraw;
 
+	int		c_stateChanges;		// GL_State() calls that changed something
+	int		c_textureBinds;		// glBindTexture() calls
+	int		c_materialChanges;	// ambient surfaces drawn with a different material than the last one
+
 	float	maxLightValue;	// for light scale
 	int		msec;			// total msec for backend run
 } backEndCounters_t;
@@ -674,6 +712,7 @@ const int MAX_GUI_SURFACES	= 1024;		// default size of the drawSurfs list for gu
 
 typedef enum {
 	BE_ARB2,
+	BE_NULL,		// r_nullGL, nothing is drawn
 	BE_BAD
 } backEndName_t;
 
@@ -765,8 +804,6 @@ public:
 
 	idVec4					ambientLightVector;	// used for "ambient bump mapping"
 
-	float					sortOffset;				// for determinist sorting of equal sort materials
-
 	idList<idRenderWorldLocal*>worlds;
 
 	idRenderWorldLocal *	primaryWorld;
@@ -853,7 +890,7 @@ extern idCVar r_checkBounds;			// compare all surface bounds with precalculated
 extern idCVar r_useLightPortalFlow;		// 1 = do a more precise area reference determination
 extern idCVar r_useShadowSurfaceScissor;// 1 = scissor shadows by the scissor rect of the interaction surfaces
 extern idCVar r_useConstantMaterials;	// 1 = use pre-calculated material registers if possible
-extern idCVar r_useInteractionTable;	// create a full entityDefs * lightDefs table to make finding interactions faster
+extern idCVar r_useInteractionTable;	// create a lightDef / entityDef hash table to make finding interactions faster
 extern idCVar r_useNodeCommonChildren;	// stop pushing reference bounds early when possible
 extern idCVar r_useSilRemap;			// 1 = consider verts with the same XYZ, but different ST the same for shadows
 extern idCVar r_useCulling;				// 0 = none, 1 = sphere, 2 = sphere + box
@@ -862,6 +899,7 @@ extern idCVar r_useLightScissors;		// 1 = use custom scissor rectangle for each
 extern idCVar r_useClippedLightScissors;// 0 = full screen when near clipped, 1 = exact when near clipped, 2 = exact always
 extern idCVar r_useEntityCulling;		// 0 = none, 1 = box
 extern idCVar r_useEntityScissors;		// 1 = use custom scissor rectangle for each entity
+extern idCVar r_useOcclusionCulling;	// 1 = cull entities and lights behind the world with a software depth buffer
 extern idCVar r_useInteractionCulling;	// 1 = cull interactions
 extern idCVar r_useInteractionScissors;	// 1 = use a custom scissor rectangle for each interaction
 extern idCVar r_useFrustumFarDistance;	// if != 0 force the view frustum far distance to this distance
@@ -874,11 +912,13 @@ extern idCVar r_useShadowVertexProgram;	// 1 = do the shadow projection in the v
 extern idCVar r_useShadowProjectedCull;	// 1 = discard triangles outside light volume before shadowing
 extern idCVar r_useDeferredTangents;	// 1 = don't always calc tangents after deform
 extern idCVar r_useCachedDynamicModels;	// 1 = cache snapshots of dynamic models
+extern idCVar r_parallelDynamicModels;	// 1 = deform visible md5 models on the job threads
 extern idCVar r_useTwoSidedStencil;		// 1 = do stencil shadows in one pass with different ops on each side
 extern idCVar r_useInfiniteFarZ;		// 1 = use the no-far-clip-plane trick
 extern idCVar r_useScissor;				// 1 = scissor clip as portals and lights are processed
 extern idCVar r_usePortals;				// 1 = use portals to perform area culling, otherwise draw everything
 extern idCVar r_useStateCaching;		// avoid redundant state changes in GL_*() calls
+extern idCVar r_useStateSorting;		// sort opaque surfaces by distance, material and entity
 extern idCVar r_useCombinerDisplayLists;// if 1, put all nvidia register combiner programming in display lists
 extern idCVar r_useVertexBuffers;		// if 0, don't use ARB_vertex_buffer_object for vertexes
 extern idCVar r_useIndexBuffers;		// if 0, don't use ARB_vertex_buffer_object for indexes
@@ -893,6 +933,8 @@ extern idCVar r_skipSuppress;			// ignore the per-view suppressions
 extern idCVar r_skipInteractions;		// skip all light/surface interaction drawing
 extern idCVar r_skipFrontEnd;			// bypasses all front end work, but 2D gui rendering still draws
 extern idCVar r_skipBackEnd;			// don't draw anything
+extern idCVar r_nullGL;					// no window or GL context, the back end only checks the command lists
+extern idCVar r_smp;					// run the back end in a render thread
 extern idCVar r_skipCopyTexture;		// do all rendering, but don't actually copyTexSubImage2D
 extern idCVar r_skipRender;				// skip 3D rendering, but pass 2D
 extern idCVar r_skipRenderContext;		// NULL the rendering context during backend 3D rendering
@@ -951,10 +993,13 @@ extern idCVar r_showEntityScissors;		// show entity scissor rectangles
 extern idCVar r_showInteractionFrustums;// show a frustum for each interaction
 extern idCVar r_showInteractionScissors;// show screen rectangle which contains the interaction frustum
 extern idCVar r_showMemory;				// print frame memory utilization
+extern idCVar r_frameAllocStats;		// print frame memory utilization of each thread
 extern idCVar r_showCull;				// report sphere and box culling stats
+extern idCVar r_showOcclusionCulling;	// 1 = report occlusion culling stats, 2 = also show culled rects, 3 = also draw occluders
 extern idCVar r_showInteractions;		// report interaction generation activity
 extern idCVar r_showSurfaces;			// report surface/light/shadow counts
 extern idCVar r_showPrimitives;			// report vertex/index/draw counts
+extern idCVar r_showStateChanges;		// report GL state changes, texture binds and material changes
 extern idCVar r_showPortals;			// draw portal outlines in color based on passed / not passed
 extern idCVar r_showAlloc;				// report alloc/free counts
 extern idCVar r_showSkel;				// draw the skeleton when model animates
@@ -1112,10 +1157,11 @@ void		GLimp_ResetGamma();
 
 // Returns false if the system only has a single processor
 
-void		GLimp_ActivateContext( void );
-void		GLimp_DeactivateContext( void );
+bool		GLimp_ActivateContext( void );
+bool		GLimp_DeactivateContext( void );
 // These are used for managing SMP handoffs of the OpenGL context
-// between threads, and as a performance tunining aid.  Setting
+// between threads (r_smp), and as a performance tunining aid.
+// They return false if the context can't be made current/released.  Setting
 // 'r_skipRenderContext 1' will call GLimp_DeactivateContext() before
 // the 3D rendering code, and GLimp_ActivateContext() afterwards.  On
 // most OpenGL implementations, this will result in all OpenGL calls
@@ -1176,6 +1222,8 @@ void R_SetViewMatrix( viewDef_t *viewDef );
 
 void myGlMultMatrix( const float *a, const float *b, float *out );
 
+unsigned long long R_DrawSurfSortKey( const drawSurf_t *drawSurf, int addOrder );
+
 /*
 ============================================================
 
@@ -1193,6 +1241,7 @@ idRenderModel *R_EntityDefDynamicModel( idRenderEntityLocal *def );
 viewEntity_t *R_SetEntityDefViewEntity( idRenderEntityLocal *def );
 viewLight_t *R_SetLightDefViewLight( idRenderLightLocal *def );
 
+void R_SetDrawSurfGeo( drawSurf_t *drawSurf, const srfTriangles_t *tri );
 void R_AddDrawSurf( const srfTriangles_t *tri, const viewEntity_t *space, const renderEntity_t *renderEntity,
 					const idMaterial *shader, const idScreenRect &scissor, const float soft_particle_radius = -1.0f ); // soft particles in #3878
 
@@ -1264,7 +1313,7 @@ void RB_EnterWeaponDepthHack();
 void RB_EnterModelDepthHack( float depth );
 void RB_LeaveDepthHack();
 void RB_DrawElementsImmediate( const srfTriangles_t *tri );
-void RB_RenderTriangleSurface( const srfTriangles_t *tri );
+void RB_RenderTriangleSurface( const drawSurf_t *surf );
 void RB_T_RenderTriangleSurface( const drawSurf_t *surf );
 void RB_RenderDrawSurfListWithFunction( drawSurf_t **drawSurfs, int numDrawSurfs,
 					  void (*triFunc_)( const drawSurf_t *) );
@@ -1291,10 +1340,10 @@ DRAW_STANDARD
 ============================================================
 */
 
-void RB_DrawElementsWithCounters( const srfTriangles_t *tri );
-void RB_DrawShadowElementsWithCounters( const srfTriangles_t *tri, int numIndexes );
+void RB_DrawElementsWithCounters( const drawSurf_t *surf );
+void RB_DrawShadowElementsWithCounters( const drawSurf_t *surf, int numIndexes );
 void RB_STD_FillDepthBuffer( drawSurf_t **drawSurfs, int numDrawSurfs );
-void RB_BindVariableStageImage( const textureStage_t *texture, const float *shaderRegisters );
+void RB_BindVariableStageImage( const textureStage_t *texture, const float *shaderRegisters, const cinData_t *cin );
 void RB_BindStageTexture( const float *shaderRegisters, const textureStage_t *texture, const drawSurf_t *surf );
 void RB_FinishStageTexture( const textureStage_t *texture, const drawSurf_t *surf );
 void RB_StencilShadowPass( const drawSurf_t *drawSurfs );
@@ -1583,9 +1632,11 @@ void R_InitFrameData( void );
 void R_ShutdownFrameData( void );
 int R_CountFrameData( void );
 void R_ToggleSmpFrame( void );
+void R_ReserveFrameMemory( int bytes );
 void *R_FrameAlloc( int bytes );
 void *R_ClearedFrameAlloc( int bytes );
 void R_FrameFree( void *data );
+void R_FrameAllocBench_f( const idCmdArgs &args );
 
 void *R_StaticAlloc( int bytes );		// just malloc with error checking
 void *R_ClearedStaticAlloc( int bytes );	// with memset
@@ -1632,6 +1683,53 @@ void RB_ShowImages( void );
 
 void RB_ExecuteBackEndCommands( const emptyCommand_t *cmds );
 
+/*
+=============================================================
+
+TR_NULLGL
+
+=============================================================
+*/
+
+GLExtension_t R_NullGL_ExtensionPointer( const char *name );
+void RB_NullGL_ExecuteBackEndCommands( const emptyCommand_t *cmds );
+void R_ResetNullBackEndStats( void );
+void R_PrintNullBackEndStats( void );
+void R_NullGLStats_f( const idCmdArgs &args );
+
+/*
+=============================================================
+
+TR_SMP
+
+=============================================================
+*/
+
+void R_StartRenderThread( void );
+void R_StopRenderThread( void );
+bool R_RenderThreadActive( void );
+bool R_OnRenderThread( void );
+void R_WaitForRenderThread( void );
+void R_SyncRenderThread( void );
+void R_IssueRenderThreadCommands( const emptyCommand_t *cmds );
+void R_DeferImageLoad( idImage *image );
+void R_FinishRenderThreadFrame( void );
+
+/*
+=============================================================
+
+TR_OCCLUSION
+
+=============================================================
+*/
+
+struct portalArea_s;
+
+void R_RenderOcclusionBuffer( void );
+bool R_CullEntityByOcclusion( viewEntity_t *vEntity );
+bool R_CullLightByOcclusion( const viewLight_t *vLight );
+void R_FreeAreaOccluders( struct portalArea_s *area );
+
 
 /*
 =============================================================
@@ -178,12 +178,36 @@ void R_ShowColoredScreenRect( const idScreenRect &rect, int colorIndex ) {
 	}
 }
 
+#define	MEMORY_BLOCK_SIZE	0x100000
+#define	ARENA_BLOCK_SIZE	0x10000		// carved from a memory block by a thread that ran out
+
+// frameData points at one of these, the other one may
+// be in use by the render thread
+static frameData_t	*smpFrameData[SMP_FRAMES];
+static int			smpFrame;
+
 /*
 ====================
 R_ToggleSmpFrame
+
+With the render thread running, this switches to the other frameData,
+which the back end is done with after R_FinishRenderThreadFrame()
 ====================
 */
 void R_ToggleSmpFrame( void ) {
+	if ( R_RenderThreadActive() ) {
+		smpFrame = ( smpFrame + 1 ) % SMP_FRAMES;
+		frameData = smpFrameData[smpFrame];
+	} else {
+		// the other frames may still have surfaces from before
+		// the render thread was stopped
+		for ( int i = 0; i < SMP_FRAMES; i++ ) {
+			if ( smpFrameData[i] != frameData ) {
+				R_FreeDeferredTriSurfs( smpFrameData[i] );
+			}
+		}
+	}
+
 	R_FreeDeferredTriSurfs( frameData );
 
 	// clear frame-temporary data
@@ -203,14 +227,21 @@ void R_ToggleSmpFrame( void ) {
 		block->used = 0;
 	}
 
+	// and drop the blocks the threads were bumping through
+	for ( int i = 0; i <= MAX_JOB_THREADS; i++ ) {
+		frameArena_t *arena = &frame->arenas[i];
+		arena->base = NULL;
+		arena->size = 0;
+		arena->used = 0;
+		arena->frameBytes = 0;
+	}
+
 	R_ClearCommandChain();
 }
 
 
 //=====================================================
 
-#define	MEMORY_BLOCK_SIZE	0x100000
-
 /*
 =====================
 R_ShutdownFrameData
@@ -221,19 +252,22 @@ void R_ShutdownFrameData( void ) {
 	frameMemoryBlock_t *block;
 
 	// free any current data
-	frame = frameData;
-	if ( !frame ) {
-		return;
-	}
+	for ( int i = 0; i < SMP_FRAMES; i++ ) {
+		frame = smpFrameData[i];
+		if ( !frame ) {
+			continue;
+		}
 
-	R_FreeDeferredTriSurfs( frame );
+		R_FreeDeferredTriSurfs( frame );
 
-	frameMemoryBlock_t *nextBlock;
-	for ( block = frame->memory ; block ; block = nextBlock ) {
-		nextBlock = block->next;
-		Mem_Free( block );
+		frameMemoryBlock_t *nextBlock;
+		for ( block = frame->memory ; block ; block = nextBlock ) {
+			nextBlock = block->next;
+			Mem_Free( block );
+		}
+		Mem_Free( frame );
+		smpFrameData[i] = NULL;
 	}
-	Mem_Free( frame );
 	frameData = NULL;
 }
 
@@ -249,18 +283,22 @@ void R_InitFrameData( void ) {
 
 	R_ShutdownFrameData();
 
-	frameData = (frameData_t *)Mem_ClearedAlloc( sizeof( *frameData ));
-	frame = frameData;
-	size = MEMORY_BLOCK_SIZE;
-	block = (frameMemoryBlock_t *)Mem_Alloc( size + sizeof( *block ) );
-	if ( !block ) {
-		common->FatalError( "R_InitFrameData: Mem_Alloc() failed" );
+	for ( int i = 0; i < SMP_FRAMES; i++ ) {
+		frame = (frameData_t *)Mem_ClearedAlloc( sizeof( *frame ));
+		size = MEMORY_BLOCK_SIZE;
+		block = (frameMemoryBlock_t *)Mem_Alloc( size + sizeof( *block ) );
+		if ( !block ) {
+			common->FatalError( "R_InitFrameData: Mem_Alloc() failed" );
+		}
+		block->size = size;
+		block->used = 0;
+		block->next = NULL;
+		frame->memory = block;
+		frame->memoryHighwater = 0;
+		smpFrameData[i] = frame;
 	}
-	block->size = size;
-	block->used = 0;
-	block->next = NULL;
-	frame->memory = block;
-	frame->memoryHighwater = 0;
+	smpFrame = 0;
+	frameData = smpFrameData[0];
 
 	R_ToggleSmpFrame();
 }
@@ -278,7 +316,7 @@ int R_CountFrameData( void ) {
 	count = 0;
 	frame = frameData;
 	for ( block = frame->memory ; block ; block=block->next ) {
-		count += block->used;
+		count += Min( block->used, block->size );
 		if ( block == frame->alloc ) {
 			break;
 		}
@@ -288,6 +326,12 @@ int R_CountFrameData( void ) {
 	if ( count > frame->memoryHighwater ) {
 		frame->memoryHighwater = count;
 	}
+	for ( int i = 0; i <= MAX_JOB_THREADS; i++ ) {
+		frameArena_t *arena = &frame->arenas[i];
+		if ( arena->frameBytes > arena->highwater ) {
+			arena->highwater = arena->frameBytes;
+		}
+	}
 
 	return count;
 }
@@ -295,10 +339,17 @@ int R_CountFrameData( void ) {
 /*
 =================
 R_StaticAlloc
+
+Image load jobs allocate from several threads, see R_BeginImageLoadJobs()
 =================
 */
 void *R_StaticAlloc( int bytes ) {
 	void	*buf;
+	bool	locked = R_ImageLoadJobsActive();
+
+	if ( locked ) {
+		Sys_EnterCriticalSection( CRITICAL_SECTION_TWO );
+	}
 
 	tr.pc.c_alloc++;
 
@@ -306,6 +357,10 @@ void *R_StaticAlloc( int bytes ) {
 
 	buf = Mem_Alloc( bytes );
 
+	if ( locked ) {
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_TWO );
+	}
+
 	// don't exit on failure on zero length allocations since the old code didn't
 	if ( !buf && ( bytes != 0 ) ) {
 		common->FatalError( "R_StaticAlloc failed on %i bytes", bytes );
@@ -332,8 +387,157 @@ R_StaticFree
 =================
 */
 void R_StaticFree( void *data ) {
+	bool	locked = R_ImageLoadJobsActive();
+
+	if ( locked ) {
+		Sys_EnterCriticalSection( CRITICAL_SECTION_TWO );
+	}
+
 	tr.pc.c_free++;
 	Mem_Free( data );
+
+	if ( locked ) {
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_TWO );
+	}
+}
+
+/*
+================
+R_InsertFrameMemoryBlock
+================
+*/
+static frameMemoryBlock_t *R_InsertFrameMemoryBlock( frameMemoryBlock_t *prev, int size ) {
+	frameMemoryBlock_t *newBlock;
+
+	newBlock = (frameMemoryBlock_t *)Mem_Alloc( size + sizeof( *newBlock ) );
+	if ( !newBlock ) {
+		common->FatalError( "R_FrameAlloc: Mem_Alloc() failed" );
+	}
+	newBlock->size = size;
+	newBlock->used = 0;
+	newBlock->next = prev->next;
+	prev->next = newBlock;
+	return newBlock;
+}
+
+/*
+================
+R_ReserveFrameMemory
+
+idHeap isn't thread safe, so only the main thread may add blocks to the
+chain.  It must call this right before it hands work that calls
+R_FrameAlloc to the job threads, with enough bytes for all of it and
+an arena block per thread.
+================
+*/
+void R_ReserveFrameMemory( int bytes ) {
+	frameData_t		*frame;
+	frameMemoryBlock_t	*block;
+	int				available;
+
+	assert( Sys_JobThreadIndex() == 0 );
+
+	frame = frameData;
+	available = 0;
+	for ( block = frame->alloc; ; block = block->next ) {
+		available += Max( block->size - block->used, 0 );
+		if ( available >= bytes ) {
+			return;
+		}
+		if ( !block->next ) {
+			break;
+		}
+	}
+
+	while( available < bytes ) {
+		block = R_InsertFrameMemoryBlock( block, MEMORY_BLOCK_SIZE );
+		available += MEMORY_BLOCK_SIZE;
+	}
+}
+
+/*
+================
+R_FrameAllocBigBlock
+
+Allocations bigger than MEMORY_BLOCK_SIZE get a block of their own right
+after the current one, so the blocks after it, which may be reserved for
+the job threads, keep their room.  An unused block of an earlier frame
+that is big enough is moved there instead of allocating a new one.
+================
+*/
+static byte *R_FrameAllocBigBlock( int bytes ) {
+	frameData_t		*frame;
+	frameMemoryBlock_t	*block, *prev;
+
+	Sys_EnterCriticalSection( CRITICAL_SECTION_TWO );
+
+	frame = frameData;
+	for ( prev = frame->alloc, block = prev->next; block; prev = block, block = block->next ) {
+		if ( block->used == 0 && block->size >= bytes ) {
+			prev->next = block->next;
+			block->next = frame->alloc->next;
+			frame->alloc->next = block;
+			break;
+		}
+	}
+	if ( !block ) {
+		block = R_InsertFrameMemoryBlock( frame->alloc, bytes );
+	}
+
+	// the rest of it is used once the current block runs full
+	block->used = bytes;
+
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_TWO );
+
+	return block->base;
+}
+
+/*
+================
+R_FrameAllocBlock
+
+Carves bytes out of the shared memory blocks, the atomic add
+is all the threads contend on until a block runs full.  Only the
+main thread grows the chain, job threads use what was reserved.
+================
+*/
+static byte *R_FrameAllocBlock( int bytes ) {
+	frameData_t		*frame;
+	frameMemoryBlock_t	*block;
+
+	// bigger allocations get a block of their own, which only the main thread can add
+	if ( bytes > MEMORY_BLOCK_SIZE ) {
+		if ( Sys_JobThreadIndex() != 0 ) {
+			common->FatalError( "R_FrameAlloc of %i exceeded MEMORY_BLOCK_SIZE on a job thread",
+				bytes );
+		}
+		return R_FrameAllocBigBlock( bytes );
+	}
+
+	frame = frameData;
+	while( 1 ) {
+		block = frame->alloc;
+
+		int used = Sys_AtomicAdd( &block->used, bytes );
+		if ( used <= block->size ) {
+			return block->base + used - bytes;
+		}
+
+		// the block is full, the first thread to get here advances
+		// everyone to the next memory block, creating it at the end of the chain
+		Sys_EnterCriticalSection( CRITICAL_SECTION_TWO );
+		if ( frame->alloc == block ) {
+			if ( !block->next ) {
+				if ( Sys_JobThreadIndex() != 0 ) {
+					Sys_LeaveCriticalSection( CRITICAL_SECTION_TWO );
+					common->FatalError( "R_FrameAlloc: job thread ran out of reserved frame memory" );
+				}
+				R_InsertFrameMemoryBlock( block, MEMORY_BLOCK_SIZE );
+			}
+			frame->alloc = block->next;
+		}
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_TWO );
+	}
 }
 
 /*
@@ -343,12 +547,8 @@ R_FrameAlloc
 This data will be automatically freed when the
 current frame's back end completes.
 
-This should only be called by the front end.  The
-back end shouldn't need to allocate memory.
-
-If we passed smpFrame in, the back end could
-alloc memory, because it will always be a
-different frameData than the front end is using.
+This should only be called by the front end and the jobs
+it runs.  The back end shouldn't need to allocate memory.
 
 All temporary data, like dynamic tesselations
 and local spaces are allocated here.
@@ -358,54 +558,34 @@ contiguous with previous allocations even
 from this frame.
 
 The memory is NOT zero filled.
-Should part of this be inlined in a macro?
 ================
 */
 void *R_FrameAlloc( int bytes ) {
-	frameData_t		*frame;
-	frameMemoryBlock_t	*block;
+	frameArena_t	*arena;
 	void			*buf;
 
 	bytes = (bytes+16)&~15;
-	// see if it can be satisfied in the current block
-	frame = frameData;
-	block = frame->alloc;
+	arena = &frameData->arenas[ Sys_JobThreadIndex() ];
+	arena->frameBytes += bytes;
 
-	if ( block->size - block->used >= bytes ) {
-		buf = block->base + block->used;
-		block->used += bytes;
+	// see if it can be satisfied in the thread's current block
+	if ( arena->size - arena->used >= bytes ) {
+		buf = arena->base + arena->used;
+		arena->used += bytes;
 		return buf;
 	}
 
-	// advance to the next memory block if available
-	block = block->next;
-	// create a new block if we are at the end of
-	// the chain
-	if ( !block ) {
-		int		size;
-
-		size = MEMORY_BLOCK_SIZE;
-		block = (frameMemoryBlock_t *)Mem_Alloc( size + sizeof( *block ) );
-		if ( !block ) {
-			common->FatalError( "R_FrameAlloc: Mem_Alloc() failed" );
-		}
-		block->size = size;
-		block->used = 0;
-		block->next = NULL;
-		frame->alloc->next = block;
-	}
-
-	// we could fix this if we needed to...
-	if ( bytes > block->size ) {
-		common->FatalError( "R_FrameAlloc of %i exceeded MEMORY_BLOCK_SIZE",
-			bytes );
+	// big allocations go straight to the shared blocks, so the rest
+	// of the current arena block isn't thrown away
+	if ( bytes > ARENA_BLOCK_SIZE / 4 ) {
+		return R_FrameAllocBlock( bytes );
 	}
 
-	frame->alloc = block;
-
-	block->used = bytes;
+	arena->base = R_FrameAllocBlock( ARENA_BLOCK_SIZE );
+	arena->size = ARENA_BLOCK_SIZE;
+	arena->used = bytes;
 
-	return block->base;
+	return arena->base;
 }
 
 /*
@@ -437,6 +617,113 @@ to both alloc and free.
 void R_FrameFree( void *data ) {
 }
 
+/*
+====================================================================
+
+frameAllocBench
+
+====================================================================
+*/
+
+typedef struct {
+	byte *	ptr;
+	int		size;
+} frameAllocBenchEntry_t;
+
+/*
+==================
+R_FrameAllocBenchJob
+
+Each allocation starts with its index, the rest is filled with its low byte
+==================
+*/
+static void R_FrameAllocBenchJob( void *data, int first, int last ) {
+	frameAllocBenchEntry_t *entries = (frameAllocBenchEntry_t *)data;
+
+	for ( int i = first; i < last; i++ ) {
+		byte *ptr = (byte *)R_FrameAlloc( entries[i].size );
+		*(int *)ptr = i;
+		memset( ptr + sizeof( int ), i & 255, entries[i].size - sizeof( int ) );
+		entries[i].ptr = ptr;
+	}
+}
+
+/*
+==================
+R_FrameAllocBenchErrors
+
+Returns the number of allocations that are misaligned or were overwritten
+==================
+*/
+static int R_FrameAllocBenchErrors( const frameAllocBenchEntry_t *entries, int numEntries ) {
+	int errors = 0;
+
+	for ( int i = 0; i < numEntries; i++ ) {
+		const byte *ptr = entries[i].ptr;
+		if ( ( (uintptr_t)ptr & 15 ) != 0 || *(const int *)ptr != i ) {
+			errors++;
+			continue;
+		}
+		for ( int j = sizeof( int ); j < entries[i].size; j++ ) {
+			if ( ptr[j] != ( i & 255 ) ) {
+				errors++;
+				break;
+			}
+		}
+	}
+	return errors;
+}
+
+/*
+==================
+R_FrameAllocBench_f
+
+Makes the same frame allocations on the main thread and on the job threads,
+checks that none of them overlap and prints the times. The memory the job
+threads need is reserved up front, like any work handed to them must.
+==================
+*/
+void R_FrameAllocBench_f( const idCmdArgs &args ) {
+	frameAllocBenchEntry_t *entries;
+	int		i, total;
+
+	const int numEntries = ( args.Argc() > 1 ) ? atoi( args.Argv( 1 ) ) : 10000;
+	if ( numEntries < 1 ) {
+		common->Printf( "usage: frameAllocBench [allocations]\n" );
+		return;
+	}
+
+	// mostly small allocations like the front end's, every 64th one too big for an arena
+	idRandom random( 1 );
+	entries = (frameAllocBenchEntry_t *)R_StaticAlloc( numEntries * sizeof( entries[0] ) );
+	total = 0;
+	for ( i = 0; i < numEntries; i++ ) {
+		entries[i].ptr = NULL;
+		entries[i].size = ( ( i & 63 ) == 63 ) ? ARENA_BLOCK_SIZE / 2 : 16 + random.RandomInt( 512 );
+		total += ( entries[i].size + 16 ) & ~15;
+	}
+
+	common->Printf( "frameAllocBench: %d allocations, %d KB, %d job threads\n", numEntries, total >> 10, Sys_NumJobThreads() );
+
+	double start = Sys_MillisecondsPrecise();
+	R_FrameAllocBenchJob( entries, 0, numEntries );
+	const double serialMsec = Sys_MillisecondsPrecise() - start;
+	const int serialErrors = R_FrameAllocBenchErrors( entries, numEntries );
+
+	// the tails of the arenas and blocks the threads leave behind are lost
+	R_ReserveFrameMemory( 2 * total + ( Sys_NumJobThreads() + 1 ) * ARENA_BLOCK_SIZE );
+
+	start = Sys_MillisecondsPrecise();
+	Sys_ParallelFor( R_FrameAllocBenchJob, entries, numEntries, 64 );
+	const double parallelMsec = Sys_MillisecondsPrecise() - start;
+	const int parallelErrors = R_FrameAllocBenchErrors( entries, numEntries );
+
+	common->Printf( "%8.2f ms main thread, %d bad allocations\n", serialMsec, serialErrors );
+	common->Printf( "%8.2f ms jobs, %d bad allocations\n", parallelMsec, parallelErrors );
+
+	R_StaticFree( entries );
+}
+
 
 
 //==========================================================================
@@ -1042,35 +1329,108 @@ DRAWSURF SORTING
 
 /*
 =======================
-R_QsortSurfaces
+R_DrawSurfSortKey
 
+The material sort is in the upper 32 bits, with the float bits flipped so
+they order like the float.  Opaque surfaces of entities and the world are
+then grouped by a coarse distance, material and entity, so the back end
+changes less state.  Everything else keeps the order it was added in, as
+blending and guis depend on it.
 =======================
 */
-static int R_QsortSurfaces( const void *a, const void *b ) {
-	const drawSurf_t	*ea, *eb;
-
-	ea = *(drawSurf_t **)a;
-	eb = *(drawSurf_t **)b;
-
-	if ( ea->sort < eb->sort ) {
-		return -1;
-	}
-	if ( ea->sort > eb->sort ) {
-		return 1;
+unsigned long long R_DrawSurfSortKey( const drawSurf_t *drawSurf, int addOrder ) {
+	union {
+		float			f;
+		unsigned int	i;
+	} sort;
+	unsigned int	low;
+
+	sort.f = drawSurf->sort;
+	sort.i = ( sort.i & 0x80000000u ) ? ~sort.i : ( sort.i | 0x80000000u );
+
+	const idMaterial *material = drawSurf->material;
+	const idRenderEntityLocal *def = drawSurf->space->entityDef;
+
+	if ( r_useStateSorting.GetBool() && def != NULL && material->GetSort() == SS_OPAQUE && material->Coverage() != MC_TRANSLUCENT ) {
+		// distance buckets double from 64 units, front to back helps the depth fill
+		idVec3 center;
+		R_LocalPointToGlobal( drawSurf->space->modelMatrix, drawSurf->geo->bounds.GetCenter(), center );
+		float dist = ( center - tr.viewDef->renderView.vieworg ).LengthFast() * ( 1.0f / 64.0f );
+		unsigned int bucket = 0;
+		while ( dist >= 2.0f && bucket < 7 ) {
+			dist *= 0.5f;
+			bucket++;
+		}
+		low = ( bucket << 28 ) | ( ( material->Index() & 0xffff ) << 12 ) | ( def->index & 0xfff );
+	} else {
+		low = 0x80000000u | ( addOrder & 0x7fffffff );
 	}
-	return 0;
-}
 
+	return ( (unsigned long long)sort.i << 32 ) | low;
+}
 
 /*
 =================
 R_SortDrawSurfs
+
+LSD radix sort on the drawSurf keys, one pass per byte that isn't
+the same for all of them.  Being stable, surfaces with equal keys
+stay in the order they were added.
 =================
 */
 static void R_SortDrawSurfs( void ) {
-	// sort the drawsurfs by sort type, then orientation, then shader
-	qsort( tr.viewDef->drawSurfs, tr.viewDef->numDrawSurfs, sizeof( tr.viewDef->drawSurfs[0] ),
-		R_QsortSurfaces );
+	typedef struct {
+		unsigned long long	key;
+		drawSurf_t *		surf;
+	} sortSurf_t;
+
+	drawSurf_t **drawSurfs = tr.viewDef->drawSurfs;
+	const int numDrawSurfs = tr.viewDef->numDrawSurfs;
+	int counts[8][256];
+
+	if ( numDrawSurfs < 2 ) {
+		return;
+	}
+
+	sortSurf_t *src = (sortSurf_t *)R_FrameAlloc( numDrawSurfs * sizeof( src[0] ) );
+	sortSurf_t *dst = (sortSurf_t *)R_FrameAlloc( numDrawSurfs * sizeof( dst[0] ) );
+
+	memset( counts, 0, sizeof( counts ) );
+	for ( int i = 0; i < numDrawSurfs; i++ ) {
+		const unsigned long long key = drawSurfs[i]->sortKey;
+		src[i].key = key;
+		src[i].surf = drawSurfs[i];
+		for ( int b = 0; b < 8; b++ ) {
+			counts[b][( key >> ( b * 8 ) ) & 255]++;
+		}
+	}
+
+	for ( int b = 0; b < 8; b++ ) {
+		const int shift = b * 8;
+		int *count = counts[b];
+
+		if ( count[( src[0].key >> shift ) & 255] == numDrawSurfs ) {
+			continue;
+		}
+
+		int offset = 0;
+		for ( int i = 0; i < 256; i++ ) {
+			const int c = count[i];
+			count[i] = offset;
+			offset += c;
+		}
+		for ( int i = 0; i < numDrawSurfs; i++ ) {
+			dst[count[( src[i].key >> shift ) & 255]++] = src[i];
+		}
+
+		sortSurf_t *temp = src;
+		src = dst;
+		dst = temp;
+	}
+
+	for ( int i = 0; i < numDrawSurfs; i++ ) {
+		drawSurfs[i] = src[i].surf;
+	}
 }
 
 
@@ -1106,8 +1466,6 @@ void R_RenderView( viewDef_t *parms ) {
 
 	tr.viewDef = parms;
 
-	tr.sortOffset = 0;
-
 	// set the matrix for world space to eye space
 	R_SetViewMatrix( tr.viewDef );
 
@@ -1126,6 +1484,9 @@ void R_RenderView( viewDef_t *parms ) {
 	// constrain the view frustum to the view lights and entities
 	R_ConstrainViewFrustum();
 
+	// rasterize the world of the visible areas for occlusion culling
+	R_RenderOcclusionBuffer();
+
 	// make sure that interactions exist for all light / entity combinations
 	// that are visible
 	// add any pre-generated light shadows, and calculate the light shader values
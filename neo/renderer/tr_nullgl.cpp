@@ -0,0 +1,432 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+#include "sys/platform.h"
+#include "idlib/hashing/CRC32.h"
+#include "framework/CmdSystem.h"
+#include "renderer/tr_local.h"
+
+/*
+====================================================================
+
+null GL
+
+With r_nullGL set no window or GL context is created. All qgl
+functions are stubs that do nothing and return 0, except for the few
+queries the init code depends on, and the back end only walks the
+render command lists it gets from the front end, counting and hashing
+what would have been drawn.
+
+That allows timing the front end with timeDemo on machines without a
+display or GPU, and the hash shows if a change altered its output.
+
+====================================================================
+*/
+
+// just enough for R_CheckPortableExtensions() and R_ARB2_Init(), no vertex buffer
+// objects or texture compression, so nothing is ever written into mapped buffers
+static const char *nullGLExtensions =
+	"GL_ARB_multitexture GL_ARB_texture_env_combine GL_ARB_texture_cube_map GL_ARB_texture_env_dot3 "
+	"GL_ARB_texture_env_add GL_ARB_vertex_program GL_ARB_fragment_program GL_EXT_stencil_wrap GL_EXT_stencil_two_side";
+
+static GLuint nullGLTextures;
+
+static const GLubyte * APIENTRY NullGL_GetString( GLenum name ) {
+	switch ( name ) {
+	case GL_VENDOR:
+		return (const GLubyte *)"dhewm3";
+	case GL_RENDERER:
+		return (const GLubyte *)"null GL";
+	case GL_VERSION:
+		return (const GLubyte *)"2.1";
+	case GL_EXTENSIONS:
+		return (const GLubyte *)nullGLExtensions;
+	}
+	return (const GLubyte *)"";
+}
+
+static void APIENTRY NullGL_GetIntegerv( GLenum pname, GLint *params ) {
+	switch ( pname ) {
+	case GL_MAX_TEXTURE_SIZE:
+		*params = 4096;
+		break;
+	case GL_MAX_TEXTURE_UNITS_ARB:
+	case GL_MAX_TEXTURE_COORDS_ARB:
+		*params = 8;
+		break;
+	case GL_MAX_TEXTURE_IMAGE_UNITS_ARB:
+		*params = 16;
+		break;
+	case GL_PROGRAM_ERROR_POSITION_ARB:
+		*params = -1;
+		break;
+	default:
+		*params = 0;
+		break;
+	}
+}
+
+static void APIENTRY NullGL_GenTextures( GLsizei n, GLuint *textures ) {
+	for ( int i = 0; i < n; i++ ) {
+		textures[i] = ++nullGLTextures;
+	}
+}
+
+// one stub for every qgl function, they have to match the prototypes as
+// APIENTRY is __stdcall on win32 and the callee pops the arguments
+#define QGLPROC( name, rettype, args )	static rettype APIENTRY NullGL_##name args { return (rettype)0; }
+#include "renderer/qgl_proc.h"
+
+static void APIENTRY NullGL_glMultiTexCoord2fARB( GLenum, GLfloat, GLfloat ) {}
+static void APIENTRY NullGL_glMultiTexCoord2fvARB( GLenum, GLfloat * ) {}
+static void APIENTRY NullGL_glActiveTextureARB( GLenum ) {}
+static void APIENTRY NullGL_glClientActiveTextureARB( GLenum ) {}
+static void APIENTRY NullGL_glBindBufferARB( GLenum, GLuint ) {}
+static void APIENTRY NullGL_glDeleteBuffersARB( GLsizei, const GLuint * ) {}
+static void APIENTRY NullGL_glGenBuffersARB( GLsizei, GLuint * ) {}
+static GLboolean APIENTRY NullGL_glIsBufferARB( GLuint ) { return 0; }
+static void APIENTRY NullGL_glBufferDataARB( GLenum, GLsizeiptrARB, const void *, GLenum ) {}
+static void APIENTRY NullGL_glBufferSubDataARB( GLenum, GLintptrARB, GLsizeiptrARB, const void * ) {}
+static void APIENTRY NullGL_glGetBufferSubDataARB( GLenum, GLintptrARB, GLsizeiptrARB, void * ) {}
+static void * APIENTRY NullGL_glMapBufferARB( GLenum, GLenum ) { return NULL; }
+static GLboolean APIENTRY NullGL_glUnmapBufferARB( GLenum ) { return 0; }
+static void APIENTRY NullGL_glGetBufferParameterivARB( GLenum, GLenum, GLint * ) {}
+static void APIENTRY NullGL_glGetBufferPointervARB( GLenum, GLenum, void ** ) {}
+static void APIENTRY NullGL_glTexImage3D( GLenum, GLint, GLint, GLsizei, GLsizei, GLsizei, GLint, GLenum, GLenum, const GLvoid * ) {}
+static void APIENTRY NullGL_glColorTableEXT( int, int, int, int, int, const void * ) {}
+static void APIENTRY NullGL_glActiveStencilFaceEXT( GLenum ) {}
+static void APIENTRY NullGL_glStencilOpSeparate( GLenum, GLenum, GLenum, GLenum ) {}
+static void APIENTRY NullGL_glCompressedTexImage2DARB( GLenum, GLint, GLenum, GLsizei, GLsizei, GLint, GLsizei, const void * ) {}
+static void APIENTRY NullGL_glGetCompressedTexImageARB( GLenum, GLint, void * ) {}
+static void APIENTRY NullGL_glVertexAttribPointerARB( GLuint, GLint, GLenum, GLboolean, GLsizei, const void * ) {}
+static void APIENTRY NullGL_glEnableVertexAttribArrayARB( GLuint ) {}
+static void APIENTRY NullGL_glDisableVertexAttribArrayARB( GLuint ) {}
+static void APIENTRY NullGL_glProgramStringARB( GLenum, GLenum, GLsizei, const void * ) {}
+static void APIENTRY NullGL_glBindProgramARB( GLenum, GLuint ) {}
+static void APIENTRY NullGL_glGenProgramsARB( GLsizei, GLuint * ) {}
+static void APIENTRY NullGL_glProgramEnvParameter4fvARB( GLenum, GLuint, const GLfloat * ) {}
+static void APIENTRY NullGL_glProgramLocalParameter4fvARB( GLenum, GLuint, const GLfloat * ) {}
+static void APIENTRY NullGL_glDepthBoundsEXT( GLclampd, GLclampd ) {}
+static void APIENTRY NullGL_glDebugMessageCallbackARB( GLDEBUGPROCARB, const void * ) {}
+
+/*
+==================
+NullGL_Proc
+
+Only compiles if the replacement has the type of the qgl pointer
+==================
+*/
+template<typename F> static GLExtension_t NullGL_Proc( const F &, F proc ) {
+	return (GLExtension_t)proc;
+}
+
+typedef struct {
+	const char *	name;
+	GLExtension_t	proc;
+} nullGLProc_t;
+
+#define NULLGL_PROC( name, proc )	{ #name, NullGL_Proc( q##name, proc ) },
+#define NULLGL_STUB( name )			NULLGL_PROC( name, NullGL_##name )
+
+static const nullGLProc_t nullGLProcs[] = {
+	// replacements must come first, the first match is used
+	NULLGL_PROC( glGetString, NullGL_GetString )
+	NULLGL_PROC( glGetIntegerv, NullGL_GetIntegerv )
+	NULLGL_PROC( glGenTextures, NullGL_GenTextures )
+
+#define QGLPROC( name, rettype, args ) NULLGL_STUB( name )
+#include "renderer/qgl_proc.h"
+
+	NULLGL_STUB( glMultiTexCoord2fARB )
+	NULLGL_STUB( glMultiTexCoord2fvARB )
+	NULLGL_STUB( glActiveTextureARB )
+	NULLGL_STUB( glClientActiveTextureARB )
+	NULLGL_STUB( glBindBufferARB )
+	NULLGL_STUB( glDeleteBuffersARB )
+	NULLGL_STUB( glGenBuffersARB )
+	NULLGL_STUB( glIsBufferARB )
+	NULLGL_STUB( glBufferDataARB )
+	NULLGL_STUB( glBufferSubDataARB )
+	NULLGL_STUB( glGetBufferSubDataARB )
+	NULLGL_STUB( glMapBufferARB )
+	NULLGL_STUB( glUnmapBufferARB )
+	NULLGL_STUB( glGetBufferParameterivARB )
+	NULLGL_STUB( glGetBufferPointervARB )
+	NULLGL_STUB( glTexImage3D )
+	NULLGL_STUB( glColorTableEXT )
+	NULLGL_STUB( glActiveStencilFaceEXT )
+	NULLGL_STUB( glStencilOpSeparate )
+	{ "glStencilOpSeparateATI", NullGL_Proc( qglStencilOpSeparate, NullGL_glStencilOpSeparate ) },
+	NULLGL_STUB( glCompressedTexImage2DARB )
+	NULLGL_STUB( glGetCompressedTexImageARB )
+	NULLGL_STUB( glVertexAttribPointerARB )
+	NULLGL_STUB( glEnableVertexAttribArrayARB )
+	NULLGL_STUB( glDisableVertexAttribArrayARB )
+	NULLGL_STUB( glProgramStringARB )
+	NULLGL_STUB( glBindProgramARB )
+	NULLGL_STUB( glGenProgramsARB )
+	NULLGL_STUB( glProgramEnvParameter4fvARB )
+	NULLGL_STUB( glProgramLocalParameter4fvARB )
+	NULLGL_STUB( glDepthBoundsEXT )
+	NULLGL_STUB( glDebugMessageCallbackARB )
+	{ NULL, NULL }
+};
+
+#undef NULLGL_STUB
+#undef NULLGL_PROC
+
+/*
+==================
+R_NullGL_ExtensionPointer
+
+Used instead of GLimp_ExtensionPointer() when r_nullGL is set
+==================
+*/
+GLExtension_t R_NullGL_ExtensionPointer( const char *name ) {
+	for ( int i = 0; nullGLProcs[i].name != NULL; i++ ) {
+		if ( idStr::Cmp( nullGLProcs[i].name, name ) == 0 ) {
+			return nullGLProcs[i].proc;
+		}
+	}
+	return NULL;
+}
+
+/*
+====================================================================
+
+null back end
+
+====================================================================
+*/
+
+typedef struct {
+	int				frames;
+	int				views3D;
+	int				views2D;
+	int				drawSurfs;
+	int				lights;
+	int				interactions;
+	int				shadowSurfs;
+	int				shadowIndexes;
+	unsigned int	crc;
+} nullBackEndStats_t;
+
+static nullBackEndStats_t	nullStats;
+
+/*
+==================
+RB_NullGL_HashSurf
+
+Only hashes what doesn't depend on memory addresses, so the same
+timeDemo gives the same hash on every run
+==================
+*/
+static void RB_NullGL_HashSurf( const drawSurf_t *surf ) {
+	int		data[7];
+
+	if ( surf->material ) {
+		const char *name = surf->material->GetName();
+		CRC32_UpdateChecksum( nullStats.crc, name, strlen( name ) );
+	}
+	data[0] = surf->geo ? surf->numIndexes : 0;
+	data[1] = idMath::Ftoi( surf->sort * 1000.0f );
+	data[2] = surf->dsFlags;
+	data[3] = surf->scissorRect.x1;
+	data[4] = surf->scissorRect.y1;
+	data[5] = surf->scissorRect.x2;
+	data[6] = surf->scissorRect.y2;
+	CRC32_UpdateChecksum( nullStats.crc, data, sizeof( data ) );
+}
+
+/*
+==================
+RB_NullGL_CountInteractions
+==================
+*/
+static void RB_NullGL_CountInteractions( const drawSurf_t *surf ) {
+	for ( ; surf ; surf = surf->nextOnLight ) {
+		nullStats.interactions++;
+		RB_NullGL_HashSurf( surf );
+	}
+}
+
+/*
+==================
+RB_NullGL_CountShadows
+==================
+*/
+static void RB_NullGL_CountShadows( const drawSurf_t *surf ) {
+	for ( ; surf ; surf = surf->nextOnLight ) {
+		nullStats.shadowSurfs++;
+		nullStats.shadowIndexes += surf->numIndexes;
+		backEnd.pc.c_shadowElements++;
+		backEnd.pc.c_shadowIndexes += surf->numIndexes;
+		RB_NullGL_HashSurf( surf );
+	}
+}
+
+/*
+==================
+RB_NullGL_DrawView
+==================
+*/
+static void RB_NullGL_DrawView( const drawSurfsCommand_t *cmd ) {
+	const viewDef_t	*viewDef = cmd->viewDef;
+	int				data[6];
+
+	backEnd.viewDef = viewDef;
+
+	if ( viewDef->viewEntitys ) {
+		nullStats.views3D++;
+	} else {
+		nullStats.views2D++;
+	}
+
+	data[0] = viewDef->numDrawSurfs;
+	data[1] = viewDef->isSubview;
+	data[2] = viewDef->scissor.x1;
+	data[3] = viewDef->scissor.y1;
+	data[4] = viewDef->scissor.x2;
+	data[5] = viewDef->scissor.y2;
+	CRC32_UpdateChecksum( nullStats.crc, data, sizeof( data ) );
+
+	nullStats.drawSurfs += viewDef->numDrawSurfs;
+	backEnd.pc.c_surfaces += viewDef->numDrawSurfs;
+	for ( int i = 0; i < viewDef->numDrawSurfs; i++ ) {
+		RB_NullGL_HashSurf( viewDef->drawSurfs[i] );
+	}
+
+	for ( const viewLight_t *vLight = viewDef->viewLights; vLight; vLight = vLight->next ) {
+		nullStats.lights++;
+		if ( vLight->lightShader ) {
+			const char *name = vLight->lightShader->GetName();
+			CRC32_UpdateChecksum( nullStats.crc, name, strlen( name ) );
+		}
+		RB_NullGL_CountShadows( vLight->globalShadows );
+		RB_NullGL_CountInteractions( vLight->localInteractions );
+		RB_NullGL_CountShadows( vLight->localShadows );
+		RB_NullGL_CountInteractions( vLight->globalInteractions );
+		RB_NullGL_CountInteractions( vLight->translucentInteractions );
+	}
+}
+
+/*
+==================
+RB_NullGL_ExecuteBackEndCommands
+
+Replaces RB_ExecuteBackEndCommands() when the null back end is active
+==================
+*/
+void RB_NullGL_ExecuteBackEndCommands( const emptyCommand_t *cmds ) {
+	if ( cmds->commandId == RC_NOP && !cmds->next ) {
+		return;
+	}
+
+	int startTime = Sys_Milliseconds();
+
+	// background loads still have to be finished, they own image memory
+	if ( !R_OnRenderThread() ) {
+		globalImages->CompleteBackgroundImageLoads();
+	}
+
+	for ( ; cmds ; cmds = (const emptyCommand_t *)cmds->next ) {
+		CRC32_UpdateChecksum( nullStats.crc, &cmds->commandId, sizeof( cmds->commandId ) );
+
+		switch ( cmds->commandId ) {
+		case RC_NOP:
+			break;
+		case RC_DRAW_VIEW:
+			RB_NullGL_DrawView( (const drawSurfsCommand_t *)cmds );
+			break;
+		case RC_SET_BUFFER:
+			backEnd.frameCount = ((const setBufferCommand_t *)cmds)->frameCount;
+			break;
+		case RC_SWAP_BUFFERS:
+			nullStats.frames++;
+			break;
+		case RC_COPY_RENDER:
+			break;
+		default:
+			common->Error( "RB_NullGL_ExecuteBackEndCommands: bad commandId" );
+			break;
+		}
+	}
+
+	backEnd.pc.msec = Sys_Milliseconds() - startTime;
+}
+
+/*
+==================
+R_ResetNullBackEndStats
+==================
+*/
+void R_ResetNullBackEndStats( void ) {
+	memset( &nullStats, 0, sizeof( nullStats ) );
+	CRC32_InitChecksum( nullStats.crc );
+}
+
+/*
+==================
+R_PrintNullBackEndStats
+
+Does nothing unless the null back end is active
+==================
+*/
+void R_PrintNullBackEndStats( void ) {
+	if ( tr.backEndRenderer != BE_NULL ) {
+		return;
+	}
+
+	unsigned int crc = nullStats.crc;
+	CRC32_FinishChecksum( crc );
+
+	float scale = 1.0f / Max( nullStats.frames, 1 );
+	common->Printf( "null GL: %i frames, %i 3D views, %i 2D views\n", nullStats.frames, nullStats.views3D, nullStats.views2D );
+	common->Printf( "null GL per frame: %.1f surfaces, %.1f lights, %.1f interactions, %.1f shadows with %.0f indexes\n",
+					nullStats.drawSurfs * scale, nullStats.lights * scale, nullStats.interactions * scale,
+					nullStats.shadowSurfs * scale, nullStats.shadowIndexes * scale );
+	common->Printf( "null GL command list hash: %08x\n", crc );
+}
+
+/*
+==================
+R_NullGLStats_f
+
+nullGLStats [reset]
+==================
+*/
+void R_NullGLStats_f( const idCmdArgs &args ) {
+	if ( tr.backEndRenderer != BE_NULL ) {
+		common->Printf( "the null back end is not active (set r_nullGL 1 on the command line)\n" );
+		return;
+	}
+	if ( args.Argc() > 1 && idStr::Icmp( args.Argv( 1 ), "reset" ) == 0 ) {
+		R_ResetNullBackEndStats();
+		return;
+	}
+	R_PrintNullBackEndStats();
+}
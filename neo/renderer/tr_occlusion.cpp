@@ -0,0 +1,615 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "sys/platform.h"
+#include "renderer/ModelManager.h"
+#include "renderer/RenderWorld_local.h"
+
+#include "renderer/tr_local.h"
+
+#if defined(__GNUC__) && defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*
+====================================================================
+
+software occlusion culling
+
+With r_useOcclusionCulling set, the opaque world surfaces of all visible
+areas are rasterized into a small 1/w buffer on the CPU before any light
+or entity is added to the view.  Lights whose frustum and entities whose
+bounds are completely behind that buffer are dropped before any
+interaction work is done for them.
+
+The buffer only holds the nearest occluder for each pixel, and is eroded
+by one pixel after rasterization, so edges and precision errors can only
+make something visible, never cull it.
+
+Occluded entities keep their shadows, they are handled like entities
+that are only in the view for a light.
+
+====================================================================
+*/
+
+const int	OCCLUSION_WIDTH = 256;		// must be a multiple of 4
+const int	OCCLUSION_HEIGHT = 128;
+
+// occluder triangles are clipped to this many times the screen size
+// before projection, so the edge functions stay well inside float precision
+const float	OCCLUSION_GUARD_BAND = 2.0f;
+
+// world triangles smaller than this are not worth rasterizing
+const float	OCCLUSION_MIN_OCCLUDER_AREA = 16.0f;
+
+// something is only occluded if it is this much farther away than the occluders
+const float	OCCLUSION_DEPTH_BIAS = 1.01f;
+
+typedef struct {
+	float		x, y;			// occlusion buffer pixels, y is up
+	float		invW;
+} occlusionVert_t;
+
+static bool		occlusionValid;		// only set for the main view while it is being built
+static float	occlusionMVP[16];
+static float	occlusionNearW;
+
+ALIGN16( static float occlusionDepth[OCCLUSION_HEIGHT * OCCLUSION_WIDTH] );	// 1/w of the nearest occluder, 0 = empty
+ALIGN16( static float occlusionScratch[OCCLUSION_HEIGHT * OCCLUSION_WIDTH] );
+
+/*
+==================
+R_TransformOcclusionPoint
+==================
+*/
+static ID_INLINE void R_TransformOcclusionPoint( const idVec3 &v, idVec4 &clip ) {
+	const float *m = occlusionMVP;
+
+	clip.x = v.x * m[0*4+0] + v.y * m[1*4+0] + v.z * m[2*4+0] + m[3*4+0];
+	clip.y = v.x * m[0*4+1] + v.y * m[1*4+1] + v.z * m[2*4+1] + m[3*4+1];
+	clip.z = v.x * m[0*4+2] + v.y * m[1*4+2] + v.z * m[2*4+2] + m[3*4+2];
+	clip.w = v.x * m[0*4+3] + v.y * m[1*4+3] + v.z * m[2*4+3] + m[3*4+3];
+}
+
+/*
+==================
+R_BuildAreaOccluders
+
+Collects the opaque triangles of the area model in the winding they
+are visible from.  This is only done the first time the area is seen.
+==================
+*/
+static void R_BuildAreaOccluders( portalArea_t *area ) {
+	area->occludersBuilt = true;
+	area->occluderVerts = NULL;
+	area->numOccluderVerts = 0;
+
+	idRenderModel *model = renderModelManager->CheckModel( va( "_area%i", area->areaNum ) );
+	if ( model == NULL || !model->IsStaticWorldModel() ) {
+		return;
+	}
+
+	int numVerts = 0;
+	for ( int i = 0; i < model->NumSurfaces(); i++ ) {
+		const modelSurface_t *surf = model->Surface( i );
+		const idMaterial *shader = surf->shader;
+
+		if ( surf->geometry == NULL || shader == NULL ) {
+			continue;
+		}
+		if ( !shader->IsDrawn() || shader->Coverage() != MC_OPAQUE || shader->Deform() != DFRM_NONE ) {
+			continue;
+		}
+		numVerts += surf->geometry->numIndexes * ( shader->GetCullType() == CT_TWO_SIDED ? 2 : 1 );
+	}
+	if ( numVerts == 0 ) {
+		return;
+	}
+
+	idVec3 *verts = (idVec3 *)R_StaticAlloc( numVerts * sizeof( verts[0] ) );
+	numVerts = 0;
+
+	for ( int i = 0; i < model->NumSurfaces(); i++ ) {
+		const modelSurface_t *surf = model->Surface( i );
+		const idMaterial *shader = surf->shader;
+
+		if ( surf->geometry == NULL || shader == NULL ) {
+			continue;
+		}
+		if ( !shader->IsDrawn() || shader->Coverage() != MC_OPAQUE || shader->Deform() != DFRM_NONE ) {
+			continue;
+		}
+
+		const srfTriangles_t *tri = surf->geometry;
+		const cullType_t cullType = shader->GetCullType();
+
+		for ( int j = 0; j < tri->numIndexes; j += 3 ) {
+			const idVec3 &v1 = tri->verts[tri->indexes[j+0]].xyz;
+			const idVec3 &v2 = tri->verts[tri->indexes[j+1]].xyz;
+			const idVec3 &v3 = tri->verts[tri->indexes[j+2]].xyz;
+
+			if ( ( v2 - v1 ).Cross( v3 - v1 ).LengthSqr() < Square( 2.0f * OCCLUSION_MIN_OCCLUDER_AREA ) ) {
+				continue;
+			}
+
+			// store the triangles so they are front facing when the view is
+			// on the positive side of ( v3 - v1 ) x ( v2 - v1 )
+			if ( cullType != CT_BACK_SIDED ) {
+				verts[numVerts++] = v1;
+				verts[numVerts++] = v2;
+				verts[numVerts++] = v3;
+			}
+			if ( cullType != CT_FRONT_SIDED ) {
+				verts[numVerts++] = v1;
+				verts[numVerts++] = v3;
+				verts[numVerts++] = v2;
+			}
+		}
+	}
+
+	area->occluderVerts = verts;
+	area->numOccluderVerts = numVerts;
+}
+
+/*
+==================
+R_FreeAreaOccluders
+==================
+*/
+void R_FreeAreaOccluders( portalArea_t *area ) {
+	if ( area->occluderVerts ) {
+		R_StaticFree( area->occluderVerts );
+	}
+	area->occluderVerts = NULL;
+	area->numOccluderVerts = 0;
+	area->occludersBuilt = false;
+}
+
+/*
+==================
+R_ClipOcclusionPolygon
+
+Clips a polygon in clip space to one of the near and guard band planes,
+each plane is given as dot( plane, ( x, y, w, 1 ) ) >= 0
+==================
+*/
+static int R_ClipOcclusionPolygon( const idVec4 *in, int numIn, idVec4 *out, const float plane[4] ) {
+	float	dists[8];
+	int		numOut = 0;
+	bool	allIn = true;
+
+	for ( int i = 0; i < numIn; i++ ) {
+		dists[i] = plane[0] * in[i].x + plane[1] * in[i].y + plane[2] * in[i].w + plane[3];
+		if ( dists[i] < 0.0f ) {
+			allIn = false;
+		}
+	}
+	if ( allIn ) {
+		for ( int i = 0; i < numIn; i++ ) {
+			out[i] = in[i];
+		}
+		return numIn;
+	}
+
+	for ( int i = 0; i < numIn; i++ ) {
+		const int next = ( i + 1 ) % numIn;
+
+		if ( dists[i] >= 0.0f ) {
+			out[numOut++] = in[i];
+		}
+		if ( ( dists[i] >= 0.0f ) != ( dists[next] >= 0.0f ) ) {
+			const float f = dists[i] / ( dists[i] - dists[next] );
+			out[numOut++] = in[i] + f * ( in[next] - in[i] );
+		}
+	}
+	return numOut;
+}
+
+/*
+==================
+R_RasterizeOcclusionTriangle
+
+Keeps the nearest 1/w for every pixel center inside the triangle.
+The 1/w plane is lowered by half a pixel of slope, so it is never
+in front of the real surface anywhere inside the pixel.
+==================
+*/
+static void R_RasterizeOcclusionTriangle( const occlusionVert_t *v0, const occlusionVert_t *v1, const occlusionVert_t *v2 ) {
+	float area = ( v1->x - v0->x ) * ( v2->y - v0->y ) - ( v1->y - v0->y ) * ( v2->x - v0->x );
+	if ( idMath::Fabs( area ) < 1e-4f ) {
+		return;
+	}
+	if ( area < 0.0f ) {
+		const occlusionVert_t *temp = v1;
+		v1 = v2;
+		v2 = temp;
+		area = -area;
+	}
+
+	int x1 = idMath::Ftoi( floor( Min3( v0->x, v1->x, v2->x ) ) );
+	int x2 = idMath::Ftoi( ceil( Max3( v0->x, v1->x, v2->x ) ) );
+	int y1 = idMath::Ftoi( floor( Min3( v0->y, v1->y, v2->y ) ) );
+	int y2 = idMath::Ftoi( ceil( Max3( v0->y, v1->y, v2->y ) ) );
+	x1 = Max( x1, 0 ) & ~3;
+	x2 = Min( x2, OCCLUSION_WIDTH - 1 );
+	y1 = Max( y1, 0 );
+	y2 = Min( y2, OCCLUSION_HEIGHT - 1 );
+	if ( x1 > x2 || y1 > y2 ) {
+		return;
+	}
+
+	// each edge function is zero on its edge and area on the opposite vertex
+	const float a0 = v1->y - v2->y, b0 = v2->x - v1->x, c0 = v1->x * v2->y - v1->y * v2->x;
+	const float a1 = v2->y - v0->y, b1 = v0->x - v2->x, c1 = v2->x * v0->y - v2->y * v0->x;
+	const float a2 = v0->y - v1->y, b2 = v1->x - v0->x, c2 = v0->x * v1->y - v0->y * v1->x;
+
+	const float invArea = 1.0f / area;
+	const float za = ( a0 * v0->invW + a1 * v1->invW + a2 * v2->invW ) * invArea;
+	const float zb = ( b0 * v0->invW + b1 * v1->invW + b2 * v2->invW ) * invArea;
+	const float zc = ( c0 * v0->invW + c1 * v1->invW + c2 * v2->invW ) * invArea - 0.5f * ( idMath::Fabs( za ) + idMath::Fabs( zb ) );
+
+#if defined(__GNUC__) && defined(__SSE2__)
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 four = _mm_set1_ps( 4.0f );
+	const __m128 xa0 = _mm_set1_ps( a0 ), xa1 = _mm_set1_ps( a1 ), xa2 = _mm_set1_ps( a2 ), xza = _mm_set1_ps( za );
+	const __m128 xStart = _mm_add_ps( _mm_set1_ps( (float)x1 ), _mm_set_ps( 3.5f, 2.5f, 1.5f, 0.5f ) );
+
+	for ( int y = y1; y <= y2; y++ ) {
+		const float fy = y + 0.5f;
+		const __m128 e0 = _mm_set1_ps( b0 * fy + c0 );
+		const __m128 e1 = _mm_set1_ps( b1 * fy + c1 );
+		const __m128 e2 = _mm_set1_ps( b2 * fy + c2 );
+		const __m128 z = _mm_set1_ps( zb * fy + zc );
+		float *row = occlusionDepth + y * OCCLUSION_WIDTH;
+		__m128 px = xStart;
+
+		for ( int x = x1; x <= x2; x += 4 ) {
+			__m128 inside = _mm_cmpge_ps( _mm_add_ps( _mm_mul_ps( xa0, px ), e0 ), zero );
+			inside = _mm_and_ps( inside, _mm_cmpge_ps( _mm_add_ps( _mm_mul_ps( xa1, px ), e1 ), zero ) );
+			inside = _mm_and_ps( inside, _mm_cmpge_ps( _mm_add_ps( _mm_mul_ps( xa2, px ), e2 ), zero ) );
+			const __m128 depth = _mm_and_ps( inside, _mm_add_ps( _mm_mul_ps( xza, px ), z ) );
+			_mm_store_ps( row + x, _mm_max_ps( _mm_load_ps( row + x ), depth ) );
+			px = _mm_add_ps( px, four );
+		}
+	}
+#else
+	for ( int y = y1; y <= y2; y++ ) {
+		const float fy = y + 0.5f;
+		float *row = occlusionDepth + y * OCCLUSION_WIDTH;
+
+		for ( int x = x1; x <= x2; x++ ) {
+			const float fx = x + 0.5f;
+			if ( a0 * fx + b0 * fy + c0 >= 0.0f && a1 * fx + b1 * fy + c1 >= 0.0f && a2 * fx + b2 * fy + c2 >= 0.0f ) {
+				const float depth = za * fx + zb * fy + zc;
+				if ( depth > row[x] ) {
+					row[x] = depth;
+				}
+			}
+		}
+	}
+#endif
+}
+
+/*
+==================
+R_RasterizeOccluder
+==================
+*/
+static void R_RasterizeOccluder( const idVec3 &v1, const idVec3 &v2, const idVec3 &v3 ) {
+	const float planes[5][4] = {
+		{ 0.0f, 0.0f, 1.0f, -occlusionNearW },
+		{ -1.0f, 0.0f, OCCLUSION_GUARD_BAND, 0.0f },
+		{ 1.0f, 0.0f, OCCLUSION_GUARD_BAND, 0.0f },
+		{ 0.0f, -1.0f, OCCLUSION_GUARD_BAND, 0.0f },
+		{ 0.0f, 1.0f, OCCLUSION_GUARD_BAND, 0.0f }
+	};
+	idVec4				clip[2][8];
+	occlusionVert_t		verts[8];
+	int					numVerts = 3;
+	int					cur = 0;
+
+	R_TransformOcclusionPoint( v1, clip[0][0] );
+	R_TransformOcclusionPoint( v2, clip[0][1] );
+	R_TransformOcclusionPoint( v3, clip[0][2] );
+
+	for ( int i = 0; i < 5 && numVerts >= 3; i++ ) {
+		numVerts = R_ClipOcclusionPolygon( clip[cur], numVerts, clip[cur^1], planes[i] );
+		cur ^= 1;
+	}
+	if ( numVerts < 3 ) {
+		return;
+	}
+
+	for ( int i = 0; i < numVerts; i++ ) {
+		const float invW = 1.0f / clip[cur][i].w;
+		verts[i].x = ( clip[cur][i].x * invW * 0.5f + 0.5f ) * OCCLUSION_WIDTH;
+		verts[i].y = ( clip[cur][i].y * invW * 0.5f + 0.5f ) * OCCLUSION_HEIGHT;
+		verts[i].invW = invW;
+	}
+	for ( int i = 2; i < numVerts; i++ ) {
+		R_RasterizeOcclusionTriangle( &verts[0], &verts[i-1], &verts[i] );
+	}
+}
+
+/*
+==================
+R_ErodeOcclusionBuffer
+
+Replaces every pixel with the farthest 1/w of its 3x3 neighborhood,
+so an object that ends within a pixel of an occluder edge stays visible.
+==================
+*/
+static void R_ErodeOcclusionBuffer( void ) {
+	// horizontal pass into the scratch buffer
+	for ( int y = 0; y < OCCLUSION_HEIGHT; y++ ) {
+		const float *src = occlusionDepth + y * OCCLUSION_WIDTH;
+		float *dst = occlusionScratch + y * OCCLUSION_WIDTH;
+		int x;
+
+		for ( x = 0; x < 4; x++ ) {
+			dst[x] = Min3( src[Max( x - 1, 0 )], src[x], src[x+1] );
+		}
+#if defined(__GNUC__) && defined(__SSE2__)
+		for ( ; x < OCCLUSION_WIDTH - 4; x += 4 ) {
+			const __m128 left = _mm_loadu_ps( src + x - 1 );
+			const __m128 right = _mm_loadu_ps( src + x + 1 );
+			_mm_store_ps( dst + x, _mm_min_ps( _mm_load_ps( src + x ), _mm_min_ps( left, right ) ) );
+		}
+#else
+		for ( ; x < OCCLUSION_WIDTH - 4; x++ ) {
+			dst[x] = Min3( src[x-1], src[x], src[x+1] );
+		}
+#endif
+		for ( ; x < OCCLUSION_WIDTH; x++ ) {
+			dst[x] = Min3( src[x-1], src[x], src[Min( x + 1, OCCLUSION_WIDTH - 1 )] );
+		}
+	}
+
+	// vertical pass back into the depth buffer
+	for ( int y = 0; y < OCCLUSION_HEIGHT; y++ ) {
+		const float *above = occlusionScratch + Max( y - 1, 0 ) * OCCLUSION_WIDTH;
+		const float *src = occlusionScratch + y * OCCLUSION_WIDTH;
+		const float *below = occlusionScratch + Min( y + 1, OCCLUSION_HEIGHT - 1 ) * OCCLUSION_WIDTH;
+		float *dst = occlusionDepth + y * OCCLUSION_WIDTH;
+
+#if defined(__GNUC__) && defined(__SSE2__)
+		for ( int x = 0; x < OCCLUSION_WIDTH; x += 4 ) {
+			const __m128 m = _mm_min_ps( _mm_load_ps( above + x ), _mm_load_ps( below + x ) );
+			_mm_store_ps( dst + x, _mm_min_ps( _mm_load_ps( src + x ), m ) );
+		}
+#else
+		for ( int x = 0; x < OCCLUSION_WIDTH; x++ ) {
+			dst[x] = Min3( above[x], src[x], below[x] );
+		}
+#endif
+	}
+}
+
+/*
+==================
+R_RenderOcclusionBuffer
+
+Called after the visible areas have been found, but before any
+lights or entities are added to the view.
+==================
+*/
+void R_RenderOcclusionBuffer( void ) {
+	occlusionValid = false;
+
+	if ( !r_useOcclusionCulling.GetBool() || tr.viewDef->isSubview || tr.viewDef->areaNum < 0 ) {
+		return;
+	}
+
+	idRenderWorldLocal *world = static_cast<idRenderWorldLocal *>( tr.viewDef->renderWorld );
+	if ( world == NULL || world->numPortalAreas <= 0 ) {
+		return;
+	}
+
+	const double start = Sys_MillisecondsPrecise();
+
+	myGlMultMatrix( tr.viewDef->worldSpace.modelViewMatrix, tr.viewDef->projectionMatrix, occlusionMVP );
+	occlusionNearW = r_znear.GetFloat();
+
+	memset( occlusionDepth, 0, sizeof( occlusionDepth ) );
+
+	const idVec3 &viewOrg = tr.viewDef->renderView.vieworg;
+	const bool showOccluders = r_showOcclusionCulling.GetInteger() >= 3;
+
+	for ( int i = 0; i < world->numPortalAreas; i++ ) {
+		portalArea_t *area = &world->portalAreas[i];
+
+		if ( area->viewCount != tr.viewCount ) {
+			continue;
+		}
+		if ( !area->occludersBuilt ) {
+			R_BuildAreaOccluders( area );
+		}
+
+		const idVec3 *verts = area->occluderVerts;
+		for ( int j = 0; j < area->numOccluderVerts; j += 3 ) {
+			const idVec3 &v1 = verts[j+0];
+			const idVec3 &v2 = verts[j+1];
+			const idVec3 &v3 = verts[j+2];
+
+			// only the side facing the view occludes anything
+			if ( ( v3 - v1 ).Cross( v2 - v1 ) * ( viewOrg - v1 ) < 0.0f ) {
+				continue;
+			}
+
+			R_RasterizeOccluder( v1, v2, v3 );
+			tr.pc.c_occluderTris++;
+
+			if ( showOccluders ) {
+				world->DebugLine( colorCyan, v1, v2 );
+				world->DebugLine( colorCyan, v2, v3 );
+				world->DebugLine( colorCyan, v3, v1 );
+			}
+		}
+	}
+
+	R_ErodeOcclusionBuffer();
+
+	occlusionValid = true;
+
+	tr.pc.occlusionUsec += idMath::Ftoi( ( Sys_MillisecondsPrecise() - start ) * 1000.0 );
+}
+
+/*
+==================
+R_OcclusionTestPoints
+
+Returns true if the convex hull of the world space points is completely
+behind the occluders.  Anything that crosses the near plane or is off
+screen is left for the other culling to decide.
+==================
+*/
+static bool R_OcclusionTestPoints( const idVec3 *points, int numPoints, int colorIndex ) {
+	float	minX = idMath::INFINITY, minY = idMath::INFINITY;
+	float	maxX = -idMath::INFINITY, maxY = -idMath::INFINITY;
+	float	maxInvW = 0.0f;
+
+	tr.pc.c_occlusionTests++;
+
+	for ( int i = 0; i < numPoints; i++ ) {
+		idVec4 clip;
+
+		R_TransformOcclusionPoint( points[i], clip );
+		if ( clip.w < occlusionNearW ) {
+			return false;
+		}
+
+		const float invW = 1.0f / clip.w;
+		const float x = ( clip.x * invW * 0.5f + 0.5f ) * OCCLUSION_WIDTH;
+		const float y = ( clip.y * invW * 0.5f + 0.5f ) * OCCLUSION_HEIGHT;
+
+		minX = Min( minX, x );
+		maxX = Max( maxX, x );
+		minY = Min( minY, y );
+		maxY = Max( maxY, y );
+		maxInvW = Max( maxInvW, invW );
+	}
+
+	if ( maxX < 0.0f || maxY < 0.0f || minX >= OCCLUSION_WIDTH || minY >= OCCLUSION_HEIGHT ) {
+		return false;
+	}
+	const int x1 = Max( idMath::Ftoi( floor( minX ) ), 0 );
+	const int x2 = Min( idMath::Ftoi( floor( maxX ) ), OCCLUSION_WIDTH - 1 );
+	const int y1 = Max( idMath::Ftoi( floor( minY ) ), 0 );
+	const int y2 = Min( idMath::Ftoi( floor( maxY ) ), OCCLUSION_HEIGHT - 1 );
+
+	// any pixel where the occluders are not clearly nearer makes it visible
+	const float depth = maxInvW * OCCLUSION_DEPTH_BIAS;
+	for ( int y = y1; y <= y2; y++ ) {
+		const float *row = occlusionDepth + y * OCCLUSION_WIDTH;
+		for ( int x = x1; x <= x2; x++ ) {
+			if ( row[x] <= depth ) {
+				return false;
+			}
+		}
+	}
+
+	if ( r_showOcclusionCulling.GetInteger() >= 2 ) {
+		const int width = tr.viewDef->viewport.x2 - tr.viewDef->viewport.x1 + 1;
+		const int height = tr.viewDef->viewport.y2 - tr.viewDef->viewport.y1 + 1;
+		idScreenRect rect;
+
+		rect.Clear();
+		rect.x1 = x1 * width / OCCLUSION_WIDTH;
+		rect.x2 = ( x2 + 1 ) * width / OCCLUSION_WIDTH - 1;
+		rect.y1 = y1 * height / OCCLUSION_HEIGHT;
+		rect.y2 = ( y2 + 1 ) * height / OCCLUSION_HEIGHT - 1;
+		R_ShowColoredScreenRect( rect, colorIndex );
+	}
+
+	return true;
+}
+
+/*
+==================
+R_CullEntityByOcclusion
+
+Occluded entities are turned into shadow only entities by
+clearing their scissor rect, so their interactions are still
+created for any visible light that they cast shadows for.
+==================
+*/
+bool R_CullEntityByOcclusion( viewEntity_t *vEntity ) {
+	if ( !occlusionValid || vEntity->scissorRect.IsEmpty() ) {
+		return false;
+	}
+
+	const idRenderEntityLocal *def = vEntity->entityDef;
+
+	// depth hacked models are drawn on top of the walls they poke into
+	if ( def->parms.weaponDepthHack || def->parms.modelDepthHack != 0.0f ) {
+		return false;
+	}
+
+	idVec3 points[8];
+	idBox( def->referenceBounds, def->parms.origin, def->parms.axis ).ToPoints( points );
+
+	if ( !R_OcclusionTestPoints( points, 8, 0 ) ) {
+		return false;
+	}
+
+	vEntity->scissorRect.Clear();
+	tr.pc.c_occludedEntities++;
+	return true;
+}
+
+/*
+==================
+R_CullLightByOcclusion
+
+Everything a light touches, lit or shadowed, is inside its
+frustum, so nothing of it is visible if the frustum is occluded.
+==================
+*/
+bool R_CullLightByOcclusion( const viewLight_t *vLight ) {
+	if ( !occlusionValid ) {
+		return false;
+	}
+
+	// the frustum is at most a six sided polytope
+	const srfTriangles_t *tri = vLight->lightDef->frustumTris;
+	if ( tri == NULL || tri->numVerts <= 0 || tri->numVerts > 8 ) {
+		return false;
+	}
+
+	idVec3 points[8];
+	for ( int i = 0; i < tri->numVerts; i++ ) {
+		points[i] = tri->verts[i].xyz;
+	}
+
+	if ( !R_OcclusionTestPoints( points, tri->numVerts, 1 ) ) {
+		return false;
+	}
+
+	tr.pc.c_occludedLights++;
+	return true;
+}
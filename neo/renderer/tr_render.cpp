@@ -76,33 +76,34 @@ void RB_DrawElementsImmediate( const srfTriangles_t *tri ) {
 RB_DrawElementsWithCounters
 ================
 */
-void RB_DrawElementsWithCounters( const srfTriangles_t *tri ) {
+void RB_DrawElementsWithCounters( const drawSurf_t *surf ) {
+	const srfTriangles_t *tri = surf->geo;
 
 	backEnd.pc.c_drawElements++;
-	backEnd.pc.c_drawIndexes += tri->numIndexes;
-	backEnd.pc.c_drawVertexes += tri->numVerts;
+	backEnd.pc.c_drawIndexes += surf->numIndexes;
+	backEnd.pc.c_drawVertexes += surf->numVerts;
 
 	if ( tri->ambientSurface != NULL  ) {
 		if ( tri->indexes == tri->ambientSurface->indexes ) {
-			backEnd.pc.c_drawRefIndexes += tri->numIndexes;
+			backEnd.pc.c_drawRefIndexes += surf->numIndexes;
 		}
 		if ( tri->verts == tri->ambientSurface->verts ) {
-			backEnd.pc.c_drawRefVertexes += tri->numVerts;
+			backEnd.pc.c_drawRefVertexes += surf->numVerts;
 		}
 	}
 
-	if ( tri->indexCache && r_useIndexBuffers.GetBool() ) {
+	if ( surf->indexCache && r_useIndexBuffers.GetBool() ) {
 		qglDrawElements( GL_TRIANGLES,
-						r_singleTriangle.GetBool() ? 3 : tri->numIndexes,
+						r_singleTriangle.GetBool() ? 3 : surf->numIndexes,
 						GL_INDEX_TYPE,
-						(int *)vertexCache.Position( tri->indexCache ) );
-		backEnd.pc.c_vboIndexes += tri->numIndexes;
+						(int *)vertexCache.Position( surf->indexCache ) );
+		backEnd.pc.c_vboIndexes += surf->numIndexes;
 	} else {
 		if ( r_useIndexBuffers.GetBool() ) {
 			vertexCache.UnbindIndex();
 		}
 		qglDrawElements( GL_TRIANGLES,
-						r_singleTriangle.GetBool() ? 3 : tri->numIndexes,
+						r_singleTriangle.GetBool() ? 3 : surf->numIndexes,
 						GL_INDEX_TYPE,
 						tri->indexes );
 	}
@@ -115,16 +116,18 @@ RB_DrawShadowElementsWithCounters
 May not use all the indexes in the surface if caps are skipped
 ================
 */
-void RB_DrawShadowElementsWithCounters( const srfTriangles_t *tri, int numIndexes ) {
+void RB_DrawShadowElementsWithCounters( const drawSurf_t *surf, int numIndexes ) {
+	const srfTriangles_t *tri = surf->geo;
+
 	backEnd.pc.c_shadowElements++;
 	backEnd.pc.c_shadowIndexes += numIndexes;
-	backEnd.pc.c_shadowVertexes += tri->numVerts;
+	backEnd.pc.c_shadowVertexes += surf->numVerts;
 
-	if ( tri->indexCache && r_useIndexBuffers.GetBool() ) {
+	if ( surf->indexCache && r_useIndexBuffers.GetBool() ) {
 		qglDrawElements( GL_TRIANGLES,
 						r_singleTriangle.GetBool() ? 3 : numIndexes,
 						GL_INDEX_TYPE,
-						(int *)vertexCache.Position( tri->indexCache ) );
+						(int *)vertexCache.Position( surf->indexCache ) );
 		backEnd.pc.c_vboIndexes += numIndexes;
 	} else {
 		if ( r_useIndexBuffers.GetBool() ) {
@@ -145,18 +148,18 @@ RB_RenderTriangleSurface
 Sets texcoord and vertex pointers
 ===============
 */
-void RB_RenderTriangleSurface( const srfTriangles_t *tri ) {
-	if ( !tri->ambientCache ) {
-		RB_DrawElementsImmediate( tri );
+void RB_RenderTriangleSurface( const drawSurf_t *surf ) {
+	if ( !surf->ambientCache ) {
+		RB_DrawElementsImmediate( surf->geo );
 		return;
 	}
 
 
-	idDrawVert *ac = (idDrawVert *)vertexCache.Position( tri->ambientCache );
+	idDrawVert *ac = (idDrawVert *)vertexCache.Position( surf->ambientCache );
 	qglVertexPointer( 3, GL_FLOAT, sizeof( idDrawVert ), ac->xyz.ToFloatPtr() );
 	qglTexCoordPointer( 2, GL_FLOAT, sizeof( idDrawVert ), ac->st.ToFloatPtr() );
 
-	RB_DrawElementsWithCounters( tri );
+	RB_DrawElementsWithCounters( surf );
 }
 
 /*
@@ -166,7 +169,7 @@ RB_T_RenderTriangleSurface
 ===============
 */
 void RB_T_RenderTriangleSurface( const drawSurf_t *surf ) {
-	RB_RenderTriangleSurface( surf->geo );
+	RB_RenderTriangleSurface( surf );
 }
 
 /*
@@ -373,25 +376,19 @@ void RB_LoadShaderTextureMatrix( const float *shaderRegisters, const textureStag
 ======================
 RB_BindVariableStageImage
 
-Handles generating a cinematic frame if needed
+Uploads the cinematic frame the front end decoded, cin is
+the surface's entry for the stage in drawSurf_t::cinematicFrames
 ======================
 */
-void RB_BindVariableStageImage( const textureStage_t *texture, const float *shaderRegisters ) {
+void RB_BindVariableStageImage( const textureStage_t *texture, const float *shaderRegisters, const cinData_t *cin ) {
 	if ( texture->cinematic ) {
-		cinData_t	cin;
-
 		if ( r_skipDynamicTextures.GetBool() ) {
 			globalImages->defaultImage->Bind();
 			return;
 		}
 
-		// offset time by shaderParm[7] (FIXME: make the time offset a parameter of the shader?)
-		// We make no attempt to optimize for multiple identical cinematics being in view, or
-		// for cinematics going at a lower framerate than the renderer.
-		cin = texture->cinematic->ImageForTime( (int)(1000 * ( backEnd.viewDef->floatTime + backEnd.viewDef->renderView.shaderParms[11] ) ) );
-
-		if ( cin.image ) {
-			globalImages->cinematicImage->UploadScratch( cin.image, cin.imageWidth, cin.imageHeight );
+		if ( cin && cin->image ) {
+			globalImages->cinematicImage->UploadScratch( cin->image, cin->imageWidth, cin->imageHeight );
 		} else {
 			globalImages->blackImage->Bind();
 		}
@@ -409,12 +406,24 @@ RB_BindStageTexture
 ======================
 */
 void RB_BindStageTexture( const float *shaderRegisters, const textureStage_t *texture, const drawSurf_t *surf ) {
+	const cinData_t *cin = NULL;
+
+	// find the frame of the stage if it has a cinematic
+	if ( texture->cinematic && surf->cinematicFrames ) {
+		for ( int i = 0; i < surf->material->GetNumStages(); i++ ) {
+			if ( &surf->material->GetStage( i )->texture == texture ) {
+				cin = &surf->cinematicFrames[i];
+				break;
+			}
+		}
+	}
+
 	// image
-	RB_BindVariableStageImage( texture, shaderRegisters );
+	RB_BindVariableStageImage( texture, shaderRegisters, cin );
 
 	// texgens
 	if ( texture->texgen == TG_DIFFUSE_CUBE ) {
-		qglTexCoordPointer( 3, GL_FLOAT, sizeof( idDrawVert ), ((idDrawVert *)vertexCache.Position( surf->geo->ambientCache ))->normal.ToFloatPtr() );
+		qglTexCoordPointer( 3, GL_FLOAT, sizeof( idDrawVert ), ((idDrawVert *)vertexCache.Position( surf->ambientCache ))->normal.ToFloatPtr() );
 	}
 	if ( texture->texgen == TG_SKYBOX_CUBE || texture->texgen == TG_WOBBLESKY_CUBE ) {
 		qglTexCoordPointer( 3, GL_FLOAT, 0, vertexCache.Position( surf->dynamicTexCoords ) );
@@ -427,7 +436,7 @@ void RB_BindStageTexture( const float *shaderRegisters, const textureStage_t *te
 		qglTexGenf( GL_T, GL_TEXTURE_GEN_MODE, GL_REFLECTION_MAP_EXT );
 		qglTexGenf( GL_R, GL_TEXTURE_GEN_MODE, GL_REFLECTION_MAP_EXT );
 		qglEnableClientState( GL_NORMAL_ARRAY );
-		qglNormalPointer( GL_FLOAT, sizeof( idDrawVert ), ((idDrawVert *)vertexCache.Position( surf->geo->ambientCache ))->normal.ToFloatPtr() );
+		qglNormalPointer( GL_FLOAT, sizeof( idDrawVert ), ((idDrawVert *)vertexCache.Position( surf->ambientCache ))->normal.ToFloatPtr() );
 
 		qglMatrixMode( GL_TEXTURE );
 		float	mat[16];
@@ -453,7 +462,7 @@ void RB_FinishStageTexture( const textureStage_t *texture, const drawSurf_t *sur
 	if ( texture->texgen == TG_DIFFUSE_CUBE || texture->texgen == TG_SKYBOX_CUBE
 		|| texture->texgen == TG_WOBBLESKY_CUBE ) {
 		qglTexCoordPointer( 2, GL_FLOAT, sizeof( idDrawVert ),
-			(void *)&(((idDrawVert *)vertexCache.Position( surf->geo->ambientCache ))->st) );
+			(void *)&(((idDrawVert *)vertexCache.Position( surf->ambientCache ))->st) );
 	}
 
 	if ( texture->texgen == TG_REFLECT_CUBE ) {
@@ -702,7 +711,7 @@ void RB_CreateSingleDrawInteractions( const drawSurf_t *surf, void (*DrawInterac
 	inter.specularMatrix[0].Zero();
 	inter.specularMatrix[1].Zero();
 
-	if ( r_skipInteractions.GetBool() || !surf->geo || !surf->geo->ambientCache ) {
+	if ( r_skipInteractions.GetBool() || !surf->geo || !surf->ambientCache ) {
 		return;
 	}
 
@@ -834,7 +843,7 @@ void RB_CreateSingleDrawInteractions( const drawSurf_t *surf, void (*DrawInterac
 						RB_SubmittInteraction( &inter, DrawInteraction );
 					}
 // jmarshall - add no specular support(great for fill lighting).
-					if ( !allowNoSpecular || !vLight->lightDef->parms.noSpecular )
+					if ( !allowNoSpecular || !vLight->noSpecular )
 					{
 						R_SetDrawInteraction( surfaceStage, surfaceRegs, &inter.specularImage,
 												inter.specularMatrix, inter.specularColor.ToFloatPtr() );
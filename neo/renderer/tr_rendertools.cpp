@@ -566,13 +566,13 @@ void RB_ShowLightCount( void ) {
 		for ( i = 0 ; i < 2 ; i++ ) {
 			for ( surf = i ? vLight->localInteractions: vLight->globalInteractions; surf; surf = (drawSurf_t *)surf->nextOnLight ) {
 				RB_SimpleSurfaceSetup( surf );
-				if ( !surf->geo->ambientCache ) {
+				if ( !surf->ambientCache ) {
 					continue;
 				}
 
-				const idDrawVert	*ac = (idDrawVert *)vertexCache.Position( surf->geo->ambientCache );
+				const idDrawVert	*ac = (idDrawVert *)vertexCache.Position( surf->ambientCache );
 				qglVertexPointer( 3, GL_FLOAT, sizeof( idDrawVert ), &ac->xyz );
-				RB_DrawElementsWithCounters( surf->geo );
+				RB_DrawElementsWithCounters( surf );
 			}
 		}
 	}
@@ -708,27 +708,26 @@ static void RB_ShowShadowCount( void ) {
 			for ( surf = i ? vLight->localShadows : vLight->globalShadows
 				; surf ; surf = (drawSurf_t *)surf->nextOnLight ) {
 				RB_SimpleSurfaceSetup( surf );
-				const srfTriangles_t	*tri = surf->geo;
-				if ( !tri->shadowCache ) {
+				if ( !surf->shadowCache ) {
 					continue;
 				}
 
 				if ( r_showShadowCount.GetInteger() == 3 ) {
 					// only show turboshadows
-					if ( tri->numShadowIndexesNoCaps != tri->numIndexes ) {
+					if ( surf->numShadowIndexesNoCaps != surf->numIndexes ) {
 						continue;
 					}
 				}
 				if ( r_showShadowCount.GetInteger() == 4 ) {
 					// only show static shadows
-					if ( tri->numShadowIndexesNoCaps == tri->numIndexes ) {
+					if ( surf->numShadowIndexesNoCaps == surf->numIndexes ) {
 						continue;
 					}
 				}
 
-				shadowCache_t *cache = (shadowCache_t *)vertexCache.Position( tri->shadowCache );
+				shadowCache_t *cache = (shadowCache_t *)vertexCache.Position( surf->shadowCache );
 				qglVertexPointer( 4, GL_FLOAT, sizeof( *cache ), &cache->xyz );
-				RB_DrawElementsWithCounters( tri );
+				RB_DrawElementsWithCounters( surf );
 			}
 		}
 	}
@@ -1612,9 +1611,8 @@ r_showLights 3	: also draw edges of each volume
 ==============
 */
 void RB_ShowLights( void ) {
-	const idRenderLightLocal	*light;
 	int					count;
-	srfTriangles_t		*tri;
+	drawSurf_t			ds;
 	viewLight_t			*vLight;
 
 	if ( !r_showLights.GetInteger() ) {
@@ -1637,17 +1635,21 @@ void RB_ShowLights( void ) {
 
 	count = 0;
 	for ( vLight = backEnd.viewDef->viewLights ; vLight ; vLight = vLight->next ) {
-		light = vLight->lightDef;
 		count++;
 
-		tri = light->frustumTris;
+		// the frustum only has an ambient cache for fog lights, others are drawn immediate
+		memset( &ds, 0, sizeof( ds ) );
+		ds.geo = vLight->frustumTris;
+		ds.ambientCache = vLight->frustumTrisAmbientCache;
+		ds.numVerts = vLight->frustumTris->numVerts;
+		ds.numIndexes = vLight->frustumTris->numIndexes;
 
 		// depth buffered planes
 		if ( r_showLights.GetInteger() >= 2 ) {
 			GL_State( GLS_SRCBLEND_SRC_ALPHA | GLS_DSTBLEND_ONE_MINUS_SRC_ALPHA | GLS_DEPTHMASK );
 			qglColor4f( 0, 0, 1, 0.25 );
 			qglEnable( GL_DEPTH_TEST );
-			RB_RenderTriangleSurface( tri );
+			RB_RenderTriangleSurface( &ds );
 		}
 
 		// non-hidden lines
@@ -1655,7 +1657,7 @@ void RB_ShowLights( void ) {
 			GL_State( GLS_POLYMODE_LINE | GLS_DEPTHMASK  );
 			qglDisable( GL_DEPTH_TEST );
 			qglColor3f( 1, 1, 1 );
-			RB_RenderTriangleSurface( tri );
+			RB_RenderTriangleSurface( &ds );
 		}
 
 		int index;
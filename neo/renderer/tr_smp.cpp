@@ -0,0 +1,344 @@
+/*
+===========================================================================
+
+Doom 3 GPL Source Code
+Copyright (C) 1999-2011 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 GPL Source Code ("Doom 3 Source Code").
+
+Doom 3 Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+#include "sys/platform.h"
+#include "sys/sys_imgui.h"
+
+#include "renderer/tr_local.h"
+
+/*
+====================================================================
+
+Render thread
+
+With r_smp the back end runs the command list of a frame in its own
+thread, while the main thread already runs the game and the front end
+of the next frame. frameData and the vertex cache frame lists are
+double buffered, so the front end never writes to what the back end
+reads. idRenderSystemLocal::EndFrame() waits for the last frame to be
+finished before it hands over the next one, that's the only regular
+fence.
+
+The GL context is current on the render thread. Everything else that
+needs GL (image uploads and purges, program reloads, screenshots) calls
+R_SyncRenderThread(), which waits for the back end and moves the context
+to the main thread until the next command list is issued. The render
+thread never loads images, it binds a placeholder and leaves the load
+to the main thread at the next fence, because the file system and
+idHeap aren't thread safe. For the same reason the front end keeps the
+vertex cache in system memory, it can't upload to vertex buffer objects.
+
+====================================================================
+*/
+
+const int MAX_DEFERRED_IMAGE_LOADS = 256;
+
+static xthreadInfo					renderThread;
+static bool							renderThreadRunning = false;
+static volatile bool				renderThreadQuit = false;
+static const emptyCommand_t * volatile	renderThreadCmds = NULL;		// list for the render thread, NULL when it's done
+static volatile bool				renderThreadReleaseContext = false;
+static bool							renderThreadBusy = false;		// the thread was kicked and not waited for yet
+static bool							mainThreadHasContext = true;
+static ID_THREAD_LOCAL bool			onRenderThread = false;
+
+// images the back end couldn't bind yet, only touched by the render
+// thread while it runs and by the main thread after the fence
+static idImage *					deferredImageLoads[MAX_DEFERRED_IMAGE_LOADS];
+static int							numDeferredImageLoads = 0;
+
+static int							renderThreadWaitMsec = 0;		// main thread time spent at fences this frame
+static int							renderThreadContextMoves = 0;	// R_SyncRenderThread() calls that moved the context this frame
+
+/*
+==================
+RenderThread
+==================
+*/
+static int RenderThread( void *parms ) {
+	bool	hasContext = false;
+
+	onRenderThread = true;
+
+	while ( 1 ) {
+		Sys_WaitForEvent( TRIGGER_EVENT_TWO );
+		if ( renderThreadQuit ) {
+			break;
+		}
+
+		if ( renderThreadCmds ) {
+			if ( !hasContext ) {
+				if ( !r_nullGL.GetBool() ) {
+					GLimp_ActivateContext();
+				}
+				hasContext = true;
+			}
+			RB_ExecuteBackEndCommands( renderThreadCmds );
+			renderThreadCmds = NULL;
+		}
+
+		if ( renderThreadReleaseContext ) {
+			if ( hasContext && !r_nullGL.GetBool() ) {
+				GLimp_DeactivateContext();
+			}
+			hasContext = false;
+			renderThreadReleaseContext = false;
+		}
+
+		Sys_TriggerEvent( TRIGGER_EVENT_THREE );
+	}
+
+	if ( hasContext && !r_nullGL.GetBool() ) {
+		GLimp_DeactivateContext();
+	}
+	return 0;
+}
+
+/*
+==================
+R_KickRenderThread
+==================
+*/
+static void R_KickRenderThread( void ) {
+	renderThreadBusy = true;
+	Sys_TriggerEvent( TRIGGER_EVENT_TWO );
+}
+
+/*
+==================
+R_WaitForRenderThread
+
+Returns when the back end is done with everything it was given
+==================
+*/
+void R_WaitForRenderThread( void ) {
+	if ( !renderThreadBusy ) {
+		return;
+	}
+
+	int start = Sys_Milliseconds();
+	Sys_WaitForEvent( TRIGGER_EVENT_THREE );
+	renderThreadBusy = false;
+	renderThreadWaitMsec += Sys_Milliseconds() - start;
+}
+
+/*
+==================
+R_SyncRenderThread
+
+Must be called by the main thread before it uses GL,
+does nothing on the render thread or without r_smp
+==================
+*/
+void R_SyncRenderThread( void ) {
+	if ( !renderThreadRunning || onRenderThread ) {
+		return;
+	}
+
+	R_WaitForRenderThread();
+
+	if ( !mainThreadHasContext ) {
+		renderThreadReleaseContext = true;
+		R_KickRenderThread();
+		R_WaitForRenderThread();
+
+		if ( !r_nullGL.GetBool() ) {
+			GLimp_ActivateContext();
+		}
+		mainThreadHasContext = true;
+		renderThreadContextMoves++;
+	}
+}
+
+/*
+==================
+R_StartRenderThread
+
+Called at the end of R_InitOpenGL(), so r_smp changes need a vid_restart
+==================
+*/
+void R_StartRenderThread( void ) {
+	if ( renderThreadRunning || !r_smp.GetBool() ) {
+		return;
+	}
+
+	if ( !r_nullGL.GetBool() && !GLimp_DeactivateContext() ) {
+		common->Warning( "r_smp: the GL context can't be moved to another thread, running the back end on the main thread" );
+		return;
+	}
+	mainThreadHasContext = false;
+
+	renderThreadQuit = false;
+	renderThreadCmds = NULL;
+	renderThreadReleaseContext = false;
+	renderThreadBusy = false;
+	numDeferredImageLoads = 0;
+
+	Sys_CreateThread( RenderThread, NULL, renderThread, "Render" );
+	renderThreadRunning = true;
+
+	common->Printf( "running the back end in a render thread (r_smp 1)\n" );
+}
+
+/*
+==================
+R_StopRenderThread
+
+Leaves the GL context current on the main thread
+==================
+*/
+void R_StopRenderThread( void ) {
+	if ( !renderThreadRunning ) {
+		return;
+	}
+
+	R_WaitForRenderThread();
+
+	renderThreadQuit = true;
+	Sys_TriggerEvent( TRIGGER_EVENT_TWO );
+	Sys_DestroyThread( renderThread );
+	renderThreadRunning = false;
+
+	if ( !mainThreadHasContext ) {
+		if ( !r_nullGL.GetBool() ) {
+			GLimp_ActivateContext();
+		}
+		mainThreadHasContext = true;
+	}
+
+	// the back end skipped these, nothing will pick them up anymore
+	numDeferredImageLoads = 0;
+}
+
+/*
+==================
+R_RenderThreadActive
+==================
+*/
+bool R_RenderThreadActive( void ) {
+	return renderThreadRunning;
+}
+
+/*
+==================
+R_OnRenderThread
+==================
+*/
+bool R_OnRenderThread( void ) {
+	return onRenderThread;
+}
+
+/*
+==================
+R_IssueRenderThreadCommands
+
+Hands the command list to the render thread and returns right away,
+unless an ImGui frame is rendered with it
+==================
+*/
+void R_IssueRenderThreadCommands( const emptyCommand_t *cmds ) {
+	R_WaitForRenderThread();
+
+	if ( mainThreadHasContext ) {
+		if ( !r_nullGL.GetBool() ) {
+			GLimp_DeactivateContext();
+		}
+		mainThreadHasContext = false;
+	}
+
+	// ImGui isn't thread safe, the frame it started in NewFrame()
+	// is ended by RB_SwapBuffers(), so wait for it
+	bool imguiFrame = D3::ImGuiHooks::IsFrameActive();
+
+	renderThreadCmds = cmds;
+	R_KickRenderThread();
+
+	if ( imguiFrame ) {
+		R_WaitForRenderThread();
+	}
+}
+
+/*
+==================
+R_DeferImageLoad
+
+Called by the render thread for images that aren't loaded yet
+==================
+*/
+void R_DeferImageLoad( idImage *image ) {
+	for ( int i = 0; i < numDeferredImageLoads; i++ ) {
+		if ( deferredImageLoads[i] == image ) {
+			return;
+		}
+	}
+	// if it doesn't fit, it will be asked for again next frame
+	if ( numDeferredImageLoads < MAX_DEFERRED_IMAGE_LOADS ) {
+		deferredImageLoads[numDeferredImageLoads++] = image;
+	}
+}
+
+/*
+==================
+R_FinishRenderThreadFrame
+
+The fence in idRenderSystemLocal::EndFrame(), afterwards the back end
+counters can be read and the other frameData can be reused. Does the
+image loads the back end left to the main thread.
+==================
+*/
+void R_FinishRenderThreadFrame( void ) {
+	if ( !renderThreadRunning ) {
+		return;
+	}
+
+	R_WaitForRenderThread();
+
+	for ( int i = 0; i < numDeferredImageLoads; i++ ) {
+		idImage *image = deferredImageLoads[i];
+		if ( image->texnum != idImage::TEXTURE_NOT_LOADED ) {
+			continue;
+		}
+		if ( image->partialImage ) {
+			if ( !image->backgroundLoadInProgress ) {
+				image->StartBackgroundImageLoad();
+			}
+		} else {
+			image->ActuallyLoadImage( true, false );
+		}
+	}
+	numDeferredImageLoads = 0;
+
+	// uploads, so R_SyncRenderThread() is called when there is something to do
+	globalImages->CompleteBackgroundImageLoads();
+
+	if ( r_showSmp.GetBool() ) {
+		common->Printf( "smp: back end %3i msec, main thread waited %3i msec, %i context moves\n",
+						backEnd.pc.msec, renderThreadWaitMsec, renderThreadContextMoves );
+	}
+	renderThreadWaitMsec = 0;
+	renderThreadContextMoves = 0;
+}
@@ -1705,7 +1705,8 @@ void R_DeriveTangents( srfTriangles_t *tri, bool allocFacePlanes ) {
 		return;
 	}
 
-	tr.pc.c_tangentIndexes += tri->numIndexes;
+	// deformed MD5 surfaces get here from the job threads
+	Sys_AtomicAdd( &tr.pc.c_tangentIndexes, tri->numIndexes );
 
 	if ( !tri->facePlanes && allocFacePlanes ) {
 		R_AllocStaticTriSurfPlanes( tri, tri->numIndexes );
@@ -284,20 +284,43 @@ int idWaveFile::CloseOGG( void ) {
 
   idSampleDecoderLocal
 
+  Streamed OggVorbis samples are decoded ahead of the mixer by the decoder thread
+  into a ring of 44kHz samples per decoder. The mixer copies from the ring and only
+  decodes by itself when the samples aren't there yet, either because the sound
+  was started or moved somewhere else (a seek) or because the decoder thread fell
+  behind (an underrun).
+
+  CRITICAL_SECTION_ONE protects the stb_vorbis state and the list of prefetching
+  decoders, CRITICAL_SECTION_THREE protects the rings and the statistics. The
+  decoder thread has its own stb_vorbis handle for every ring and only takes the
+  locks to pick a ring and to publish the chunk, so the mixer never waits for it
+  to finish decoding. Amplitude queries from the main thread also use a handle
+  of their own and leave the rings alone.
+
 ===================================================================================
 */
 
+const int DECODER_RING_SAMPLES				= MIXBUFFER_SAMPLES * 8;	// 44kHz samples decoded ahead of the mixer
+const int DECODER_CHUNK_SAMPLES				= MIXBUFFER_SAMPLES;		// 44kHz samples decoded by the thread at once
+const int DECODER_ACTIVE_TIME				= 44100;					// rings not read for this long aren't filled anymore
+
 class idSampleDecoderLocal : public idSampleDecoder {
 public:
 	virtual void			Decode( idSoundSample *sample, int sampleOffset44k, int sampleCount44k, float *dest );
 	virtual void			ClearDecoder( void );
 	virtual idSoundSample *	GetSample( void ) const;
 	virtual int				GetLastDecodeTime( void ) const;
+	virtual void			SetLooping( bool loop );
+	virtual void			DecodeAmplitude( idSoundSample *sample, int sampleOffset44k, int sampleCount44k, float *dest );
 
 	void					Clear( void );
 	int						DecodePCM( idSoundSample *sample, int sampleOffset44k, int sampleCount44k, float *dest );
 	int						DecodeOGG( idSoundSample *sample, int sampleOffset44k, int sampleCount44k, float *dest );
 
+	static int				DecodePCMSamples( idSoundSample *sample, int sampleOffset44k, int sampleCount44k, float *dest, bool &error );
+	static int				DecodeOGGSamples( stb_vorbis *handle, int &handleOffset, idSoundSample *sample, int sampleOffset44k, int sampleCount44k, float *dest, bool &error );
+	static bool				FillNextRing( float *chunk );
+
 private:
 	bool					failed;				// set if decoding failed
 	int						lastFormat;			// last format being decoded
@@ -306,10 +329,63 @@ private:
 	int						lastDecodeTime;		// last time decoding sound
 
 	stb_vorbis*				stbv;				// stb_vorbis (Ogg) handle, using lastSample->nonCacheData
+
+	bool					looping;			// the ring continues at the start of the sample
+	float *					ring;				// samples decoded ahead, NULL if the decoder isn't prefetching
+	int						ringStart;			// 44kHz sample offset of ring[ringRead]
+	int						ringRead;			// index of the next sample in the ring
+	int						ringCount;			// number of decoded samples in the ring
+	int						ringGeneration;		// incremented when the ring is restarted
+	bool					ringStalled;		// the decoder thread couldn't decode at the end of the ring
+	bool					ringBusy;			// the decoder thread is decoding a chunk for the ring
+	stb_vorbis*				ringStbv;			// handle of the decoder thread, only used while ringBusy
+	int						ringStbvOffset;		// sample offset of ringStbv
+
+	stb_vorbis*				amplitudeStbv;		// handle for amplitude queries from the main thread
+	idSoundSample *			amplitudeSample;	// sample amplitudeStbv was opened for
+	int						amplitudeStbvOffset;	// sample offset of amplitudeStbv
+
+	void					StartPrefetch( void );
+	void					StopPrefetch( void );
+	bool					ReadRing( int sampleOffset44k, int sampleCount44k, float *dest );
+	void					WriteRing( const float *src, int sampleCount44k );
+	void					RestartRing( int sampleOffset44k );
+	int						RingEnd( void ) const;
 };
 
+typedef struct {
+	int						ringReads;			// mixer reads copied from a ring
+	int						underruns;			// mixer reads the decoder thread hadn't decoded yet
+	int						seeks;				// mixer reads outside of the ring
+	int						chunks;				// chunks decoded by the decoder thread
+	double					decodeMsec;			// time spent decoding chunks
+} decoderStats_t;
+
 idBlockAlloc<idSampleDecoderLocal, 64>		sampleDecoderAllocator;
 
+static idList<idSampleDecoderLocal *>		prefetchDecoders;
+static decoderStats_t						decoderStats;
+static xthreadInfo							decoderThread;
+static bool									decoderThreadRunning = false;
+static volatile bool						decoderThreadQuit = false;
+
+/*
+====================
+DecoderThread
+====================
+*/
+static int DecoderThread( void *parms ) {
+	static float chunk[DECODER_CHUNK_SAMPLES];
+
+	while ( !decoderThreadQuit ) {
+		// sleep until the mixer used some of the decoded samples
+		if ( !idSampleDecoderLocal::FillNextRing( chunk ) ) {
+			Sys_WaitForEvent( TRIGGER_EVENT_ONE );
+		}
+	}
+	return 0;
+}
+
 /*
 ====================
 idSampleDecoder::Init
@@ -319,6 +395,14 @@ void idSampleDecoder::Init( void ) {
 	decoderMemoryAllocator.Init();
 	decoderMemoryAllocator.SetLockMemory( true );
 	decoderMemoryAllocator.SetFixedBlocks( idSoundSystemLocal::s_realTimeDecoding.GetBool() ? 10 : 1 );
+
+	memset( &decoderStats, 0, sizeof( decoderStats ) );
+
+	if ( idSoundSystemLocal::s_realTimeDecoding.GetBool() && idSoundSystemLocal::s_decoderThread.GetBool() && !decoderThreadRunning ) {
+		decoderThreadQuit = false;
+		Sys_CreateThread( DecoderThread, NULL, decoderThread, "SoundDecoder" );
+		decoderThreadRunning = true;
+	}
 }
 
 /*
@@ -327,10 +411,55 @@ idSampleDecoder::Shutdown
 ====================
 */
 void idSampleDecoder::Shutdown( void ) {
+	StopThread();
+	prefetchDecoders.Clear();
 	decoderMemoryAllocator.Shutdown();
 	sampleDecoderAllocator.Shutdown();
 }
 
+/*
+====================
+idSampleDecoder::StopThread
+
+Has to be called before the sound samples are freed.
+====================
+*/
+void idSampleDecoder::StopThread( void ) {
+	if ( !decoderThreadRunning ) {
+		return;
+	}
+	decoderThreadQuit = true;
+	Sys_TriggerEvent( TRIGGER_EVENT_ONE );
+	Sys_DestroyThread( decoderThread );
+	decoderThreadRunning = false;
+}
+
+/*
+====================
+idSampleDecoder::PrintStats
+====================
+*/
+void idSampleDecoder::PrintStats( void ) {
+	decoderStats_t stats;
+	int numPrefetching;
+
+	Sys_EnterCriticalSection( CRITICAL_SECTION_ONE );
+	numPrefetching = prefetchDecoders.Num();
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_ONE );
+
+	Sys_EnterCriticalSection( CRITICAL_SECTION_THREE );
+	stats = decoderStats;
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_THREE );
+
+	if ( !decoderThreadRunning ) {
+		common->Printf( "decoder thread not running\n" );
+		return;
+	}
+	common->Printf( "%d decoders prefetching, %d kB per ring\n", numPrefetching, DECODER_RING_SAMPLES * (int)sizeof( float ) >> 10 );
+	common->Printf( "%d mixer reads from rings, %d underruns, %d seeks\n", stats.ringReads, stats.underruns, stats.seeks );
+	common->Printf( "%d chunks decoded in %1.1f msec (%1.3f msec per chunk)\n", stats.chunks, stats.decodeMsec, stats.chunks ? stats.decodeMsec / stats.chunks : 0.0 );
+}
+
 /*
 ====================
 idSampleDecoder::Alloc
@@ -383,6 +512,19 @@ void idSampleDecoderLocal::Clear( void ) {
 	lastSampleOffset = 0;
 	lastDecodeTime = 0;
 	stbv = NULL;
+	looping = false;
+	ring = NULL;
+	ringStart = 0;
+	ringRead = 0;
+	ringCount = 0;
+	ringGeneration = 0;
+	ringStalled = false;
+	ringBusy = false;
+	ringStbv = NULL;
+	ringStbvOffset = 0;
+	amplitudeStbv = NULL;
+	amplitudeSample = NULL;
+	amplitudeStbvOffset = 0;
 }
 
 /*
@@ -398,13 +540,20 @@ void idSampleDecoderLocal::ClearDecoder( void ) {
 			break;
 		}
 		case WAVE_FORMAT_TAG_OGG: {
+			StopPrefetch();
 			stb_vorbis_close( stbv );
 			stbv = NULL;
 			break;
 		}
 	}
+	if ( amplitudeStbv != NULL ) {
+		stb_vorbis_close( amplitudeStbv );
+	}
 
+	// the looping flag is set by the channel before decoding a new sample
+	bool loop = looping;
 	Clear();
+	looping = loop;
 
 	Sys_LeaveCriticalSection( CRITICAL_SECTION_ONE );
 }
@@ -427,6 +576,280 @@ int idSampleDecoderLocal::GetLastDecodeTime( void ) const {
 	return lastDecodeTime;
 }
 
+/*
+====================
+idSampleDecoderLocal::SetLooping
+
+The decoder thread continues at the start of looping samples.
+====================
+*/
+void idSampleDecoderLocal::SetLooping( bool loop ) {
+	if ( loop == looping ) {
+		return;
+	}
+	Sys_EnterCriticalSection( CRITICAL_SECTION_THREE );
+	looping = loop;
+	if ( ring != NULL ) {
+		ringCount = 0;
+		ringGeneration++;
+		ringStalled = false;
+	}
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_THREE );
+}
+
+/*
+====================
+idSampleDecoderLocal::StartPrefetch
+
+Called with CRITICAL_SECTION_ONE held when an OggVorbis sample is opened.
+====================
+*/
+void idSampleDecoderLocal::StartPrefetch( void ) {
+	if ( !decoderThreadRunning ) {
+		return;
+	}
+	int stbVorbErr = 0;
+	stb_vorbis *newStbv = stb_vorbis_open_memory( lastSample->nonCacheData, lastSample->objectMemSize, &stbVorbErr, NULL );
+	if ( newStbv == NULL ) {
+		return;
+	}
+	float *newRing = (float *)decoderMemoryAllocator.Alloc( DECODER_RING_SAMPLES * sizeof( float ) );
+	if ( newRing == NULL ) {
+		stb_vorbis_close( newStbv );
+		return;
+	}
+	ringStbv = newStbv;
+	ringStbvOffset = 0;
+	Sys_EnterCriticalSection( CRITICAL_SECTION_THREE );
+	ring = newRing;
+	ringStart = 0;
+	ringRead = 0;
+	ringCount = 0;
+	ringGeneration++;
+	ringStalled = false;
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_THREE );
+	prefetchDecoders.Append( this );
+}
+
+/*
+====================
+idSampleDecoderLocal::StopPrefetch
+
+Called with CRITICAL_SECTION_ONE held.
+====================
+*/
+void idSampleDecoderLocal::StopPrefetch( void ) {
+	if ( ring == NULL ) {
+		return;
+	}
+	prefetchDecoders.Remove( this );
+
+	// wait for a chunk the decoder thread is still decoding,
+	// it only needs CRITICAL_SECTION_THREE to publish it
+	float *oldRing;
+	while( 1 ) {
+		Sys_EnterCriticalSection( CRITICAL_SECTION_THREE );
+		if ( !ringBusy ) {
+			oldRing = ring;
+			ring = NULL;
+			ringCount = 0;
+			Sys_LeaveCriticalSection( CRITICAL_SECTION_THREE );
+			break;
+		}
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_THREE );
+		Sys_Sleep( 1 );
+	}
+	decoderMemoryAllocator.Free( (byte *)oldRing );
+	stb_vorbis_close( ringStbv );
+	ringStbv = NULL;
+}
+
+/*
+====================
+idSampleDecoderLocal::ReadRing
+
+Called with CRITICAL_SECTION_THREE held. Samples in the ring before the
+requested offset are skipped, returns false if not all requested samples
+have been decoded yet.
+====================
+*/
+bool idSampleDecoderLocal::ReadRing( int sampleOffset44k, int sampleCount44k, float *dest ) {
+	if ( ring == NULL ) {
+		return false;
+	}
+
+	const int length = lastSample->LengthIn44kHzSamples();
+	int skip = sampleOffset44k - ringStart;
+	if ( looping && length > 0 ) {
+		skip %= length;
+		if ( skip < 0 ) {
+			skip += length;
+		}
+	}
+
+	if ( skip < 0 || skip + sampleCount44k > ringCount ) {
+		if ( skip == 0 ) {
+			decoderStats.underruns++;
+		} else {
+			decoderStats.seeks++;
+		}
+		return false;
+	}
+
+	int first = ( ringRead + skip ) % DECODER_RING_SAMPLES;
+	int count = Min( sampleCount44k, DECODER_RING_SAMPLES - first );
+	memcpy( dest, ring + first, count * sizeof( dest[0] ) );
+	memcpy( dest + count, ring, ( sampleCount44k - count ) * sizeof( dest[0] ) );
+
+	ringRead = ( first + sampleCount44k ) % DECODER_RING_SAMPLES;
+	ringCount -= skip + sampleCount44k;
+	ringStart = sampleOffset44k + sampleCount44k;
+	if ( looping && length > 0 ) {
+		ringStart %= length;
+	}
+
+	decoderStats.ringReads++;
+	return true;
+}
+
+/*
+====================
+idSampleDecoderLocal::WriteRing
+
+Called with CRITICAL_SECTION_THREE held.
+====================
+*/
+void idSampleDecoderLocal::WriteRing( const float *src, int sampleCount44k ) {
+	assert( ringCount + sampleCount44k <= DECODER_RING_SAMPLES );
+
+	int first = ( ringRead + ringCount ) % DECODER_RING_SAMPLES;
+	int count = Min( sampleCount44k, DECODER_RING_SAMPLES - first );
+	memcpy( ring + first, src, count * sizeof( src[0] ) );
+	memcpy( ring, src + count, ( sampleCount44k - count ) * sizeof( src[0] ) );
+
+	ringCount += sampleCount44k;
+}
+
+/*
+====================
+idSampleDecoderLocal::RestartRing
+
+Called with CRITICAL_SECTION_ONE held after the mixer decoded by itself,
+the decoder thread continues where the mixer stopped.
+====================
+*/
+void idSampleDecoderLocal::RestartRing( int sampleOffset44k ) {
+	Sys_EnterCriticalSection( CRITICAL_SECTION_THREE );
+	if ( ring != NULL ) {
+		const int length = lastSample->LengthIn44kHzSamples();
+		ringStart = ( looping && length > 0 ) ? sampleOffset44k % length : sampleOffset44k;
+		ringRead = 0;
+		ringCount = 0;
+		ringGeneration++;
+		ringStalled = false;
+	}
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_THREE );
+}
+
+/*
+====================
+idSampleDecoderLocal::RingEnd
+
+Called with CRITICAL_SECTION_THREE held, returns the offset of the sample after the ring.
+====================
+*/
+int idSampleDecoderLocal::RingEnd( void ) const {
+	const int length = lastSample->LengthIn44kHzSamples();
+	int end = ringStart + ringCount;
+	if ( looping && length > 0 ) {
+		end %= length;
+	}
+	return end;
+}
+
+/*
+====================
+idSampleDecoderLocal::FillNextRing
+
+Called from the decoder thread. Decodes the next chunk for the recently
+used ring with the fewest decoded samples, returns false if all rings are
+full or not in use. The decoder is marked busy while the chunk is decoded
+without holding a lock, so StopPrefetch() waits for it before it closes
+the handle.
+====================
+*/
+bool idSampleDecoderLocal::FillNextRing( float *chunk ) {
+	idSampleDecoderLocal *best = NULL;
+	int bestStart = 0;
+	int generation = 0;
+
+	// protects the list of prefetching decoders
+	Sys_EnterCriticalSection( CRITICAL_SECTION_ONE );
+
+	const int time = soundSystemLocal.CurrentSoundTime;
+
+	Sys_EnterCriticalSection( CRITICAL_SECTION_THREE );
+	for ( int i = 0; i < prefetchDecoders.Num(); i++ ) {
+		idSampleDecoderLocal *decoder = prefetchDecoders[i];
+		if ( decoder->failed || decoder->ringStalled || time - decoder->lastDecodeTime > DECODER_ACTIVE_TIME ) {
+			continue;
+		}
+		if ( decoder->ringCount > DECODER_RING_SAMPLES - DECODER_CHUNK_SAMPLES ) {
+			continue;
+		}
+		int start = decoder->RingEnd();
+		if ( start >= decoder->lastSample->LengthIn44kHzSamples() ) {
+			if ( !decoder->looping ) {
+				continue;
+			}
+			start = 0;
+		}
+		// prefer the emptiest ring, then the one the mixer read last
+		if ( best == NULL || decoder->ringCount < best->ringCount ||
+				( decoder->ringCount == best->ringCount && decoder->lastDecodeTime > best->lastDecodeTime ) ) {
+			best = decoder;
+			bestStart = start;
+			generation = decoder->ringGeneration;
+		}
+	}
+	if ( best != NULL ) {
+		best->ringBusy = true;
+	}
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_THREE );
+
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_ONE );
+
+	if ( best == NULL ) {
+		return false;
+	}
+
+	idSoundSample *sample = best->lastSample;
+	int count = Min( DECODER_CHUNK_SAMPLES, sample->LengthIn44kHzSamples() - bestStart );
+
+	bool error = false;
+	double startMsec = Sys_MillisecondsPrecise();
+	int readSamples44k = DecodeOGGSamples( best->ringStbv, best->ringStbvOffset, sample, bestStart, count, chunk, error );
+	double decodeMsec = Sys_MillisecondsPrecise() - startMsec;
+
+	Sys_EnterCriticalSection( CRITICAL_SECTION_THREE );
+	// the ring may have been restarted by SetLooping() or the mixer while decoding
+	if ( generation == best->ringGeneration ) {
+		if ( readSamples44k > 0 ) {
+			best->WriteRing( chunk, readSamples44k );
+		}
+		// the mixer decodes by itself from here and notices errors
+		if ( error || readSamples44k < count ) {
+			best->ringStalled = true;
+		}
+	}
+	best->ringBusy = false;
+	decoderStats.chunks++;
+	decoderStats.decodeMsec += decodeMsec;
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_THREE );
+
+	return true;
+}
+
 /*
 ====================
 idSampleDecoderLocal::Decode
@@ -446,7 +869,18 @@ void idSampleDecoderLocal::Decode( idSoundSample *sample, int sampleOffset44k, i
 		return;
 	}
 
-	// samples can be decoded both from the sound thread and the main thread for shakes
+	if ( ring != NULL ) {
+		Sys_EnterCriticalSection( CRITICAL_SECTION_THREE );
+		bool ready = ReadRing( sampleOffset44k, sampleCount44k, dest );
+		Sys_LeaveCriticalSection( CRITICAL_SECTION_THREE );
+
+		if ( ready ) {
+			Sys_TriggerEvent( TRIGGER_EVENT_ONE );
+			return;
+		}
+	}
+
+	// the decoder can be cleared from the main thread while the sound thread decodes
 	Sys_EnterCriticalSection( CRITICAL_SECTION_ONE );
 
 	switch( sample->objectInfo.wFormatTag ) {
@@ -456,6 +890,10 @@ void idSampleDecoderLocal::Decode( idSoundSample *sample, int sampleOffset44k, i
 		}
 		case WAVE_FORMAT_TAG_OGG: {
 			readSamples44k = DecodeOGG( sample, sampleOffset44k, sampleCount44k, dest );
+			// let the decoder thread continue from here
+			if ( ring != NULL ) {
+				RestartRing( sampleOffset44k + readSamples44k );
+			}
 			break;
 		}
 		default: {
@@ -466,6 +904,63 @@ void idSampleDecoderLocal::Decode( idSoundSample *sample, int sampleOffset44k, i
 
 	Sys_LeaveCriticalSection( CRITICAL_SECTION_ONE );
 
+	if ( ring != NULL ) {
+		Sys_TriggerEvent( TRIGGER_EVENT_ONE );
+	}
+
+	if ( readSamples44k < sampleCount44k ) {
+		memset( dest + readSamples44k, 0, ( sampleCount44k - readSamples44k ) * sizeof( dest[0] ) );
+	}
+}
+
+/*
+====================
+idSampleDecoderLocal::DecodeAmplitude
+
+Called from the main thread for screen shakes and sound driven lights.
+Decodes with a handle of its own, so the mixer's handle and the ring
+aren't moved to the position of the query.
+====================
+*/
+void idSampleDecoderLocal::DecodeAmplitude( idSoundSample *sample, int sampleOffset44k, int sampleCount44k, float *dest ) {
+	int readSamples44k = 0;
+	bool error = false;
+
+	// the decoder can be cleared by the sound thread
+	Sys_EnterCriticalSection( CRITICAL_SECTION_ONE );
+
+	if ( !failed || sample != lastSample ) {
+		switch( sample->objectInfo.wFormatTag ) {
+			case WAVE_FORMAT_TAG_PCM: {
+				if ( sample->nonCacheData != NULL ) {
+					readSamples44k = DecodePCMSamples( sample, sampleOffset44k, sampleCount44k, dest, error );
+				}
+				break;
+			}
+			case WAVE_FORMAT_TAG_OGG: {
+				if ( amplitudeSample != sample ) {
+					if ( amplitudeStbv != NULL ) {
+						stb_vorbis_close( amplitudeStbv );
+						amplitudeStbv = NULL;
+					}
+					amplitudeSample = NULL;
+					if ( sample->nonCacheData != NULL ) {
+						int stbVorbErr = 0;
+						amplitudeStbv = stb_vorbis_open_memory( sample->nonCacheData, sample->objectMemSize, &stbVorbErr, NULL );
+						amplitudeSample = sample;
+						amplitudeStbvOffset = 0;
+					}
+				}
+				if ( amplitudeStbv != NULL ) {
+					readSamples44k = DecodeOGGSamples( amplitudeStbv, amplitudeStbvOffset, sample, sampleOffset44k, sampleCount44k, dest, error );
+				}
+				break;
+			}
+		}
+	}
+
+	Sys_LeaveCriticalSection( CRITICAL_SECTION_ONE );
+
 	if ( readSamples44k < sampleCount44k ) {
 		memset( dest + readSamples44k, 0, ( sampleCount44k - readSamples44k ) * sizeof( dest[0] ) );
 	}
@@ -477,12 +972,21 @@ idSampleDecoderLocal::DecodePCM
 ====================
 */
 int idSampleDecoderLocal::DecodePCM( idSoundSample *sample, int sampleOffset44k, int sampleCount44k, float *dest ) {
-	const byte *first;
-	int pos, size, readSamples;
-
 	lastFormat = WAVE_FORMAT_TAG_PCM;
 	lastSample = sample;
 
+	return DecodePCMSamples( sample, sampleOffset44k, sampleCount44k, dest, failed );
+}
+
+/*
+====================
+idSampleDecoderLocal::DecodePCMSamples
+====================
+*/
+int idSampleDecoderLocal::DecodePCMSamples( idSoundSample *sample, int sampleOffset44k, int sampleCount44k, float *dest, bool &error ) {
+	const byte *first;
+	int pos, size, readSamples;
+
 	int shift = 22050 / sample->objectInfo.nSamplesPerSec;
 	int sampleOffset = sampleOffset44k >> shift;
 	int sampleCount = sampleCount44k >> shift;
@@ -491,12 +995,12 @@ int idSampleDecoderLocal::DecodePCM( idSoundSample *sample, int sampleOffset44k,
 		//assert( false );	// this should never happen ( note: I've seen that happen with the main thread down in idGameLocal::MapClear clearing entities - TTimo )
 		// DG: see comment in DecodeOGG()
 		common->Warning( "Called idSampleDecoderLocal::DecodePCM() on idSoundSample '%s' without nonCacheData\n", sample->name.c_str() );
-		failed = true;
+		error = true;
 		return 0;
 	}
 
 	if ( !sample->FetchFromCache( sampleOffset * sizeof( short ), &first, &pos, &size, false ) ) {
-		failed = true;
+		error = true;
 		return 0;
 	}
 
@@ -518,12 +1022,6 @@ idSampleDecoderLocal::DecodeOGG
 ====================
 */
 int idSampleDecoderLocal::DecodeOGG( idSoundSample *sample, int sampleOffset44k, int sampleCount44k, float *dest ) {
-	int readSamples, totalSamples;
-
-	int shift = 22050 / sample->objectInfo.nSamplesPerSec;
-	int sampleOffset = sampleOffset44k >> shift;
-	int sampleCount = sampleCount44k >> shift;
-
 	// open OGG file if not yet opened
 	if ( lastSample == NULL ) {
 		// make sure there is enough space for another decoder
@@ -557,30 +1055,49 @@ int idSampleDecoderLocal::DecodeOGG( idSoundSample *sample, int sampleOffset44k,
 		}
 		lastFormat = WAVE_FORMAT_TAG_OGG;
 		lastSample = sample;
+		StartPrefetch();
 	}
 
+	return DecodeOGGSamples( stbv, lastSampleOffset, sample, sampleOffset44k, sampleCount44k, dest, failed );
+}
+
+/*
+====================
+idSampleDecoderLocal::DecodeOGGSamples
+
+Decodes with the given handle, handleOffset is the sample offset the
+handle is at and avoids seeking when decoding continues from there.
+====================
+*/
+int idSampleDecoderLocal::DecodeOGGSamples( stb_vorbis *handle, int &handleOffset, idSoundSample *sample, int sampleOffset44k, int sampleCount44k, float *dest, bool &error ) {
+	int readSamples, totalSamples;
+
+	int shift = 22050 / sample->objectInfo.nSamplesPerSec;
+	int sampleOffset = sampleOffset44k >> shift;
+	int sampleCount = sampleCount44k >> shift;
+
 	if( sample->objectInfo.nChannels > 2 ) {
 		assert( 0 && ">2 channels currently not supported (samplesBuf expects 1 or 2)" );
 		common->Warning( "Ogg Vorbis files with >2 channels are not supported!\n" );
 		// no idea if other parts of the engine support more than stereo;
 		// pretty sure though the standard gamedata doesn't use it (positional sounds must be mono anyway)
-		failed = true;
+		error = true;
 		return 0;
 	}
 
 	// seek to the right offset if necessary
-	if ( sampleOffset != lastSampleOffset ) {
-		if ( stb_vorbis_seek( stbv, sampleOffset / sample->objectInfo.nChannels ) == 0 ) {
-			int stbVorbErr = stb_vorbis_get_error( stbv );
+	if ( sampleOffset != handleOffset ) {
+		if ( stb_vorbis_seek( handle, sampleOffset / sample->objectInfo.nChannels ) == 0 ) {
+			int stbVorbErr = stb_vorbis_get_error( handle );
 			int offset = sampleOffset / sample->objectInfo.nChannels;
 			common->Warning( "idSampleDecoderLocal::DecodeOGG() stb_vorbis_seek(%d) for %s failed: %s\n",
 			                 offset, sample->name.c_str(), my_stbv_strerror( stbVorbErr ) );
-			failed = true;
+			error = true;
 			return 0;
 		}
 	}
 
-	lastSampleOffset = sampleOffset;
+	handleOffset = sampleOffset;
 
 	// decode OGG samples
 	totalSamples = sampleCount;
@@ -591,7 +1108,7 @@ int idSampleDecoderLocal::DecodeOGG( idSoundSample *sample, int sampleOffset44k,
 		float samplesBuf[2][MIXBUFFER_SAMPLES];
 		float* samples[2] = { samplesBuf[0], samplesBuf[1] };
 		int reqSamples = Min( MIXBUFFER_SAMPLES, totalSamples / sample->objectInfo.nChannels );
-		int ret = stb_vorbis_get_samples_float( stbv, sample->objectInfo.nChannels, samples, reqSamples );
+		int ret = stb_vorbis_get_samples_float( handle, sample->objectInfo.nChannels, samples, reqSamples );
 		if ( reqSamples == 0 ) {
 			// DG: it happened that sampleCount was an odd number in a *stereo* sound file
 			//  and eventually totalSamples was 1 and thus reqSamples = totalSamples/2 was 0
@@ -603,7 +1120,7 @@ int idSampleDecoderLocal::DecodeOGG( idSoundSample *sample, int sampleOffset44k,
 			break;
 		}
 		if ( ret == 0 ) {
-			int stbVorbErr = stb_vorbis_get_error( stbv );
+			int stbVorbErr = stb_vorbis_get_error( handle );
 			if ( stbVorbErr == VORBIS__no_error && reqSamples < 5 ) {
 				// DG: it sometimes happens that 0 is returned when reqSamples was 1 and there is no error.
 				// don't really know why; I'll just (arbitrarily) accept up to 5 "dropped" samples
@@ -613,12 +1130,12 @@ int idSampleDecoderLocal::DecodeOGG( idSoundSample *sample, int sampleOffset44k,
 			} else {
 				common->Warning( "idSampleDecoderLocal::DecodeOGG() stb_vorbis_get_samples_float() %d (%d) samples\n  for %s failed: %s\n",
 					reqSamples, totalSamples, sample->name.c_str(), my_stbv_strerror( stbVorbErr ) );
-				failed = true;
+				error = true;
 				break;
 			}
 		}
 		if ( ret < 0 ) {
-			failed = true;
+			error = true;
 			return 0;
 		}
 		ret *= sample->objectInfo.nChannels;
@@ -629,7 +1146,7 @@ int idSampleDecoderLocal::DecodeOGG( idSoundSample *sample, int sampleOffset44k,
 		totalSamples -= ret;
 	} while( totalSamples > 0 );
 
-	lastSampleOffset += readSamples;
+	handleOffset += readSamples;
 
 	return ( readSamples << shift );
 }
@@ -257,10 +257,11 @@ idSoundChannel::GatherChannelSamples
 
 Will always return 44kHz samples for the given range, even if it deeply looped or
 out of the range of the unlooped samples.  Handles looping between multiple different
-samples and leadins
+samples and leadins.  Amplitude queries from the main thread decode
+separately from the mixer.
 ===================
 */
-void idSoundChannel::GatherChannelSamples( int sampleOffset44k, int sampleCount44k, float *dest ) const {
+void idSoundChannel::GatherChannelSamples( int sampleOffset44k, int sampleCount44k, float *dest, bool amplitude ) const {
 	float	*dest_p = dest;
 	int		len;
 
@@ -292,7 +293,12 @@ void idSoundChannel::GatherChannelSamples( int sampleOffset44k, int sampleCount4
 		}
 
 		// decode the sample
-		decoder->Decode( leadin, sampleOffset44k, len, dest_p );
+		if ( amplitude ) {
+			decoder->DecodeAmplitude( leadin, sampleOffset44k, len, dest_p );
+		} else {
+			decoder->SetLooping( soundShader && ( parms.soundShaderFlags & SSF_LOOPING ) && soundShader->entries[0] == leadin );
+			decoder->Decode( leadin, sampleOffset44k, len, dest_p );
+		}
 
 		dest_p += len;
 		sampleCount44k -= len;
@@ -326,7 +332,12 @@ void idSoundChannel::GatherChannelSamples( int sampleOffset44k, int sampleCount4
 		}
 
 		// decode the sample
-		decoder->Decode( loop, sampleOffset44k, len, dest_p );
+		if ( amplitude ) {
+			decoder->DecodeAmplitude( loop, sampleOffset44k, len, dest_p );
+		} else {
+			decoder->SetLooping( true );
+			decoder->Decode( loop, sampleOffset44k, len, dest_p );
+		}
 
 		dest_p += len;
 		sampleCount44k -= len;
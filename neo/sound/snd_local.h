@@ -412,7 +412,7 @@ public:
 	void				Clear( void );
 	void				Start( void );
 	void				Stop( void );
-	void				GatherChannelSamples( int sampleOffset44k, int sampleCount44k, float *dest ) const;
+	void				GatherChannelSamples( int sampleOffset44k, int sampleCount44k, float *dest, bool amplitude = false ) const;
 	void				ALStop( void );			// free OpenAL resources if any
 
 	bool				triggerState;
@@ -848,6 +848,7 @@ public:
 	static idCVar			s_force22kHz;
 	static idCVar			s_clipVolumes;
 	static idCVar			s_realTimeDecoding;
+	static idCVar			s_decoderThread;
 	static idCVar			s_useEAXReverb;
 	static idCVar			s_decompressionLimit;
 
@@ -926,16 +927,21 @@ class idSampleDecoder {
 public:
 	static void				Init( void );
 	static void				Shutdown( void );
+	static void				StopThread( void );
 	static idSampleDecoder *Alloc( void );
 	static void				Free( idSampleDecoder *decoder );
 	static int				GetNumUsedBlocks( void );
 	static int				GetUsedBlockMemory( void );
+	static void				PrintStats( void );
 
 	virtual					~idSampleDecoder( void ) {}
 	virtual void			Decode( idSoundSample *sample, int sampleOffset44k, int sampleCount44k, float *dest ) = 0;
 	virtual void			ClearDecoder( void ) = 0;
 	virtual idSoundSample *	GetSample( void ) const = 0;
 	virtual int				GetLastDecodeTime( void ) const = 0;
+	virtual void			SetLooping( bool loop ) = 0;
+							// for amplitude queries from the main thread, doesn't disturb the mixer's decoding
+	virtual void			DecodeAmplitude( idSoundSample *sample, int sampleOffset44k, int sampleCount44k, float *dest ) = 0;
 };
 
 
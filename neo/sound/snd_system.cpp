@@ -27,6 +27,7 @@ If you have questions concerning this license or the applicable additional terms
 */
 
 #include "sys/platform.h"
+#include "idlib/math/Simd_Generic.h"
 
 #include "sound/snd_local.h"
 #include <limits.h>
@@ -61,6 +62,7 @@ idCVar idSoundSystemLocal::s_numberOfSpeakers( "s_numberOfSpeakers", "2", CVAR_S
 idCVar idSoundSystemLocal::s_force22kHz( "s_force22kHz", "0", CVAR_SOUND | CVAR_BOOL, ""  );
 idCVar idSoundSystemLocal::s_clipVolumes( "s_clipVolumes", "1", CVAR_SOUND | CVAR_BOOL, ""  );
 idCVar idSoundSystemLocal::s_realTimeDecoding( "s_realTimeDecoding", "1", CVAR_SOUND | CVAR_BOOL | CVAR_INIT, "" );
+idCVar idSoundSystemLocal::s_decoderThread( "s_decoderThread", "1", CVAR_SOUND | CVAR_BOOL | CVAR_INIT, "decode streamed ogg sounds ahead of the mixer in a separate thread" );
 
 idCVar idSoundSystemLocal::s_slowAttenuate( "s_slowAttenuate", "1", CVAR_SOUND | CVAR_BOOL, "slowmo sounds attenuate over shorted distance" );
 idCVar idSoundSystemLocal::s_enviroSuitCutoffFreq( "s_enviroSuitCutoffFreq", "2000", CVAR_SOUND | CVAR_FLOAT, "" );
@@ -286,6 +288,7 @@ void ListSoundDecoders_f( const idCmdArgs &args ) {
 	common->Printf( "%d waiting decoders\n", numWaitingDecoders );
 	common->Printf( "%d active decoders\n", numActiveDecoders );
 	common->Printf( "%d kB decoder memory in %d blocks\n", idSampleDecoder::GetUsedBlockMemory() >> 10, idSampleDecoder::GetNumUsedBlocks() );
+	idSampleDecoder::PrintStats();
 }
 
 /*
@@ -321,6 +324,109 @@ void SoundSystemRestart_f( const idCmdArgs &args ) {
 	soundSystem->SetMute( false );
 }
 
+/*
+===============
+SoundMixBench_f
+
+  mixes synthetic channels the way the software mixer does, with the generic code and
+  the current SIMD processor, and prints the time per 44kHz block. No sound device is needed.
+===============
+*/
+void SoundMixBench_f( const idCmdArgs &args ) {
+	const int numChannels = ( args.Argc() > 1 ) ? atoi( args.Argv( 1 ) ) : 32;
+	const int numSpeakers = ( args.Argc() > 2 ) ? atoi( args.Argv( 2 ) ) : 2;
+	const int numBlocks = ( args.Argc() > 3 ) ? atoi( args.Argv( 3 ) ) : 100;
+	int i, p, b, c;
+
+	if ( numChannels < 1 || ( numSpeakers != 2 && numSpeakers != 6 ) || numBlocks < 1 ) {
+		common->Printf( "usage: soundMixBench [numChannels] [numSpeakers 2 or 6] [numBlocks]\n" );
+		return;
+	}
+
+	idSIMD_Generic generic;
+	idSIMDProcessor *processors[2] = { &generic, SIMDProcessor };
+
+	// every channel reads the same noise from a different offset
+	const int numPCM = MIXBUFFER_SAMPLES * 2 + numChannels * 16;
+	short *pcm = (short *)Mem_Alloc16( numPCM * sizeof( short ) );
+	float *input = (float *)Mem_Alloc16( MIXBUFFER_SAMPLES * 2 * sizeof( float ) );
+	float *mix = (float *)Mem_Alloc16( MIXBUFFER_SAMPLES * 6 * sizeof( float ) );
+	short *out[2];
+	out[0] = (short *)Mem_Alloc16( MIXBUFFER_SAMPLES * 6 * sizeof( short ) );
+	out[1] = (short *)Mem_Alloc16( MIXBUFFER_SAMPLES * 6 * sizeof( short ) );
+
+	unsigned int seed = 1;
+	for ( i = 0; i < numPCM; i++ ) {
+		seed = seed * 1664525 + 1013904223;
+		pcm[i] = (short)( seed >> 16 ) / 4;
+	}
+
+	common->Printf( "soundMixBench: %d channels, %d speakers, %d blocks of %d samples\n", numChannels, numSpeakers, numBlocks, MIXBUFFER_SAMPLES );
+
+	for ( p = 0; p < 2; p++ ) {
+		idSIMDProcessor *proc = processors[p];
+		double upSampleTime = 0.0, mixTime = 0.0, convertTime = 0.0;
+
+		for ( b = 0; b < numBlocks; b++ ) {
+			proc->Memset( mix, 0, MIXBUFFER_SAMPLES * numSpeakers * sizeof( float ) );
+
+			for ( c = 0; c < numChannels; c++ ) {
+				// a quarter of the channels is stereo, half of them is 22kHz
+				const int numSampleChannels = ( ( c & 3 ) == 3 ) ? 2 : 1;
+				const int kHz = ( c & 1 ) ? 22050 : 44100;
+				const int numSamples = MIXBUFFER_SAMPLES * numSampleChannels * kHz / 44100;
+				float lastV[6], currentV[6];
+
+				for ( i = 0; i < 6; i++ ) {
+					lastV[i] = 0.1f * ( ( c + i + b ) % 8 );
+					currentV[i] = 0.1f * ( ( c + i + b + 1 ) % 8 );
+				}
+
+				double start = Sys_MillisecondsPrecise();
+				proc->UpSamplePCMTo44kHz( input, pcm + c * 16, numSamples, kHz, numSampleChannels );
+				double upSampled = Sys_MillisecondsPrecise();
+
+				if ( numSpeakers == 6 ) {
+					if ( numSampleChannels == 1 ) {
+						proc->MixSoundSixSpeakerMono( mix, input, MIXBUFFER_SAMPLES, lastV, currentV );
+					} else {
+						proc->MixSoundSixSpeakerStereo( mix, input, MIXBUFFER_SAMPLES, lastV, currentV );
+					}
+				} else {
+					if ( numSampleChannels == 1 ) {
+						proc->MixSoundTwoSpeakerMono( mix, input, MIXBUFFER_SAMPLES, lastV, currentV );
+					} else {
+						proc->MixSoundTwoSpeakerStereo( mix, input, MIXBUFFER_SAMPLES, lastV, currentV );
+					}
+				}
+
+				upSampleTime += upSampled - start;
+				mixTime += Sys_MillisecondsPrecise() - upSampled;
+			}
+
+			double start = Sys_MillisecondsPrecise();
+			proc->MixedSoundToSamples( out[p], mix, MIXBUFFER_SAMPLES * numSpeakers );
+			convertTime += Sys_MillisecondsPrecise() - start;
+		}
+
+		const double usec = 1000.0 / numBlocks;
+		common->Printf( "%-28s %8.1f us per block (upsample %.1f, mix %.1f, convert %.1f)\n", proc->GetName(),
+						( upSampleTime + mixTime + convertTime ) * usec, upSampleTime * usec, mixTime * usec, convertTime * usec );
+	}
+
+	int maxDiff = 0;
+	for ( i = 0; i < MIXBUFFER_SAMPLES * numSpeakers; i++ ) {
+		maxDiff = Max( maxDiff, abs( out[0][i] - out[1][i] ) );
+	}
+	common->Printf( "largest difference of the last block: %d\n", maxDiff );
+
+	Mem_Free16( pcm );
+	Mem_Free16( input );
+	Mem_Free16( mix );
+	Mem_Free16( out[0] );
+	Mem_Free16( out[1] );
+}
+
 // DG: make this function callable from idSessionLocal::Frame() without having to
 // change the public idSoundSystem interface - that would break mod DLL compat,
 // and this is not relevant for gamecode.
@@ -554,6 +660,7 @@ void idSoundSystemLocal::Init() {
 	cmdSystem->AddCommand( "reloadSounds", SoundReloadSounds_f, CMD_FL_SOUND|CMD_FL_CHEAT, "reloads all sounds" );
 	cmdSystem->AddCommand( "testSound", TestSound_f, CMD_FL_SOUND | CMD_FL_CHEAT, "tests a sound", idCmdSystem::ArgCompletion_SoundName );
 	cmdSystem->AddCommand( "s_restart", SoundSystemRestart_f, CMD_FL_SOUND, "restarts the sound system" );
+	cmdSystem->AddCommand( "soundMixBench", SoundMixBench_f, CMD_FL_SOUND, "measures the software mixer with synthetic channels, usage: soundMixBench [numChannels] [numSpeakers] [numBlocks]" );
 }
 
 /*
@@ -588,6 +695,9 @@ void idSoundSystemLocal::Shutdown() {
 		openalSources[i].looping = false;
 	}
 
+	// the decoder thread reads from the sounds
+	idSampleDecoder::StopThread();
+
 	// destroy all the sounds (hardware buffers as well)
 	delete soundCache;
 	soundCache = NULL;
@@ -660,18 +660,14 @@ void idSoundWorldLocal::AVIUpdate() {
 
 	MixLoop( lastAVI44kHz, numSpeakers, mix_p );
 
+	// clamp all speakers at once, then split them up
+	SIMDProcessor->MixedSoundToSamples( (short *)mix_p, mix_p, MIXBUFFER_SAMPLES * numSpeakers );
+
 	for ( int i = 0; i < numSpeakers; i++ ) {
 		short outD[MIXBUFFER_SAMPLES];
 
 		for( int j = 0; j < MIXBUFFER_SAMPLES; j++ ) {
-			float s = mix_p[ j*numSpeakers + i];
-			if ( s < -32768.0f ) {
-				outD[j] = -32768;
-			} else if ( s > 32767.0f ) {
-				outD[j] = 32767;
-			} else {
-				outD[j] = idMath::FtoiFast( s );
-			}
+			outD[j] = ((short *)mix_p)[ j*numSpeakers + i];
 		}
 		// write to file
 		fpa[i]->Write( outD, MIXBUFFER_SAMPLES*sizeof(short) );
@@ -1911,14 +1907,8 @@ void idSoundWorldLocal::AddChannelContribution( idSoundEmitterLocal *sound, idSo
 
 				for ( j = 0; j < finishedbuffers; j++ ) {
 					chan->GatherChannelSamples( chan->openalStreamingOffset * sample->objectInfo.nChannels, MIXBUFFER_SAMPLES * sample->objectInfo.nChannels, alignedInputSamples );
-					for ( int i = 0; i < ( MIXBUFFER_SAMPLES * sample->objectInfo.nChannels ); i++ ) {
-						if ( alignedInputSamples[i] < -32768.0f )
-							((short *)alignedInputSamples)[i] = -32768;
-						else if ( alignedInputSamples[i] > 32767.0f )
-							((short *)alignedInputSamples)[i] = 32767;
-						else
-							((short *)alignedInputSamples)[i] = idMath::FtoiFast( alignedInputSamples[i] );
-					}
+					// converting in place is fine, the shorts are written behind the floats that are read
+					SIMDProcessor->MixedSoundToSamples( (short *)alignedInputSamples, alignedInputSamples, MIXBUFFER_SAMPLES * sample->objectInfo.nChannels );
 					alBufferData( buffers[j], chan->leadinSample->objectInfo.nChannels == 1 ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16, alignedInputSamples, MIXBUFFER_SAMPLES * sample->objectInfo.nChannels * sizeof( short ), 44100 );
 					chan->openalStreamingOffset += MIXBUFFER_SAMPLES;
 				}
@@ -2166,7 +2156,7 @@ float idSoundWorldLocal::FindAmplitude( idSoundEmitterLocal *sound, const int lo
 				}
 			} else {
 				// get actual sample data
-				chan->GatherChannelSamples( offset, AMPLITUDE_SAMPLES, sourceBuffer );
+				chan->GatherChannelSamples( offset, AMPLITUDE_SAMPLES, sourceBuffer, true );
 			}
 		}
 		activeChannelCount++;
@@ -448,6 +448,9 @@ idPort::idPort
 idPort::idPort() {
 	netSocket = 0;
 	memset( &bound_to, 0, sizeof( bound_to ) );
+	batch = NULL;
+	packetsRead = bytesRead = recvCalls = 0;
+	packetsWritten = bytesWritten = sendCalls = 0;
 }
 
 /*
@@ -459,6 +462,24 @@ idPort::~idPort() {
 	Close();
 }
 
+/*
+==================
+idPort::SetBatching
+
+packets are always sent and read one by one here
+==================
+*/
+void idPort::SetBatching( bool enable ) {
+}
+
+/*
+==================
+idPort::FlushPackets
+==================
+*/
+void idPort::FlushPackets( void ) {
+}
+
 /*
 ==================
 idPort::Close
@@ -469,6 +490,9 @@ void idPort::Close() {
 		CloseSocket(netSocket);
 		netSocket = 0;
 		memset( &bound_to, 0, sizeof( bound_to ) );
+	} else if ( bound_to.type == NA_LOOPBACK ) {
+		Sys_CloseLoopbackPort( bound_to.port );
+		memset( &bound_to, 0, sizeof( bound_to ) );
 	}
 }
 
@@ -482,12 +506,17 @@ bool idPort::GetPacket( netadr_t &net_from, void *data, int &size, int maxSize )
 	struct sockaddr_in from;
 	socklen_t fromlen;
 
+	if ( bound_to.type == NA_LOOPBACK ) {
+		return Sys_GetLoopbackPacket( bound_to.port, net_from, data, size, maxSize );
+	}
+
 	if ( !netSocket ) {
 		return false;
 	}
 
 	fromlen = sizeof( from );
 	ret = recvfrom( netSocket, data, maxSize, 0, (struct sockaddr *) &from, &fromlen );
+	recvCalls++;
 
 	if ( ret == -1 ) {
 		if (errno == EWOULDBLOCK || errno == ECONNREFUSED) {
@@ -515,6 +544,10 @@ bool idPort::GetPacketBlocking( netadr_t &net_from, void *data, int &size, int m
 	struct timeval		tv;
 	int					ret;
 
+	if ( bound_to.type == NA_LOOPBACK ) {
+		return Sys_GetLoopbackPacket( bound_to.port, net_from, data, size, maxSize );
+	}
+
 	if ( !netSocket ) {
 		return false;
 	}
@@ -546,6 +579,7 @@ bool idPort::GetPacketBlocking( netadr_t &net_from, void *data, int &size, int m
 	socklen_t fromlen;
 	fromlen = sizeof( from );
 	ret = recvfrom( netSocket, data, maxSize, 0, (struct sockaddr *)&from, &fromlen );
+	recvCalls++;
 	if ( ret == -1 ) {
 		// there should be no blocking errors once select declares things are good
 		common->DPrintf( "idPort::GetPacketBlocking: %s\n", strerror( errno ) );
@@ -571,6 +605,11 @@ void idPort::SendPacket( const netadr_t to, const void *data, int size ) {
 		return;
 	}
 
+	if ( bound_to.type == NA_LOOPBACK ) {
+		Sys_SendLoopbackPacket( bound_to.port, to, data, size );
+		return;
+	}
+
 	if ( !netSocket ) {
 		return;
 	}
@@ -578,6 +617,7 @@ void idPort::SendPacket( const netadr_t to, const void *data, int size ) {
 	NetadrToSockadr( &to, &addr );
 
 	ret = sendto( netSocket, data, size, 0, (struct sockaddr *) &addr, sizeof(addr) );
+	sendCalls++;
 	if ( ret == -1 ) {
 		common->Printf( "idPort::SendPacket ERROR: to %s: %s\n", Sys_NetAdrToString( to ), strerror( errno ) );
 	}
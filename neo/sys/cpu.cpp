@@ -67,7 +67,7 @@ void Sys_FPU_SetFTZ(bool enable) {
 #else
 
 #if defined(__GNUC__)
-static inline void CPUid(int index, int *a, int *b, int *c, int *d) {
+static inline void CPUid(int index, int subindex, int *a, int *b, int *c, int *d) {
 #if __x86_64__
 #	define REG_b "rbx"
 #	define REG_S "rsi"
@@ -83,7 +83,23 @@ static inline void CPUid(int index, int *a, int *b, int *c, int *d) {
 		"xchg %%" REG_b ", %%" REG_S
 		:	"=a" (*a), "=S" (*b),
 			"=c" (*c), "=d" (*d)
-		: "0" (index));
+		: "0" (index), "2" (subindex));
+}
+
+static inline void CPUid(int index, int *a, int *b, int *c, int *d) {
+	CPUid(index, 0, a, b, c, d);
+}
+
+// reads an extended control register, only valid if CPUID reports OSXSAVE
+static inline long long XGetBV(int index) {
+	unsigned int lo, hi;
+
+	__asm__ volatile
+	(	".byte 0x0f, 0x01, 0xd0"	// xgetbv, spelled out for old assemblers
+		: "=a" (lo), "=d" (hi)
+		: "c" (index));
+
+	return ((long long)hi << 32) | lo;
 }
 #elif defined(_MSC_VER)
 #include <intrin.h>
@@ -98,11 +114,34 @@ static inline void CPUid(int index, int *a, int *b, int *c, int *d) {
 	*c = info[2];
 	*d = info[3];
 }
+
+static inline void CPUid(int index, int subindex, int *a, int *b, int *c, int *d) {
+	int info[4] = { };
+
+	// VS2008 SP1 and up
+	__cpuidex(info, index, subindex);
+
+	*a = info[0];
+	*b = info[1];
+	*c = info[2];
+	*d = info[3];
+}
+
+static inline long long XGetBV(int index) {
+	// VS2010 SP1 and up
+	return _xgetbv(index);
+}
 #else
 #error unsupported compiler
 #endif
 
 #define c_SSE3		(1 << 0)
+#define c_FMA		(1 << 12)
+#define c_OSXSAVE	(1 << 27)
+#define c_AVX		(1 << 28)
+#define b7_AVX2		(1 << 5)
+#define XCR0_SSE	(1 << 1)
+#define XCR0_AVX	(1 << 2)
 #define d_SSE2		(1 << 26)
 #define d_FXSAVE	(1 << 24)
 
@@ -130,6 +169,47 @@ static inline bool HasSSE3() {
 	return (c & c_SSE3) == c_SSE3;
 }
 
+// the AVX registers are only usable if the OS saves them on context switches
+static inline bool HasOSAVX() {
+	int a, b, c, d;
+
+	CPUid(0, &a, &b, &c, &d);
+	if (a < 1)
+		return false;
+
+	CPUid(1, &a, &b, &c, &d);
+	if ((c & (c_OSXSAVE | c_AVX)) != (c_OSXSAVE | c_AVX))
+		return false;
+
+	return (XGetBV(0) & (XCR0_SSE | XCR0_AVX)) == (XCR0_SSE | XCR0_AVX);
+}
+
+static inline bool HasAVX2() {
+	int a, b, c, d;
+
+	if (!HasOSAVX())
+		return false;
+
+	CPUid(0, &a, &b, &c, &d);
+	if (a < 7)
+		return false;
+
+	CPUid(7, 0, &a, &b, &c, &d);
+
+	return (b & b7_AVX2) == b7_AVX2;
+}
+
+static inline bool HasFMA3() {
+	int a, b, c, d;
+
+	if (!HasOSAVX())
+		return false;
+
+	CPUid(1, &a, &b, &c, &d);
+
+	return (c & c_FMA) == c_FMA;
+}
+
 #define MXCSR_DAZ	(1 << 6)
 #define MXCSR_FTZ	(1 << 15)
 
@@ -222,6 +302,12 @@ int Sys_GetProcessorId( void ) {
 	// there is no SDL_HasSSE3() in SDL 1.2
 	if (HasSSE3())
 		flags |= CPUID_SSE3;
+
+	if (HasAVX2())
+		flags |= CPUID_AVX2;
+
+	if (HasFMA3())
+		flags |= CPUID_FMA3;
 #endif
 
 	if (SDL_HasAltiVec())
@@ -1219,19 +1219,49 @@ void GLimp_ResetGamma() {
 /*
 =================
 GLimp_ActivateContext
+
+Makes the context current on the calling thread
 =================
 */
-void GLimp_ActivateContext() {
-	common->DPrintf("TODO: GLimp_ActivateContext\n");
+bool GLimp_ActivateContext() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+  #if SDL_VERSION_ATLEAST(3, 0, 0)
+	if ( ! SDL_GL_MakeCurrent( window, context ) ) {
+  #else
+	if ( SDL_GL_MakeCurrent( window, context ) < 0 ) {
+  #endif
+		common->Warning( "GLimp_ActivateContext: %s", SDL_GetError() );
+		return false;
+	}
+	return true;
+#else
+	common->DPrintf( "SDL1.2 can't move the OpenGL context to another thread\n" );
+	return false;
+#endif
 }
 
 /*
 =================
 GLimp_DeactivateContext
+
+Releases the context from the calling thread
 =================
 */
-void GLimp_DeactivateContext() {
-	common->DPrintf("TODO: GLimp_DeactivateContext\n");
+bool GLimp_DeactivateContext() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+  #if SDL_VERSION_ATLEAST(3, 0, 0)
+	if ( ! SDL_GL_MakeCurrent( window, NULL ) ) {
+  #else
+	if ( SDL_GL_MakeCurrent( window, NULL ) < 0 ) {
+  #endif
+		common->Warning( "GLimp_DeactivateContext: %s", SDL_GetError() );
+		return false;
+	}
+	return true;
+#else
+	common->DPrintf( "SDL1.2 can't move the OpenGL context to another thread\n" );
+	return false;
+#endif
 }
 
 /*
@@ -1247,7 +1277,9 @@ GLExtension_t GLimp_ExtensionPointer(const char *name) {
 
 void GLimp_GrabInput(int flags) {
 	if (!window) {
-		common->Warning("GLimp_GrabInput called without window");
+		// with r_nullGL there never is a window, don't warn about it every frame
+		if (!r_nullGL.GetBool())
+			common->Warning("GLimp_GrabInput called without window");
 		return;
 	}
 #if SDL_VERSION_ATLEAST(3, 0, 0)
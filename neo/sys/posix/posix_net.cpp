@@ -387,6 +387,87 @@ static int IPSocket( const char *net_interface, int port, netadr_t *bound_to = N
 	return newsocket;
 }
 
+#ifdef __linux__
+// recvmmsg and sendmmsg read and send several packets with one system call
+#define ID_NET_BATCHING
+#endif
+
+#ifdef ID_NET_BATCHING
+
+const int MAX_BATCH_PACKETS		= 32;			// packets per recvmmsg / sendmmsg
+const int MAX_BATCH_RECV_SIZE	= 16384;		// MAX_MESSAGE_SIZE, what the callers read with recvfrom
+const int MAX_BATCH_SEND_BYTES	= 65536;
+
+struct portBatch_s {
+	// packets queued by SendPacket until FlushPackets
+	int					numSend;
+	int					sendBytes;
+	struct sockaddr_in	sendAddr[MAX_BATCH_PACKETS];
+	struct iovec		sendIov[MAX_BATCH_PACKETS];
+	struct mmsghdr		sendMsg[MAX_BATCH_PACKETS];
+	byte				sendData[MAX_BATCH_SEND_BYTES];
+
+	// packets read with one recvmmsg, handed out one by one by GetPacket
+	int					numRecv;
+	int					nextRecv;
+	struct sockaddr_in	recvAddr[MAX_BATCH_PACKETS];
+	struct iovec		recvIov[MAX_BATCH_PACKETS];
+	struct mmsghdr		recvMsg[MAX_BATCH_PACKETS];
+	byte				recvData[MAX_BATCH_PACKETS][MAX_BATCH_RECV_SIZE];
+};
+
+/*
+==================
+NET_GetBatchedPacket
+
+returns the next packet of the last recvmmsg, reads the next batch when all were handed out
+==================
+*/
+static bool NET_GetBatchedPacket( int netSocket, portBatch_s *batch, netadr_t &net_from, void *data, int &size, int maxSize, int &recvCalls ) {
+	int i, ret;
+
+	while ( 1 ) {
+		while ( batch->nextRecv < batch->numRecv ) {
+			i = batch->nextRecv++;
+			if ( ( batch->recvMsg[i].msg_hdr.msg_flags & MSG_TRUNC ) || (int)batch->recvMsg[i].msg_len >= maxSize ) {
+				common->DPrintf( "idPort::GetPacket: dropped oversize packet\n" );
+				continue;
+			}
+			SockadrToNetadr( &batch->recvAddr[i], &net_from );
+			size = batch->recvMsg[i].msg_len;
+			memcpy( data, batch->recvData[i], size );
+			return true;
+		}
+
+		for ( i = 0; i < MAX_BATCH_PACKETS; i++ ) {
+			batch->recvIov[i].iov_base = batch->recvData[i];
+			batch->recvIov[i].iov_len = MAX_BATCH_RECV_SIZE;
+			memset( &batch->recvMsg[i], 0, sizeof( batch->recvMsg[i] ) );
+			batch->recvMsg[i].msg_hdr.msg_name = &batch->recvAddr[i];
+			batch->recvMsg[i].msg_hdr.msg_namelen = sizeof( batch->recvAddr[i] );
+			batch->recvMsg[i].msg_hdr.msg_iov = &batch->recvIov[i];
+			batch->recvMsg[i].msg_hdr.msg_iovlen = 1;
+		}
+		batch->numRecv = 0;
+		batch->nextRecv = 0;
+
+		ret = recvmmsg( netSocket, batch->recvMsg, MAX_BATCH_PACKETS, MSG_DONTWAIT, NULL );
+		recvCalls++;
+		if ( ret == -1 ) {
+			if ( errno != EWOULDBLOCK && errno != ECONNREFUSED ) {
+				common->DPrintf( "idPort::GetPacket recvmmsg(): %s\n", strerror( errno ) );
+			}
+			return false;
+		}
+		if ( ret == 0 ) {
+			return false;
+		}
+		batch->numRecv = ret;
+	}
+}
+
+#endif
+
 /*
 ==================
 idPort::idPort
@@ -395,6 +476,9 @@ idPort::idPort
 idPort::idPort() {
 	netSocket = 0;
 	memset( &bound_to, 0, sizeof( bound_to ) );
+	batch = NULL;
+	packetsRead = bytesRead = recvCalls = 0;
+	packetsWritten = bytesWritten = sendCalls = 0;
 }
 
 /*
@@ -404,6 +488,60 @@ idPort::~idPort
 */
 idPort::~idPort() {
 	Close();
+	SetBatching( false );
+}
+
+/*
+==================
+idPort::SetBatching
+==================
+*/
+void idPort::SetBatching( bool enable ) {
+#ifdef ID_NET_BATCHING
+	if ( enable && batch == NULL ) {
+		batch = new portBatch_s;
+		batch->numSend = 0;
+		batch->sendBytes = 0;
+		batch->numRecv = 0;
+		batch->nextRecv = 0;
+	} else if ( !enable && batch != NULL ) {
+		// packets that were already read are dropped
+		FlushPackets();
+		delete batch;
+		batch = NULL;
+	}
+#endif
+}
+
+/*
+==================
+idPort::FlushPackets
+==================
+*/
+void idPort::FlushPackets( void ) {
+#ifdef ID_NET_BATCHING
+	int sent, ret;
+
+	if ( batch == NULL ) {
+		return;
+	}
+
+	for ( sent = 0; netSocket && sent < batch->numSend; ) {
+		ret = sendmmsg( netSocket, batch->sendMsg + sent, batch->numSend - sent, 0 );
+		sendCalls++;
+		if ( ret == -1 ) {
+			// the first packet failed, drop it like a failed sendto
+			netadr_t to;
+			SockadrToNetadr( &batch->sendAddr[sent], &to );
+			common->Printf( "idPort::FlushPackets ERROR: to %s: %s\n", Sys_NetAdrToString( to ), strerror( errno ) );
+			sent++;
+		} else {
+			sent += ret;
+		}
+	}
+	batch->numSend = 0;
+	batch->sendBytes = 0;
+#endif
 }
 
 /*
@@ -413,9 +551,19 @@ idPort::Close
 */
 void idPort::Close() {
 	if ( netSocket ) {
+		FlushPackets();
+#ifdef ID_NET_BATCHING
+		if ( batch ) {
+			batch->numRecv = 0;
+			batch->nextRecv = 0;
+		}
+#endif
 		close(netSocket);
 		netSocket = 0;
 		memset( &bound_to, 0, sizeof( bound_to ) );
+	} else if ( bound_to.type == NA_LOOPBACK ) {
+		Sys_CloseLoopbackPort( bound_to.port );
+		memset( &bound_to, 0, sizeof( bound_to ) );
 	}
 }
 
@@ -429,12 +577,28 @@ bool idPort::GetPacket( netadr_t &net_from, void *data, int &size, int maxSize )
 	struct sockaddr_in from;
 	int fromlen;
 
+	if ( bound_to.type == NA_LOOPBACK ) {
+		return Sys_GetLoopbackPacket( bound_to.port, net_from, data, size, maxSize );
+	}
+
 	if ( !netSocket ) {
 		return false;
 	}
 
+#ifdef ID_NET_BATCHING
+	if ( batch ) {
+		if ( !NET_GetBatchedPacket( netSocket, batch, net_from, data, size, maxSize, recvCalls ) ) {
+			return false;
+		}
+		packetsRead++;
+		bytesRead += size;
+		return true;
+	}
+#endif
+
 	fromlen = sizeof( from );
 	ret = recvfrom( netSocket, data, maxSize, 0, (struct sockaddr *) &from, (socklen_t *) &fromlen );
+	recvCalls++;
 
 	if ( ret == -1 ) {
 		if (errno == EWOULDBLOCK || errno == ECONNREFUSED) {
@@ -449,6 +613,8 @@ bool idPort::GetPacket( netadr_t &net_from, void *data, int &size, int maxSize )
 
 	SockadrToNetadr( &from, &net_from );
 	size = ret;
+	packetsRead++;
+	bytesRead += size;
 	return true;
 }
 
@@ -462,10 +628,25 @@ bool idPort::GetPacketBlocking( netadr_t &net_from, void *data, int &size, int m
 	struct timeval		tv;
 	int					ret;
 
+	if ( bound_to.type == NA_LOOPBACK ) {
+		return Sys_GetLoopbackPacket( bound_to.port, net_from, data, size, maxSize );
+	}
+
 	if ( !netSocket ) {
 		return false;
 	}
 
+#ifdef ID_NET_BATCHING
+	if ( batch ) {
+		// don't wait if there are packets left from the last batch
+		if ( batch->nextRecv < batch->numRecv ) {
+			return GetPacket( net_from, data, size, maxSize );
+		}
+		// the caller is idle until the next packet, send the replies it queued
+		FlushPackets();
+	}
+#endif
+
 	if ( timeout < 0 ) {
 		return GetPacket( net_from, data, size, maxSize );
 	}
@@ -489,10 +670,18 @@ bool idPort::GetPacketBlocking( netadr_t &net_from, void *data, int &size, int m
 		// timed out
 		return false;
 	}
+
+#ifdef ID_NET_BATCHING
+	if ( batch ) {
+		return GetPacket( net_from, data, size, maxSize );
+	}
+#endif
+
 	struct sockaddr_in from;
 	int fromlen;
 	fromlen = sizeof( from );
 	ret = recvfrom( netSocket, data, maxSize, 0, (struct sockaddr *)&from, (socklen_t *)&fromlen );
+	recvCalls++;
 	if ( ret == -1 ) {
 		// there should be no blocking errors once select declares things are good
 		common->DPrintf( "idPort::GetPacketBlocking: %s\n", strerror( errno ) );
@@ -501,6 +690,8 @@ bool idPort::GetPacketBlocking( netadr_t &net_from, void *data, int &size, int m
 	assert( ret < maxSize );
 	SockadrToNetadr( &from, &net_from );
 	size = ret;
+	packetsRead++;
+	bytesRead += size;
 	return true;
 }
 
@@ -518,13 +709,43 @@ void idPort::SendPacket( const netadr_t to, const void *data, int size ) {
 		return;
 	}
 
+	if ( bound_to.type == NA_LOOPBACK ) {
+		Sys_SendLoopbackPacket( bound_to.port, to, data, size );
+		return;
+	}
+
 	if ( !netSocket ) {
 		return;
 	}
 
 	NetadrToSockadr( &to, &addr );
 
+	packetsWritten++;
+	bytesWritten += size;
+
+#ifdef ID_NET_BATCHING
+	if ( batch && size <= MAX_BATCH_SEND_BYTES ) {
+		if ( batch->numSend >= MAX_BATCH_PACKETS || batch->sendBytes + size > MAX_BATCH_SEND_BYTES ) {
+			FlushPackets();
+		}
+
+		int i = batch->numSend++;
+		memcpy( batch->sendData + batch->sendBytes, data, size );
+		batch->sendAddr[i] = addr;
+		batch->sendIov[i].iov_base = batch->sendData + batch->sendBytes;
+		batch->sendIov[i].iov_len = size;
+		memset( &batch->sendMsg[i], 0, sizeof( batch->sendMsg[i] ) );
+		batch->sendMsg[i].msg_hdr.msg_name = &batch->sendAddr[i];
+		batch->sendMsg[i].msg_hdr.msg_namelen = sizeof( batch->sendAddr[i] );
+		batch->sendMsg[i].msg_hdr.msg_iov = &batch->sendIov[i];
+		batch->sendMsg[i].msg_hdr.msg_iovlen = 1;
+		batch->sendBytes += size;
+		return;
+	}
+#endif
+
 	ret = sendto( netSocket, data, size, 0, (struct sockaddr *) &addr, sizeof(addr) );
+	sendCalls++;
 	if ( ret == -1 ) {
 		common->Printf( "idPort::SendPacket ERROR: to %s: %s\n", Sys_NetAdrToString( to ), strerror( errno ) );
 	}
@@ -394,8 +394,8 @@ void GLimp_ResetGamma() {}
 bool GLimp_SetScreenParms(glimpParms_t parms) { return true; };
 void GLimp_Shutdown() {};
 void GLimp_SwapBuffers() {};
-void GLimp_ActivateContext() {};
-void GLimp_DeactivateContext() {};
+bool GLimp_ActivateContext() { return false; };
+bool GLimp_DeactivateContext() { return false; };
 void GLimp_GrabInput(int flags) {};
 bool GLimp_SetSwapInterval( int swapInterval ) { return false; }
 int GLimp_GetSwapInterval() { return 0; }
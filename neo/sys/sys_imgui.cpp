@@ -318,11 +318,17 @@ void Shutdown()
 void NewFrame()
 {
 	D3P_ScopedCPUSample(Imgui_NewFrame);
+	// no context without a window, e.g. with r_nullGL
+	if ( !imgui_initialized )
+		return;
+
 	// it can happen that NewFrame() is called without EndFrame() having been called
 	// after the last NewFrame() call, for example when D3Radiant is active and in
 	// idSessionLocal::UpdateScreen() Sys_IsWindowVisible() returns false.
 	// In that case, end the previous frame here so it's ended at all.
 	if ( haveNewFrame ) {
+		// with r_smp the render thread may have the GL context
+		R_SyncRenderThread();
 		EndFrame();
 	}
 
@@ -350,7 +356,8 @@ void NewFrame()
 		style.FontScaleDpi = scale;
 	}
 
-	// Start the Dear ImGui frame
+	// Start the Dear ImGui frame, the OpenGL2 backend may create its textures here
+	R_SyncRenderThread();
 	ImGui_ImplOpenGL2_NewFrame();
 
 	if ( ShouldShowCursor() )
@@ -519,13 +526,23 @@ bool ShouldShowCursor()
 	}
 }
 
+bool IsFrameActive()
+{
+	return haveNewFrame;
+}
+
 void EndFrame()
 {
-	if (openImguiWindows == 0 && !haveNewFrame)
+	if ( !imgui_initialized || (openImguiWindows == 0 && !haveNewFrame) )
 		return;
 
 	// I think this can happen if we're not coming from idCommon::Frame() but screenshot or sth
 	if ( !haveNewFrame ) {
+		// the main thread may be using ImGui, the render thread
+		// only ends frames that were started for it
+		if ( R_OnRenderThread() ) {
+			return;
+		}
 		NewFrame();
 	}
 	haveNewFrame = false;
@@ -58,6 +58,9 @@ extern void NewFrame();
 // renders ImGui menus then
 extern void EndFrame();
 
+// true between NewFrame() and EndFrame()
+extern bool IsFrameActive();
+
 extern float GetScale();
 extern void SetScale( float scale );
 
@@ -110,6 +113,8 @@ inline void NewFrame() {}
 
 inline void EndFrame() {}
 
+inline bool IsFrameActive() { return false; }
+
 inline void OpenWindow( D3ImGuiWindow win ) {}
 
 inline void CloseWindow( D3ImGuiWindow win ) {}
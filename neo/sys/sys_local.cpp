@@ -113,6 +113,162 @@ sysEvent_t idSysLocal::GenerateMouseMoveEvent( int deltax, int deltay ) {
 	return ev;
 }
 
+int idSysLocal::NumJobThreads( void ) {
+	return Sys_NumJobThreads();
+}
+
+void idSysLocal::ParallelFor( jobRange_t function, void *data, int count, int minRange ) {
+	Sys_ParallelFor( function, data, count, minRange );
+}
+
+double idSysLocal::GetMillisecondsPrecise( void ) {
+	return Sys_MillisecondsPrecise();
+}
+
+/*
+===============================================================================
+
+	Loopback ports
+
+	Lets a server and clients in the same process talk through idPort without
+	any sockets. Every open loopback port has a queue with the packets sent to
+	it, each stored with the port of the sender and its size.
+
+===============================================================================
+*/
+
+const int MAX_LOOPBACK_PORTS		= 64;
+
+typedef struct {
+	int					port;		// 0 if the queue is unused
+	idList<byte>		packets;
+	int					readOffset;
+} loopbackQueue_t;
+
+static loopbackQueue_t	loopbackQueues[MAX_LOOPBACK_PORTS];
+
+/*
+==================
+Sys_FindLoopbackQueue
+==================
+*/
+static loopbackQueue_t *Sys_FindLoopbackQueue( int port ) {
+	for ( int i = 0; i < MAX_LOOPBACK_PORTS; i++ ) {
+		if ( loopbackQueues[i].port == port ) {
+			return &loopbackQueues[i];
+		}
+	}
+	return NULL;
+}
+
+/*
+==================
+Sys_OpenLoopbackPort
+==================
+*/
+bool Sys_OpenLoopbackPort( int port ) {
+	if ( port <= 0 || Sys_FindLoopbackQueue( port ) != NULL ) {
+		return false;
+	}
+	loopbackQueue_t *queue = Sys_FindLoopbackQueue( 0 );
+	if ( queue == NULL ) {
+		return false;
+	}
+	queue->port = port;
+	queue->packets.SetGranularity( 16384 );
+	queue->packets.SetNum( 0, false );
+	queue->readOffset = 0;
+	return true;
+}
+
+/*
+==================
+Sys_CloseLoopbackPort
+==================
+*/
+void Sys_CloseLoopbackPort( int port ) {
+	loopbackQueue_t *queue = Sys_FindLoopbackQueue( port );
+	if ( queue != NULL && port > 0 ) {
+		queue->port = 0;
+		queue->packets.Clear();
+		queue->readOffset = 0;
+	}
+}
+
+/*
+==================
+Sys_GetLoopbackPacket
+==================
+*/
+bool Sys_GetLoopbackPacket( int port, netadr_t &from, void *data, int &size, int maxSize ) {
+	loopbackQueue_t *queue = Sys_FindLoopbackQueue( port );
+	if ( queue == NULL || port <= 0 ) {
+		return false;
+	}
+
+	while ( queue->readOffset < queue->packets.Num() ) {
+		int header[2];
+		memcpy( header, queue->packets.Ptr() + queue->readOffset, sizeof( header ) );
+		const byte *packet = queue->packets.Ptr() + queue->readOffset + sizeof( header );
+		queue->readOffset += sizeof( header ) + header[1];
+
+		if ( header[1] > maxSize ) {
+			// same as an oversized datagram
+			continue;
+		}
+
+		memset( &from, 0, sizeof( from ) );
+		from.type = NA_LOOPBACK;
+		from.port = header[0];
+		memcpy( data, packet, header[1] );
+		size = header[1];
+		return true;
+	}
+
+	// all packets read
+	queue->packets.SetNum( 0, false );
+	queue->readOffset = 0;
+	return false;
+}
+
+/*
+==================
+Sys_SendLoopbackPacket
+==================
+*/
+void Sys_SendLoopbackPacket( int fromPort, const netadr_t to, const void *data, int size ) {
+	if ( to.type != NA_LOOPBACK || to.port == 0 || size < 0 ) {
+		return;
+	}
+	loopbackQueue_t *queue = Sys_FindLoopbackQueue( to.port );
+	if ( queue == NULL ) {
+		// nobody is listening on that port
+		return;
+	}
+
+	int header[2] = { fromPort, size };
+	int offset = queue->packets.Num();
+	queue->packets.AssureSize( offset + sizeof( header ) + size );
+	memcpy( queue->packets.Ptr() + offset, header, sizeof( header ) );
+	memcpy( queue->packets.Ptr() + offset + sizeof( header ), data, size );
+}
+
+/*
+==================
+idPort::InitForLoopback
+==================
+*/
+bool idPort::InitForLoopback( int portNumber ) {
+	if ( !Sys_OpenLoopbackPort( portNumber ) ) {
+		return false;
+	}
+	netSocket = 0;
+	memset( &bound_to, 0, sizeof( bound_to ) );
+	bound_to.type = NA_LOOPBACK;
+	bound_to.port = portNumber;
+	return true;
+}
+
 /*
 =================
 Sys_TimeStampToStr
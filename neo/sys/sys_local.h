@@ -64,6 +64,11 @@ public:
 
 	virtual void			OpenURL( const char *url, bool quit );
 	virtual void			StartProcess( const char *exeName, bool quit );
+
+	virtual int				NumJobThreads( void );
+	virtual void			ParallelFor( jobRange_t function, void *data, int count, int minRange );
+
+	virtual double			GetMillisecondsPrecise( void );
 };
 
 #endif /* !__SYS_LOCAL__ */
@@ -41,6 +41,8 @@ typedef enum {
 	CPUID_SSE2							= 0x00080,	// Streaming SIMD Extensions 2
 	CPUID_SSE3							= 0x00100,	// Streaming SIMD Extentions 3 aka Prescott's New Instructions
 	CPUID_ALTIVEC						= 0x00200,	// AltiVec
+	CPUID_AVX2							= 0x00400,	// Advanced Vector Extensions 2, with OS support for the YMM state
+	CPUID_FMA3							= 0x00800,	// Fused Multiply-Add
 } cpuidSimd_t;
 
 typedef enum {
@@ -315,6 +317,8 @@ public:
 
 	// if the InitForPort fails, the idPort.port field will remain 0
 	bool		InitForPort( int portNumber );
+	// in-process port without a socket, only reachable from other loopback ports
+	bool		InitForLoopback( int portNumber );
 	int			GetPort( void ) const { return bound_to.port; }
 	netadr_t	GetAdr( void ) const { return bound_to; }
 	void		Close();
@@ -323,15 +327,23 @@ public:
 	bool		GetPacketBlocking( netadr_t &from, void *data, int &size, int maxSize, int timeout );
 	void		SendPacket( const netadr_t to, const void *data, int size );
 
+				// queue sent packets until FlushPackets or GetPacketBlocking has to wait and
+				// read several packets at once, only Linux does this, with sendmmsg and recvmmsg
+	void		SetBatching( bool enable );
+	void		FlushPackets( void );
+
 	int			packetsRead;
 	int			bytesRead;
+	int			recvCalls;		// system calls made to read packets
 
 	int			packetsWritten;
 	int			bytesWritten;
+	int			sendCalls;		// system calls made to send packets
 
 private:
 	netadr_t	bound_to;		// interface and port
 	int			netSocket;		// OS specific socket
+	struct portBatch_s *batch;	// OS specific packet queues when batching
 };
 
 class idTCP {
@@ -367,6 +379,12 @@ bool			Sys_CompareNetAdrBase( const netadr_t a, const netadr_t b );
 void			Sys_InitNetworking( void );
 void			Sys_ShutdownNetworking( void );
 
+				// packet queues of the ports opened with idPort::InitForLoopback
+bool			Sys_OpenLoopbackPort( int port );
+void			Sys_CloseLoopbackPort( int port );
+bool			Sys_GetLoopbackPacket( int port, netadr_t &from, void *data, int &size, int maxSize );
+void			Sys_SendLoopbackPacket( int fromPort, const netadr_t to, const void *data, int size );
+
 
 /*
 ==============================================================
@@ -427,6 +445,60 @@ enum {
 void				Sys_WaitForEvent( int index = TRIGGER_EVENT_ZERO );
 void				Sys_TriggerEvent( int index = TRIGGER_EVENT_ZERO );
 
+// atomically adds to the value and returns the new value, implies a full memory barrier
+int					Sys_AtomicAdd( volatile int *value, int add );
+
+/*
+==============================================================
+
+	Job system
+
+	A pool of worker threads that run small independent jobs. Every worker owns a
+	queue it takes its own jobs from, idle workers steal from the other queues.
+	Jobs are tracked by a counter that is decremented when a job finishes, the
+	submitting thread waits on the counter and runs queued jobs in the meantime.
+	Jobs must not wait on counters themselves.
+
+==============================================================
+*/
+
+const int MAX_JOB_THREADS			= 32;
+
+// for per thread data of code that runs in jobs
+#ifdef _MSC_VER
+  #define ID_THREAD_LOCAL __declspec(thread)
+#else
+  #define ID_THREAD_LOCAL __thread
+#endif
+
+typedef void (*jobRun_t)( void *data );
+typedef void (*jobRange_t)( void *data, int first, int last );	// handles [first, last)
+
+typedef struct {
+	jobRun_t		function;
+	void *			data;
+} jobDecl_t;
+
+// must be zero initialized and stay valid until Sys_WaitForJobs() returns
+typedef struct {
+	volatile int	pending;
+} jobCounter_t;
+
+// numThreads == -1 uses one worker per logical core besides the main thread,
+// with 0 workers jobs are run by the submitting thread
+void				Sys_InitJobs( int numThreads );
+void				Sys_ShutdownJobs( void );
+int					Sys_NumJobThreads( void );
+int					Sys_JobThreadIndex( void );	// 1 + worker number on job workers, 0 on any other thread
+
+void				Sys_SubmitJobs( jobCounter_t &counter, const jobDecl_t *jobs, int numJobs );
+void				Sys_WaitForJobs( jobCounter_t &counter );
+
+// splits [0, count) into ranges of at least minRange elements, runs them in parallel and waits for them
+void				Sys_ParallelFor( jobRange_t function, void *data, int count, int minRange = 1 );
+
+void				Sys_PrintJobStats( bool reset );
+
 /*
 ==============================================================
 
@@ -458,6 +530,11 @@ public:
 
 	virtual void			OpenURL( const char *url, bool quit ) = 0;
 	virtual void			StartProcess( const char *exePath, bool quit ) = 0;
+
+	virtual int				NumJobThreads( void ) = 0;
+	virtual void			ParallelFor( jobRange_t function, void *data, int count, int minRange ) = 0;
+
+	virtual double			GetMillisecondsPrecise( void ) = 0;
 };
 
 extern idSys *				sys;
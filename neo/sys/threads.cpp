@@ -28,6 +28,11 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "sys/sys_sdl.h"
 
+#ifdef _MSC_VER
+  // must come before idStr redirects strcmp & co
+  #include <intrin.h>
+#endif
+
 #if 0 // TODO: was there a reason not to include full SDL.h?
   #include <SDL_version.h>
   #include <SDL_mutex.h>
@@ -53,6 +58,7 @@ If you have questions concerning this license or the applicable additional terms
   #define SDL_DestroyCond SDL_DestroyCondition
   #define SDL_CondWait SDL_WaitCondition
   #define SDL_CondSignal SDL_SignalCondition
+  #define SDL_CondBroadcast SDL_BroadcastCondition
 #endif
 
 #if SDL_MAJOR_VERSION < 3
@@ -73,7 +79,7 @@ static SDL_cond		*cond[MAX_TRIGGER_EVENTS] = { };
 static bool			signaled[MAX_TRIGGER_EVENTS] = { };
 static bool			waiting[MAX_TRIGGER_EVENTS] = { };
 
-static xthreadInfo	*thread[MAX_THREADS] = { };
+static xthreadInfo	*thread[MAX_THREADS + MAX_JOB_THREADS] = { };	// the job workers come on top
 static size_t		thread_count = 0;
 
 static bool mainThreadIDset = false;
@@ -121,7 +127,7 @@ void Sys_InitThreads() {
 	}
 
 	// threads
-	for (int i = 0; i < MAX_THREADS; i++)
+	for (int i = 0; i < MAX_THREADS + MAX_JOB_THREADS; i++)
 		thread[i] = NULL;
 
 	thread_count = 0;
@@ -134,7 +140,7 @@ Sys_ShutdownThreads
 */
 void Sys_ShutdownThreads() {
 	// threads
-	for (int i = 0; i < MAX_THREADS; i++) {
+	for (int i = 0; i < MAX_THREADS + MAX_JOB_THREADS; i++) {
 		if (!thread[i])
 			continue;
 
@@ -284,7 +290,7 @@ void Sys_CreateThread(xthread_t function, void *parms, xthreadInfo& info, const
 	info.threadHandle = t;
 	info.threadId = SDL_GetThreadID(t);
 
-	if (thread_count < MAX_THREADS)
+	if (thread_count < MAX_THREADS + MAX_JOB_THREADS)
 		thread[thread_count++] = &info;
 	else
 		common->DPrintf("WARNING: MAX_THREADS reached\n");
@@ -374,3 +380,474 @@ bool Sys_IsMainThread() {
 	// any threads yet so it should be the main thread
 	return true;
 }
+
+/*
+==================
+Sys_AtomicAdd
+==================
+*/
+int Sys_AtomicAdd(volatile int *value, int add) {
+#ifdef _MSC_VER
+	return _InterlockedExchangeAdd((volatile long *)value, add) + add;
+#else
+	return __sync_add_and_fetch(value, add);
+#endif
+}
+
+/*
+======================================================
+job system
+
+every worker owns a ring buffer of jobs guarded by its own mutex. the owner
+pushes and pops at the tail so it keeps working on what it just queued,
+thieves take from the head. threads that aren't workers spread their jobs
+over all worker queues and steal while they wait for them.
+
+idle workers sleep on jobWorkCond, jobsQueued tells them whether there's
+anything left to take. it's only raised with jobMutex held, so a worker
+that checked it under the mutex can't miss the wakeup.
+======================================================
+*/
+
+const int JOB_QUEUE_SIZE = 2048;	// jobs that don't fit are run right away by the submitting thread
+
+typedef struct {
+	jobRun_t		function;
+	void *			data;
+	jobCounter_t *	counter;
+} job_t;
+
+typedef struct {
+	SDL_mutex *		mutex;
+	job_t *			jobs;
+	volatile int	head;
+	volatile int	tail;			// head == tail is empty
+
+	// only written by the thread the stats belong to, except for the shared "other threads" entry
+	volatile int	numRun;
+	volatile int	numStolen;
+	volatile int	numSleeps;
+} jobQueue_t;
+
+static int				jobNumWorkers = 0;
+static jobQueue_t		jobQueues[MAX_JOB_THREADS];
+static jobQueue_t		jobOtherStats;				// stats of jobs run by threads that aren't workers
+static xthreadInfo		jobThreads[MAX_JOB_THREADS];
+static char				jobThreadNames[MAX_JOB_THREADS][16];
+
+static SDL_mutex *		jobMutex = NULL;
+static SDL_cond *		jobWorkCond = NULL;			// jobs were queued or the workers should quit
+static SDL_cond *		jobDoneCond = NULL;			// a job counter reached zero
+static volatile int		jobsQueued = 0;
+static volatile int		jobsQuit = 0;
+static volatile int		jobNextQueue = 0;
+static volatile int		jobNumSubmitted = 0;
+
+static ID_THREAD_LOCAL int jobWorkerIndex = -1;	// -1 for threads that aren't workers
+
+/*
+==================
+Job_Push
+==================
+*/
+static bool Job_Push(jobQueue_t &queue, const job_t &job) {
+	SDL_LockMutex(queue.mutex);
+
+	int next = (queue.tail + 1) % JOB_QUEUE_SIZE;
+	if (next == queue.head) {
+		SDL_UnlockMutex(queue.mutex);
+		return false;
+	}
+	queue.jobs[queue.tail] = job;
+	queue.tail = next;
+
+	SDL_UnlockMutex(queue.mutex);
+	return true;
+}
+
+/*
+==================
+Job_Take
+takes the newest job from the own queue or the oldest one from another queue
+==================
+*/
+static bool Job_Take(jobQueue_t &queue, bool own, job_t &job) {
+	if (queue.head == queue.tail) {
+		// racy peek, an empty looking queue is skipped without taking the lock
+		return false;
+	}
+
+	SDL_LockMutex(queue.mutex);
+
+	if (queue.head == queue.tail) {
+		SDL_UnlockMutex(queue.mutex);
+		return false;
+	}
+	if (own) {
+		queue.tail = (queue.tail + JOB_QUEUE_SIZE - 1) % JOB_QUEUE_SIZE;
+		job = queue.jobs[queue.tail];
+	} else {
+		job = queue.jobs[queue.head];
+		queue.head = (queue.head + 1) % JOB_QUEUE_SIZE;
+	}
+
+	SDL_UnlockMutex(queue.mutex);
+
+	Sys_AtomicAdd(&jobsQueued, -1);
+	return true;
+}
+
+/*
+==================
+Job_Find
+==================
+*/
+static bool Job_Find(int self, job_t &job, bool &stolen) {
+	if (self >= 0 && Job_Take(jobQueues[self], true, job)) {
+		stolen = false;
+		return true;
+	}
+
+	// start at a different queue for every thread so the thieves don't all fight over the same one
+	int start = (self >= 0) ? self + 1 : 0;
+	for (int i = 0; i < jobNumWorkers; i++) {
+		int victim = (start + i) % jobNumWorkers;
+		if (victim != self && Job_Take(jobQueues[victim], false, job)) {
+			stolen = true;
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+==================
+Job_Run
+==================
+*/
+static void Job_Run(const job_t &job, jobQueue_t &stats, bool stolen) {
+	job.function(job.data);
+
+	if (jobWorkerIndex >= 0) {
+		stats.numRun++;
+		stats.numStolen += stolen;
+	} else {
+		Sys_AtomicAdd(&stats.numRun, 1);
+		Sys_AtomicAdd(&stats.numStolen, stolen);
+	}
+
+	if (Sys_AtomicAdd(&job.counter->pending, -1) == 0 && jobMutex) {
+		// the counter may go out of scope as soon as the waiter sees zero, don't touch it anymore
+		SDL_LockMutex(jobMutex);
+		SDL_CondBroadcast(jobDoneCond);
+		SDL_UnlockMutex(jobMutex);
+	}
+}
+
+/*
+==================
+Job_WorkerThread
+==================
+*/
+static int Job_WorkerThread(void *parm) {
+	int self = (int)(intptr_t)parm;
+	jobQueue_t &stats = jobQueues[self];
+
+	jobWorkerIndex = self;
+
+	while (1) {
+		job_t job;
+		bool stolen;
+
+		if (Job_Find(self, job, stolen)) {
+			Job_Run(job, stats, stolen);
+			continue;
+		}
+
+		SDL_LockMutex(jobMutex);
+		while (jobsQueued <= 0 && !jobsQuit) {
+			stats.numSleeps++;
+			SDL_CondWait(jobWorkCond, jobMutex);
+		}
+		SDL_UnlockMutex(jobMutex);
+
+		if (jobsQuit) {
+			break;
+		}
+	}
+
+	jobWorkerIndex = -1;
+	return 0;
+}
+
+/*
+==================
+Sys_InitJobs
+==================
+*/
+void Sys_InitJobs(int numThreads) {
+	assert(jobNumWorkers == 0);
+
+	if (numThreads < 0) {
+#if SDL_VERSION_ATLEAST(3, 0, 0)
+		numThreads = SDL_GetNumLogicalCPUCores() - 1;
+#elif SDL_VERSION_ATLEAST(2, 0, 0)
+		numThreads = SDL_GetCPUCount() - 1;
+#else
+		// SDL1.2 can't tell the number of cores, only use workers if explicitly asked for
+		numThreads = 0;
+#endif
+	}
+	numThreads = idMath::ClampInt(0, MAX_JOB_THREADS, numThreads);
+
+	memset(&jobOtherStats, 0, sizeof(jobOtherStats));
+	jobsQueued = 0;
+	jobsQuit = 0;
+	jobNextQueue = 0;
+	jobNumSubmitted = 0;
+
+	if (numThreads == 0) {
+		common->Printf("job system: running jobs on the submitting thread\n");
+		return;
+	}
+
+	jobMutex = SDL_CreateMutex();
+	jobWorkCond = SDL_CreateCond();
+	jobDoneCond = SDL_CreateCond();
+	if (!jobMutex || !jobWorkCond || !jobDoneCond) {
+		common->Error("ERROR: job system mutex creation failed\n");
+	}
+
+	for (int i = 0; i < numThreads; i++) {
+		jobQueue_t &queue = jobQueues[i];
+		memset(&queue, 0, sizeof(queue));
+		queue.mutex = SDL_CreateMutex();
+		queue.jobs = new job_t[JOB_QUEUE_SIZE];
+		if (!queue.mutex) {
+			common->Error("ERROR: job queue mutex creation failed\n");
+		}
+	}
+
+	// the workers start stealing right away, all queues must exist before
+	jobNumWorkers = numThreads;
+
+	for (int i = 0; i < numThreads; i++) {
+		idStr::snPrintf(jobThreadNames[i], sizeof(jobThreadNames[i]), "JobWorker%d", i);
+		Sys_CreateThread(Job_WorkerThread, (void *)(intptr_t)i, jobThreads[i], jobThreadNames[i]);
+	}
+
+	common->Printf("job system: %d worker threads\n", numThreads);
+}
+
+/*
+==================
+Sys_ShutdownJobs
+==================
+*/
+void Sys_ShutdownJobs(void) {
+	if (jobNumWorkers == 0) {
+		return;
+	}
+
+	SDL_LockMutex(jobMutex);
+	jobsQuit = 1;
+	SDL_CondBroadcast(jobWorkCond);
+	SDL_UnlockMutex(jobMutex);
+
+	for (int i = 0; i < jobNumWorkers; i++) {
+		Sys_DestroyThread(jobThreads[i]);
+	}
+
+	for (int i = 0; i < jobNumWorkers; i++) {
+		jobQueue_t &queue = jobQueues[i];
+		assert(queue.head == queue.tail);
+		SDL_DestroyMutex(queue.mutex);
+		delete[] queue.jobs;
+		queue.mutex = NULL;
+		queue.jobs = NULL;
+	}
+	jobNumWorkers = 0;
+
+	SDL_DestroyCond(jobDoneCond);
+	SDL_DestroyCond(jobWorkCond);
+	SDL_DestroyMutex(jobMutex);
+	jobDoneCond = NULL;
+	jobWorkCond = NULL;
+	jobMutex = NULL;
+}
+
+/*
+==================
+Sys_NumJobThreads
+==================
+*/
+int Sys_NumJobThreads(void) {
+	return jobNumWorkers;
+}
+
+/*
+==================
+Sys_JobThreadIndex
+==================
+*/
+int Sys_JobThreadIndex(void) {
+	return jobWorkerIndex + 1;
+}
+
+/*
+==================
+Sys_SubmitJobs
+==================
+*/
+void Sys_SubmitJobs(jobCounter_t &counter, const jobDecl_t *jobs, int numJobs) {
+	if (numJobs <= 0) {
+		return;
+	}
+
+	Sys_AtomicAdd(&jobNumSubmitted, numJobs);
+
+	job_t job;
+	job.counter = &counter;
+
+	if (jobNumWorkers == 0) {
+		Sys_AtomicAdd(&counter.pending, numJobs);
+		for (int i = 0; i < numJobs; i++) {
+			job.function = jobs[i].function;
+			job.data = jobs[i].data;
+			Job_Run(job, jobOtherStats, false);
+		}
+		return;
+	}
+
+	// the counter must cover all jobs before the first one can finish
+	Sys_AtomicAdd(&counter.pending, numJobs);
+
+	int numQueued = 0;
+	for (int i = 0; i < numJobs; i++) {
+		job.function = jobs[i].function;
+		job.data = jobs[i].data;
+
+		int queue = jobWorkerIndex;
+		if (queue < 0) {
+			queue = (Sys_AtomicAdd(&jobNextQueue, 1) & 0x7fffffff) % jobNumWorkers;
+		}
+		if (Job_Push(jobQueues[queue], job)) {
+			numQueued++;
+		} else {
+			Job_Run(job, (jobWorkerIndex >= 0) ? jobQueues[jobWorkerIndex] : jobOtherStats, false);
+		}
+	}
+
+	if (numQueued > 0) {
+		SDL_LockMutex(jobMutex);
+		Sys_AtomicAdd(&jobsQueued, numQueued);
+		SDL_CondBroadcast(jobWorkCond);
+		SDL_UnlockMutex(jobMutex);
+	}
+}
+
+/*
+==================
+Sys_WaitForJobs
+==================
+*/
+void Sys_WaitForJobs(jobCounter_t &counter) {
+	jobQueue_t &stats = (jobWorkerIndex >= 0) ? jobQueues[jobWorkerIndex] : jobOtherStats;
+
+	// help out instead of blocking a core
+	while (counter.pending > 0) {
+		job_t job;
+		bool stolen;
+
+		if (!Job_Find(jobWorkerIndex, job, stolen)) {
+			break;
+		}
+		Job_Run(job, stats, stolen);
+	}
+
+	if (counter.pending <= 0) {
+		return;
+	}
+
+	// the remaining jobs are already running on the workers
+	SDL_LockMutex(jobMutex);
+	while (counter.pending > 0) {
+		Sys_AtomicAdd(&stats.numSleeps, 1);
+		SDL_CondWait(jobDoneCond, jobMutex);
+	}
+	SDL_UnlockMutex(jobMutex);
+}
+
+/*
+==================
+Sys_ParallelFor
+==================
+*/
+typedef struct {
+	jobRange_t		function;
+	void *			data;
+	int				first;
+	int				last;
+} jobRangeParms_t;
+
+static void Job_RunRange(void *data) {
+	const jobRangeParms_t *parms = (const jobRangeParms_t *)data;
+	parms->function(parms->data, parms->first, parms->last);
+}
+
+void Sys_ParallelFor(jobRange_t function, void *data, int count, int minRange) {
+	const int MAX_RANGES = 4 * ( MAX_JOB_THREADS + 1 );
+
+	if (count <= 0) {
+		return;
+	}
+
+	// a few ranges per thread so threads that finish early can steal the rest
+	int numRanges = idMath::ClampInt(1, MAX_RANGES, 4 * (jobNumWorkers + 1));
+	numRanges = Min(numRanges, count / Max(minRange, 1));
+
+	if (jobNumWorkers == 0 || numRanges <= 1) {
+		function(data, 0, count);
+		return;
+	}
+
+	jobRangeParms_t parms[MAX_RANGES];
+	jobDecl_t jobs[MAX_RANGES];
+
+	for (int i = 0; i < numRanges; i++) {
+		parms[i].function = function;
+		parms[i].data = data;
+		parms[i].first = (int)((long long)count * i / numRanges);
+		parms[i].last = (int)((long long)count * (i + 1) / numRanges);
+		jobs[i].function = Job_RunRange;
+		jobs[i].data = &parms[i];
+	}
+
+	jobCounter_t counter = { 0 };
+	Sys_SubmitJobs(counter, jobs, numRanges);
+	Sys_WaitForJobs(counter);
+}
+
+/*
+==================
+Sys_PrintJobStats
+==================
+*/
+void Sys_PrintJobStats(bool reset) {
+	common->Printf("%d worker threads, %d jobs submitted\n", jobNumWorkers, jobNumSubmitted);
+	common->Printf("thread          run   stolen   sleeps\n");
+	common->Printf("-------------------------------------\n");
+	for (int i = 0; i < jobNumWorkers; i++) {
+		const jobQueue_t &queue = jobQueues[i];
+		common->Printf("%-12s %6d   %6d   %6d\n", jobThreadNames[i], queue.numRun, queue.numStolen, queue.numSleeps);
+	}
+	common->Printf("%-12s %6d   %6d   %6d\n", "other", jobOtherStats.numRun, jobOtherStats.numStolen, jobOtherStats.numSleeps);
+
+	if (reset) {
+		for (int i = 0; i < jobNumWorkers; i++) {
+			jobQueues[i].numRun = jobQueues[i].numStolen = jobQueues[i].numSleeps = 0;
+		}
+		jobOtherStats.numRun = jobOtherStats.numStolen = jobOtherStats.numSleeps = 0;
+		jobNumSubmitted = 0;
+	}
+}
@@ -661,6 +661,9 @@ idPort::idPort
 idPort::idPort() {
 	netSocket = 0;
 	memset( &bound_to, 0, sizeof( bound_to ) );
+	batch = NULL;
+	packetsRead = bytesRead = recvCalls = 0;
+	packetsWritten = bytesWritten = sendCalls = 0;
 }
 
 /*
@@ -672,6 +675,24 @@ idPort::~idPort() {
 	Close();
 }
 
+/*
+==================
+idPort::SetBatching
+
+packets are always sent and read one by one here
+==================
+*/
+void idPort::SetBatching( bool enable ) {
+}
+
+/*
+==================
+idPort::FlushPackets
+==================
+*/
+void idPort::FlushPackets( void ) {
+}
+
 /*
 ==================
 InitForPort
@@ -704,6 +725,9 @@ void idPort::Close() {
 		closesocket( netSocket );
 		netSocket = 0;
 		memset( &bound_to, 0, sizeof( bound_to ) );
+	} else if ( bound_to.type == NA_LOOPBACK ) {
+		Sys_CloseLoopbackPort( bound_to.port );
+		memset( &bound_to, 0, sizeof( bound_to ) );
 	}
 }
 
@@ -716,9 +740,14 @@ bool idPort::GetPacket( netadr_t &from, void *data, int &size, int maxSize ) {
 	udpMsg_t *msg;
 	bool ret;
 
+	if ( bound_to.type == NA_LOOPBACK ) {
+		return Sys_GetLoopbackPacket( bound_to.port, from, data, size, maxSize );
+	}
+
 	while( 1 ) {
 
 		ret = Net_GetUDPPacket( netSocket, from, (char *)data, size, maxSize );
+		recvCalls++;
 		if ( !ret ) {
 			break;
 		}
@@ -780,6 +809,10 @@ idPort::GetPacketBlocking
 */
 bool idPort::GetPacketBlocking( netadr_t &from, void *data, int &size, int maxSize, int timeout ) {
 
+	if ( bound_to.type == NA_LOOPBACK ) {
+		return Sys_GetLoopbackPacket( bound_to.port, from, data, size, maxSize );
+	}
+
 	Net_WaitForUDPPacket( netSocket, timeout );
 
 	if ( GetPacket( from, data, size, maxSize ) ) {
@@ -805,6 +838,11 @@ void idPort::SendPacket( const netadr_t to, const void *data, int size ) {
 	packetsWritten++;
 	bytesWritten += size;
 
+	if ( bound_to.type == NA_LOOPBACK ) {
+		Sys_SendLoopbackPacket( bound_to.port, to, data, size );
+		return;
+	}
+
 	if ( net_forceDrop.GetInteger() > 0 ) {
 		if ( rand() < net_forceDrop.GetInteger() * RAND_MAX / 100 ) {
 			return;
@@ -829,6 +867,7 @@ void idPort::SendPacket( const netadr_t to, const void *data, int size ) {
 
 		for ( msg = udpPorts[ bound_to.port ]->sendFirst; msg && msg->time <= Sys_Milliseconds() - net_forceLatency.GetInteger(); msg = udpPorts[ bound_to.port ]->sendFirst ) {
 			Net_SendUDPPacket( netSocket, msg->size, msg->data, msg->address );
+			sendCalls++;
 			udpPorts[ bound_to.port ]->sendFirst = udpPorts[ bound_to.port ]->sendFirst->next;
 			if ( !udpPorts[ bound_to.port ]->sendFirst ) {
 				udpPorts[ bound_to.port ]->sendLast = NULL;
@@ -838,6 +877,7 @@ void idPort::SendPacket( const netadr_t to, const void *data, int size ) {
 
 	} else {
 		Net_SendUDPPacket( netSocket, size, data, to );
+		sendCalls++;
 	}
 }
 